@@ -0,0 +1,861 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 The MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/mpconfig.h"
+#include "py/misc.h"
+
+#if MICROPY_PY_CRYPTOLIB && MICROPY_PY_CRYPTOLIB_AES_BUILTIN
+
+#include "extmod/cryptolib_aes.h"
+
+#if MICROPY_PY_CRYPTOLIB_AES_HW && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CRYPTOLIB_AES_USE_AESNI (1)
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define CRYPTOLIB_AES_USE_AESNI (0)
+#endif
+
+// Number of blocks to encrypt at once, so that AES-NI can pipeline them.
+#define AES_BATCH (8)
+
+#define GET32(p) ((uint32_t)(p)[0] << 24 | (uint32_t)(p)[1] << 16 | (uint32_t)(p)[2] << 8 | (uint32_t)(p)[3])
+#define PUT32(p, v) ((p)[0] = (v) >> 24, (p)[1] = (v) >> 16, (p)[2] = (v) >> 8, (p)[3] = (v))
+#define ROR(x, n) ((x) >> (n) | (x) << (32 - (n)))
+
+static void aes_xor(uint8_t *out, const uint8_t *a, const uint8_t *b, size_t len) {
+    // Work a machine word at a time; memcpy keeps the accesses unaligned-safe.
+    for (; len >= sizeof(uintptr_t); len -= sizeof(uintptr_t)) {
+        uintptr_t x, y;
+        memcpy(&x, a, sizeof(x));
+        memcpy(&y, b, sizeof(y));
+        x ^= y;
+        memcpy(out, &x, sizeof(x));
+        out += sizeof(x);
+        a += sizeof(x);
+        b += sizeof(x);
+    }
+    while (len--) {
+        *out++ = *a++ ^ *b++;
+    }
+}
+
+// Multiplies each of the four bytes of w by x in GF(2^8), without branches.
+static inline uint32_t aes_xtime4(uint32_t w) {
+    uint32_t hi = w >> 7 & 0x01010101;
+    return (w & 0x7f7f7f7f) << 1 ^ hi ^ hi << 1 ^ hi << 3 ^ hi << 4;
+}
+
+// Applies MixColumns, or InvMixColumns, to each column of len bytes of state.
+static void aes_mix_columns(uint8_t *s, size_t len, bool inverse) {
+    for (; len; len -= 4, s += 4) {
+        uint32_t w = s[0] | (uint32_t)s[1] << 8 | (uint32_t)s[2] << 16 | (uint32_t)s[3] << 24;
+        if (inverse) {
+            // InvMixColumns is MixColumns after multiplying by (5, 0, 4, 0).
+            w ^= aes_xtime4(aes_xtime4(w ^ ROR(w, 16)));
+        }
+        w = aes_xtime4(w ^ ROR(w, 8)) ^ ROR(w, 8) ^ ROR(w, 16) ^ ROR(w, 24);
+        s[0] = w;
+        s[1] = w >> 8;
+        s[2] = w >> 16;
+        s[3] = w >> 24;
+    }
+}
+
+#if MICROPY_PY_CRYPTOLIB_AES_CONST_TIME
+
+// The constant-time implementation computes the S-box instead of looking it
+// up, so that no memory access or branch depends on the key or the data.  It
+// works on two blocks at once, with the bytes bitsliced into 32-bit words.
+
+// Transposes an 8x8 bit matrix, one row per byte.
+static inline uint64_t aes_transpose8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ x >> 7) & 0x00aa00aa00aa00aa;
+    x ^= t ^ t << 7;
+    t = (x ^ x >> 14) & 0x0000cccc0000cccc;
+    x ^= t ^ t << 14;
+    t = (x ^ x >> 28) & 0x00000000f0f0f0f0;
+    x ^= t ^ t << 28;
+    return x;
+}
+
+// Sets bit j of x[i] to bit i of b[j], for 32 bytes.
+static void aes_bitslice(uint32_t x[8], const uint8_t b[32]) {
+    memset(x, 0, 8 * sizeof(uint32_t));
+    for (int k = 0; k < 4; ++k) {
+        uint64_t m = 0;
+        for (int j = 0; j < 8; ++j) {
+            m |= (uint64_t)b[8 * k + j] << (8 * j);
+        }
+        m = aes_transpose8(m);
+        for (int i = 0; i < 8; ++i) {
+            x[i] |= (uint32_t)(m >> (8 * i) & 0xff) << (8 * k);
+        }
+    }
+}
+
+static void aes_unbitslice(uint8_t b[32], const uint32_t x[8]) {
+    for (int k = 0; k < 4; ++k) {
+        uint64_t m = 0;
+        for (int i = 0; i < 8; ++i) {
+            m |= (uint64_t)(x[i] >> (8 * k) & 0xff) << (8 * i);
+        }
+        m = aes_transpose8(m);
+        for (int j = 0; j < 8; ++j) {
+            b[8 * k + j] = m >> (8 * j);
+        }
+    }
+}
+
+// Reduces a bitsliced product modulo x^8 + x^4 + x^3 + x + 1.
+static void gf_reduce(uint32_t r[8], uint32_t t[15]) {
+    for (int k = 14; k >= 8; --k) {
+        t[k - 4] ^= t[k];
+        t[k - 5] ^= t[k];
+        t[k - 7] ^= t[k];
+        t[k - 8] ^= t[k];
+    }
+    memcpy(r, t, 8 * sizeof(uint32_t));
+}
+
+static void gf_mul(uint32_t r[8], const uint32_t a[8], const uint32_t b[8]) {
+    uint32_t t[15] = {0};
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            t[i + j] ^= a[i] & b[j];
+        }
+    }
+    gf_reduce(r, t);
+}
+
+static void gf_square(uint32_t r[8], const uint32_t a[8]) {
+    uint32_t t[15] = {0};
+    for (int i = 0; i < 8; ++i) {
+        t[2 * i] = a[i];
+    }
+    gf_reduce(r, t);
+}
+
+// Applies the S-box, or the inverse S-box, to 32 bytes.
+static void aes_sub_bytes(uint8_t b[32], bool inverse) {
+    uint32_t x[8], y[8];
+    aes_bitslice(x, b);
+    if (inverse) {
+        // Undo the affine transformation.
+        for (int i = 0; i < 8; ++i) {
+            y[i] = x[(i + 2) & 7] ^ x[(i + 5) & 7] ^ x[(i + 7) & 7];
+        }
+        y[0] = ~y[0];
+        y[2] = ~y[2];
+        memcpy(x, y, sizeof(x));
+    }
+
+    // Invert in GF(2^8) as x^254, which also maps 0 to 0.
+    uint32_t x2[8], x3[8], x12[8], t[8];
+    gf_square(x2, x);
+    gf_mul(x3, x2, x);
+    gf_square(t, x3);
+    gf_square(x12, t);
+    gf_mul(t, x12, x3);
+    for (int i = 0; i < 4; ++i) {
+        gf_square(t, t);
+    }
+    gf_mul(t, t, x12);
+    gf_mul(x, t, x2);
+
+    if (!inverse) {
+        // The affine transformation.
+        for (int i = 0; i < 8; ++i) {
+            y[i] = x[i] ^ x[(i + 4) & 7] ^ x[(i + 5) & 7] ^ x[(i + 6) & 7] ^ x[(i + 7) & 7];
+        }
+        y[0] = ~y[0];
+        y[1] = ~y[1];
+        y[5] = ~y[5];
+        y[6] = ~y[6];
+        memcpy(x, y, sizeof(x));
+    }
+    aes_unbitslice(b, x);
+}
+
+static void aes_shift_rows(uint8_t s[16], bool inverse) {
+    uint8_t t[16];
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 4; ++r) {
+            t[4 * c + r] = s[4 * ((inverse ? c - r : c + r) & 3) + r];
+        }
+    }
+    memcpy(s, t, 16);
+}
+
+// Decryption uses the equivalent inverse cipher, like AES-NI, so it has the
+// same structure as encryption.
+static void aes_crypt_2blocks_ct(const cryptolib_aes_ctx_t *ctx, uint8_t s[32], bool encrypt) {
+    aes_xor(s, s, ctx->rk[0], 16);
+    aes_xor(s + 16, s + 16, ctx->rk[0], 16);
+    for (int r = 1; r <= ctx->nr; ++r) {
+        aes_sub_bytes(s, !encrypt);
+        aes_shift_rows(s, !encrypt);
+        aes_shift_rows(s + 16, !encrypt);
+        if (r < ctx->nr) {
+            aes_mix_columns(s, 32, !encrypt);
+        }
+        aes_xor(s, s, ctx->rk[r], 16);
+        aes_xor(s + 16, s + 16, ctx->rk[r], 16);
+    }
+}
+
+static uint32_t aes_sub_word(uint32_t w) {
+    uint8_t b[32] = {0};
+    PUT32(b, w);
+    aes_sub_bytes(b, false);
+    return GET32(b);
+}
+
+#else
+
+// aes_te[x] is column (2, 1, 1, 3) * S(x) and aes_td[x] is column
+// (14, 9, 13, 11) * S^-1(x); the other byte positions use rotations of these.
+static const uint8_t aes_sbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static const uint8_t aes_inv_sbox[256] = {
+    0x52, 0x09, 0x6a, 0xd5, 0x30, 0x36, 0xa5, 0x38, 0xbf, 0x40, 0xa3, 0x9e, 0x81, 0xf3, 0xd7, 0xfb,
+    0x7c, 0xe3, 0x39, 0x82, 0x9b, 0x2f, 0xff, 0x87, 0x34, 0x8e, 0x43, 0x44, 0xc4, 0xde, 0xe9, 0xcb,
+    0x54, 0x7b, 0x94, 0x32, 0xa6, 0xc2, 0x23, 0x3d, 0xee, 0x4c, 0x95, 0x0b, 0x42, 0xfa, 0xc3, 0x4e,
+    0x08, 0x2e, 0xa1, 0x66, 0x28, 0xd9, 0x24, 0xb2, 0x76, 0x5b, 0xa2, 0x49, 0x6d, 0x8b, 0xd1, 0x25,
+    0x72, 0xf8, 0xf6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xd4, 0xa4, 0x5c, 0xcc, 0x5d, 0x65, 0xb6, 0x92,
+    0x6c, 0x70, 0x48, 0x50, 0xfd, 0xed, 0xb9, 0xda, 0x5e, 0x15, 0x46, 0x57, 0xa7, 0x8d, 0x9d, 0x84,
+    0x90, 0xd8, 0xab, 0x00, 0x8c, 0xbc, 0xd3, 0x0a, 0xf7, 0xe4, 0x58, 0x05, 0xb8, 0xb3, 0x45, 0x06,
+    0xd0, 0x2c, 0x1e, 0x8f, 0xca, 0x3f, 0x0f, 0x02, 0xc1, 0xaf, 0xbd, 0x03, 0x01, 0x13, 0x8a, 0x6b,
+    0x3a, 0x91, 0x11, 0x41, 0x4f, 0x67, 0xdc, 0xea, 0x97, 0xf2, 0xcf, 0xce, 0xf0, 0xb4, 0xe6, 0x73,
+    0x96, 0xac, 0x74, 0x22, 0xe7, 0xad, 0x35, 0x85, 0xe2, 0xf9, 0x37, 0xe8, 0x1c, 0x75, 0xdf, 0x6e,
+    0x47, 0xf1, 0x1a, 0x71, 0x1d, 0x29, 0xc5, 0x89, 0x6f, 0xb7, 0x62, 0x0e, 0xaa, 0x18, 0xbe, 0x1b,
+    0xfc, 0x56, 0x3e, 0x4b, 0xc6, 0xd2, 0x79, 0x20, 0x9a, 0xdb, 0xc0, 0xfe, 0x78, 0xcd, 0x5a, 0xf4,
+    0x1f, 0xdd, 0xa8, 0x33, 0x88, 0x07, 0xc7, 0x31, 0xb1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xec, 0x5f,
+    0x60, 0x51, 0x7f, 0xa9, 0x19, 0xb5, 0x4a, 0x0d, 0x2d, 0xe5, 0x7a, 0x9f, 0x93, 0xc9, 0x9c, 0xef,
+    0xa0, 0xe0, 0x3b, 0x4d, 0xae, 0x2a, 0xf5, 0xb0, 0xc8, 0xeb, 0xbb, 0x3c, 0x83, 0x53, 0x99, 0x61,
+    0x17, 0x2b, 0x04, 0x7e, 0xba, 0x77, 0xd6, 0x26, 0xe1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0c, 0x7d,
+};
+
+static const uint32_t aes_te[256] = {
+    0xc66363a5, 0xf87c7c84, 0xee777799, 0xf67b7b8d, 0xfff2f20d, 0xd66b6bbd, 0xde6f6fb1, 0x91c5c554,
+    0x60303050, 0x02010103, 0xce6767a9, 0x562b2b7d, 0xe7fefe19, 0xb5d7d762, 0x4dababe6, 0xec76769a,
+    0x8fcaca45, 0x1f82829d, 0x89c9c940, 0xfa7d7d87, 0xeffafa15, 0xb25959eb, 0x8e4747c9, 0xfbf0f00b,
+    0x41adadec, 0xb3d4d467, 0x5fa2a2fd, 0x45afafea, 0x239c9cbf, 0x53a4a4f7, 0xe4727296, 0x9bc0c05b,
+    0x75b7b7c2, 0xe1fdfd1c, 0x3d9393ae, 0x4c26266a, 0x6c36365a, 0x7e3f3f41, 0xf5f7f702, 0x83cccc4f,
+    0x6834345c, 0x51a5a5f4, 0xd1e5e534, 0xf9f1f108, 0xe2717193, 0xabd8d873, 0x62313153, 0x2a15153f,
+    0x0804040c, 0x95c7c752, 0x46232365, 0x9dc3c35e, 0x30181828, 0x379696a1, 0x0a05050f, 0x2f9a9ab5,
+    0x0e070709, 0x24121236, 0x1b80809b, 0xdfe2e23d, 0xcdebeb26, 0x4e272769, 0x7fb2b2cd, 0xea75759f,
+    0x1209091b, 0x1d83839e, 0x582c2c74, 0x341a1a2e, 0x361b1b2d, 0xdc6e6eb2, 0xb45a5aee, 0x5ba0a0fb,
+    0xa45252f6, 0x763b3b4d, 0xb7d6d661, 0x7db3b3ce, 0x5229297b, 0xdde3e33e, 0x5e2f2f71, 0x13848497,
+    0xa65353f5, 0xb9d1d168, 0x00000000, 0xc1eded2c, 0x40202060, 0xe3fcfc1f, 0x79b1b1c8, 0xb65b5bed,
+    0xd46a6abe, 0x8dcbcb46, 0x67bebed9, 0x7239394b, 0x944a4ade, 0x984c4cd4, 0xb05858e8, 0x85cfcf4a,
+    0xbbd0d06b, 0xc5efef2a, 0x4faaaae5, 0xedfbfb16, 0x864343c5, 0x9a4d4dd7, 0x66333355, 0x11858594,
+    0x8a4545cf, 0xe9f9f910, 0x04020206, 0xfe7f7f81, 0xa05050f0, 0x783c3c44, 0x259f9fba, 0x4ba8a8e3,
+    0xa25151f3, 0x5da3a3fe, 0x804040c0, 0x058f8f8a, 0x3f9292ad, 0x219d9dbc, 0x70383848, 0xf1f5f504,
+    0x63bcbcdf, 0x77b6b6c1, 0xafdada75, 0x42212163, 0x20101030, 0xe5ffff1a, 0xfdf3f30e, 0xbfd2d26d,
+    0x81cdcd4c, 0x180c0c14, 0x26131335, 0xc3ecec2f, 0xbe5f5fe1, 0x359797a2, 0x884444cc, 0x2e171739,
+    0x93c4c457, 0x55a7a7f2, 0xfc7e7e82, 0x7a3d3d47, 0xc86464ac, 0xba5d5de7, 0x3219192b, 0xe6737395,
+    0xc06060a0, 0x19818198, 0x9e4f4fd1, 0xa3dcdc7f, 0x44222266, 0x542a2a7e, 0x3b9090ab, 0x0b888883,
+    0x8c4646ca, 0xc7eeee29, 0x6bb8b8d3, 0x2814143c, 0xa7dede79, 0xbc5e5ee2, 0x160b0b1d, 0xaddbdb76,
+    0xdbe0e03b, 0x64323256, 0x743a3a4e, 0x140a0a1e, 0x924949db, 0x0c06060a, 0x4824246c, 0xb85c5ce4,
+    0x9fc2c25d, 0xbdd3d36e, 0x43acacef, 0xc46262a6, 0x399191a8, 0x319595a4, 0xd3e4e437, 0xf279798b,
+    0xd5e7e732, 0x8bc8c843, 0x6e373759, 0xda6d6db7, 0x018d8d8c, 0xb1d5d564, 0x9c4e4ed2, 0x49a9a9e0,
+    0xd86c6cb4, 0xac5656fa, 0xf3f4f407, 0xcfeaea25, 0xca6565af, 0xf47a7a8e, 0x47aeaee9, 0x10080818,
+    0x6fbabad5, 0xf0787888, 0x4a25256f, 0x5c2e2e72, 0x381c1c24, 0x57a6a6f1, 0x73b4b4c7, 0x97c6c651,
+    0xcbe8e823, 0xa1dddd7c, 0xe874749c, 0x3e1f1f21, 0x964b4bdd, 0x61bdbddc, 0x0d8b8b86, 0x0f8a8a85,
+    0xe0707090, 0x7c3e3e42, 0x71b5b5c4, 0xcc6666aa, 0x904848d8, 0x06030305, 0xf7f6f601, 0x1c0e0e12,
+    0xc26161a3, 0x6a35355f, 0xae5757f9, 0x69b9b9d0, 0x17868691, 0x99c1c158, 0x3a1d1d27, 0x279e9eb9,
+    0xd9e1e138, 0xebf8f813, 0x2b9898b3, 0x22111133, 0xd26969bb, 0xa9d9d970, 0x078e8e89, 0x339494a7,
+    0x2d9b9bb6, 0x3c1e1e22, 0x15878792, 0xc9e9e920, 0x87cece49, 0xaa5555ff, 0x50282878, 0xa5dfdf7a,
+    0x038c8c8f, 0x59a1a1f8, 0x09898980, 0x1a0d0d17, 0x65bfbfda, 0xd7e6e631, 0x844242c6, 0xd06868b8,
+    0x824141c3, 0x299999b0, 0x5a2d2d77, 0x1e0f0f11, 0x7bb0b0cb, 0xa85454fc, 0x6dbbbbd6, 0x2c16163a,
+};
+
+static const uint32_t aes_td[256] = {
+    0x51f4a750, 0x7e416553, 0x1a17a4c3, 0x3a275e96, 0x3bab6bcb, 0x1f9d45f1, 0xacfa58ab, 0x4be30393,
+    0x2030fa55, 0xad766df6, 0x88cc7691, 0xf5024c25, 0x4fe5d7fc, 0xc52acbd7, 0x26354480, 0xb562a38f,
+    0xdeb15a49, 0x25ba1b67, 0x45ea0e98, 0x5dfec0e1, 0xc32f7502, 0x814cf012, 0x8d4697a3, 0x6bd3f9c6,
+    0x038f5fe7, 0x15929c95, 0xbf6d7aeb, 0x955259da, 0xd4be832d, 0x587421d3, 0x49e06929, 0x8ec9c844,
+    0x75c2896a, 0xf48e7978, 0x99583e6b, 0x27b971dd, 0xbee14fb6, 0xf088ad17, 0xc920ac66, 0x7dce3ab4,
+    0x63df4a18, 0xe51a3182, 0x97513360, 0x62537f45, 0xb16477e0, 0xbb6bae84, 0xfe81a01c, 0xf9082b94,
+    0x70486858, 0x8f45fd19, 0x94de6c87, 0x527bf8b7, 0xab73d323, 0x724b02e2, 0xe31f8f57, 0x6655ab2a,
+    0xb2eb2807, 0x2fb5c203, 0x86c57b9a, 0xd33708a5, 0x302887f2, 0x23bfa5b2, 0x02036aba, 0xed16825c,
+    0x8acf1c2b, 0xa779b492, 0xf307f2f0, 0x4e69e2a1, 0x65daf4cd, 0x0605bed5, 0xd134621f, 0xc4a6fe8a,
+    0x342e539d, 0xa2f355a0, 0x058ae132, 0xa4f6eb75, 0x0b83ec39, 0x4060efaa, 0x5e719f06, 0xbd6e1051,
+    0x3e218af9, 0x96dd063d, 0xdd3e05ae, 0x4de6bd46, 0x91548db5, 0x71c45d05, 0x0406d46f, 0x605015ff,
+    0x1998fb24, 0xd6bde997, 0x894043cc, 0x67d99e77, 0xb0e842bd, 0x07898b88, 0xe7195b38, 0x79c8eedb,
+    0xa17c0a47, 0x7c420fe9, 0xf8841ec9, 0x00000000, 0x09808683, 0x322bed48, 0x1e1170ac, 0x6c5a724e,
+    0xfd0efffb, 0x0f853856, 0x3daed51e, 0x362d3927, 0x0a0fd964, 0x685ca621, 0x9b5b54d1, 0x24362e3a,
+    0x0c0a67b1, 0x9357e70f, 0xb4ee96d2, 0x1b9b919e, 0x80c0c54f, 0x61dc20a2, 0x5a774b69, 0x1c121a16,
+    0xe293ba0a, 0xc0a02ae5, 0x3c22e043, 0x121b171d, 0x0e090d0b, 0xf28bc7ad, 0x2db6a8b9, 0x141ea9c8,
+    0x57f11985, 0xaf75074c, 0xee99ddbb, 0xa37f60fd, 0xf701269f, 0x5c72f5bc, 0x44663bc5, 0x5bfb7e34,
+    0x8b432976, 0xcb23c6dc, 0xb6edfc68, 0xb8e4f163, 0xd731dcca, 0x42638510, 0x13972240, 0x84c61120,
+    0x854a247d, 0xd2bb3df8, 0xaef93211, 0xc729a16d, 0x1d9e2f4b, 0xdcb230f3, 0x0d8652ec, 0x77c1e3d0,
+    0x2bb3166c, 0xa970b999, 0x119448fa, 0x47e96422, 0xa8fc8cc4, 0xa0f03f1a, 0x567d2cd8, 0x223390ef,
+    0x87494ec7, 0xd938d1c1, 0x8ccaa2fe, 0x98d40b36, 0xa6f581cf, 0xa57ade28, 0xdab78e26, 0x3fadbfa4,
+    0x2c3a9de4, 0x5078920d, 0x6a5fcc9b, 0x547e4662, 0xf68d13c2, 0x90d8b8e8, 0x2e39f75e, 0x82c3aff5,
+    0x9f5d80be, 0x69d0937c, 0x6fd52da9, 0xcf2512b3, 0xc8ac993b, 0x10187da7, 0xe89c636e, 0xdb3bbb7b,
+    0xcd267809, 0x6e5918f4, 0xec9ab701, 0x834f9aa8, 0xe6956e65, 0xaaffe67e, 0x21bccf08, 0xef15e8e6,
+    0xbae79bd9, 0x4a6f36ce, 0xea9f09d4, 0x29b07cd6, 0x31a4b2af, 0x2a3f2331, 0xc6a59430, 0x35a266c0,
+    0x744ebc37, 0xfc82caa6, 0xe090d0b0, 0x33a7d815, 0xf104984a, 0x41ecdaf7, 0x7fcd500e, 0x1791f62f,
+    0x764dd68d, 0x43efb04d, 0xccaa4d54, 0xe49604df, 0x9ed1b5e3, 0x4c6a881b, 0xc12c1fb8, 0x4665517f,
+    0x9d5eea04, 0x018c355d, 0xfa877473, 0xfb0b412e, 0xb3671d5a, 0x92dbd252, 0xe9105633, 0x6dd64713,
+    0x9ad7618c, 0x37a10c7a, 0x59f8148e, 0xeb133c89, 0xcea927ee, 0xb761c935, 0xe11ce5ed, 0x7a47b13c,
+    0x9cd2df59, 0x55f2733f, 0x1814ce79, 0x73c737bf, 0x53f7cdea, 0x5ffdaa5b, 0xdf3d6f14, 0x7844db86,
+    0xcaaff381, 0xb968c43e, 0x3824342c, 0xc2a3405f, 0x161dc372, 0xbce2250c, 0x283c498b, 0xff0d9541,
+    0x39a80171, 0x080cb3de, 0xd8b4e49c, 0x6456c190, 0x7bcb8461, 0xd532b670, 0x486c5c74, 0xd0b85742,
+};
+
+#define TE(a, b, c, d) \
+    (aes_te[(a) >> 24] ^ ROR(aes_te[((b) >> 16) & 0xff], 8) ^ ROR(aes_te[((c) >> 8) & 0xff], 16) ^ ROR(aes_te[(d) & 0xff], 24))
+#define TD(a, b, c, d) \
+    (aes_td[(a) >> 24] ^ ROR(aes_td[((b) >> 16) & 0xff], 8) ^ ROR(aes_td[((c) >> 8) & 0xff], 16) ^ ROR(aes_td[(d) & 0xff], 24))
+#define SUB(tbl, a, b, c, d) \
+    ((uint32_t)tbl[(a) >> 24] << 24 | (uint32_t)tbl[((b) >> 16) & 0xff] << 16 | (uint32_t)tbl[((c) >> 8) & 0xff] << 8 | tbl[(d) & 0xff])
+
+static void aes_encrypt_block_sw(const cryptolib_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out) {
+    uint32_t s0 = GET32(in) ^ GET32(ctx->rk[0]);
+    uint32_t s1 = GET32(in + 4) ^ GET32(ctx->rk[0] + 4);
+    uint32_t s2 = GET32(in + 8) ^ GET32(ctx->rk[0] + 8);
+    uint32_t s3 = GET32(in + 12) ^ GET32(ctx->rk[0] + 12);
+    for (int r = 1; r < ctx->nr; ++r) {
+        const uint8_t *rk = ctx->rk[r];
+        uint32_t t0 = TE(s0, s1, s2, s3) ^ GET32(rk);
+        uint32_t t1 = TE(s1, s2, s3, s0) ^ GET32(rk + 4);
+        uint32_t t2 = TE(s2, s3, s0, s1) ^ GET32(rk + 8);
+        uint32_t t3 = TE(s3, s0, s1, s2) ^ GET32(rk + 12);
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+    }
+    const uint8_t *rk = ctx->rk[ctx->nr];
+    uint32_t t0 = SUB(aes_sbox, s0, s1, s2, s3) ^ GET32(rk);
+    uint32_t t1 = SUB(aes_sbox, s1, s2, s3, s0) ^ GET32(rk + 4);
+    uint32_t t2 = SUB(aes_sbox, s2, s3, s0, s1) ^ GET32(rk + 8);
+    uint32_t t3 = SUB(aes_sbox, s3, s0, s1, s2) ^ GET32(rk + 12);
+    PUT32(out, t0);
+    PUT32(out + 4, t1);
+    PUT32(out + 8, t2);
+    PUT32(out + 12, t3);
+}
+
+static void aes_decrypt_block_sw(const cryptolib_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out) {
+    uint32_t s0 = GET32(in) ^ GET32(ctx->rk[0]);
+    uint32_t s1 = GET32(in + 4) ^ GET32(ctx->rk[0] + 4);
+    uint32_t s2 = GET32(in + 8) ^ GET32(ctx->rk[0] + 8);
+    uint32_t s3 = GET32(in + 12) ^ GET32(ctx->rk[0] + 12);
+    for (int r = 1; r < ctx->nr; ++r) {
+        const uint8_t *rk = ctx->rk[r];
+        uint32_t t0 = TD(s0, s3, s2, s1) ^ GET32(rk);
+        uint32_t t1 = TD(s1, s0, s3, s2) ^ GET32(rk + 4);
+        uint32_t t2 = TD(s2, s1, s0, s3) ^ GET32(rk + 8);
+        uint32_t t3 = TD(s3, s2, s1, s0) ^ GET32(rk + 12);
+        s0 = t0;
+        s1 = t1;
+        s2 = t2;
+        s3 = t3;
+    }
+    const uint8_t *rk = ctx->rk[ctx->nr];
+    uint32_t t0 = SUB(aes_inv_sbox, s0, s3, s2, s1) ^ GET32(rk);
+    uint32_t t1 = SUB(aes_inv_sbox, s1, s0, s3, s2) ^ GET32(rk + 4);
+    uint32_t t2 = SUB(aes_inv_sbox, s2, s1, s0, s3) ^ GET32(rk + 8);
+    uint32_t t3 = SUB(aes_inv_sbox, s3, s2, s1, s0) ^ GET32(rk + 12);
+    PUT32(out, t0);
+    PUT32(out + 4, t1);
+    PUT32(out + 8, t2);
+    PUT32(out + 12, t3);
+}
+
+static uint32_t aes_sub_word(uint32_t w) {
+    return SUB(aes_sbox, w, w, w, w);
+}
+
+#endif
+
+#if CRYPTOLIB_AES_USE_AESNI
+
+static bool aes_have_aesni(void) {
+    static int8_t have = -1;
+    if (have < 0) {
+        unsigned int eax, ebx, ecx, edx;
+        have = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_AES) && (ecx & bit_PCLMUL);
+    }
+    return have;
+}
+
+// The round keys are already in the form that the AES-NI instructions use,
+// including the decryption keys for the equivalent inverse cipher.
+__attribute__((target("aes,sse2")))
+static void aes_blocks_aesni(const cryptolib_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t nblocks, bool encrypt) {
+    __m128i rk[15];
+    int nr = ctx->nr;
+    for (int r = 0; r <= nr; ++r) {
+        rk[r] = _mm_loadu_si128((const __m128i *)ctx->rk[r]);
+    }
+    for (; nblocks >= 4; nblocks -= 4, in += 64, out += 64) {
+        __m128i b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), rk[0]);
+        __m128i b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 16)), rk[0]);
+        __m128i b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 32)), rk[0]);
+        __m128i b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 48)), rk[0]);
+        if (encrypt) {
+            for (int r = 1; r < nr; ++r) {
+                b0 = _mm_aesenc_si128(b0, rk[r]);
+                b1 = _mm_aesenc_si128(b1, rk[r]);
+                b2 = _mm_aesenc_si128(b2, rk[r]);
+                b3 = _mm_aesenc_si128(b3, rk[r]);
+            }
+            b0 = _mm_aesenclast_si128(b0, rk[nr]);
+            b1 = _mm_aesenclast_si128(b1, rk[nr]);
+            b2 = _mm_aesenclast_si128(b2, rk[nr]);
+            b3 = _mm_aesenclast_si128(b3, rk[nr]);
+        } else {
+            for (int r = 1; r < nr; ++r) {
+                b0 = _mm_aesdec_si128(b0, rk[r]);
+                b1 = _mm_aesdec_si128(b1, rk[r]);
+                b2 = _mm_aesdec_si128(b2, rk[r]);
+                b3 = _mm_aesdec_si128(b3, rk[r]);
+            }
+            b0 = _mm_aesdeclast_si128(b0, rk[nr]);
+            b1 = _mm_aesdeclast_si128(b1, rk[nr]);
+            b2 = _mm_aesdeclast_si128(b2, rk[nr]);
+            b3 = _mm_aesdeclast_si128(b3, rk[nr]);
+        }
+        _mm_storeu_si128((__m128i *)out, b0);
+        _mm_storeu_si128((__m128i *)(out + 16), b1);
+        _mm_storeu_si128((__m128i *)(out + 32), b2);
+        _mm_storeu_si128((__m128i *)(out + 48), b3);
+    }
+    for (; nblocks; --nblocks, in += 16, out += 16) {
+        __m128i b = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), rk[0]);
+        if (encrypt) {
+            for (int r = 1; r < nr; ++r) {
+                b = _mm_aesenc_si128(b, rk[r]);
+            }
+            b = _mm_aesenclast_si128(b, rk[nr]);
+        } else {
+            for (int r = 1; r < nr; ++r) {
+                b = _mm_aesdec_si128(b, rk[r]);
+            }
+            b = _mm_aesdeclast_si128(b, rk[nr]);
+        }
+        _mm_storeu_si128((__m128i *)out, b);
+    }
+}
+
+#endif
+
+static void aes_blocks(const cryptolib_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t nblocks, bool encrypt) {
+    #if CRYPTOLIB_AES_USE_AESNI
+    if (aes_have_aesni()) {
+        aes_blocks_aesni(ctx, in, out, nblocks, encrypt);
+        return;
+    }
+    #endif
+    #if MICROPY_PY_CRYPTOLIB_AES_CONST_TIME
+    uint8_t s[32];
+    while (nblocks) {
+        size_t n = MIN(nblocks, 2);
+        memcpy(s, in, 16 * n);
+        if (n == 1) {
+            memset(s + 16, 0, 16);
+        }
+        aes_crypt_2blocks_ct(ctx, s, encrypt);
+        memcpy(out, s, 16 * n);
+        in += 16 * n;
+        out += 16 * n;
+        nblocks -= n;
+    }
+    #else
+    for (; nblocks; --nblocks, in += 16, out += 16) {
+        if (encrypt) {
+            aes_encrypt_block_sw(ctx, in, out);
+        } else {
+            aes_decrypt_block_sw(ctx, in, out);
+        }
+    }
+    #endif
+}
+
+// Adds one to the last len bytes of the block, as a big-endian number.
+static void aes_inc_counter(uint8_t counter[16], int len) {
+    for (int i = 15; i >= 16 - len; --i) {
+        if (++counter[i] != 0) {
+            break;
+        }
+    }
+}
+
+void cryptolib_aes_set_key(cryptolib_aes_ctx_t *ctx, const uint8_t *key, size_t keysize, bool encrypt) {
+    uint32_t w[60];
+    size_t nk = keysize / 4;
+    size_t nw = 4 * (nk + 7);
+    uint8_t rcon = 1;
+    for (size_t i = 0; i < nk; ++i) {
+        w[i] = GET32(key + 4 * i);
+    }
+    for (size_t i = nk; i < nw; ++i) {
+        uint32_t t = w[i - 1];
+        if (i % nk == 0) {
+            t = aes_sub_word(ROR(t, 24)) ^ (uint32_t)rcon << 24;
+            rcon = rcon << 1 ^ (rcon & 0x80 ? 0x1b : 0);
+        } else if (nk > 6 && i % nk == 4) {
+            t = aes_sub_word(t);
+        }
+        w[i] = w[i - nk] ^ t;
+    }
+
+    ctx->nr = nk + 6;
+    for (size_t r = 0; r <= ctx->nr; ++r) {
+        // Decryption applies the round keys in reverse, and uses the
+        // equivalent inverse cipher, so the inner ones need InvMixColumns.
+        size_t src = encrypt ? r : ctx->nr - r;
+        for (size_t i = 0; i < 4; ++i) {
+            PUT32(ctx->rk[r] + 4 * i, w[4 * src + i]);
+        }
+        if (!encrypt && r > 0 && r < ctx->nr) {
+            aes_mix_columns(ctx->rk[r], 16, true);
+        }
+    }
+}
+
+void cryptolib_aes_ecb(const cryptolib_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t nblocks, bool encrypt) {
+    aes_blocks(ctx, in, out, nblocks, encrypt);
+}
+
+void cryptolib_aes_cbc(const cryptolib_aes_ctx_t *ctx, uint8_t iv[16], const uint8_t *in, uint8_t *out, size_t nblocks, bool encrypt) {
+    if (encrypt) {
+        for (; nblocks; --nblocks, in += 16, out += 16) {
+            aes_xor(iv, iv, in, 16);
+            aes_blocks(ctx, iv, iv, 1, true);
+            memcpy(out, iv, 16);
+        }
+        return;
+    }
+
+    // Decryption doesn't chain, so decrypt a batch of blocks at once.  The
+    // input may be the output buffer, so each ciphertext block is kept in iv
+    // until it has been used.
+    uint8_t buf[AES_BATCH * 16];
+    while (nblocks) {
+        size_t n = MIN(nblocks, AES_BATCH);
+        aes_blocks(ctx, in, buf, n, false);
+        for (size_t i = 0; i < n; ++i, in += 16, out += 16) {
+            uint8_t next_iv[16];
+            memcpy(next_iv, in, 16);
+            aes_xor(out, buf + 16 * i, iv, 16);
+            memcpy(iv, next_iv, 16);
+        }
+        nblocks -= n;
+    }
+}
+
+// CTR mode on a stream of bytes: the counter is incremented over its last
+// inc_len bytes and *offset is the number of bytes of keystream used.
+static void aes_ctr(const cryptolib_aes_ctx_t *ctx, uint8_t counter[16], int inc_len,
+    uint8_t keystream[16], size_t *offset, const uint8_t *in, uint8_t *out, size_t len) {
+    size_t n = *offset;
+    for (; n != 0 && len != 0; --len) {
+        *out++ = *in++ ^ keystream[n];
+        n = (n + 1) & 15;
+    }
+
+    uint8_t buf[AES_BATCH * 16];
+    while (len >= 16) {
+        size_t nblocks = MIN(len / 16, AES_BATCH);
+        for (size_t i = 0; i < nblocks; ++i) {
+            memcpy(buf + 16 * i, counter, 16);
+            aes_inc_counter(counter, inc_len);
+        }
+        aes_blocks(ctx, buf, buf, nblocks, true);
+        aes_xor(out, in, buf, nblocks * 16);
+        in += nblocks * 16;
+        out += nblocks * 16;
+        len -= nblocks * 16;
+    }
+
+    if (len != 0) {
+        aes_blocks(ctx, counter, keystream, 1, true);
+        aes_inc_counter(counter, inc_len);
+        aes_xor(out, in, keystream, len);
+        n = len;
+    }
+    *offset = n;
+}
+
+void cryptolib_aes_ctr(const cryptolib_aes_ctx_t *ctx, uint8_t counter[16], uint8_t keystream[16], size_t *offset, const uint8_t *in, uint8_t *out, size_t len) {
+    aes_ctr(ctx, counter, 16, keystream, offset, in, out, len);
+}
+
+#if MICROPY_PY_CRYPTOLIB_GCM
+
+#define GET64(p) ((uint64_t)GET32(p) << 32 | GET32((p) + 4))
+
+#if CRYPTOLIB_AES_USE_AESNI
+
+// Multiplies in GF(2^128) with bit-reflected operands, as in Intel's
+// "Carry-Less Multiplication and Its Usage for Computing the GCM Mode".
+__attribute__((target("pclmul,ssse3")))
+static inline __m128i gcm_mult_clmul(__m128i a, __m128i b) {
+    __m128i lo = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    __m128i hi = _mm_clmulepi64_si128(a, b, 0x11);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    // Shift the 256-bit product left by one bit.
+    __m128i lo_carry = _mm_srli_epi32(lo, 31);
+    __m128i hi_carry = _mm_srli_epi32(hi, 31);
+    lo = _mm_or_si128(_mm_slli_epi32(lo, 1), _mm_slli_si128(lo_carry, 4));
+    hi = _mm_or_si128(_mm_slli_epi32(hi, 1), _mm_slli_si128(hi_carry, 4));
+    hi = _mm_or_si128(hi, _mm_srli_si128(lo_carry, 12));
+
+    // Reduce modulo x^128 + x^7 + x^2 + x + 1.
+    __m128i t = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+    __m128i t_hi = _mm_srli_si128(t, 4);
+    lo = _mm_xor_si128(lo, _mm_slli_si128(t, 12));
+    t = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+    t = _mm_xor_si128(_mm_xor_si128(t, t_hi), lo);
+    return _mm_xor_si128(hi, t);
+}
+
+__attribute__((target("pclmul,ssse3")))
+static void gcm_hash_blocks_clmul(cryptolib_aes_gcm_t *gcm, const uint8_t *data, size_t nblocks) {
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i y = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)gcm->y), bswap);
+    __m128i h = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)gcm->h), bswap);
+    for (; nblocks; --nblocks, data += 16) {
+        y = _mm_xor_si128(y, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap));
+        y = gcm_mult_clmul(y, h);
+    }
+    _mm_storeu_si128((__m128i *)gcm->y, _mm_shuffle_epi8(y, bswap));
+}
+
+#endif
+
+#if MICROPY_PY_CRYPTOLIB_AES_CONST_TIME
+
+// Multiplies y by h a bit at a time, using masks instead of branches.
+static void gcm_mult(cryptolib_aes_gcm_t *gcm) {
+    uint64_t vh = GET64(gcm->h);
+    uint64_t vl = GET64(gcm->h + 8);
+    uint64_t zh = 0;
+    uint64_t zl = 0;
+    for (int i = 0; i < 128; ++i) {
+        uint64_t mask = -(uint64_t)(gcm->y[i >> 3] >> (7 - (i & 7)) & 1);
+        zh ^= vh & mask;
+        zl ^= vl & mask;
+        uint64_t t = -(vl & 1) & 0xe100000000000000;
+        vl = vh << 63 | vl >> 1;
+        vh = vh >> 1 ^ t;
+    }
+    PUT32(gcm->y, zh >> 32);
+    PUT32(gcm->y + 4, zh);
+    PUT32(gcm->y + 8, zl >> 32);
+    PUT32(gcm->y + 12, zl);
+}
+
+#else
+
+// Reductions of the four bits shifted out by gcm_mult.
+static const uint16_t gcm_last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0,
+};
+
+// Precomputes the products of H with each 4-bit value.
+static void gcm_gen_table(cryptolib_aes_gcm_t *gcm) {
+    uint64_t vh = GET64(gcm->h);
+    uint64_t vl = GET64(gcm->h + 8);
+    gcm->hh[0] = 0;
+    gcm->hl[0] = 0;
+    gcm->hh[8] = vh;
+    gcm->hl[8] = vl;
+    for (int i = 4; i > 0; i >>= 1) {
+        uint64_t t = (vl & 1) * 0xe1000000;
+        vl = vh << 63 | vl >> 1;
+        vh = vh >> 1 ^ t << 32;
+        gcm->hh[i] = vh;
+        gcm->hl[i] = vl;
+    }
+    for (int i = 2; i <= 8; i *= 2) {
+        for (int j = 1; j < i; ++j) {
+            gcm->hh[i + j] = gcm->hh[i] ^ gcm->hh[j];
+            gcm->hl[i + j] = gcm->hl[i] ^ gcm->hl[j];
+        }
+    }
+}
+
+static void gcm_mult(cryptolib_aes_gcm_t *gcm) {
+    const uint8_t *x = gcm->y;
+    uint8_t lo = x[15] & 0xf;
+    uint64_t zh = gcm->hh[lo];
+    uint64_t zl = gcm->hl[lo];
+    for (int i = 15; i >= 0; --i) {
+        lo = x[i] & 0xf;
+        uint8_t hi = x[i] >> 4;
+        if (i != 15) {
+            uint8_t rem = zl & 0xf;
+            zl = zh << 60 | zl >> 4;
+            zh = zh >> 4 ^ (uint64_t)gcm_last4[rem] << 48;
+            zh ^= gcm->hh[lo];
+            zl ^= gcm->hl[lo];
+        }
+        uint8_t rem = zl & 0xf;
+        zl = zh << 60 | zl >> 4;
+        zh = zh >> 4 ^ (uint64_t)gcm_last4[rem] << 48;
+        zh ^= gcm->hh[hi];
+        zl ^= gcm->hl[hi];
+    }
+    PUT32(gcm->y, zh >> 32);
+    PUT32(gcm->y + 4, zh);
+    PUT32(gcm->y + 8, zl >> 32);
+    PUT32(gcm->y + 12, zl);
+}
+
+#endif
+
+static void gcm_hash_blocks(cryptolib_aes_gcm_t *gcm, const uint8_t *data, size_t nblocks) {
+    #if CRYPTOLIB_AES_USE_AESNI
+    if (aes_have_aesni()) {
+        gcm_hash_blocks_clmul(gcm, data, nblocks);
+        return;
+    }
+    #endif
+    for (; nblocks; --nblocks, data += 16) {
+        aes_xor(gcm->y, gcm->y, data, 16);
+        gcm_mult(gcm);
+    }
+}
+
+// Feeds data into GHASH, keeping any partial block until more data arrives.
+static void gcm_hash(cryptolib_aes_gcm_t *gcm, const uint8_t *data, size_t len) {
+    if (gcm->partial_len != 0) {
+        size_t n = MIN(len, 16u - gcm->partial_len);
+        memcpy(gcm->partial + gcm->partial_len, data, n);
+        gcm->partial_len += n;
+        data += n;
+        len -= n;
+        if (gcm->partial_len < 16) {
+            return;
+        }
+        gcm_hash_blocks(gcm, gcm->partial, 1);
+        gcm->partial_len = 0;
+    }
+    gcm_hash_blocks(gcm, data, len / 16);
+    data += len & ~15;
+    len &= 15;
+    memcpy(gcm->partial, data, len);
+    gcm->partial_len = len;
+}
+
+// Pads the data hashed so far to a whole block.
+static void gcm_hash_flush(cryptolib_aes_gcm_t *gcm) {
+    if (gcm->partial_len != 0) {
+        memset(gcm->partial + gcm->partial_len, 0, 16 - gcm->partial_len);
+        gcm_hash_blocks(gcm, gcm->partial, 1);
+        gcm->partial_len = 0;
+    }
+}
+
+void cryptolib_aes_gcm_init(cryptolib_aes_gcm_t *gcm, const cryptolib_aes_ctx_t *ctx, const uint8_t iv[12]) {
+    memset(gcm, 0, sizeof(*gcm));
+    aes_blocks(ctx, gcm->h, gcm->h, 1, true);
+    #if !MICROPY_PY_CRYPTOLIB_AES_CONST_TIME
+    gcm_gen_table(gcm);
+    #endif
+    memcpy(gcm->counter, iv, 12);
+    gcm->counter[15] = 1;
+    aes_blocks(ctx, gcm->counter, gcm->tag_mask, 1, true);
+    aes_inc_counter(gcm->counter, 4);
+}
+
+void cryptolib_aes_gcm_update_aad(cryptolib_aes_gcm_t *gcm, const uint8_t *aad, size_t len) {
+    gcm->aad_len += len;
+    gcm_hash(gcm, aad, len);
+}
+
+void cryptolib_aes_gcm_crypt(cryptolib_aes_gcm_t *gcm, const cryptolib_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len, bool encrypt) {
+    if (!gcm->in_data) {
+        gcm_hash_flush(gcm);
+        gcm->in_data = true;
+    }
+    gcm->data_len += len;
+    // GHASH is over the ciphertext; hash it in chunks while it's still in the
+    // cache, and before it's overwritten when decrypting in place.
+    while (len != 0) {
+        size_t n = MIN(len, AES_BATCH * 16);
+        size_t offset = gcm->keystream_offset;
+        if (!encrypt) {
+            gcm_hash(gcm, in, n);
+        }
+        aes_ctr(ctx, gcm->counter, 4, gcm->keystream, &offset, in, out, n);
+        if (encrypt) {
+            gcm_hash(gcm, out, n);
+        }
+        gcm->keystream_offset = offset;
+        in += n;
+        out += n;
+        len -= n;
+    }
+}
+
+void cryptolib_aes_gcm_tag(const cryptolib_aes_gcm_t *gcm_in, uint8_t tag[16]) {
+    // Finish a copy of the hash, so that more data can still be added.
+    cryptolib_aes_gcm_t gcm = *gcm_in;
+    uint8_t lengths[16];
+    gcm_hash_flush(&gcm);
+    PUT32(lengths, gcm.aad_len >> 29);
+    PUT32(lengths + 4, gcm.aad_len << 3);
+    PUT32(lengths + 8, gcm.data_len >> 29);
+    PUT32(lengths + 12, gcm.data_len << 3);
+    gcm_hash_blocks(&gcm, lengths, 1);
+    aes_xor(tag, gcm.y, gcm.tag_mask, 16);
+}
+
+#endif // MICROPY_PY_CRYPTOLIB_GCM
+
+#endif // MICROPY_PY_CRYPTOLIB && MICROPY_PY_CRYPTOLIB_AES_BUILTIN
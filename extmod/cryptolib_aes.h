@@ -0,0 +1,74 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Damien P. George
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_EXTMOD_CRYPTOLIB_AES_H
+#define MICROPY_INCLUDED_EXTMOD_CRYPTOLIB_AES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "py/mpconfig.h"
+
+// Built-in AES for the cryptolib module.  On x86 hosts built with gcc or
+// clang it uses the AES-NI and PCLMULQDQ instructions when the CPU has them.
+// Otherwise it uses a constant-time implementation, or lookup tables if
+// MICROPY_PY_CRYPTOLIB_AES_CONST_TIME is disabled.
+
+// An expanded key, for either encryption or decryption.
+typedef struct _cryptolib_aes_ctx_t {
+    uint8_t rk[15][16]; // round keys, in the order they are applied
+    uint8_t nr; // number of rounds
+} cryptolib_aes_ctx_t;
+
+// State of a GCM encryption or decryption, with a 12-byte IV.
+typedef struct _cryptolib_aes_gcm_t {
+    #if !MICROPY_PY_CRYPTOLIB_AES_CONST_TIME
+    uint64_t hl[16], hh[16]; // multiples of the hash key, for the table method
+    #endif
+    uint8_t h[16]; // hash key
+    uint8_t y[16]; // GHASH accumulator
+    uint8_t tag_mask[16]; // encrypted initial counter block
+    uint8_t counter[16];
+    uint8_t keystream[16];
+    uint8_t partial[16]; // data not yet hashed
+    uint8_t partial_len;
+    uint8_t keystream_offset;
+    bool in_data; // set once encryption or decryption has started
+    uint64_t aad_len;
+    uint64_t data_len;
+} cryptolib_aes_gcm_t;
+
+void cryptolib_aes_set_key(cryptolib_aes_ctx_t *ctx, const uint8_t *key, size_t keysize, bool encrypt);
+void cryptolib_aes_ecb(const cryptolib_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t nblocks, bool encrypt);
+void cryptolib_aes_cbc(const cryptolib_aes_ctx_t *ctx, uint8_t iv[16], const uint8_t *in, uint8_t *out, size_t nblocks, bool encrypt);
+void cryptolib_aes_ctr(const cryptolib_aes_ctx_t *ctx, uint8_t counter[16], uint8_t keystream[16], size_t *offset, const uint8_t *in, uint8_t *out, size_t len);
+
+void cryptolib_aes_gcm_init(cryptolib_aes_gcm_t *gcm, const cryptolib_aes_ctx_t *ctx, const uint8_t iv[12]);
+void cryptolib_aes_gcm_update_aad(cryptolib_aes_gcm_t *gcm, const uint8_t *aad, size_t len);
+void cryptolib_aes_gcm_crypt(cryptolib_aes_gcm_t *gcm, const cryptolib_aes_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len, bool encrypt);
+void cryptolib_aes_gcm_tag(const cryptolib_aes_gcm_t *gcm, uint8_t tag[16]);
+
+#endif // MICROPY_INCLUDED_EXTMOD_CRYPTOLIB_AES_H
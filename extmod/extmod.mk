@@ -2,6 +2,7 @@
 # and provides rules to build 3rd-party components for extmod modules.
 
 SRC_EXTMOD_C += \
+	extmod/cryptolib_aes.c \
 	extmod/machine_adc.c \
 	extmod/machine_adc_block.c \
 	extmod/machine_bitstream.c \
@@ -59,6 +60,7 @@ SRC_EXTMOD_C += \
 	extmod/vfs_fat_diskio.c \
 	extmod/vfs_fat_file.c \
 	extmod/vfs_lfs.c \
+	extmod/vfs_mpycache.c \
 	extmod/vfs_posix.c \
 	extmod/vfs_posix_file.c \
 	extmod/vfs_reader.c \
@@ -25,6 +25,7 @@
  */
 
 #include "py/runtime.h"
+#include "py/objlist.h"
 #include "py/stream.h"
 
 #if MICROPY_PY_BTREE
@@ -32,6 +33,10 @@
 #include <stdio.h>
 #include <errno.h> // for declaration of global errno variable
 #include <fcntl.h>
+#if MICROPY_PY_BTREE_FD
+#include <unistd.h>
+#include "extmod/vfs_posix.h"
+#endif
 
 // Undefine queue macros that will be defined in berkeley-db-1.xx headers
 // below, in case they clash with system ones defined in headers above.
@@ -60,10 +65,22 @@
 #include "berkeley-db/db.h"
 #include "berkeley-db/btree.h"
 
+#if MICROPY_PY_BTREE_FD
+// A POSIX VFS file, along with the file position that berkeley-db last
+// seeked to.
+typedef struct _btree_fd_t {
+    mp_obj_t stream;
+    off_t pos;
+} btree_fd_t;
+#endif
+
 typedef struct _mp_obj_btree_t {
     mp_obj_base_t base;
     mp_obj_t stream; // retain a reference to prevent GC from reclaiming it
     DB *db;
+    #if MICROPY_PY_BTREE_FD
+    btree_fd_t fd;
+    #endif
     mp_obj_t start_key;
     mp_obj_t end_key;
     #define FLAG_END_KEY_INCL 1
@@ -95,6 +112,7 @@ static mp_obj_btree_t *btree_new(DB *db, mp_obj_t stream) {
     o->db = db;
     o->start_key = mp_const_none;
     o->end_key = mp_const_none;
+    o->flags = FLAG_ITER_KEYS;
     o->next_flags = 0;
     return o;
 }
@@ -134,6 +152,43 @@ static mp_obj_t btree_put(size_t n_args, const mp_obj_t *args) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(btree_put_obj, 3, 4, btree_put);
 
+#if !MICROPY_ENABLE_DYNRUNTIME
+// Insert (key, value) pairs that come in strictly ascending key order.  This
+// is a convenience wrapper around __bt_put that checks the order, not a
+// bottom-up build of the tree: each pair is still inserted on its own.  Any
+// speed-up comes from berkeley-db's handling of sorted inserts, which looks
+// at the last leaf page before searching and splits it unevenly.
+static mp_obj_t btree_load(mp_obj_t self_in, mp_obj_t iterable) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    BTREE *t = self->db->internal;
+    mp_obj_iter_buf_t iter_buf;
+    mp_obj_t iter = mp_getiter(iterable, &iter_buf);
+    mp_obj_t item;
+    mp_obj_t prev_key = MP_OBJ_NULL;
+    mp_int_t n = 0;
+    while ((item = mp_iternext(iter)) != MP_OBJ_STOP_ITERATION) {
+        mp_obj_t *pair;
+        mp_obj_get_array_fixed_n(item, 2, &pair);
+        DBT key, val;
+        buf_to_dbt(pair[0], &key);
+        buf_to_dbt(pair[1], &val);
+        if (prev_key != MP_OBJ_NULL) {
+            DBT prev;
+            buf_to_dbt(prev_key, &prev);
+            if (t->bt_cmp(&prev, &key) >= 0) {
+                mp_raise_ValueError(MP_ERROR_TEXT("keys not sorted"));
+            }
+        }
+        int res = __bt_put(self->db, &key, &val, 0);
+        CHECK_ERROR(res);
+        prev_key = pair[0];
+        ++n;
+    }
+    return MP_OBJ_NEW_SMALL_INT(n);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(btree_load_obj, btree_load);
+#endif
+
 static mp_obj_t btree_get(size_t n_args, const mp_obj_t *args) {
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(args[0]);
     DBT key, val;
@@ -223,35 +278,33 @@ static mp_obj_t btree_getiter(mp_obj_t self_in, mp_obj_iter_buf_t *iter_buf) {
     return self_in;
 }
 
-static mp_obj_t btree_iternext(mp_obj_t self_in) {
-    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
-    DBT key, val;
+// Move to the next entry of the iteration, checking it against end_key (which
+// is NULL if the iteration has no end key).  Returns false at the end.
+static bool btree_iter_step(mp_obj_btree_t *self, DBT *key, DBT *val, const DBT *end_key) {
     int res;
     bool desc = self->flags & FLAG_DESC;
     if (self->start_key != MP_OBJ_NULL) {
         int flags = R_FIRST;
         if (self->start_key != mp_const_none) {
-            buf_to_dbt(self->start_key, &key);
+            buf_to_dbt(self->start_key, key);
             flags = R_CURSOR;
         } else if (desc) {
             flags = R_LAST;
         }
-        res = __bt_seq(self->db, &key, &val, flags);
+        res = __bt_seq(self->db, key, val, flags);
         self->start_key = MP_OBJ_NULL;
     } else {
-        res = __bt_seq(self->db, &key, &val, desc ? R_PREV : R_NEXT);
+        res = __bt_seq(self->db, key, val, desc ? R_PREV : R_NEXT);
     }
 
     if (res == RET_SPECIAL) {
-        return MP_OBJ_STOP_ITERATION;
+        return false;
     }
     CHECK_ERROR(res);
 
-    if (self->end_key != mp_const_none) {
-        DBT end_key;
-        buf_to_dbt(self->end_key, &end_key);
+    if (end_key != NULL) {
         BTREE *t = self->db->internal;
-        int cmp = t->bt_cmp(&key, &end_key);
+        int cmp = t->bt_cmp(key, end_key);
         if (desc) {
             cmp = -cmp;
         }
@@ -260,25 +313,82 @@ static mp_obj_t btree_iternext(mp_obj_t self_in) {
         }
         if (cmp >= 0) {
             self->end_key = MP_OBJ_NULL;
-            return MP_OBJ_STOP_ITERATION;
+            return false;
         }
     }
+    return true;
+}
 
+static mp_obj_t btree_iter_entry(mp_obj_btree_t *self, const DBT *key, const DBT *val) {
     switch (self->flags & FLAG_ITER_TYPE_MASK) {
         case FLAG_ITER_KEYS:
-            return mp_obj_new_bytes(key.data, key.size);
+            return mp_obj_new_bytes(key->data, key->size);
         case FLAG_ITER_VALUES:
-            return mp_obj_new_bytes(val.data, val.size);
+            return mp_obj_new_bytes(val->data, val->size);
         default: {
             mp_obj_t pair_o = mp_obj_new_tuple(2, NULL);
             mp_obj_tuple_t *pair = MP_OBJ_TO_PTR(pair_o);
-            pair->items[0] = mp_obj_new_bytes(key.data, key.size);
-            pair->items[1] = mp_obj_new_bytes(val.data, val.size);
+            pair->items[0] = mp_obj_new_bytes(key->data, key->size);
+            pair->items[1] = mp_obj_new_bytes(val->data, val->size);
             return pair_o;
         }
     }
 }
 
+static mp_obj_t btree_iternext(mp_obj_t self_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->end_key == MP_OBJ_NULL) {
+        // The end key was already reached.
+        return MP_OBJ_STOP_ITERATION;
+    }
+    DBT end_key, *end = NULL;
+    if (self->end_key != mp_const_none) {
+        buf_to_dbt(self->end_key, &end_key);
+        end = &end_key;
+    }
+    DBT key, val;
+    if (!btree_iter_step(self, &key, &val, end)) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    return btree_iter_entry(self, &key, &val);
+}
+
+#if !MICROPY_ENABLE_DYNRUNTIME
+// Return a list of up to n entries of the iteration, the same ones that
+// iterating would give next.  The end key is resolved once per batch.  The
+// list starts with room for at most BTREE_FETCH_PREALLOC entries and grows as
+// needed, so a large n doesn't allocate more than the range actually has.
+#define BTREE_FETCH_PREALLOC (64)
+static mp_obj_t btree_fetch(mp_obj_t self_in, mp_obj_t n_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t n = mp_obj_get_int(n_in);
+    if (n < 0) {
+        mp_raise_ValueError(NULL);
+    }
+    if (self->next_flags != 0) {
+        // Start the iteration set up by keys(), values() or items().
+        btree_getiter(self_in, NULL);
+    }
+    mp_obj_t list = mp_obj_new_list(MIN((size_t)n, BTREE_FETCH_PREALLOC), NULL);
+    mp_obj_list_set_len(list, 0);
+    size_t len = 0;
+    if (self->end_key != MP_OBJ_NULL) {
+        DBT end_key, *end = NULL;
+        if (self->end_key != mp_const_none) {
+            buf_to_dbt(self->end_key, &end_key);
+            end = &end_key;
+        }
+        DBT key, val;
+        while (len < (size_t)n && btree_iter_step(self, &key, &val, end)) {
+            mp_obj_list_append(list, btree_iter_entry(self, &key, &val));
+            ++len;
+        }
+    }
+    return list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(btree_fetch_obj, btree_fetch);
+#endif
+
 static mp_obj_t btree_subscr(mp_obj_t self_in, mp_obj_t index, mp_obj_t value) {
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
     if (value == MP_OBJ_NULL) {
@@ -338,6 +448,8 @@ static const mp_rom_map_elem_t btree_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_keys), MP_ROM_PTR(&btree_keys_obj) },
     { MP_ROM_QSTR(MP_QSTR_values), MP_ROM_PTR(&btree_values_obj) },
     { MP_ROM_QSTR(MP_QSTR_items), MP_ROM_PTR(&btree_items_obj) },
+    { MP_ROM_QSTR(MP_QSTR_fetch), MP_ROM_PTR(&btree_fetch_obj) },
+    { MP_ROM_QSTR(MP_QSTR_load), MP_ROM_PTR(&btree_load_obj) },
 };
 
 static MP_DEFINE_CONST_DICT(btree_locals_dict, btree_locals_dict_table);
@@ -367,6 +479,101 @@ static const FILEVTABLE btree_stream_fvtable = {
     mp_stream_posix_fsync
 };
 
+#if MICROPY_PY_BTREE_FD
+// Page I/O directly on the file descriptor of a POSIX VFS file.  Seeks only
+// record the position, so each page costs a single pread or pwrite system call
+// rather than an lseek and a read or write through the stream protocol.
+
+// Return the file descriptor of a POSIX VFS file, or -1 if it's closed.
+static int btree_stream_fd(mp_obj_t stream) {
+    const mp_stream_p_t *stream_p = mp_get_stream(stream);
+    int err;
+    mp_uint_t res = stream_p->ioctl(stream, MP_STREAM_GET_FILENO, 0, &err);
+    if (res == MP_STREAM_ERROR) {
+        return -1;
+    }
+    return res;
+}
+
+// The file may have been closed since the database was opened, and its
+// descriptor reused by another file, so look the descriptor up on each access.
+static int btree_fd_get(btree_fd_t *f) {
+    int fd = btree_stream_fd(f->stream);
+    if (fd < 0) {
+        errno = EBADF;
+    }
+    return fd;
+}
+
+static ssize_t btree_fd_read(void *fd_in, void *buf, size_t size) {
+    btree_fd_t *f = fd_in;
+    int fd = btree_fd_get(f);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t res;
+    do {
+        res = pread(fd, buf, size, f->pos);
+    } while (res < 0 && errno == EINTR);
+    if (res > 0) {
+        f->pos += res;
+    }
+    return res;
+}
+
+static ssize_t btree_fd_write(void *fd_in, const void *buf, size_t size) {
+    btree_fd_t *f = fd_in;
+    int fd = btree_fd_get(f);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t res;
+    do {
+        res = pwrite(fd, buf, size, f->pos);
+    } while (res < 0 && errno == EINTR);
+    if (res > 0) {
+        f->pos += res;
+    }
+    return res;
+}
+
+static off_t btree_fd_lseek(void *fd_in, off_t offset, int whence) {
+    btree_fd_t *f = fd_in;
+    if (whence == SEEK_SET) {
+        f->pos = offset;
+    } else if (whence == SEEK_CUR) {
+        f->pos += offset;
+    } else {
+        int fd = btree_fd_get(f);
+        if (fd < 0) {
+            return -1;
+        }
+        off_t res = lseek(fd, offset, whence);
+        if (res < 0) {
+            return res;
+        }
+        f->pos = res;
+    }
+    return f->pos;
+}
+
+static int btree_fd_fsync(void *fd_in) {
+    int fd = btree_fd_get(fd_in);
+    if (fd < 0) {
+        return -1;
+    }
+    return fsync(fd);
+}
+
+static const FILEVTABLE btree_fd_fvtable = {
+    btree_fd_read,
+    btree_fd_write,
+    btree_fd_lseek,
+    btree_fd_fsync
+};
+
+#endif
+
 #if !MICROPY_ENABLE_DYNRUNTIME
 static mp_obj_t mod_btree_open(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     static const mp_arg_t allowed_args[] = {
@@ -393,11 +600,25 @@ static mp_obj_t mod_btree_open(size_t n_args, const mp_obj_t *pos_args, mp_map_t
     openinfo.psize = args.pagesize.u_int;
     openinfo.minkeypage = args.minkeypage.u_int;
 
-    DB *db = __bt_open(MP_OBJ_TO_PTR(pos_args[0]), &btree_stream_fvtable, &openinfo, /*dflags*/ 0);
-    if (db == NULL) {
+    mp_obj_btree_t *o = btree_new(NULL, pos_args[0]);
+    void *fd = MP_OBJ_TO_PTR(pos_args[0]);
+    const FILEVTABLE *fvtable = &btree_stream_fvtable;
+    #if MICROPY_PY_BTREE_FD
+    if (mp_obj_is_type(pos_args[0], &mp_type_vfs_posix_fileio)) {
+        int file_fd = btree_stream_fd(pos_args[0]);
+        if (file_fd >= 0) {
+            o->fd.stream = pos_args[0];
+            o->fd.pos = lseek(file_fd, 0, SEEK_CUR);
+            fd = &o->fd;
+            fvtable = &btree_fd_fvtable;
+        }
+    }
+    #endif
+    o->db = __bt_open(fd, fvtable, &openinfo, /*dflags*/ 0);
+    if (o->db == NULL) {
         mp_raise_OSError(errno);
     }
-    return MP_OBJ_FROM_PTR(btree_new(db, pos_args[0]));
+    return MP_OBJ_FROM_PTR(o);
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(mod_btree_open_obj, 1, mod_btree_open);
 
@@ -39,11 +39,12 @@
 // of PEP 272 can be made with a simple wrapper which adds all the
 // needed boilerplate.
 
-// values follow PEP 272
+// values follow PEP 272 (GCM isn't in PEP 272, its value follows PyCryptodome)
 enum {
     UCRYPTOLIB_MODE_ECB = 1,
     UCRYPTOLIB_MODE_CBC = 2,
     UCRYPTOLIB_MODE_CTR = 6,
+    UCRYPTOLIB_MODE_GCM = 11,
 };
 
 struct ctr_params {
@@ -54,13 +55,29 @@ struct ctr_params {
     uint8_t encrypted_counter[16];
 };
 
-#if MICROPY_SSL_AXTLS
+#if MICROPY_PY_CRYPTOLIB_AES_BUILTIN
+#include "extmod/cryptolib_aes.h"
+
+// As for mbedtls below, the key is kept until the first call to encrypt/decrypt
+// says which direction to expand it for.
+struct builtin_aes_ctx_with_key {
+    union {
+        cryptolib_aes_ctx_t aes;
+        struct {
+            uint8_t key[32];
+            uint8_t keysize;
+        } init_data;
+    } u;
+    uint8_t iv[16];
+};
+#define AES_CTX_IMPL struct builtin_aes_ctx_with_key
+
+#elif MICROPY_SSL_AXTLS
 #include "lib/axtls/crypto/crypto.h"
 
 #define AES_CTX_IMPL AES_CTX
-#endif
 
-#if MICROPY_SSL_MBEDTLS
+#elif MICROPY_SSL_MBEDTLS
 #include <mbedtls/aes.h>
 
 // we can't run mbedtls AES key schedule until we know whether we're used for encrypt or decrypt.
@@ -79,6 +96,18 @@ struct mbedtls_aes_ctx_with_key {
 #define AES_CTX_IMPL struct mbedtls_aes_ctx_with_key
 #endif
 
+#if MICROPY_PY_CRYPTOLIB_GCM && !MICROPY_PY_CRYPTOLIB_AES_BUILTIN
+#error MICROPY_PY_CRYPTOLIB_GCM requires MICROPY_PY_CRYPTOLIB_AES_BUILTIN
+#endif
+
+// State for the streaming modes, only allocated for those modes.
+union mode_params {
+    struct ctr_params ctr;
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    cryptolib_aes_gcm_t gcm;
+    #endif
+};
+
 typedef struct _mp_obj_aes_t {
     mp_obj_base_t base;
     AES_CTX_IMPL ctx;
@@ -87,7 +116,7 @@ typedef struct _mp_obj_aes_t {
 #define AES_KEYTYPE_ENC  1
 #define AES_KEYTYPE_DEC  2
     uint8_t key_type : 2;
-    struct ctr_params ctr_params[]; // optional
+    union mode_params mode_params[]; // optional
 } mp_obj_aes_t;
 
 static inline bool is_ctr_mode(int block_mode) {
@@ -98,11 +127,50 @@ static inline bool is_ctr_mode(int block_mode) {
     #endif
 }
 
+static inline bool is_gcm_mode(int block_mode) {
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    return block_mode == UCRYPTOLIB_MODE_GCM;
+    #else
+    return false;
+    #endif
+}
+
 static inline struct ctr_params *ctr_params_from_aes(mp_obj_aes_t *o) {
-    return &o->ctr_params[0];
+    return &o->mode_params[0].ctr;
 }
 
-#if MICROPY_SSL_AXTLS
+#if MICROPY_PY_CRYPTOLIB_AES_BUILTIN
+static void aes_initial_set_key_impl(AES_CTX_IMPL *ctx, const uint8_t *key, size_t keysize, const uint8_t iv[16]) {
+    ctx->u.init_data.keysize = keysize;
+    memcpy(ctx->u.init_data.key, key, keysize);
+
+    if (NULL != iv) {
+        memcpy(ctx->iv, iv, sizeof(ctx->iv));
+    }
+}
+
+static void aes_final_set_key_impl(AES_CTX_IMPL *ctx, bool encrypt) {
+    uint8_t key[32];
+    uint8_t keysize = ctx->u.init_data.keysize;
+    memcpy(key, ctx->u.init_data.key, keysize);
+    cryptolib_aes_set_key(&ctx->u.aes, key, keysize, encrypt);
+}
+
+static void aes_process_ecb_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *out, size_t in_len, bool encrypt) {
+    cryptolib_aes_ecb(&ctx->u.aes, in, out, in_len / 16, encrypt);
+}
+
+static void aes_process_cbc_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *out, size_t in_len, bool encrypt) {
+    cryptolib_aes_cbc(&ctx->u.aes, ctx->iv, in, out, in_len / 16, encrypt);
+}
+
+#if MICROPY_PY_CRYPTOLIB_CTR
+static void aes_process_ctr_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *out, size_t in_len, struct ctr_params *ctr_params) {
+    cryptolib_aes_ctr(&ctx->u.aes, ctx->iv, ctr_params->encrypted_counter, &ctr_params->offset, in, out, in_len);
+}
+#endif
+
+#elif MICROPY_SSL_AXTLS
 static void aes_initial_set_key_impl(AES_CTX_IMPL *ctx, const uint8_t *key, size_t keysize, const uint8_t iv[16]) {
     assert(16 == keysize || 32 == keysize);
     AES_set_key(ctx, key, iv, (16 == keysize) ? AES_MODE_128 : AES_MODE_256);
@@ -114,21 +182,23 @@ static void aes_final_set_key_impl(AES_CTX_IMPL *ctx, bool encrypt) {
     }
 }
 
-static void aes_process_ecb_impl(AES_CTX_IMPL *ctx, const uint8_t in[16], uint8_t out[16], bool encrypt) {
-    memcpy(out, in, 16);
-    // We assume that out (vstr.buf or given output buffer) is uint32_t aligned
-    uint32_t *p = (uint32_t *)out;
-    // axTLS likes it weird and complicated with byteswaps
-    for (int i = 0; i < 4; i++) {
-        p[i] = MP_HTOBE32(p[i]);
-    }
-    if (encrypt) {
-        AES_encrypt(ctx, p);
-    } else {
-        AES_decrypt(ctx, p);
-    }
-    for (int i = 0; i < 4; i++) {
-        p[i] = MP_BE32TOH(p[i]);
+static void aes_process_ecb_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *out, size_t in_len, bool encrypt) {
+    for (; in_len != 0; in_len -= 16, in += 16, out += 16) {
+        memcpy(out, in, 16);
+        // We assume that out (vstr.buf or given output buffer) is uint32_t aligned
+        uint32_t *p = (uint32_t *)out;
+        // axTLS likes it weird and complicated with byteswaps
+        for (int i = 0; i < 4; i++) {
+            p[i] = MP_HTOBE32(p[i]);
+        }
+        if (encrypt) {
+            AES_encrypt(ctx, p);
+        } else {
+            AES_decrypt(ctx, p);
+        }
+        for (int i = 0; i < 4; i++) {
+            p[i] = MP_BE32TOH(p[i]);
+        }
     }
 }
 
@@ -148,7 +218,7 @@ static void aes_process_ctr_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *
 
     while (in_len--) {
         if (n == 0) {
-            aes_process_ecb_impl(ctx, counter, ctr_params->encrypted_counter, true);
+            aes_process_ecb_impl(ctx, counter, ctr_params->encrypted_counter, 16, true);
 
             // increment the 128-bit counter
             for (int i = 15; i >= 0; --i) {
@@ -166,9 +236,7 @@ static void aes_process_ctr_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *
 }
 #endif
 
-#endif
-
-#if MICROPY_SSL_MBEDTLS
+#elif MICROPY_SSL_MBEDTLS
 static void aes_initial_set_key_impl(AES_CTX_IMPL *ctx, const uint8_t *key, size_t keysize, const uint8_t iv[16]) {
     ctx->u.init_data.keysize = keysize;
     memcpy(ctx->u.init_data.key, key, keysize);
@@ -195,8 +263,10 @@ static void aes_final_set_key_impl(AES_CTX_IMPL *ctx, bool encrypt) {
     }
 }
 
-static void aes_process_ecb_impl(AES_CTX_IMPL *ctx, const uint8_t in[16], uint8_t out[16], bool encrypt) {
-    mbedtls_aes_crypt_ecb(&ctx->u.mbedtls_ctx, encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT, in, out);
+static void aes_process_ecb_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *out, size_t in_len, bool encrypt) {
+    for (; in_len != 0; in_len -= 16, in += 16, out += 16) {
+        mbedtls_aes_crypt_ecb(&ctx->u.mbedtls_ctx, encrypt ? MBEDTLS_AES_ENCRYPT : MBEDTLS_AES_DECRYPT, in, out);
+    }
 }
 
 static void aes_process_cbc_impl(AES_CTX_IMPL *ctx, const uint8_t *in, uint8_t *out, size_t in_len, bool encrypt) {
@@ -221,6 +291,9 @@ static mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args,
         case UCRYPTOLIB_MODE_CBC:
         #if MICROPY_PY_CRYPTOLIB_CTR
         case UCRYPTOLIB_MODE_CTR:
+        #endif
+        #if MICROPY_PY_CRYPTOLIB_GCM
+        case UCRYPTOLIB_MODE_GCM:
         #endif
             break;
 
@@ -228,7 +301,15 @@ static mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args,
             mp_raise_ValueError(MP_ERROR_TEXT("mode"));
     }
 
-    mp_obj_aes_t *o = mp_obj_malloc_var(mp_obj_aes_t, ctr_params, struct ctr_params, !!is_ctr_mode(block_mode), type);
+    size_t mode_params_size = 0;
+    if (is_ctr_mode(block_mode)) {
+        mode_params_size = sizeof(struct ctr_params);
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    } else if (is_gcm_mode(block_mode)) {
+        mode_params_size = sizeof(cryptolib_aes_gcm_t);
+    #endif
+    }
+    mp_obj_aes_t *o = mp_obj_malloc_helper(offsetof(mp_obj_aes_t, mode_params) + mode_params_size, type);
 
     o->block_mode = block_mode;
     o->key_type = AES_KEYTYPE_NONE;
@@ -244,10 +325,11 @@ static mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args,
     if (n_args > 2 && args[2] != mp_const_none) {
         mp_get_buffer_raise(args[2], &ivinfo, MP_BUFFER_READ);
 
-        if (16 != ivinfo.len) {
+        // GCM takes a 12-byte nonce, which it extends to the initial counter.
+        if ((is_gcm_mode(block_mode) ? 12 : 16) != ivinfo.len) {
             mp_raise_ValueError(MP_ERROR_TEXT("IV"));
         }
-    } else if (o->block_mode == UCRYPTOLIB_MODE_CBC || is_ctr_mode(o->block_mode)) {
+    } else if (o->block_mode == UCRYPTOLIB_MODE_CBC || is_ctr_mode(o->block_mode) || is_gcm_mode(o->block_mode)) {
         mp_raise_ValueError(MP_ERROR_TEXT("IV"));
     }
 
@@ -255,6 +337,16 @@ static mp_obj_t cryptolib_aes_make_new(const mp_obj_type_t *type, size_t n_args,
         ctr_params_from_aes(o)->offset = 0;
     }
 
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    if (is_gcm_mode(block_mode)) {
+        // GCM always encrypts with the key, and needs it now to hash any AAD.
+        aes_initial_set_key_impl(&o->ctx, keyinfo.buf, keyinfo.len, NULL);
+        aes_final_set_key_impl(&o->ctx, true);
+        cryptolib_aes_gcm_init(&o->mode_params[0].gcm, &o->ctx.u.aes, ivinfo.buf);
+        return MP_OBJ_FROM_PTR(o);
+    }
+    #endif
+
     aes_initial_set_key_impl(&o->ctx, keyinfo.buf, keyinfo.len, ivinfo.buf);
 
     return MP_OBJ_FROM_PTR(o);
@@ -272,7 +364,7 @@ static mp_obj_t aes_process(size_t n_args, const mp_obj_t *args, bool encrypt) {
     mp_buffer_info_t in_bufinfo;
     mp_get_buffer_raise(in_buf, &in_bufinfo, MP_BUFFER_READ);
 
-    if (!is_ctr_mode(self->block_mode) && in_bufinfo.len % 16 != 0) {
+    if (!is_ctr_mode(self->block_mode) && !is_gcm_mode(self->block_mode) && in_bufinfo.len % 16 != 0) {
         mp_raise_ValueError(MP_ERROR_TEXT("blksize % 16"));
     }
 
@@ -292,9 +384,11 @@ static mp_obj_t aes_process(size_t n_args, const mp_obj_t *args, bool encrypt) {
     }
 
     if (AES_KEYTYPE_NONE == self->key_type) {
-        // always set key for encryption if CTR mode.
+        // always set key for encryption if CTR mode; GCM mode has already set it.
         const bool encrypt_mode = encrypt || is_ctr_mode(self->block_mode);
-        aes_final_set_key_impl(&self->ctx, encrypt_mode);
+        if (!is_gcm_mode(self->block_mode)) {
+            aes_final_set_key_impl(&self->ctx, encrypt_mode);
+        }
         self->key_type = encrypt ? AES_KEYTYPE_ENC : AES_KEYTYPE_DEC;
     } else {
         if ((encrypt && self->key_type == AES_KEYTYPE_DEC) ||
@@ -305,14 +399,9 @@ static mp_obj_t aes_process(size_t n_args, const mp_obj_t *args, bool encrypt) {
     }
 
     switch (self->block_mode) {
-        case UCRYPTOLIB_MODE_ECB: {
-            uint8_t *in = in_bufinfo.buf, *out = out_buf_ptr;
-            uint8_t *top = in + in_bufinfo.len;
-            for (; in < top; in += 16, out += 16) {
-                aes_process_ecb_impl(&self->ctx, in, out, encrypt);
-            }
+        case UCRYPTOLIB_MODE_ECB:
+            aes_process_ecb_impl(&self->ctx, in_bufinfo.buf, out_buf_ptr, in_bufinfo.len, encrypt);
             break;
-        }
 
         case UCRYPTOLIB_MODE_CBC:
             aes_process_cbc_impl(&self->ctx, in_bufinfo.buf, out_buf_ptr, in_bufinfo.len, encrypt);
@@ -324,6 +413,13 @@ static mp_obj_t aes_process(size_t n_args, const mp_obj_t *args, bool encrypt) {
                 ctr_params_from_aes(self));
             break;
         #endif
+
+        #if MICROPY_PY_CRYPTOLIB_GCM
+        case UCRYPTOLIB_MODE_GCM:
+            cryptolib_aes_gcm_crypt(&self->mode_params[0].gcm, &self->ctx.u.aes, in_bufinfo.buf, out_buf_ptr,
+                in_bufinfo.len, encrypt);
+            break;
+        #endif
     }
 
     if (out_buf != MP_OBJ_NULL) {
@@ -342,9 +438,62 @@ static mp_obj_t cryptolib_aes_decrypt(size_t n_args, const mp_obj_t *args) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(cryptolib_aes_decrypt_obj, 2, 3, cryptolib_aes_decrypt);
 
+#if MICROPY_PY_CRYPTOLIB_GCM
+static cryptolib_aes_gcm_t *gcm_from_aes(mp_obj_t self_in) {
+    mp_obj_aes_t *self = MP_OBJ_TO_PTR(self_in);
+    if (!is_gcm_mode(self->block_mode)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("mode"));
+    }
+    return &self->mode_params[0].gcm;
+}
+
+// Adds associated data, which is authenticated but not encrypted.
+static mp_obj_t cryptolib_aes_update(mp_obj_t self_in, mp_obj_t aad_in) {
+    cryptolib_aes_gcm_t *gcm = gcm_from_aes(self_in);
+    if (gcm->in_data) {
+        mp_raise_ValueError(MP_ERROR_TEXT("AAD after data"));
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(aad_in, &bufinfo, MP_BUFFER_READ);
+    cryptolib_aes_gcm_update_aad(gcm, bufinfo.buf, bufinfo.len);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(cryptolib_aes_update_obj, cryptolib_aes_update);
+
+static mp_obj_t cryptolib_aes_digest(mp_obj_t self_in) {
+    vstr_t vstr;
+    vstr_init_len(&vstr, 16);
+    cryptolib_aes_gcm_tag(gcm_from_aes(self_in), (uint8_t *)vstr.buf);
+    return mp_obj_new_bytes_from_vstr(&vstr);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(cryptolib_aes_digest_obj, cryptolib_aes_digest);
+
+static mp_obj_t cryptolib_aes_verify(mp_obj_t self_in, mp_obj_t tag_in) {
+    uint8_t tag[16];
+    cryptolib_aes_gcm_tag(gcm_from_aes(self_in), tag);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(tag_in, &bufinfo, MP_BUFFER_READ);
+    // Compare in constant time, so the time taken doesn't leak the tag.
+    uint8_t diff = bufinfo.len != sizeof(tag);
+    for (size_t i = 0; i < sizeof(tag) && i < bufinfo.len; ++i) {
+        diff |= tag[i] ^ ((uint8_t *)bufinfo.buf)[i];
+    }
+    if (diff) {
+        mp_raise_ValueError(MP_ERROR_TEXT("MAC check failed"));
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(cryptolib_aes_verify_obj, cryptolib_aes_verify);
+#endif
+
 static const mp_rom_map_elem_t cryptolib_aes_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_encrypt), MP_ROM_PTR(&cryptolib_aes_encrypt_obj) },
     { MP_ROM_QSTR(MP_QSTR_decrypt), MP_ROM_PTR(&cryptolib_aes_decrypt_obj) },
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    { MP_ROM_QSTR(MP_QSTR_update), MP_ROM_PTR(&cryptolib_aes_update_obj) },
+    { MP_ROM_QSTR(MP_QSTR_digest), MP_ROM_PTR(&cryptolib_aes_digest_obj) },
+    { MP_ROM_QSTR(MP_QSTR_verify), MP_ROM_PTR(&cryptolib_aes_verify_obj) },
+    #endif
 };
 static MP_DEFINE_CONST_DICT(cryptolib_aes_locals_dict, cryptolib_aes_locals_dict_table);
 
@@ -365,6 +514,9 @@ static const mp_rom_map_elem_t mp_module_cryptolib_globals_table[] = {
     #if MICROPY_PY_CRYPTOLIB_CTR
     { MP_ROM_QSTR(MP_QSTR_MODE_CTR), MP_ROM_INT(UCRYPTOLIB_MODE_CTR) },
     #endif
+    #if MICROPY_PY_CRYPTOLIB_GCM
+    { MP_ROM_QSTR(MP_QSTR_MODE_GCM), MP_ROM_INT(UCRYPTOLIB_MODE_GCM) },
+    #endif
     #endif
 };
 
@@ -40,6 +40,9 @@ typedef struct _mp_obj_framebuf_t {
     void *buf;
     uint16_t width, height, stride;
     uint8_t format;
+    // bounding box of the pixels drawn since the dirty rectangle was cleared,
+    // with exclusive end coordinates; empty when dirty_x0 >= dirty_x1
+    uint16_t dirty_x0, dirty_y0, dirty_x1, dirty_y1;
 } mp_obj_framebuf_t;
 
 #if !MICROPY_ENABLE_DYNRUNTIME
@@ -49,13 +52,36 @@ static const mp_obj_type_t mp_type_framebuf;
 typedef void (*setpixel_t)(const mp_obj_framebuf_t *, unsigned int, unsigned int, uint32_t);
 typedef uint32_t (*getpixel_t)(const mp_obj_framebuf_t *, unsigned int, unsigned int);
 typedef void (*fill_rect_t)(const mp_obj_framebuf_t *, unsigned int, unsigned int, unsigned int, unsigned int, uint32_t);
+typedef void (*getrow_t)(const mp_obj_framebuf_t *, unsigned int, unsigned int, unsigned int, uint32_t *);
+typedef void (*setrow_t)(const mp_obj_framebuf_t *, unsigned int, unsigned int, unsigned int, const uint32_t *, uint32_t);
 
 typedef struct _mp_framebuf_p_t {
     setpixel_t setpixel;
     getpixel_t getpixel;
     fill_rect_t fill_rect;
+    // get/set a span of pixels along a row, so that operations on whole rows
+    // don't need an indirect call per pixel; setrow skips pixels equal to key
+    getrow_t getrow;
+    setrow_t setrow;
+    uint8_t bpp;
 } mp_framebuf_p_t;
 
+// Row functions for formats that use their get/set pixel functions inline.
+#define FRAMEBUF_ROW_FUNCS(fmt) \
+    static void fmt##_getrow(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, uint32_t *cols) { \
+        for (; w; --w, ++x) { \
+            *cols++ = fmt##_getpixel(fb, x, y); \
+        } \
+    } \
+    static void fmt##_setrow(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, const uint32_t *cols, uint32_t key) { \
+        for (; w; --w, ++x) { \
+            uint32_t col = *cols++; \
+            if (col != key) { \
+                fmt##_setpixel(fb, x, y, col); \
+            } \
+        } \
+    }
+
 // constants for formats
 #define FRAMEBUF_MVLSB    (0)
 #define FRAMEBUF_RGB565   (1)
@@ -80,19 +106,22 @@ static uint32_t mono_horiz_getpixel(const mp_obj_framebuf_t *fb, unsigned int x,
 }
 
 static void mono_horiz_fill_rect(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, unsigned int h, uint32_t col) {
-    unsigned int reverse = fb->format == FRAMEBUF_MHMSB;
-    unsigned int advance = fb->stride >> 3;
-    while (w--) {
-        uint8_t *b = &((uint8_t *)fb->buf)[(x >> 3) + y * advance];
-        unsigned int offset = reverse ?  x & 7 : 7 - (x & 7);
-        for (unsigned int hh = h; hh; --hh) {
-            *b = (*b & ~(0x01 << offset)) | ((col != 0) << offset);
-            b += advance;
+    // whole bytes in the middle of each row are set with memset
+    unsigned int head = MIN(w, (8 - (x & 7)) & 7);
+    unsigned int tail = (w - head) & 7;
+    for (; h; --h, ++y) {
+        for (unsigned int xx = x; xx < x + head; ++xx) {
+            mono_horiz_setpixel(fb, xx, y, col);
+        }
+        memset(&((uint8_t *)fb->buf)[(x + head + y * fb->stride) >> 3], col ? 0xff : 0, (w - head) >> 3);
+        for (unsigned int xx = x + w - tail; xx < x + w; ++xx) {
+            mono_horiz_setpixel(fb, xx, y, col);
         }
-        ++x;
     }
 }
 
+FRAMEBUF_ROW_FUNCS(mono_horiz)
+
 // Functions for MVLSB format
 
 static void mvlsb_setpixel(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, uint32_t col) {
@@ -117,6 +146,8 @@ static void mvlsb_fill_rect(const mp_obj_framebuf_t *fb, unsigned int x, unsigne
     }
 }
 
+FRAMEBUF_ROW_FUNCS(mvlsb)
+
 // Functions for RGB565 format
 
 static void rgb565_setpixel(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, uint32_t col) {
@@ -129,11 +160,38 @@ static uint32_t rgb565_getpixel(const mp_obj_framebuf_t *fb, unsigned int x, uns
 
 static void rgb565_fill_rect(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, unsigned int h, uint32_t col) {
     uint16_t *b = &((uint16_t *)fb->buf)[x + y * fb->stride];
-    while (h--) {
-        for (unsigned int ww = w; ww; --ww) {
-            *b++ = col;
+    if (w < 8) {
+        // too narrow to be worth a call per row
+        for (; h; --h, b += fb->stride) {
+            for (unsigned int ww = 0; ww < w; ++ww) {
+                b[ww] = col;
+            }
+        }
+        return;
+    }
+    // fill the first row, then copy it to the others
+    for (unsigned int ww = 0; ww < w; ++ww) {
+        b[ww] = col;
+    }
+    for (uint16_t *row = b + fb->stride; h > 1; --h, row += fb->stride) {
+        memmove(row, b, w * sizeof(uint16_t));
+    }
+}
+
+static void rgb565_getrow(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, uint32_t *cols) {
+    const uint16_t *b = &((uint16_t *)fb->buf)[x + y * fb->stride];
+    while (w--) {
+        *cols++ = *b++;
+    }
+}
+
+static void rgb565_setrow(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, const uint32_t *cols, uint32_t key) {
+    uint16_t *b = &((uint16_t *)fb->buf)[x + y * fb->stride];
+    for (; w; --w, ++b) {
+        uint32_t col = *cols++;
+        if (col != key) {
+            *b = col;
         }
-        b += fb->stride - w;
     }
 }
 
@@ -154,13 +212,22 @@ static uint32_t gs2_hmsb_getpixel(const mp_obj_framebuf_t *fb, unsigned int x, u
 }
 
 static void gs2_hmsb_fill_rect(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, unsigned int h, uint32_t col) {
-    for (unsigned int xx = x; xx < x + w; xx++) {
-        for (unsigned int yy = y; yy < y + h; yy++) {
-            gs2_hmsb_setpixel(fb, xx, yy, col);
+    // whole bytes in the middle of each row are set with memset
+    unsigned int head = MIN(w, (4 - (x & 3)) & 3);
+    unsigned int tail = (w - head) & 3;
+    for (; h; --h, ++y) {
+        for (unsigned int xx = x; xx < x + head; ++xx) {
+            gs2_hmsb_setpixel(fb, xx, y, col);
+        }
+        memset(&((uint8_t *)fb->buf)[(x + head + y * fb->stride) >> 2], (col & 0x3) * 0x55, (w - head) >> 2);
+        for (unsigned int xx = x + w - tail; xx < x + w; ++xx) {
+            gs2_hmsb_setpixel(fb, xx, y, col);
         }
     }
 }
 
+FRAMEBUF_ROW_FUNCS(gs2_hmsb)
+
 // Functions for GS4_HMSB format
 
 static void gs4_hmsb_setpixel(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, uint32_t col) {
@@ -212,6 +279,8 @@ static void gs4_hmsb_fill_rect(const mp_obj_framebuf_t *fb, unsigned int x, unsi
     }
 }
 
+FRAMEBUF_ROW_FUNCS(gs4_hmsb)
+
 // Functions for GS8 format
 
 static void gs8_setpixel(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, uint32_t col) {
@@ -231,21 +300,52 @@ static void gs8_fill_rect(const mp_obj_framebuf_t *fb, unsigned int x, unsigned
     }
 }
 
+static void gs8_getrow(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, uint32_t *cols) {
+    const uint8_t *b = &((uint8_t *)fb->buf)[x + y * fb->stride];
+    while (w--) {
+        *cols++ = *b++;
+    }
+}
+
+static void gs8_setrow(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, const uint32_t *cols, uint32_t key) {
+    uint8_t *b = &((uint8_t *)fb->buf)[x + y * fb->stride];
+    for (; w; --w, ++b) {
+        uint32_t col = *cols++;
+        if (col != key) {
+            *b = col & 0xff;
+        }
+    }
+}
+
 static mp_framebuf_p_t formats[] = {
-    [FRAMEBUF_MVLSB] = {mvlsb_setpixel, mvlsb_getpixel, mvlsb_fill_rect},
-    [FRAMEBUF_RGB565] = {rgb565_setpixel, rgb565_getpixel, rgb565_fill_rect},
-    [FRAMEBUF_GS2_HMSB] = {gs2_hmsb_setpixel, gs2_hmsb_getpixel, gs2_hmsb_fill_rect},
-    [FRAMEBUF_GS4_HMSB] = {gs4_hmsb_setpixel, gs4_hmsb_getpixel, gs4_hmsb_fill_rect},
-    [FRAMEBUF_GS8] = {gs8_setpixel, gs8_getpixel, gs8_fill_rect},
-    [FRAMEBUF_MHLSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect},
-    [FRAMEBUF_MHMSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect},
+    [FRAMEBUF_MVLSB] = {mvlsb_setpixel, mvlsb_getpixel, mvlsb_fill_rect, mvlsb_getrow, mvlsb_setrow, 1},
+    [FRAMEBUF_RGB565] = {rgb565_setpixel, rgb565_getpixel, rgb565_fill_rect, rgb565_getrow, rgb565_setrow, 16},
+    [FRAMEBUF_GS2_HMSB] = {gs2_hmsb_setpixel, gs2_hmsb_getpixel, gs2_hmsb_fill_rect, gs2_hmsb_getrow, gs2_hmsb_setrow, 2},
+    [FRAMEBUF_GS4_HMSB] = {gs4_hmsb_setpixel, gs4_hmsb_getpixel, gs4_hmsb_fill_rect, gs4_hmsb_getrow, gs4_hmsb_setrow, 4},
+    [FRAMEBUF_GS8] = {gs8_setpixel, gs8_getpixel, gs8_fill_rect, gs8_getrow, gs8_setrow, 8},
+    [FRAMEBUF_MHLSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect, mono_horiz_getrow, mono_horiz_setrow, 1},
+    [FRAMEBUF_MHMSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect, mono_horiz_getrow, mono_horiz_setrow, 1},
 };
 
-static inline void setpixel(const mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, uint32_t col) {
+// Add a rectangle, which must be within the framebuffer, to the dirty rectangle.
+static void mark_dirty(mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, unsigned int w, unsigned int h) {
+    fb->dirty_x0 = MIN(fb->dirty_x0, x);
+    fb->dirty_y0 = MIN(fb->dirty_y0, y);
+    fb->dirty_x1 = MAX(fb->dirty_x1, x + w);
+    fb->dirty_y1 = MAX(fb->dirty_y1, y + h);
+}
+
+static void clear_dirty(mp_obj_framebuf_t *fb) {
+    fb->dirty_x0 = fb->dirty_y0 = 0xffff;
+    fb->dirty_x1 = fb->dirty_y1 = 0;
+}
+
+static inline void setpixel(mp_obj_framebuf_t *fb, unsigned int x, unsigned int y, uint32_t col) {
+    mark_dirty(fb, x, y, 1, 1);
     formats[fb->format].setpixel(fb, x, y, col);
 }
 
-static void setpixel_checked(const mp_obj_framebuf_t *fb, mp_int_t x, mp_int_t y, mp_int_t col, mp_int_t mask) {
+static void setpixel_checked(mp_obj_framebuf_t *fb, mp_int_t x, mp_int_t y, mp_int_t col, mp_int_t mask) {
     if (mask && 0 <= x && x < fb->width && 0 <= y && y < fb->height) {
         setpixel(fb, x, y, col);
     }
@@ -255,7 +355,7 @@ static inline uint32_t getpixel(const mp_obj_framebuf_t *fb, unsigned int x, uns
     return formats[fb->format].getpixel(fb, x, y);
 }
 
-static void fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
+static void fill_rect(mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
     if (h < 1 || w < 1 || x + w <= 0 || y + h <= 0 || y >= fb->height || x >= fb->width) {
         // No operation needed.
         return;
@@ -267,9 +367,76 @@ static void fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, u
     x = MAX(x, 0);
     y = MAX(y, 0);
 
+    mark_dirty(fb, x, y, xend - x, yend - y);
     formats[fb->format].fill_rect(fb, x, y, xend - x, yend - y, col);
 }
 
+// Number of pixels that the row functions below work on at a time.
+#define FRAMEBUF_SPAN_LEN (32)
+
+// The end of the pixel data of a framebuffer.
+static const uint8_t *framebuf_end(const mp_obj_framebuf_t *fb) {
+    size_t len;
+    if (fb->format == FRAMEBUF_MVLSB) {
+        len = ((fb->height + 7) >> 3) * fb->stride;
+    } else {
+        len = ((size_t)fb->height * fb->stride * formats[fb->format].bpp + 7) >> 3;
+    }
+    return (uint8_t *)fb->buf + len;
+}
+
+// Whether the pixel data of two framebuffers share memory.
+static bool framebuf_overlaps(const mp_obj_framebuf_t *a, const mp_obj_framebuf_t *b) {
+    return (uint8_t *)a->buf < framebuf_end(b) && (uint8_t *)b->buf < framebuf_end(a);
+}
+
+// Copy w pixels from (sx, sy) of src to (dx, dy) of dest, skipping those that
+// equal key, and mapping them through lut (which has lut_len entries) or else
+// palette, if given.  If dest is to the right of src then spans are copied
+// from right to left, in case they're in the same row of the same buffer.
+static void framebuf_blit_row(const mp_obj_framebuf_t *dest, unsigned int dx, unsigned int dy,
+    const mp_obj_framebuf_t *src, unsigned int sx, unsigned int sy, unsigned int w,
+    const mp_obj_framebuf_t *palette, const uint16_t *lut, unsigned int lut_len, uint32_t key) {
+    uint32_t cols[FRAMEBUF_SPAN_LEN];
+    getrow_t getrow = formats[src->format].getrow;
+    setrow_t setrow = formats[dest->format].setrow;
+    for (unsigned int done = 0; done < w;) {
+        unsigned int n = MIN(w - done, FRAMEBUF_SPAN_LEN);
+        unsigned int offset = dx > sx ? w - done - n : done;
+        getrow(src, sx + offset, sy, n, cols);
+        if (palette != NULL) {
+            for (unsigned int i = 0; i < n; ++i) {
+                cols[i] = cols[i] < lut_len ? lut[cols[i]] : getpixel(palette, cols[i], 0);
+            }
+        }
+        setrow(dest, dx + offset, dy, n, cols, key);
+        done += n;
+    }
+}
+
+// Copy w pixels from (sx, sy) of src to (dx, dy) of dest, which have the same
+// format.  Whole bytes are moved with memmove if the pixels line up with them.
+static void framebuf_copy_row(const mp_obj_framebuf_t *dest, unsigned int dx, unsigned int dy,
+    const mp_obj_framebuf_t *src, unsigned int sx, unsigned int sy, unsigned int w) {
+    unsigned int bpp = formats[dest->format].bpp;
+    unsigned int ppb = bpp < 8 ? 8 / bpp : 1; // pixels per byte
+    if (dest->format != FRAMEBUF_MVLSB && dx % ppb == sx % ppb) {
+        unsigned int head = MIN(w, (ppb - dx % ppb) % ppb);
+        unsigned int tail = (w - head) % ppb;
+        // pixels in partial bytes are copied separately, unless that could
+        // overwrite pixels of the same row that are yet to be copied
+        if ((head == 0 && tail == 0) || src != dest || sy != dy) {
+            framebuf_blit_row(dest, dx, dy, src, sx, sy, head, NULL, NULL, 0, (uint32_t)-1);
+            memmove((uint8_t *)dest->buf + (dx + head + dy * dest->stride) * bpp / 8,
+                (uint8_t *)src->buf + (sx + head + sy * src->stride) * bpp / 8,
+                (w - head - tail) * bpp / 8);
+            framebuf_blit_row(dest, dx + w - tail, dy, src, sx + w - tail, sy, tail, NULL, NULL, 0, (uint32_t)-1);
+            return;
+        }
+    }
+    framebuf_blit_row(dest, dx, dy, src, sx, sy, w, NULL, NULL, 0, (uint32_t)-1);
+}
+
 static mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args_in) {
     mp_arg_check_num(n_args, n_kw, 4, 5, false);
 
@@ -325,6 +492,7 @@ static mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, size
     o->height = height;
     o->format = format;
     o->stride = stride;
+    clear_dirty(o);
 
     return MP_OBJ_FROM_PTR(o);
 }
@@ -343,6 +511,7 @@ static mp_int_t framebuf_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo,
 static mp_obj_t framebuf_fill(mp_obj_t self_in, mp_obj_t col_in) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
     mp_int_t col = mp_obj_get_int(col_in);
+    mark_dirty(self, 0, 0, self->width, self->height);
     formats[self->format].fill_rect(self, 0, 0, self->width, self->height, col);
     return mp_const_none;
 }
@@ -416,7 +585,43 @@ static mp_obj_t framebuf_rect(size_t n_args, const mp_obj_t *args_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_rect_obj, 6, 7, framebuf_rect);
 
-static void line(const mp_obj_framebuf_t *fb, mp_int_t x1, mp_int_t y1, mp_int_t x2, mp_int_t y2, mp_int_t col) {
+// Draw a run of pixels of a line, from a to b along its major axis, clipping
+// it to the framebuffer if the line crosses its edges.
+static void line_run(mp_obj_framebuf_t *fb, bool clip, bool steep, mp_int_t a, mp_int_t b, mp_int_t minor, mp_int_t col) {
+    mp_int_t start = MIN(a, b);
+    mp_int_t len = MAX(a, b) - start + 1;
+    mp_int_t x = steep ? minor : start;
+    mp_int_t y = steep ? start : minor;
+    if (clip) {
+        if (len == 1) {
+            setpixel_checked(fb, x, y, col, 1);
+        } else {
+            fill_rect(fb, x, y, steep ? 1 : len, steep ? len : 1, col);
+        }
+    } else {
+        if (len == 1) {
+            formats[fb->format].setpixel(fb, x, y, col);
+        } else {
+            formats[fb->format].fill_rect(fb, x, y, steep ? 1 : len, steep ? len : 1, col);
+        }
+    }
+}
+
+static void line(mp_obj_framebuf_t *fb, mp_int_t x1, mp_int_t y1, mp_int_t x2, mp_int_t y2, mp_int_t col) {
+    mp_int_t xmin = MIN(x1, x2);
+    mp_int_t xmax = MAX(x1, x2);
+    mp_int_t ymin = MIN(y1, y2);
+    mp_int_t ymax = MAX(y1, y2);
+    if (xmax < 0 || xmin >= fb->width || ymax < 0 || ymin >= fb->height) {
+        // Entirely outside the framebuffer.
+        return;
+    }
+    // Only clip each run if the line isn't entirely within the framebuffer.
+    bool clip = xmin < 0 || xmax >= fb->width || ymin < 0 || ymax >= fb->height;
+    if (!clip) {
+        mark_dirty(fb, xmin, ymin, xmax - xmin + 1, ymax - ymin + 1);
+    }
+
     mp_int_t dx = x2 - x1;
     mp_int_t sx;
     if (dx > 0) {
@@ -452,28 +657,26 @@ static void line(const mp_obj_framebuf_t *fb, mp_int_t x1, mp_int_t y1, mp_int_t
         steep = false;
     }
 
+    // Draw each run of pixels that share a minor coordinate with one fill.
+    mp_int_t run = x1;
     mp_int_t e = 2 * dy - dx;
     for (mp_int_t i = 0; i < dx; ++i) {
-        if (steep) {
-            if (0 <= y1 && y1 < fb->width && 0 <= x1 && x1 < fb->height) {
-                setpixel(fb, y1, x1, col);
-            }
-        } else {
-            if (0 <= x1 && x1 < fb->width && 0 <= y1 && y1 < fb->height) {
-                setpixel(fb, x1, y1, col);
+        if (e >= 0) {
+            line_run(fb, clip, steep, run, x1, y1, col);
+            while (e >= 0) {
+                y1 += sy;
+                e -= 2 * dx;
             }
-        }
-        while (e >= 0) {
-            y1 += sy;
-            e -= 2 * dx;
+            run = x1 + sx;
         }
         x1 += sx;
         e += 2 * dy;
     }
-
-    if (0 <= x2 && x2 < fb->width && 0 <= y2 && y2 < fb->height) {
-        setpixel(fb, x2, y2, col);
+    if (run != x1) {
+        line_run(fb, clip, steep, run, x1 - sx, y1, col);
     }
+
+    line_run(fb, clip, false, x2, x2, y2, col);
 }
 
 static mp_obj_t framebuf_line(size_t n_args, const mp_obj_t *args_in) {
@@ -498,25 +701,38 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_line_obj, 6, 6, framebuf_lin
 #define ELLIPSE_MASK_Q3 (0x04)
 #define ELLIPSE_MASK_Q4 (0x08)
 
-static void draw_ellipse_points(const mp_obj_framebuf_t *fb, mp_int_t cx, mp_int_t cy, mp_int_t x, mp_int_t y, mp_int_t col, mp_int_t mask) {
-    if (mask & ELLIPSE_MASK_FILL) {
+static void ellipse_span(mp_obj_framebuf_t *fb, mp_int_t x, mp_int_t y, mp_int_t w, mp_int_t col) {
+    if (w == 1) {
+        setpixel_checked(fb, x, y, col, 1);
+    } else {
+        fill_rect(fb, x, y, w, 1, col);
+    }
+}
+
+// Draw the points from x0 to x1 at height y in each quadrant, where x0 is
+// zero when filling.
+static void draw_ellipse_points(mp_obj_framebuf_t *fb, mp_int_t cx, mp_int_t cy, mp_int_t x0, mp_int_t x1, mp_int_t y, mp_int_t col, mp_int_t mask) {
+    mp_int_t w = x1 - x0 + 1;
+    if (x0 == 0 && (mask & (ELLIPSE_MASK_Q1 | ELLIPSE_MASK_Q2)) == (ELLIPSE_MASK_Q1 | ELLIPSE_MASK_Q2)) {
+        // the spans in Q1 and Q2 join up
+        ellipse_span(fb, cx - x1, cy - y, 2 * x1 + 1, col);
+    } else {
         if (mask & ELLIPSE_MASK_Q1) {
-            fill_rect(fb, cx, cy - y, x + 1, 1, col);
+            ellipse_span(fb, cx + x0, cy - y, w, col);
         }
         if (mask & ELLIPSE_MASK_Q2) {
-            fill_rect(fb, cx - x, cy - y, x + 1, 1, col);
+            ellipse_span(fb, cx - x1, cy - y, w, col);
         }
+    }
+    if (x0 == 0 && (mask & (ELLIPSE_MASK_Q3 | ELLIPSE_MASK_Q4)) == (ELLIPSE_MASK_Q3 | ELLIPSE_MASK_Q4)) {
+        ellipse_span(fb, cx - x1, cy + y, 2 * x1 + 1, col);
+    } else {
         if (mask & ELLIPSE_MASK_Q3) {
-            fill_rect(fb, cx - x, cy + y, x + 1, 1, col);
+            ellipse_span(fb, cx - x1, cy + y, w, col);
         }
         if (mask & ELLIPSE_MASK_Q4) {
-            fill_rect(fb, cx, cy + y, x + 1, 1, col);
+            ellipse_span(fb, cx + x0, cy + y, w, col);
         }
-    } else {
-        setpixel_checked(fb, cx + x, cy - y, col, mask & ELLIPSE_MASK_Q1);
-        setpixel_checked(fb, cx - x, cy - y, col, mask & ELLIPSE_MASK_Q2);
-        setpixel_checked(fb, cx - x, cy + y, col, mask & ELLIPSE_MASK_Q3);
-        setpixel_checked(fb, cx + x, cy + y, col, mask & ELLIPSE_MASK_Q4);
     }
 }
 
@@ -530,6 +746,12 @@ static mp_obj_t framebuf_ellipse(size_t n_args, const mp_obj_t *args_in) {
     } else {
         mask |= ELLIPSE_MASK_ALL;
     }
+    if (args[2] >= 0 && args[3] >= 0
+        && (args[0] + args[2] < 0 || args[0] - args[2] >= self->width
+            || args[1] + args[3] < 0 || args[1] - args[3] >= self->height)) {
+        // Entirely outside the framebuffer.
+        return mp_const_none;
+    }
     mp_int_t two_asquare = 2 * args[2] * args[2];
     mp_int_t two_bsquare = 2 * args[3] * args[3];
     mp_int_t x = args[2];
@@ -540,7 +762,7 @@ static mp_obj_t framebuf_ellipse(size_t n_args, const mp_obj_t *args_in) {
     mp_int_t stoppingx = two_bsquare * args[2];
     mp_int_t stoppingy = 0;
     while (stoppingx >= stoppingy) {   // 1st set of points,  y' > -1
-        draw_ellipse_points(self, args[0], args[1], x, y, args[4], mask);
+        draw_ellipse_points(self, args[0], args[1], (mask & ELLIPSE_MASK_FILL) ? 0 : x, x, y, args[4], mask);
         y += 1;
         stoppingy += two_asquare;
         ellipse_error += ychange;
@@ -560,8 +782,12 @@ static mp_obj_t framebuf_ellipse(size_t n_args, const mp_obj_t *args_in) {
     ellipse_error = 0;
     stoppingx = 0;
     stoppingy = two_asquare * args[3];
+    // consecutive points in this set share a y coordinate, so draw them as
+    // one span per y
+    mp_int_t run = 0;
     while (stoppingx <= stoppingy) {  // 2nd set of points, y' < -1
-        draw_ellipse_points(self, args[0], args[1], x, y, args[4], mask);
+        mp_int_t px = x;
+        mp_int_t py = y;
         x += 1;
         stoppingx += two_bsquare;
         ellipse_error += xchange;
@@ -572,6 +798,10 @@ static mp_obj_t framebuf_ellipse(size_t n_args, const mp_obj_t *args_in) {
             ellipse_error += ychange;
             ychange += two_asquare;
         }
+        if (y != py || stoppingx > stoppingy) {
+            draw_ellipse_points(self, args[0], args[1], (mask & ELLIPSE_MASK_FILL) ? 0 : run, px, py, args[4], mask);
+            run = x;
+        }
     }
     return mp_const_none;
 }
@@ -581,6 +811,10 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_ellipse_obj, 6, 8, framebuf_
 // TODO: poly needs mp_binary_get_size & mp_binary_get_val_array which aren't
 // available in dynruntime.h yet.
 
+typedef struct _poly_edge_t {
+    mp_int_t x1, y1, x2, y2;
+} poly_edge_t;
+
 static mp_int_t poly_int(mp_buffer_info_t *bufinfo, size_t index) {
     return mp_obj_get_int(mp_binary_get_val_array(bufinfo->typecode, bufinfo->buf, index));
 }
@@ -610,75 +844,87 @@ static mp_obj_t framebuf_poly(size_t n_args, const mp_obj_t *args_in) {
         // coordinates where the scan line intersects the polygon edges,
         // then fill between each resulting pair.
 
-        // Restrict just to the scan lines that include the vertical extent of
-        // this polygon.
+        // Read each edge, from a vertex to the previous one, into a table
+        // sorted by the top of the edge, so that edges can be added to the
+        // active edge list as the scan line reaches them.
+        poly_edge_t *edges = m_new(poly_edge_t, n_poly);
         mp_int_t y_min = INT_MAX, y_max = INT_MIN;
-        for (int i = 0; i < n_poly; i++) {
-            mp_int_t py = poly_int(&bufinfo, i * 2 + 1);
-            y_min = MIN(y_min, py);
-            y_max = MAX(y_max, py);
+        mp_int_t px1 = poly_int(&bufinfo, 0);
+        mp_int_t py1 = poly_int(&bufinfo, 1);
+        for (int i = n_poly - 1, n = 0; i >= 0; --i, ++n) {
+            poly_edge_t edge = { px1, py1, poly_int(&bufinfo, i * 2), poly_int(&bufinfo, i * 2 + 1) };
+            px1 = edge.x2;
+            py1 = edge.y2;
+            y_min = MIN(y_min, py1);
+            y_max = MAX(y_max, py1);
+            // Insertion sort (for code size).
+            int j = n;
+            for (; j > 0 && MIN(edges[j - 1].y1, edges[j - 1].y2) > MIN(edge.y1, edge.y2); --j) {
+                edges[j] = edges[j - 1];
+            }
+            edges[j] = edge;
         }
 
+        // Restrict just to the scan lines that include the vertical extent of
+        // this polygon and are within the framebuffer.
+        y_min = MAX(y_min, -y);
+        y_max = MIN(y_max, self->height - 1 - y);
+
+        // Each node is the x coordinate where an edge crosses this scan line.
+        mp_int_t nodes[n_poly];
+        int active[n_poly];
+        int n_active = 0;
+        int n_next = 0;
         for (mp_int_t row = y_min; row <= y_max; row++) {
-            // Each node is the x coordinate where an edge crosses this scan line.
-            mp_int_t nodes[n_poly];
-            int n_nodes = 0;
-            mp_int_t px1 = poly_int(&bufinfo, 0);
-            mp_int_t py1 = poly_int(&bufinfo, 1);
-            int i = n_poly * 2 - 1;
-            do {
-                mp_int_t py2 = poly_int(&bufinfo, i--);
-                mp_int_t px2 = poly_int(&bufinfo, i--);
+            // Add the edges that start at or above this scan line, skipping
+            // any that end above it.
+            for (; n_next < n_poly && MIN(edges[n_next].y1, edges[n_next].y2) <= row; ++n_next) {
+                if (MAX(edges[n_next].y1, edges[n_next].y2) >= row) {
+                    active[n_active++] = n_next;
+                }
+            }
 
+            int n_nodes = 0;
+            for (int i = 0; i < n_active;) {
+                const poly_edge_t *edge = &edges[active[i]];
                 // Don't include the bottom pixel of a given edge to avoid
                 // duplicating the node with the start of the next edge. This
                 // will miss some pixels on the boundary, and in particular
                 // at a local minima or inflection point.
-                if (py1 != py2 && ((py1 > row && py2 <= row) || (py1 <= row && py2 > row))) {
-                    mp_int_t node = (32 * px1 + 32 * (px2 - px1) * (row - py1) / (py2 - py1) + 16) / 32;
-                    nodes[n_nodes++] = node;
-                } else if (row == MAX(py1, py2)) {
+                if (row < MAX(edge->y1, edge->y2)) {
+                    mp_int_t node = (32 * edge->x1 + 32 * (edge->x2 - edge->x1) * (row - edge->y1) / (edge->y2 - edge->y1) + 16) / 32;
+                    // Keep the nodes sorted left-to-right; they're mostly in
+                    // order already from the previous scan line.
+                    int j = n_nodes++;
+                    for (; j > 0 && nodes[j - 1] > node; --j) {
+                        nodes[j] = nodes[j - 1];
+                    }
+                    nodes[j] = node;
+                    ++i;
+                } else {
                     // At local-minima, try and manually fill in the pixels that get missed above.
-                    if (py1 < py2) {
-                        setpixel_checked(self, x + px2, y + py2, col, 1);
-                    } else if (py2 < py1) {
-                        setpixel_checked(self, x + px1, y + py1, col, 1);
+                    if (edge->y1 < edge->y2) {
+                        setpixel_checked(self, x + edge->x2, y + edge->y2, col, 1);
+                    } else if (edge->y2 < edge->y1) {
+                        setpixel_checked(self, x + edge->x1, y + edge->y1, col, 1);
                     } else {
                         // Even though this is a hline and would be faster to
                         // use fill_rect, use line() because it handles x2 <
                         // x1.
-                        line(self, x + px1, y + py1, x + px2, y + py2, col);
+                        line(self, x + edge->x1, y + edge->y1, x + edge->x2, y + edge->y2, col);
                     }
-                }
-
-                px1 = px2;
-                py1 = py2;
-            } while (i >= 0);
-
-            if (!n_nodes) {
-                continue;
-            }
-
-            // Sort the nodes left-to-right (bubble-sort for code size).
-            i = 0;
-            while (i < n_nodes - 1) {
-                if (nodes[i] > nodes[i + 1]) {
-                    mp_int_t swap = nodes[i];
-                    nodes[i] = nodes[i + 1];
-                    nodes[i + 1] = swap;
-                    if (i) {
-                        i--;
-                    }
-                } else {
-                    i++;
+                    // This edge ends on this scan line.
+                    active[i] = active[--n_active];
                 }
             }
 
             // Fill between each pair of nodes.
-            for (i = 0; i < n_nodes; i += 2) {
+            for (int i = 0; i < n_nodes; i += 2) {
                 fill_rect(self, x + nodes[i], y + row, (nodes[i + 1] - nodes[i]) + 1, 1, col);
             }
         }
+
+        m_del(poly_edge_t, edges, n_poly);
     } else {
         // Outline only.
         mp_int_t px1 = poly_int(&bufinfo, 0);
@@ -734,20 +980,48 @@ static mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args_in) {
     int y1 = MAX(0, -y);
     int x0end = MIN(self->width, x + source->width);
     int y0end = MIN(self->height, y + source->height);
-
-    for (; y0 < y0end; ++y0) {
-        int cx1 = x1;
-        for (int cx0 = x0; cx0 < x0end; ++cx0) {
-            uint32_t col = getpixel(source, cx1, y1);
-            if (palette) {
-                col = getpixel(palette, col, 0);
-            }
-            if (col != (uint32_t)key) {
-                setpixel(self, cx0, y0, col);
+    mark_dirty(self, x0, y0, x0end - x0, y0end - y0);
+
+    if (framebuf_overlaps(self, source)) {
+        // Go pixel by pixel, so that pixels written before they're read give
+        // the same result as they always have.
+        for (; y0 < y0end; ++y0) {
+            int cx1 = x1;
+            for (int cx0 = x0; cx0 < x0end; ++cx0) {
+                uint32_t col = getpixel(source, cx1, y1);
+                if (palette) {
+                    col = getpixel(palette, col, 0);
+                }
+                if (col != (uint32_t)key) {
+                    setpixel(self, cx0, y0, col);
+                }
+                ++cx1;
             }
-            ++cx1;
+            ++y1;
+        }
+        return mp_const_none;
+    }
+
+    unsigned int src_bpp = formats[source->format].bpp;
+    if (palette == NULL && source->format == self->format && ((uint32_t)key >> src_bpp) != 0) {
+        // the key can't match any pixel, so this is a plain copy
+        for (; y0 < y0end; ++y0, ++y1) {
+            framebuf_copy_row(self, x0, y0, source, x1, y1, x0end - x0);
         }
-        ++y1;
+        return mp_const_none;
+    }
+
+    // Look up the palette colours of the source pixel values up front.
+    uint16_t lut[256];
+    unsigned int lut_len = 0;
+    if (palette != NULL && src_bpp <= 8) {
+        lut_len = MIN(1u << src_bpp, palette->width);
+        for (unsigned int i = 0; i < lut_len; ++i) {
+            lut[i] = getpixel(palette, i, 0);
+        }
+    }
+    for (; y0 < y0end; ++y0, ++y1) {
+        framebuf_blit_row(self, x0, y0, source, x1, y1, x0end - x0, palette, lut, lut_len, key);
     }
     return mp_const_none;
 }
@@ -757,22 +1031,12 @@ static mp_obj_t framebuf_scroll(mp_obj_t self_in, mp_obj_t xstep_in, mp_obj_t ys
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
     mp_int_t xstep = mp_obj_get_int(xstep_in);
     mp_int_t ystep = mp_obj_get_int(ystep_in);
-    int sx, y, xend, yend, dx, dy;
-    if (xstep < 0) {
-        sx = 0;
-        xend = self->width + xstep;
-        if (xend <= 0) {
-            return mp_const_none;
-        }
-        dx = 1;
-    } else {
-        sx = self->width - 1;
-        xend = xstep - 1;
-        if (xend >= sx) {
-            return mp_const_none;
-        }
-        dx = -1;
+    // number of pixels that move along each row
+    mp_int_t w = self->width - (xstep < 0 ? -xstep : xstep);
+    if (w <= 0) {
+        return mp_const_none;
     }
+    int y, yend, dy;
     if (ystep < 0) {
         y = 0;
         yend = self->height + ystep;
@@ -788,10 +1052,10 @@ static mp_obj_t framebuf_scroll(mp_obj_t self_in, mp_obj_t xstep_in, mp_obj_t ys
         }
         dy = -1;
     }
+    mark_dirty(self, MAX(xstep, 0), MAX(ystep, 0), w, self->height - (ystep < 0 ? -ystep : ystep));
+    // copy whole rows, in the order that reads each row before it's overwritten
     for (; y != yend; y += dy) {
-        for (int x = sx; x != xend; x += dx) {
-            setpixel(self, x, y, getpixel(self, x - xstep, y - ystep));
-        }
+        framebuf_copy_row(self, MAX(xstep, 0), y, self, MAX(-xstep, 0), y - ystep, w);
     }
     return mp_const_none;
 }
@@ -835,6 +1099,25 @@ static mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_text_obj, 4, 5, framebuf_text);
 
+static mp_obj_t framebuf_dirty(size_t n_args, const mp_obj_t *args_in) {
+    mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(args_in[0]);
+    mp_obj_t rect = mp_const_none;
+    if (self->dirty_x0 < self->dirty_x1) {
+        mp_obj_t items[4] = {
+            MP_OBJ_NEW_SMALL_INT(self->dirty_x0),
+            MP_OBJ_NEW_SMALL_INT(self->dirty_y0),
+            MP_OBJ_NEW_SMALL_INT(self->dirty_x1 - self->dirty_x0),
+            MP_OBJ_NEW_SMALL_INT(self->dirty_y1 - self->dirty_y0),
+        };
+        rect = mp_obj_new_tuple(4, items);
+    }
+    if (n_args < 2 || mp_obj_is_true(args_in[1])) {
+        clear_dirty(self);
+    }
+    return rect;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_dirty_obj, 1, 2, framebuf_dirty);
+
 #if !MICROPY_ENABLE_DYNRUNTIME
 static const mp_rom_map_elem_t framebuf_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_fill), MP_ROM_PTR(&framebuf_fill_obj) },
@@ -851,6 +1134,7 @@ static const mp_rom_map_elem_t framebuf_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_blit), MP_ROM_PTR(&framebuf_blit_obj) },
     { MP_ROM_QSTR(MP_QSTR_scroll), MP_ROM_PTR(&framebuf_scroll_obj) },
     { MP_ROM_QSTR(MP_QSTR_text), MP_ROM_PTR(&framebuf_text_obj) },
+    { MP_ROM_QSTR(MP_QSTR_dirty), MP_ROM_PTR(&framebuf_dirty_obj) },
 };
 static MP_DEFINE_CONST_DICT(framebuf_locals_dict, framebuf_locals_dict_table);
 
@@ -27,6 +27,7 @@
 #include <assert.h>
 #include <string.h>
 
+#include "py/objlist.h"
 #include "py/runtime.h"
 
 #if MICROPY_PY_HASHLIB
@@ -37,9 +38,21 @@
 
 #if MICROPY_PY_HASHLIB_SHA256
 
-#if MICROPY_SSL_MBEDTLS
+// The built-in SHA-256 can use the host's SHA instructions and SIMD lanes, so
+// it is preferred over mbedtls when MICROPY_PY_HASHLIB_SHA256_FAST is enabled.
+#define HASHLIB_SHA256_MBEDTLS (MICROPY_SSL_MBEDTLS && !MICROPY_PY_HASHLIB_SHA256_FAST)
+
+#if HASHLIB_SHA256_MBEDTLS
 #include "mbedtls/sha256.h"
 #else
+#if MICROPY_PY_HASHLIB_SHA256_FAST && defined(__GNUC__)
+#if defined(__x86_64__) || defined(__i386__)
+#define CRYAL_SHA256_USE_SHANI
+#endif
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define CRYAL_SHA256_LANES
+#endif
+#endif
 #include "lib/crypto-algorithms/sha256.h"
 #endif
 
@@ -73,7 +86,7 @@ static void hashlib_ensure_not_final(mp_obj_hash_t *self) {
 #if MICROPY_PY_HASHLIB_SHA256
 static mp_obj_t hashlib_sha256_update(mp_obj_t self_in, mp_obj_t arg);
 
-#if MICROPY_SSL_MBEDTLS
+#if HASHLIB_SHA256_MBEDTLS
 
 #if MBEDTLS_VERSION_NUMBER < 0x02070000 || MBEDTLS_VERSION_NUMBER >= 0x03000000
 #define mbedtls_sha256_starts_ret mbedtls_sha256_starts
@@ -112,6 +125,17 @@ static mp_obj_t hashlib_sha256_digest(mp_obj_t self_in) {
     return mp_obj_new_bytes_from_vstr(&vstr);
 }
 
+#if MICROPY_PY_HASHLIB_SHA256_MANY
+static void hashlib_sha256_oneshot(const mp_buffer_info_t *bufinfo, byte *digest) {
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts_ret(&ctx, 0);
+    mbedtls_sha256_update_ret(&ctx, bufinfo->buf, bufinfo->len);
+    mbedtls_sha256_finish_ret(&ctx, digest);
+    mbedtls_sha256_free(&ctx);
+}
+#endif
+
 #else
 
 #include "lib/crypto-algorithms/sha256.c"
@@ -145,6 +169,64 @@ static mp_obj_t hashlib_sha256_digest(mp_obj_t self_in) {
     sha256_final((CRYAL_SHA256_CTX *)self->state, (byte *)vstr.buf);
     return mp_obj_new_bytes_from_vstr(&vstr);
 }
+
+#if MICROPY_PY_HASHLIB_SHA256_MANY
+static void hashlib_sha256_oneshot(const mp_buffer_info_t *bufinfo, byte *digest) {
+    CRYAL_SHA256_CTX ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, bufinfo->buf, bufinfo->len);
+    sha256_final(&ctx, digest);
+}
+#endif
+#endif
+
+#if MICROPY_PY_HASHLIB_SHA256_MANY
+// Hashes each buffer in a list or tuple on its own and returns a list of the
+// digests, without creating a hash object per buffer.
+static mp_obj_t hashlib_sha256_many(mp_obj_t buffers_in) {
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_get_array(buffers_in, &n, &items);
+    mp_obj_list_t *digests = MP_OBJ_TO_PTR(mp_obj_new_list(n, NULL));
+    byte digest[32];
+    size_t i = 0;
+
+    #ifdef CRYAL_SHA256_LANES
+    // Hash the whole blocks common to each group of four buffers in parallel,
+    // then finish each buffer on its own.
+    for (; i + 4 <= n; i += 4) {
+        mp_buffer_info_t bufinfo[4];
+        CRYAL_SHA256_CTX ctx[4];
+        CRYAL_SHA256_CTX *ctx_ptr[4];
+        const byte *data[4];
+        size_t nblocks = SIZE_MAX;
+        for (size_t j = 0; j < 4; ++j) {
+            mp_get_buffer_raise(items[i + j], &bufinfo[j], MP_BUFFER_READ);
+            sha256_init(&ctx[j]);
+            ctx_ptr[j] = &ctx[j];
+            data[j] = bufinfo[j].buf;
+            nblocks = MIN(nblocks, bufinfo[j].len / 64);
+        }
+        if (nblocks > 0) {
+            sha256_update_x4(ctx_ptr, data, nblocks);
+        }
+        for (size_t j = 0; j < 4; ++j) {
+            sha256_update(&ctx[j], data[j] + nblocks * 64, bufinfo[j].len - nblocks * 64);
+            sha256_final(&ctx[j], digest);
+            digests->items[i + j] = mp_obj_new_bytes(digest, sizeof(digest));
+        }
+    }
+    #endif
+
+    for (; i < n; ++i) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(items[i], &bufinfo, MP_BUFFER_READ);
+        hashlib_sha256_oneshot(&bufinfo, digest);
+        digests->items[i] = mp_obj_new_bytes(digest, sizeof(digest));
+    }
+    return MP_OBJ_FROM_PTR(digests);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(hashlib_sha256_many_obj, hashlib_sha256_many);
 #endif
 
 static MP_DEFINE_CONST_FUN_OBJ_2(hashlib_sha256_update_obj, hashlib_sha256_update);
@@ -358,6 +440,9 @@ static const mp_rom_map_elem_t mp_module_hashlib_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_hashlib) },
     #if MICROPY_PY_HASHLIB_SHA256
     { MP_ROM_QSTR(MP_QSTR_sha256), MP_ROM_PTR(&hashlib_sha256_type) },
+    #if MICROPY_PY_HASHLIB_SHA256_MANY
+    { MP_ROM_QSTR(MP_QSTR_sha256_many), MP_ROM_PTR(&hashlib_sha256_many_obj) },
+    #endif
     #endif
     #if MICROPY_PY_HASHLIB_SHA1
     { MP_ROM_QSTR(MP_QSTR_sha1), MP_ROM_PTR(&hashlib_sha1_type) },
@@ -159,6 +159,131 @@ mp_import_stat_t mp_vfs_import_stat(const char *path) {
     }
 }
 
+#if MICROPY_VFS_DIR_CACHE
+
+// Each cached listing is one of these states, then the directory's path and a
+// nul.  A complete listing follows that with an entry for each name in the
+// directory: the name's mp_import_stat_t, then the name and a nul.  It ends
+// with a nul.
+#define DIR_CACHE_LISTED 'L'
+#define DIR_CACHE_NO_DIR 'N'
+#define DIR_CACHE_TOO_BIG 'B'
+
+static bool dir_cache_name_eq(const char *a, const char *b, bool nocase) {
+    if (!nocase) {
+        return strcmp(a, b) == 0;
+    }
+    for (; *a != '\0' && unichar_tolower((uint8_t)*a) == unichar_tolower((uint8_t)*b); ++a, ++b) {
+    }
+    return *a == *b;
+}
+
+static int dir_cache_find(const char *listing, const char *name, bool nocase) {
+    if (listing[0] == DIR_CACHE_NO_DIR) {
+        return MP_IMPORT_STAT_NO_EXIST;
+    } else if (listing[0] == DIR_CACHE_TOO_BIG) {
+        return -1;
+    }
+    for (const char *p = listing + strlen(listing) + 1; *p != '\0'; p += strlen(p) + 1) {
+        int stat = *p++;
+        if (dir_cache_name_eq(p, name, nocase)) {
+            return stat;
+        }
+    }
+    return MP_IMPORT_STAT_NO_EXIST;
+}
+
+// Look up a path in the cached listing of its directory, first listing the
+// directory with the given function if it isn't cached and list isn't NULL.
+// FAT passes nocase because its names are case-insensitive.  Returns an
+// mp_import_stat_t, or -1 if the cache can't say whether the path exists.
+int mp_vfs_dir_cache_lookup(mp_vfs_dir_cache_t *cache, const char *path, bool nocase, mp_vfs_dir_cache_list_t list, void *self) {
+    const char *name = strrchr(path, '/');
+    size_t dir_len = 0;
+    if (name == NULL) {
+        name = path;
+    } else {
+        dir_len = name == path ? 1 : name - path;
+        ++name;
+    }
+    if (name[0] == '\0' || (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))) {
+        return -1;
+    }
+    if (nocase) {
+        // Only ASCII letters are compared case-insensitively, and FAT also
+        // ignores trailing dots and spaces, so leave other names to the
+        // filesystem.
+        for (const char *p = name; *p != '\0'; ++p) {
+            if ((uint8_t)*p >= 0x80 || ((p[0] == '.' || p[0] == ' ') && p[1] == '\0')) {
+                return -1;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < MP_VFS_DIR_CACHE_NUM; ++i) {
+        char *listing = cache->listing[i];
+        if (listing != NULL && strncmp(listing + 1, path, dir_len) == 0 && listing[1 + dir_len] == '\0') {
+            size_t alloc = cache->alloc[i];
+            memmove(&cache->listing[1], &cache->listing[0], i * sizeof(char *));
+            memmove(&cache->alloc[1], &cache->alloc[0], i * sizeof(size_t));
+            cache->listing[0] = listing;
+            cache->alloc[0] = alloc;
+            return dir_cache_find(listing, name, nocase);
+        }
+    }
+    if (list == NULL) {
+        return -1;
+    }
+
+    vstr_t listing;
+    vstr_init(&listing, dir_len + 32);
+    vstr_add_byte(&listing, DIR_CACHE_LISTED);
+    vstr_add_strn(&listing, path, dir_len);
+    vstr_add_byte(&listing, '\0');
+    int ret = list(self, listing.buf + 1, &listing);
+    if (ret == -MP_ENOENT || (ret == 0 && listing.len > MICROPY_VFS_DIR_CACHE_MAX_LEN)) {
+        // Remember that the directory doesn't exist or is too big to cache,
+        // so that it isn't listed again.
+        listing.buf[0] = ret == 0 ? DIR_CACHE_TOO_BIG : DIR_CACHE_NO_DIR;
+        listing.len = dir_len + 2;
+    } else if (ret == 0) {
+        vstr_add_byte(&listing, '\0');
+    } else {
+        vstr_clear(&listing);
+        return -1;
+    }
+
+    size_t last = MP_VFS_DIR_CACHE_NUM - 1;
+    if (cache->listing[last] != NULL) {
+        m_del(char, cache->listing[last], cache->alloc[last]);
+    }
+    memmove(&cache->listing[1], &cache->listing[0], last * sizeof(char *));
+    memmove(&cache->alloc[1], &cache->alloc[0], last * sizeof(size_t));
+    cache->listing[0] = m_renew(char, listing.buf, listing.alloc, listing.len);
+    cache->alloc[0] = listing.len;
+    return dir_cache_find(cache->listing[0], name, nocase);
+}
+
+// Add a name to a listing, returning false if the listing is now too big to
+// cache and the rest of the directory needn't be listed.
+bool mp_vfs_dir_cache_add(vstr_t *listing, const char *name, mp_import_stat_t stat) {
+    vstr_add_byte(listing, stat);
+    vstr_add_strn(listing, name, strlen(name) + 1);
+    return listing->len <= MICROPY_VFS_DIR_CACHE_MAX_LEN;
+}
+
+// Forget all cached listings, when the filesystem changes.
+void mp_vfs_dir_cache_clear(mp_vfs_dir_cache_t *cache) {
+    for (size_t i = 0; i < MP_VFS_DIR_CACHE_NUM; ++i) {
+        if (cache->listing[i] != NULL) {
+            m_del(char, cache->listing[i], cache->alloc[i]);
+            cache->listing[i] = NULL;
+        }
+    }
+}
+
+#endif // MICROPY_VFS_DIR_CACHE
+
 static mp_obj_t mp_vfs_autodetect(mp_obj_t bdev_obj) {
     #if MICROPY_VFS_LFS1 || MICROPY_VFS_LFS2
     nlr_buf_t nlr;
@@ -43,6 +43,7 @@
 #define MP_BLOCKDEV_FLAG_FREE_OBJ       (0x0002) // fs_user_mount_t obj should be freed on umount
 #define MP_BLOCKDEV_FLAG_HAVE_IOCTL     (0x0004) // new protocol with ioctl
 #define MP_BLOCKDEV_FLAG_NO_FILESYSTEM  (0x0008) // the block device has no filesystem on it
+#define MP_BLOCKDEV_FLAG_READ_AHEAD     (0x0010) // reads of several blocks work, so the cache can read ahead
 
 // constants for block protocol ioctl
 #define MP_BLOCKDEV_IOCTL_INIT          (1)
@@ -57,6 +58,19 @@ typedef struct _mp_vfs_proto_t {
     mp_import_stat_t (*import_stat)(void *self, const char *path);
 } mp_vfs_proto_t;
 
+#if MICROPY_VFS_BLOCKDEV_CACHE
+typedef struct _mp_vfs_blockdev_cache_t {
+    uint8_t *data; // the cached blocks, or NULL if not allocated yet
+    size_t block_size; // block size that data was allocated for
+    size_t block_count; // number of blocks on the device, or 0 if unknown
+    size_t next_read; // block after the last one read from the device
+    size_t tick; // incremented on each access, for LRU replacement
+    size_t block[MICROPY_VFS_BLOCKDEV_CACHE_BLOCKS]; // block number of each slot
+    size_t used[MICROPY_VFS_BLOCKDEV_CACHE_BLOCKS]; // tick of the last access to each slot
+    bool dirty[MICROPY_VFS_BLOCKDEV_CACHE_BLOCKS];
+} mp_vfs_blockdev_cache_t;
+#endif
+
 typedef struct _mp_vfs_blockdev_t {
     uint16_t flags;
     size_t block_size;
@@ -70,8 +84,28 @@ typedef struct _mp_vfs_blockdev_t {
             mp_obj_t count[2];
         } old;
     } u;
+    #if MICROPY_VFS_BLOCKDEV_CACHE
+    mp_vfs_blockdev_cache_t cache;
+    #endif
 } mp_vfs_blockdev_t;
 
+#if MICROPY_VFS_DIR_CACHE
+// Number of directory listings cached by each filesystem
+#define MP_VFS_DIR_CACHE_NUM (2)
+
+// Cached directory listings, most recently used first.  Zero-initialised
+// memory is an empty cache.
+typedef struct _mp_vfs_dir_cache_t {
+    char *listing[MP_VFS_DIR_CACHE_NUM];
+    size_t alloc[MP_VFS_DIR_CACHE_NUM];
+} mp_vfs_dir_cache_t;
+
+// Function provided by a filesystem to list a directory into the cache with
+// mp_vfs_dir_cache_add.  It returns 0 on success or a negative errno, and dir
+// is only valid until the first entry is added.
+typedef int (*mp_vfs_dir_cache_list_t)(void *self, const char *dir, vstr_t *listing);
+#endif
+
 typedef struct _mp_vfs_mount_t {
     const char *str; // mount point with leading /
     size_t len;
@@ -85,6 +119,15 @@ int mp_vfs_blockdev_read_ext(mp_vfs_blockdev_t *self, size_t block_num, size_t b
 int mp_vfs_blockdev_write(mp_vfs_blockdev_t *self, size_t block_num, size_t num_blocks, const uint8_t *buf);
 int mp_vfs_blockdev_write_ext(mp_vfs_blockdev_t *self, size_t block_num, size_t block_off, size_t len, const uint8_t *buf);
 mp_obj_t mp_vfs_blockdev_ioctl(mp_vfs_blockdev_t *self, uintptr_t cmd, uintptr_t arg);
+#if MICROPY_VFS_BLOCKDEV_CACHE
+int mp_vfs_blockdev_flush(mp_vfs_blockdev_t *self);
+#endif
+
+#if MICROPY_VFS_DIR_CACHE
+int mp_vfs_dir_cache_lookup(mp_vfs_dir_cache_t *cache, const char *path, bool nocase, mp_vfs_dir_cache_list_t list, void *self);
+bool mp_vfs_dir_cache_add(vstr_t *listing, const char *name, mp_import_stat_t stat);
+void mp_vfs_dir_cache_clear(mp_vfs_dir_cache_t *cache);
+#endif
 
 mp_vfs_mount_t *mp_vfs_lookup_path(const char *path, const char **path_out);
 mp_import_stat_t mp_vfs_import_stat(const char *path);
@@ -32,6 +32,11 @@
 
 #if MICROPY_VFS
 
+#if MICROPY_VFS_BLOCKDEV_CACHE
+#define CACHE_NUM_BLOCKS (MICROPY_VFS_BLOCKDEV_CACHE_BLOCKS)
+#define CACHE_EMPTY ((size_t)-1)
+#endif
+
 void mp_vfs_blockdev_init(mp_vfs_blockdev_t *self, mp_obj_t bdev) {
     mp_load_method(bdev, MP_QSTR_readblocks, self->readblocks);
     mp_load_method_maybe(bdev, MP_QSTR_writeblocks, self->writeblocks);
@@ -44,9 +49,12 @@ void mp_vfs_blockdev_init(mp_vfs_blockdev_t *self, mp_obj_t bdev) {
         mp_load_method_maybe(bdev, MP_QSTR_sync, self->u.old.sync);
         mp_load_method(bdev, MP_QSTR_count, self->u.old.count);
     }
+    #if MICROPY_VFS_BLOCKDEV_CACHE
+    self->cache.data = NULL;
+    #endif
 }
 
-int mp_vfs_blockdev_read(mp_vfs_blockdev_t *self, size_t block_num, size_t num_blocks, uint8_t *buf) {
+static int blockdev_read(mp_vfs_blockdev_t *self, size_t block_num, size_t num_blocks, uint8_t *buf) {
     if (self->flags & MP_BLOCKDEV_FLAG_NATIVE) {
         mp_uint_t (*f)(uint8_t *, uint32_t, uint32_t) = (void *)(uintptr_t)self->readblocks[2];
         return f(buf, block_num, num_blocks);
@@ -73,7 +81,7 @@ int mp_vfs_blockdev_read_ext(mp_vfs_blockdev_t *self, size_t block_num, size_t b
     }
 }
 
-int mp_vfs_blockdev_write(mp_vfs_blockdev_t *self, size_t block_num, size_t num_blocks, const uint8_t *buf) {
+static int blockdev_write(mp_vfs_blockdev_t *self, size_t block_num, size_t num_blocks, const uint8_t *buf) {
     if (self->writeblocks[0] == MP_OBJ_NULL) {
         // read-only block device
         return -MP_EROFS;
@@ -110,7 +118,7 @@ int mp_vfs_blockdev_write_ext(mp_vfs_blockdev_t *self, size_t block_num, size_t
     }
 }
 
-mp_obj_t mp_vfs_blockdev_ioctl(mp_vfs_blockdev_t *self, uintptr_t cmd, uintptr_t arg) {
+static mp_obj_t blockdev_ioctl(mp_vfs_blockdev_t *self, uintptr_t cmd, uintptr_t arg) {
     if (self->flags & MP_BLOCKDEV_FLAG_HAVE_IOCTL) {
         // New protocol with ioctl
         self->u.ioctl[2] = MP_OBJ_NEW_SMALL_INT(cmd);
@@ -140,4 +148,292 @@ mp_obj_t mp_vfs_blockdev_ioctl(mp_vfs_blockdev_t *self, uintptr_t cmd, uintptr_t
     }
 }
 
+#if MICROPY_VFS_BLOCKDEV_CACHE
+
+// The cache holds up to CACHE_NUM_BLOCKS blocks in slots of a single buffer,
+// for reads and writes of whole blocks (as FAT does).  Written blocks are kept
+// dirty in the cache until the device is synced or their slot is needed, and
+// are then written back in runs of adjacent blocks.  A read that misses the
+// cache straight after the previous miss reads several blocks ahead, into
+// adjacent slots, so later reads of the blocks that follow can hit.  Reads and
+// writes with the extended protocol (as littlefs does, which has its own
+// caches) go straight to the device.
+
+static void blockdev_cache_init(mp_vfs_blockdev_t *self) {
+    mp_vfs_blockdev_cache_t *cache = &self->cache;
+    cache->data = NULL;
+    cache->block_size = 0;
+    cache->block_count = 0;
+    cache->next_read = CACHE_EMPTY;
+    cache->tick = 0;
+    for (size_t i = 0; i < CACHE_NUM_BLOCKS; ++i) {
+        cache->block[i] = CACHE_EMPTY;
+        cache->used[i] = 0;
+        cache->dirty[i] = false;
+    }
+}
+
+static inline uint8_t *blockdev_cache_slot(mp_vfs_blockdev_t *self, size_t i) {
+    return self->cache.data + i * self->block_size;
+}
+
+static int blockdev_cache_find(mp_vfs_blockdev_t *self, size_t block_num) {
+    for (size_t i = 0; i < CACHE_NUM_BLOCKS; ++i) {
+        if (self->cache.block[i] == block_num) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Write back all dirty blocks, each run of adjacent blocks that are in
+// adjacent slots with one write, in order of block number.
+static int blockdev_cache_flush(mp_vfs_blockdev_t *self) {
+    mp_vfs_blockdev_cache_t *cache = &self->cache;
+    for (;;) {
+        size_t i = CACHE_NUM_BLOCKS;
+        for (size_t j = 0; j < CACHE_NUM_BLOCKS; ++j) {
+            if (cache->dirty[j] && (i == CACHE_NUM_BLOCKS || cache->block[j] < cache->block[i])) {
+                i = j;
+            }
+        }
+        if (i == CACHE_NUM_BLOCKS) {
+            return 0;
+        }
+        size_t n = 1;
+        while (i + n < CACHE_NUM_BLOCKS && cache->dirty[i + n] && cache->block[i + n] == cache->block[i] + n) {
+            ++n;
+        }
+        int ret = blockdev_write(self, cache->block[i], n, blockdev_cache_slot(self, i));
+        if (ret != 0) {
+            return ret;
+        }
+        memset(&cache->dirty[i], false, n * sizeof(bool));
+    }
+}
+
+// Allocate the cache if needed, returning false if it can't be used.
+static bool blockdev_cache_ready(mp_vfs_blockdev_t *self) {
+    mp_vfs_blockdev_cache_t *cache = &self->cache;
+    if (cache->data != NULL && cache->block_size == self->block_size) {
+        return true;
+    }
+    if (cache->data != NULL) {
+        // The filesystem changed the block size, so write back the blocks
+        // cached with the old size and start again.
+        size_t block_size = self->block_size;
+        self->block_size = cache->block_size;
+        int ret = blockdev_cache_flush(self);
+        self->block_size = block_size;
+        if (ret != 0) {
+            return false;
+        }
+        m_del(uint8_t, cache->data, CACHE_NUM_BLOCKS * cache->block_size);
+    }
+    blockdev_cache_init(self);
+    cache->data = m_new_maybe(uint8_t, CACHE_NUM_BLOCKS * self->block_size);
+    if (cache->data == NULL) {
+        return false;
+    }
+    cache->block_size = self->block_size;
+    // The block count limits how far ahead sequential reads can read.
+    mp_obj_t ret = blockdev_ioctl(self, MP_BLOCKDEV_IOCTL_BLOCK_COUNT, 0);
+    if (mp_obj_is_small_int(ret)) {
+        cache->block_count = MP_OBJ_SMALL_INT_VALUE(ret);
+    }
+    return true;
+}
+
+// Choose n adjacent slots to replace, and empty them.  The slots chosen are
+// those whose most recent use is the oldest, preferring the slot after the
+// one holding the previous block, so that runs of blocks stay together.
+static int blockdev_cache_evict(mp_vfs_blockdev_t *self, size_t block_num, size_t n, size_t *slot) {
+    mp_vfs_blockdev_cache_t *cache = &self->cache;
+    size_t best = 0;
+    size_t best_used = (size_t)-1;
+    for (size_t i = 0; i + n <= CACHE_NUM_BLOCKS; ++i) {
+        size_t used = 0;
+        for (size_t j = i; j < i + n; ++j) {
+            used = MAX(used, cache->block[j] == CACHE_EMPTY ? 0 : cache->used[j]);
+        }
+        if (used < best_used) {
+            best = i;
+            best_used = used;
+        }
+    }
+    int prev = block_num > 0 ? blockdev_cache_find(self, block_num - 1) : -1;
+    if (prev >= 0 && prev + n < CACHE_NUM_BLOCKS) {
+        size_t used = 0;
+        for (size_t j = prev + 1; j <= prev + n; ++j) {
+            used = MAX(used, cache->block[j] == CACHE_EMPTY ? 0 : cache->used[j]);
+        }
+        if (used <= cache->used[prev]) {
+            best = prev + 1;
+        }
+    }
+    for (size_t j = best; j < best + n; ++j) {
+        if (cache->dirty[j]) {
+            // Write back everything, so that adjacent blocks are written together.
+            int ret = blockdev_cache_flush(self);
+            if (ret != 0) {
+                return ret;
+            }
+            break;
+        }
+    }
+    for (size_t j = best; j < best + n; ++j) {
+        cache->block[j] = CACHE_EMPTY;
+    }
+    *slot = best;
+    return 0;
+}
+
+// Find the slot holding a block, reading it into the cache if needed.
+static int blockdev_cache_get(mp_vfs_blockdev_t *self, size_t block_num, size_t *slot) {
+    mp_vfs_blockdev_cache_t *cache = &self->cache;
+    int i = blockdev_cache_find(self, block_num);
+    if (i >= 0) {
+        cache->used[i] = ++cache->tick;
+        *slot = i;
+        return 0;
+    }
+
+    // Read ahead if this continues on from the previous read of the device,
+    // up to the next block that's already cached.
+    size_t n = 1;
+    if (block_num == cache->next_read && (self->flags & (MP_BLOCKDEV_FLAG_NATIVE | MP_BLOCKDEV_FLAG_READ_AHEAD))) {
+        size_t max_n = MIN(MICROPY_VFS_BLOCKDEV_CACHE_READAHEAD, CACHE_NUM_BLOCKS / 2);
+        if (cache->block_count > block_num) {
+            max_n = MIN(max_n, cache->block_count - block_num);
+        } else {
+            max_n = 1;
+        }
+        while (n < max_n && blockdev_cache_find(self, block_num + n) < 0) {
+            ++n;
+        }
+    }
+
+    int ret = blockdev_cache_evict(self, block_num, n, slot);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = blockdev_read(self, block_num, n, blockdev_cache_slot(self, *slot));
+    if (ret != 0) {
+        return ret;
+    }
+    ++cache->tick;
+    for (size_t j = 0; j < n; ++j) {
+        cache->block[*slot + j] = block_num + j;
+        cache->used[*slot + j] = cache->tick;
+        cache->dirty[*slot + j] = false;
+    }
+    cache->next_read = block_num + n;
+    return 0;
+}
+
+// Update the cached copies of blocks that were read from or written to the
+// device directly.  After a read, the cached copies of dirty blocks replace
+// the data read.  After a write, the cached copies match the device.
+static void blockdev_cache_sync_blocks(mp_vfs_blockdev_t *self, size_t block_num, size_t num_blocks, uint8_t *buf, bool write) {
+    mp_vfs_blockdev_cache_t *cache = &self->cache;
+    for (size_t i = 0; i < CACHE_NUM_BLOCKS; ++i) {
+        size_t b = cache->block[i] - block_num;
+        if (cache->block[i] != CACHE_EMPTY && b < num_blocks) {
+            if (write) {
+                memcpy(blockdev_cache_slot(self, i), buf + b * self->block_size, self->block_size);
+                cache->dirty[i] = false;
+            } else if (cache->dirty[i]) {
+                memcpy(buf + b * self->block_size, blockdev_cache_slot(self, i), self->block_size);
+            }
+        }
+    }
+}
+
+int mp_vfs_blockdev_flush(mp_vfs_blockdev_t *self) {
+    return blockdev_cache_flush(self);
+}
+
+#endif // MICROPY_VFS_BLOCKDEV_CACHE
+
+int mp_vfs_blockdev_read(mp_vfs_blockdev_t *self, size_t block_num, size_t num_blocks, uint8_t *buf) {
+    #if MICROPY_VFS_BLOCKDEV_CACHE
+    if (num_blocks <= CACHE_NUM_BLOCKS / 2 && blockdev_cache_ready(self)) {
+        for (; num_blocks; --num_blocks, ++block_num, buf += self->block_size) {
+            size_t slot;
+            int ret = blockdev_cache_get(self, block_num, &slot);
+            if (ret != 0) {
+                return ret;
+            }
+            memcpy(buf, blockdev_cache_slot(self, slot), self->block_size);
+        }
+        return 0;
+    }
+    if (self->cache.data != NULL) {
+        // Too many blocks to cache, so read them directly.
+        int ret = blockdev_read(self, block_num, num_blocks, buf);
+        if (ret == 0) {
+            // The device reads several blocks at once, so the cache can too.
+            self->flags |= MP_BLOCKDEV_FLAG_READ_AHEAD;
+            blockdev_cache_sync_blocks(self, block_num, num_blocks, buf, false);
+        }
+        return ret;
+    }
+    #endif
+    return blockdev_read(self, block_num, num_blocks, buf);
+}
+
+int mp_vfs_blockdev_write(mp_vfs_blockdev_t *self, size_t block_num, size_t num_blocks, const uint8_t *buf) {
+    if (self->writeblocks[0] == MP_OBJ_NULL) {
+        // read-only block device
+        return -MP_EROFS;
+    }
+
+    #if MICROPY_VFS_BLOCKDEV_CACHE
+    if (num_blocks <= CACHE_NUM_BLOCKS / 2 && blockdev_cache_ready(self)) {
+        mp_vfs_blockdev_cache_t *cache = &self->cache;
+        for (; num_blocks; --num_blocks, ++block_num, buf += self->block_size) {
+            // The whole block is written, so it doesn't need to be read first.
+            int slot = blockdev_cache_find(self, block_num);
+            if (slot < 0) {
+                size_t new_slot;
+                int ret = blockdev_cache_evict(self, block_num, 1, &new_slot);
+                if (ret != 0) {
+                    return ret;
+                }
+                slot = new_slot;
+                cache->block[slot] = block_num;
+            }
+            memcpy(blockdev_cache_slot(self, slot), buf, self->block_size);
+            cache->used[slot] = ++cache->tick;
+            cache->dirty[slot] = true;
+        }
+        return 0;
+    }
+    if (self->cache.data != NULL) {
+        // Too many blocks to cache, so write them directly.
+        int ret = blockdev_write(self, block_num, num_blocks, buf);
+        if (ret == 0) {
+            blockdev_cache_sync_blocks(self, block_num, num_blocks, (uint8_t *)buf, true);
+        }
+        return ret;
+    }
+    #endif
+    return blockdev_write(self, block_num, num_blocks, buf);
+}
+
+
+mp_obj_t mp_vfs_blockdev_ioctl(mp_vfs_blockdev_t *self, uintptr_t cmd, uintptr_t arg) {
+    #if MICROPY_VFS_BLOCKDEV_CACHE
+    if (self->cache.data != NULL) {
+        if (cmd == MP_BLOCKDEV_IOCTL_SYNC || cmd == MP_BLOCKDEV_IOCTL_DEINIT) {
+            int ret = blockdev_cache_flush(self);
+            if (ret != 0) {
+                return MP_OBJ_NEW_SMALL_INT(ret);
+            }
+        }
+    }
+    #endif
+    return blockdev_ioctl(self, cmd, arg);
+}
+
 #endif // MICROPY_VFS
@@ -51,10 +51,47 @@
 
 #define mp_obj_fat_vfs_t fs_user_mount_t
 
+#if MICROPY_VFS_DIR_CACHE
+static int fat_vfs_list_dir(void *vfs_in, const char *dir, vstr_t *listing) {
+    fs_user_mount_t *vfs = vfs_in;
+    FF_DIR d;
+    FRESULT res = f_opendir(&vfs->fatfs, &d, dir);
+    if (res != FR_OK) {
+        return -fresult_to_errno_table[res];
+    }
+    for (;;) {
+        FILINFO fno;
+        res = f_readdir(&d, &fno);
+        if (res != FR_OK || fno.fname[0] == 0) {
+            break;
+        }
+        mp_import_stat_t stat = (fno.fattrib & AM_DIR) ? MP_IMPORT_STAT_DIR : MP_IMPORT_STAT_FILE;
+        if (!mp_vfs_dir_cache_add(listing, fno.fname, stat)) {
+            break;
+        }
+        #if FF_USE_LFN
+        // The short name can be used to open the entry too.  It only differs
+        // from the long name by more than case when it has a numbered tail.
+        if (strchr(fno.altname, '~') != NULL && !mp_vfs_dir_cache_add(listing, fno.altname, stat)) {
+            break;
+        }
+        #endif
+    }
+    f_closedir(&d);
+    return res == FR_OK ? 0 : -fresult_to_errno_table[res];
+}
+#endif
+
 static mp_import_stat_t fat_vfs_import_stat(void *vfs_in, const char *path) {
     fs_user_mount_t *vfs = vfs_in;
     FILINFO fno;
     assert(vfs != NULL);
+    #if MICROPY_VFS_DIR_CACHE
+    int stat = mp_vfs_dir_cache_lookup(&vfs->dir_cache, path, true, fat_vfs_list_dir, vfs);
+    if (stat >= 0) {
+        return stat;
+    }
+    #endif
     FRESULT res = f_stat(&vfs->fatfs, path, &fno);
     if (res == FR_OK) {
         if ((fno.fattrib & AM_DIR) != 0) {
@@ -72,6 +109,9 @@ static mp_obj_t fat_vfs_make_new(const mp_obj_type_t *type, size_t n_args, size_
     // create new object
     fs_user_mount_t *vfs = mp_obj_malloc(fs_user_mount_t, type);
     vfs->fatfs.drv = vfs;
+    #if MICROPY_VFS_DIR_CACHE
+    memset(&vfs->dir_cache, 0, sizeof(vfs->dir_cache));
+    #endif
 
     // Initialise underlying block device
     vfs->blockdev.flags = MP_BLOCKDEV_FLAG_FREE_OBJ;
@@ -214,6 +254,9 @@ static mp_obj_t fat_vfs_remove_internal(mp_obj_t vfs_in, mp_obj_t path_in, mp_in
 
     // check if path is a file or directory
     if ((fno.fattrib & AM_DIR) == attr) {
+        #if MICROPY_VFS_DIR_CACHE
+        mp_vfs_dir_cache_clear(&self->dir_cache);
+        #endif
         res = f_unlink(&self->fatfs, path);
 
         if (res != FR_OK) {
@@ -239,6 +282,9 @@ static mp_obj_t fat_vfs_rename(mp_obj_t vfs_in, mp_obj_t path_in, mp_obj_t path_
     mp_obj_fat_vfs_t *self = MP_OBJ_TO_PTR(vfs_in);
     const char *old_path = mp_obj_str_get_str(path_in);
     const char *new_path = mp_obj_str_get_str(path_out);
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
     FRESULT res = f_rename(&self->fatfs, old_path, new_path);
     if (res == FR_EXIST) {
         // if new_path exists then try removing it (but only if it's a file)
@@ -258,6 +304,9 @@ static MP_DEFINE_CONST_FUN_OBJ_3(fat_vfs_rename_obj, fat_vfs_rename);
 static mp_obj_t fat_vfs_mkdir(mp_obj_t vfs_in, mp_obj_t path_o) {
     mp_obj_fat_vfs_t *self = MP_OBJ_TO_PTR(vfs_in);
     const char *path = mp_obj_str_get_str(path_o);
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
     FRESULT res = f_mkdir(&self->fatfs, path);
     if (res == FR_OK) {
         return mp_const_none;
@@ -273,6 +322,11 @@ static mp_obj_t fat_vfs_chdir(mp_obj_t vfs_in, mp_obj_t path_in) {
     const char *path;
     path = mp_obj_str_get_str(path_in);
 
+    #if MICROPY_VFS_DIR_CACHE
+    // cached listings of relative paths are of the old current directory
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
+
     FRESULT res = f_chdir(&self->fatfs, path);
 
     if (res != FR_OK) {
@@ -308,6 +362,12 @@ static mp_obj_t fat_vfs_stat(mp_obj_t vfs_in, mp_obj_t path_in) {
         fno.ftime = 0;
         fno.fattrib = AM_DIR;
     } else {
+        #if MICROPY_VFS_DIR_CACHE
+        // a path that isn't in its directory's cached listing doesn't exist
+        if (mp_vfs_dir_cache_lookup(&self->dir_cache, path, true, NULL, NULL) == MP_IMPORT_STAT_NO_EXIST) {
+            mp_raise_OSError(MP_ENOENT);
+        }
+        #endif
         FRESULT res = f_stat(&self->fatfs, path, &fno);
         if (res != FR_OK) {
             mp_raise_OSError(fresult_to_errno_table[res]);
@@ -387,6 +447,9 @@ static mp_obj_t vfs_fat_mount(mp_obj_t self_in, mp_obj_t readonly, mp_obj_t mkfs
     // check if we need to make the filesystem
     FRESULT res = (self->blockdev.flags & MP_BLOCKDEV_FLAG_NO_FILESYSTEM) ? FR_NO_FILESYSTEM : FR_OK;
     if (res == FR_NO_FILESYSTEM && mp_obj_is_true(mkfs)) {
+        #if MICROPY_VFS_DIR_CACHE
+        mp_vfs_dir_cache_clear(&self->dir_cache);
+        #endif
         uint8_t working_buf[FF_MAX_SS];
         res = f_mkfs(&self->fatfs, FM_FAT | FM_SFD, 0, working_buf, sizeof(working_buf));
     }
@@ -400,7 +463,20 @@ static mp_obj_t vfs_fat_mount(mp_obj_t self_in, mp_obj_t readonly, mp_obj_t mkfs
 static MP_DEFINE_CONST_FUN_OBJ_3(vfs_fat_mount_obj, vfs_fat_mount);
 
 static mp_obj_t vfs_fat_umount(mp_obj_t self_in) {
+    #if MICROPY_VFS_DIR_CACHE || MICROPY_VFS_BLOCKDEV_CACHE
+    fs_user_mount_t *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
+    #if MICROPY_VFS_BLOCKDEV_CACHE
+    // write back any blocks still in the cache, failing like a FatFs sync does
+    if (mp_vfs_blockdev_flush(&self->blockdev) != 0) {
+        mp_raise_OSError(MP_EIO);
+    }
+    #endif
+    #else
     (void)self_in;
+    #endif
     // keep the FAT filesystem mounted internally so the VFS methods can still be used
     return mp_const_none;
 }
@@ -34,6 +34,9 @@ typedef struct _fs_user_mount_t {
     mp_obj_base_t base;
     mp_vfs_blockdev_t blockdev;
     FATFS fatfs;
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_t dir_cache;
+    #endif
 } fs_user_mount_t;
 
 extern const byte fresult_to_errno_table[20];
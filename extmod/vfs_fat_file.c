@@ -228,6 +228,13 @@ static mp_obj_t fat_vfs_open(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mode_i
         }
     }
 
+    #if MICROPY_VFS_DIR_CACHE
+    if (mode & (FA_CREATE_ALWAYS | FA_CREATE_NEW | FA_OPEN_ALWAYS)) {
+        // the file may be created
+        mp_vfs_dir_cache_clear(&self->dir_cache);
+    }
+    #endif
+
     pyb_file_obj_t *o = mp_obj_malloc_with_finaliser(pyb_file_obj_t, type);
 
     const char *fname = mp_obj_str_get_str(path_in);
@@ -62,6 +62,9 @@ typedef struct _mp_obj_vfs_lfs1_t {
     vstr_t cur_dir;
     struct lfs1_config config;
     lfs1_t lfs;
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_t dir_cache;
+    #endif
 } mp_obj_vfs_lfs1_t;
 
 typedef struct _mp_obj_vfs_lfs1_file_t {
@@ -112,6 +115,9 @@ typedef struct _mp_obj_vfs_lfs2_t {
     vstr_t cur_dir;
     struct lfs2_config config;
     lfs2_t lfs;
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_t dir_cache;
+    #endif
 } mp_obj_vfs_lfs2_t;
 
 typedef struct _mp_obj_vfs_lfs2_file_t {
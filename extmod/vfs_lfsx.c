@@ -240,6 +240,9 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(MP_VFS_LFSx(ilistdir_obj), 1, 2, MP_V
 
 static mp_obj_t MP_VFS_LFSx(remove)(mp_obj_t self_in, mp_obj_t path_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
     const char *path = MP_VFS_LFSx(make_path)(self, path_in);
     int ret = LFSx_API(remove)(&self->lfs, path);
     if (ret < 0) {
@@ -251,6 +254,9 @@ static MP_DEFINE_CONST_FUN_OBJ_2(MP_VFS_LFSx(remove_obj), MP_VFS_LFSx(remove));
 
 static mp_obj_t MP_VFS_LFSx(rmdir)(mp_obj_t self_in, mp_obj_t path_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
     const char *path = MP_VFS_LFSx(make_path)(self, path_in);
     int ret = LFSx_API(remove)(&self->lfs, path);
     if (ret < 0) {
@@ -262,6 +268,9 @@ static MP_DEFINE_CONST_FUN_OBJ_2(MP_VFS_LFSx(rmdir_obj), MP_VFS_LFSx(rmdir));
 
 static mp_obj_t MP_VFS_LFSx(rename)(mp_obj_t self_in, mp_obj_t path_old_in, mp_obj_t path_new_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
     const char *path_old = MP_VFS_LFSx(make_path)(self, path_old_in);
     const char *path = mp_obj_str_get_str(path_new_in);
     vstr_t path_new;
@@ -281,6 +290,9 @@ static MP_DEFINE_CONST_FUN_OBJ_3(MP_VFS_LFSx(rename_obj), MP_VFS_LFSx(rename));
 
 static mp_obj_t MP_VFS_LFSx(mkdir)(mp_obj_t self_in, mp_obj_t path_o) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
     const char *path = MP_VFS_LFSx(make_path)(self, path_o);
     int ret = LFSx_API(mkdir)(&self->lfs, path);
     if (ret < 0) {
@@ -304,6 +316,11 @@ static mp_obj_t MP_VFS_LFSx(chdir)(mp_obj_t self_in, mp_obj_t path_in) {
         }
     }
 
+    #if MICROPY_VFS_DIR_CACHE
+    // Cached listings of relative paths are of the old current directory
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
+
     // Update cur_dir with new path
     if (path == vstr_str(&self->cur_dir)) {
         self->cur_dir.len = strlen(path);
@@ -371,6 +388,12 @@ static MP_DEFINE_CONST_FUN_OBJ_1(MP_VFS_LFSx(getcwd_obj), MP_VFS_LFSx(getcwd));
 
 static mp_obj_t MP_VFS_LFSx(stat)(mp_obj_t self_in, mp_obj_t path_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_VFS_DIR_CACHE
+    // A path that isn't in its directory's cached listing doesn't exist
+    if (mp_vfs_dir_cache_lookup(&self->dir_cache, mp_obj_str_get_str(path_in), false, NULL, NULL) == MP_IMPORT_STAT_NO_EXIST) {
+        mp_raise_OSError(MP_ENOENT);
+    }
+    #endif
     const char *path = MP_VFS_LFSx(make_path)(self, path_in);
     struct LFSx_API (info) info;
     int ret = LFSx_API(stat)(&self->lfs, path, &info);
@@ -461,6 +484,9 @@ static MP_DEFINE_CONST_FUN_OBJ_3(MP_VFS_LFSx(mount_obj), MP_VFS_LFSx(mount));
 
 static mp_obj_t MP_VFS_LFSx(umount)(mp_obj_t self_in) {
     MP_OBJ_VFS_LFSx *self = MP_OBJ_TO_PTR(self_in);
+    #if MICROPY_VFS_DIR_CACHE
+    mp_vfs_dir_cache_clear(&self->dir_cache);
+    #endif
     // LFS unmount never fails
     LFSx_API(unmount)(&self->lfs);
     return mp_const_none;
@@ -484,8 +510,47 @@ static const mp_rom_map_elem_t MP_VFS_LFSx(locals_dict_table)[] = {
 };
 static MP_DEFINE_CONST_DICT(MP_VFS_LFSx(locals_dict), MP_VFS_LFSx(locals_dict_table));
 
+#if MICROPY_VFS_DIR_CACHE
+static int MP_VFS_LFSx(list_dir)(void *self_in, const char *dir, vstr_t *listing) {
+    MP_OBJ_VFS_LFSx *self = self_in;
+    mp_obj_str_t path_obj = { { &mp_type_str }, 0, 0, (const byte *)dir };
+    dir = MP_VFS_LFSx(make_path)(self, MP_OBJ_FROM_PTR(&path_obj));
+    LFSx_API(dir_t) d;
+    int ret = LFSx_API(dir_open)(&self->lfs, &d, dir);
+    if (ret < 0) {
+        return ret;
+    }
+    // The directory must be closed even if adding to the listing raises.
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        struct LFSx_API (info) info;
+        while ((ret = LFSx_API(dir_read)(&self->lfs, &d, &info)) > 0) {
+            if (info.name[0] == '.' && (info.name[1] == '\0' || (info.name[1] == '.' && info.name[2] == '\0'))) {
+                continue;
+            }
+            mp_import_stat_t stat = info.type == LFSx_MACRO(_TYPE_REG) ? MP_IMPORT_STAT_FILE : MP_IMPORT_STAT_DIR;
+            if (!mp_vfs_dir_cache_add(listing, info.name, stat)) {
+                break;
+            }
+        }
+        nlr_pop();
+    } else {
+        LFSx_API(dir_close)(&self->lfs, &d);
+        nlr_jump(nlr.ret_val);
+    }
+    LFSx_API(dir_close)(&self->lfs, &d);
+    return ret < 0 ? ret : 0;
+}
+#endif
+
 static mp_import_stat_t MP_VFS_LFSx(import_stat)(void *self_in, const char *path) {
     MP_OBJ_VFS_LFSx *self = self_in;
+    #if MICROPY_VFS_DIR_CACHE
+    int stat = mp_vfs_dir_cache_lookup(&self->dir_cache, path, false, MP_VFS_LFSx(list_dir), self);
+    if (stat >= 0) {
+        return stat;
+    }
+    #endif
     struct LFSx_API (info) info;
     mp_obj_str_t path_obj = { { &mp_type_str }, 0, 0, (const byte *)path };
     path = MP_VFS_LFSx(make_path)(self, MP_OBJ_FROM_PTR(&path_obj));
@@ -112,6 +112,13 @@ mp_obj_t MP_VFS_LFSx(file_open)(mp_obj_t self_in, mp_obj_t path_in, mp_obj_t mod
     }
     #endif
 
+    #if MICROPY_VFS_DIR_CACHE
+    if (flags & LFSx_MACRO(_O_CREAT)) {
+        // The file may be created
+        mp_vfs_dir_cache_clear(&self->dir_cache);
+    }
+    #endif
+
     const char *path = MP_VFS_LFSx(make_path)(self, path_in);
     int ret = LFSx_API(file_opencfg)(&self->lfs, &o->file, path, flags, &o->cfg);
     if (ret < 0) {
@@ -0,0 +1,231 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 The MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/compile.h"
+#include "py/persistentcode.h"
+#include "py/reader.h"
+#include "py/runtime.h"
+#include "py/stream.h"
+#include "extmod/vfs.h"
+
+#if MICROPY_PERSISTENT_CODE_CACHE
+
+#if !MICROPY_PERSISTENT_CODE_SAVE
+#error "MICROPY_PERSISTENT_CODE_CACHE requires MICROPY_PERSISTENT_CODE_SAVE"
+#endif
+
+// The compiled code for a .py file is cached in the file <dir>/<name>.<hash>.mpy
+// where <dir> is MP_STATE_VM(persistent_code_cache_dir), <name> is the name of the
+// .py file without its extension and <hash> is a hash of its absolute path.  A
+// cache file contains a header identifying the source followed by the .mpy data:
+//  4 bytes "MPYC"
+//  uint    size of the source file
+//  uint    modification time of the source file
+//  uint    optimisation level
+//  uint    default emitter
+//  uint    length of the absolute path of the source file, followed by the path
+// The cache file is only used if its header matches, otherwise the source file is
+// compiled and the cache file replaced.
+
+static void mpycache_add_uint(vstr_t *vstr, mp_uint_t val) {
+    for (; val >= 0x80; val >>= 7) {
+        vstr_add_byte(vstr, 0x80 | (val & 0x7f));
+    }
+    vstr_add_byte(vstr, val);
+}
+
+// Append the components of the given path to vstr, each after a '/', dropping
+// empty and "." components and letting ".." remove the one before it.
+static void mpycache_add_path(vstr_t *vstr, const char *path, size_t len) {
+    const char *top = path + len;
+    while (path < top) {
+        const char *end = memchr(path, '/', top - path);
+        if (end == NULL) {
+            end = top;
+        }
+        size_t n = end - path;
+        if (n == 2 && path[0] == '.' && path[1] == '.') {
+            while (vstr->len > 0 && vstr->buf[--vstr->len] != '/') {
+            }
+        } else if (n != 0 && !(n == 1 && path[0] == '.')) {
+            vstr_add_char(vstr, '/');
+            vstr_add_strn(vstr, path, n);
+        }
+        path = end + 1;
+    }
+}
+
+// Fill in the expected cache file header and path for the given source file.
+static void mpycache_init(qstr source_file, vstr_t *header, vstr_t *cache_path) {
+    size_t len;
+    const char *src = (const char *)qstr_data(source_file, &len);
+
+    // Make the path absolute and normalised, so a source file has the same key
+    // whatever the cwd and however the path to it is spelt.
+    vstr_t abs_path;
+    vstr_init(&abs_path, MICROPY_ALLOC_PATH_MAX);
+    if (src[0] != '/') {
+        size_t cwd_len;
+        const char *cwd = mp_obj_str_get_data(mp_vfs_getcwd(), &cwd_len);
+        mpycache_add_path(&abs_path, cwd, cwd_len);
+    }
+    mpycache_add_path(&abs_path, src, len);
+
+    mp_obj_t stat = mp_vfs_stat(MP_OBJ_NEW_QSTR(source_file));
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_tuple_get(stat, &n, &items);
+
+    vstr_add_strn(header, "MPYC", 4);
+    mpycache_add_uint(header, mp_obj_get_int_truncated(items[6]));
+    mpycache_add_uint(header, mp_obj_get_int_truncated(items[8]));
+    mpycache_add_uint(header, MP_STATE_VM(mp_optimise_value));
+    #if MICROPY_EMIT_NATIVE
+    mpycache_add_uint(header, MP_STATE_VM(default_emit_opt));
+    #else
+    mpycache_add_uint(header, 0);
+    #endif
+    mpycache_add_uint(header, abs_path.len);
+    vstr_add_strn(header, abs_path.buf, abs_path.len);
+
+    // FNV-1a hash of the absolute path.
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < abs_path.len; ++i) {
+        hash = (hash ^ (byte)abs_path.buf[i]) * 16777619u;
+    }
+    vstr_clear(&abs_path);
+
+    const char *name = strrchr(src, '/');
+    name = name == NULL ? src : name + 1;
+    size_t name_len = src + len - name;
+    if (name_len > 3 && strcmp(name + name_len - 3, ".py") == 0) {
+        name_len -= 3;
+    }
+    size_t dir_len;
+    const char *dir = mp_obj_str_get_data(MP_STATE_VM(persistent_code_cache_dir), &dir_len);
+    vstr_add_strn(cache_path, dir, dir_len);
+    vstr_printf(cache_path, "/%.*s.%08x.mpy", (int)name_len, name, (unsigned int)hash);
+}
+
+static bool mpycache_load(const vstr_t *header, const vstr_t *cache_path, mp_compiled_module_t *cm) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_reader_t reader;
+        mp_reader_new_file(&reader, qstr_from_strn(cache_path->buf, cache_path->len));
+        for (size_t i = 0; i < header->len; ++i) {
+            if (reader.readbyte(reader.data) != (byte)header->buf[i]) {
+                // Stale cache file, or one for a different source file.
+                reader.close(reader.data);
+                nlr_pop();
+                return false;
+            }
+        }
+        mp_raw_code_load(&reader, cm);
+        nlr_pop();
+        return true;
+    } else {
+        // A missing or unreadable cache file just means the source is compiled,
+        // but let anything that isn't an Exception (eg KeyboardInterrupt) through.
+        if (!mp_obj_is_subclass_fast(MP_OBJ_FROM_PTR(((mp_obj_base_t *)nlr.ret_val)->type), MP_OBJ_FROM_PTR(&mp_type_Exception))) {
+            nlr_jump(nlr.ret_val);
+        }
+        return false;
+    }
+}
+
+// Counts the cache files saved by this process, to name their temporary files.
+static unsigned int mpycache_save_count;
+
+static void mpycache_save(const vstr_t *header, const vstr_t *cache_path, mp_compiled_module_t *cm) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        vstr_t data;
+        mp_print_t print;
+        vstr_init_print(&data, header->len + 256, &print);
+        vstr_add_strn(&data, header->buf, header->len);
+        mp_raw_code_save(cm, &print);
+
+        // Write to a temporary file and then rename it into place, so that the
+        // cache file is never seen partially written, even by another process
+        // loading it at the same time.
+        // The temporary file is unique to this process and save, so processes
+        // and threads saving the same module at once don't write to one file.
+        mp_obj_t path = mp_obj_new_str(cache_path->buf, cache_path->len);
+        vstr_t tmp_path;
+        vstr_init(&tmp_path, cache_path->len + 24);
+        vstr_add_strn(&tmp_path, cache_path->buf, cache_path->len);
+        vstr_printf(&tmp_path, ".%u.%u.tmp", (unsigned int)MICROPY_PERSISTENT_CODE_CACHE_PROCESS_ID(), ++mpycache_save_count);
+        mp_obj_t tmp = mp_obj_new_str_from_vstr(&tmp_path);
+        mp_obj_t args[2] = { tmp, MP_OBJ_NEW_QSTR(MP_QSTR_wb) };
+        mp_obj_t file = mp_vfs_open(MP_ARRAY_SIZE(args), args, (mp_map_t *)&mp_const_empty_map);
+        int errcode;
+        mp_stream_write_exactly(file, data.buf, data.len, &errcode);
+        mp_stream_close(file);
+        if (errcode != 0) {
+            mp_raise_OSError(errcode);
+        }
+        mp_vfs_rename(tmp, path);
+        vstr_clear(&data);
+        nlr_pop();
+    } else {
+        // Not being able to write the cache (eg it's read-only) isn't an error.
+        if (!mp_obj_is_subclass_fast(MP_OBJ_FROM_PTR(((mp_obj_base_t *)nlr.ret_val)->type), MP_OBJ_FROM_PTR(&mp_type_Exception))) {
+            nlr_jump(nlr.ret_val);
+        }
+    }
+}
+
+void mp_raw_code_cache_load_file(qstr source_file, mp_compiled_module_t *cm) {
+    vstr_t header;
+    vstr_t cache_path;
+    vstr_init(&header, 32 + MICROPY_ALLOC_PATH_MAX);
+    vstr_init(&cache_path, MICROPY_ALLOC_PATH_MAX);
+    mpycache_init(source_file, &header, &cache_path);
+
+    if (!mpycache_load(&header, &cache_path, cm)) {
+        mp_lexer_t *lex = mp_lexer_new_from_file(source_file);
+        mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+        mp_compile_to_raw_code(&parse_tree, source_file, false, cm);
+        // Native code, and the cached-load opcodes used at optimisation level 4,
+        // can't be saved to a .mpy file.
+        if (!cm->has_native
+            #if MICROPY_COMP_CACHE_LOADS
+            && MP_STATE_VM(mp_optimise_value) < 4
+            #endif
+            ) {
+            mpycache_save(&header, &cache_path, cm);
+        }
+    }
+
+    vstr_clear(&header);
+    vstr_clear(&cache_path);
+}
+
+MP_REGISTER_ROOT_POINTER(mp_obj_t persistent_code_cache_dir);
+
+#endif // MICROPY_PERSISTENT_CODE_CACHE
@@ -15,6 +15,7 @@
 
 /*************************** HEADER FILES ***************************/
 #include <stdlib.h>
+#include <string.h>
 #include "sha256.h"
 
 /****************************** MACROS ******************************/
@@ -41,46 +42,212 @@ static const WORD k[64] = {
 };
 
 /*********************** FUNCTION DEFINITIONS ***********************/
-static void sha256_transform(CRYAL_SHA256_CTX *ctx, const BYTE data[])
+#define LOAD_BE32(p) (((WORD)(p)[0] << 24) | ((WORD)(p)[1] << 16) | ((WORD)(p)[2] << 8) | (WORD)(p)[3])
+
+// One round, with the working variables renamed instead of shifted.
+#define ROUND(a,b,c,d,e,f,g,h,i) \
+	do { \
+		t1 = h + EP1(e) + CH(e,f,g) + k[i] + m[(i) & 15]; \
+		d += t1; \
+		h = t1 + EP0(a) + MAJ(a,b,c); \
+	} while (0)
+
+// Extends the message schedule in place, keeping only the last 16 words.
+#define SCHEDULE(i) \
+	(m[(i) & 15] += SIG1(m[((i) - 2) & 15]) + m[((i) - 7) & 15] + SIG0(m[((i) - 15) & 15]))
+
+static void sha256_transform_sw(WORD state[8], const BYTE data[], size_t nblocks)
+{
+	WORD a, b, c, d, e, f, g, h, i, t1, m[16];
+
+	for (; nblocks; --nblocks, data += 64) {
+		for (i = 0; i < 16; ++i)
+			m[i] = LOAD_BE32(data + 4 * i);
+
+		a = state[0];
+		b = state[1];
+		c = state[2];
+		d = state[3];
+		e = state[4];
+		f = state[5];
+		g = state[6];
+		h = state[7];
+
+		for (i = 0; i < 64; i += 8) {
+			if (i >= 16) {
+				SCHEDULE(i); SCHEDULE(i + 1); SCHEDULE(i + 2); SCHEDULE(i + 3);
+				SCHEDULE(i + 4); SCHEDULE(i + 5); SCHEDULE(i + 6); SCHEDULE(i + 7);
+			}
+			ROUND(a,b,c,d,e,f,g,h,i);
+			ROUND(h,a,b,c,d,e,f,g,i + 1);
+			ROUND(g,h,a,b,c,d,e,f,i + 2);
+			ROUND(f,g,h,a,b,c,d,e,i + 3);
+			ROUND(e,f,g,h,a,b,c,d,i + 4);
+			ROUND(d,e,f,g,h,a,b,c,i + 5);
+			ROUND(c,d,e,f,g,h,a,b,i + 6);
+			ROUND(b,c,d,e,f,g,h,a,i + 7);
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+}
+
+#ifdef CRYAL_SHA256_USE_SHANI
+// x86 SHA extensions, used when the CPU supports them.
+#include <cpuid.h>
+#include <immintrin.h>
+
+__attribute__((target("sha,sse4.1")))
+static void sha256_transform_shani(WORD state[8], const BYTE data[], size_t nblocks)
+{
+	const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i abef, cdgh, abef_save, cdgh_save, msg[4], t;
+	int i;
+
+	// The instructions keep the state as ABEF and CDGH.
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xb1);
+	cdgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1b);
+	abef = _mm_alignr_epi8(t, cdgh, 8);
+	cdgh = _mm_blend_epi16(cdgh, t, 0xf0);
+
+	for (; nblocks; --nblocks, data += 64) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+		for (i = 0; i < 16; ++i) {
+			if (i < 4) {
+				msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16 * i)), bswap);
+			} else {
+				t = _mm_sha256msg1_epu32(msg[i & 3], msg[(i + 1) & 3]);
+				t = _mm_add_epi32(t, _mm_alignr_epi8(msg[(i + 3) & 3], msg[(i + 2) & 3], 4));
+				msg[i & 3] = _mm_sha256msg2_epu32(t, msg[(i + 3) & 3]);
+			}
+			t = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i *)&k[4 * i]));
+			cdgh = _mm_sha256rnds2_epu32(cdgh, abef, t);
+			abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(t, 0x0e));
+		}
+		abef = _mm_add_epi32(abef, abef_save);
+		cdgh = _mm_add_epi32(cdgh, cdgh_save);
+	}
+
+	t = _mm_shuffle_epi32(abef, 0x1b);
+	cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+	_mm_storeu_si128((__m128i *)&state[0], _mm_blend_epi16(t, cdgh, 0xf0));
+	_mm_storeu_si128((__m128i *)&state[4], _mm_alignr_epi8(cdgh, t, 8));
+}
+
+static int sha256_have_shani(void)
+{
+	static int have = -1;
+	unsigned int eax, ebx, ecx, edx;
+
+	if (have < 0) {
+		have = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_1)
+			&& __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA);
+	}
+	return have;
+}
+#endif
+
+// Processes nblocks whole 64-byte blocks.
+static void sha256_transform(WORD state[8], const BYTE data[], size_t nblocks)
 {
-	WORD a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
-
-	for (i = 0, j = 0; i < 16; ++i, j += 4)
-		m[i] = ((uint32_t)data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | (data[j + 3]);
-	for ( ; i < 64; ++i)
-		m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
-
-	a = ctx->state[0];
-	b = ctx->state[1];
-	c = ctx->state[2];
-	d = ctx->state[3];
-	e = ctx->state[4];
-	f = ctx->state[5];
-	g = ctx->state[6];
-	h = ctx->state[7];
-
-	for (i = 0; i < 64; ++i) {
-		t1 = h + EP1(e) + CH(e,f,g) + k[i] + m[i];
-		t2 = EP0(a) + MAJ(a,b,c);
-		h = g;
-		g = f;
-		f = e;
-		e = d + t1;
-		d = c;
-		c = b;
-		b = a;
-		a = t1 + t2;
+#ifdef CRYAL_SHA256_USE_SHANI
+	if (sha256_have_shani()) {
+		sha256_transform_shani(state, data, nblocks);
+		return;
 	}
+#endif
+	sha256_transform_sw(state, data, nblocks);
+}
+
+#ifdef CRYAL_SHA256_LANES
+// Hashes four messages at once, one in each lane of a vector, which gives
+// the compiler independent work to fill SIMD registers with.
+typedef WORD sha256_x4_t __attribute__((vector_size(16)));
+
+#define LOAD_BE32_X4(p, i) \
+	((sha256_x4_t){LOAD_BE32((p)[0] + (i)), LOAD_BE32((p)[1] + (i)), LOAD_BE32((p)[2] + (i)), LOAD_BE32((p)[3] + (i))})
+
+static void sha256_transform_x4(CRYAL_SHA256_CTX *ctx[4], const BYTE *data[4], size_t nblocks)
+{
+	sha256_x4_t a, b, c, d, e, f, g, h, t1, m[16], state[8];
+	const BYTE *p[4] = {data[0], data[1], data[2], data[3]};
+	WORD i;
 
-	ctx->state[0] += a;
-	ctx->state[1] += b;
-	ctx->state[2] += c;
-	ctx->state[3] += d;
-	ctx->state[4] += e;
-	ctx->state[5] += f;
-	ctx->state[6] += g;
-	ctx->state[7] += h;
+	for (i = 0; i < 8; ++i)
+		state[i] = (sha256_x4_t){ctx[0]->state[i], ctx[1]->state[i], ctx[2]->state[i], ctx[3]->state[i]};
+
+	for (; nblocks; --nblocks) {
+		for (i = 0; i < 16; ++i)
+			m[i] = LOAD_BE32_X4(p, 4 * i);
+		for (i = 0; i < 4; ++i)
+			p[i] += 64;
+
+		a = state[0];
+		b = state[1];
+		c = state[2];
+		d = state[3];
+		e = state[4];
+		f = state[5];
+		g = state[6];
+		h = state[7];
+
+		for (i = 0; i < 64; i += 8) {
+			if (i >= 16) {
+				SCHEDULE(i); SCHEDULE(i + 1); SCHEDULE(i + 2); SCHEDULE(i + 3);
+				SCHEDULE(i + 4); SCHEDULE(i + 5); SCHEDULE(i + 6); SCHEDULE(i + 7);
+			}
+			ROUND(a,b,c,d,e,f,g,h,i);
+			ROUND(h,a,b,c,d,e,f,g,i + 1);
+			ROUND(g,h,a,b,c,d,e,f,i + 2);
+			ROUND(f,g,h,a,b,c,d,e,i + 3);
+			ROUND(e,f,g,h,a,b,c,d,i + 4);
+			ROUND(d,e,f,g,h,a,b,c,i + 5);
+			ROUND(c,d,e,f,g,h,a,b,i + 6);
+			ROUND(b,c,d,e,f,g,h,a,i + 7);
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+
+	for (i = 0; i < 8; ++i) {
+		ctx[0]->state[i] = state[i][0];
+		ctx[1]->state[i] = state[i][1];
+		ctx[2]->state[i] = state[i][2];
+		ctx[3]->state[i] = state[i][3];
+	}
+}
+
+void sha256_update_x4(CRYAL_SHA256_CTX *ctx[4], const BYTE *data[4], size_t nblocks)
+{
+	WORD i;
+
+#ifdef CRYAL_SHA256_USE_SHANI
+	// The SHA instructions hash a single message faster than the lanes.
+	if (sha256_have_shani()) {
+		for (i = 0; i < 4; ++i)
+			sha256_transform_shani(ctx[i]->state, data[i], nblocks);
+	} else
+#endif
+	sha256_transform_x4(ctx, data, nblocks);
+	for (i = 0; i < 4; ++i)
+		ctx[i]->bitlen += (unsigned long long)nblocks * 512;
 }
+#endif
 
 void sha256_init(CRYAL_SHA256_CTX *ctx)
 {
@@ -98,17 +265,35 @@ void sha256_init(CRYAL_SHA256_CTX *ctx)
 
 void sha256_update(CRYAL_SHA256_CTX *ctx, const BYTE data[], size_t len)
 {
-	WORD i;
+	size_t n;
 
-	for (i = 0; i < len; ++i) {
-		ctx->data[ctx->datalen] = data[i];
-		ctx->datalen++;
-		if (ctx->datalen == 64) {
-			sha256_transform(ctx, ctx->data);
-			ctx->bitlen += 512;
-			ctx->datalen = 0;
-		}
+	// Top up a partial block first.
+	if (ctx->datalen) {
+		n = 64 - ctx->datalen;
+		if (n > len)
+			n = len;
+		memcpy(ctx->data + ctx->datalen, data, n);
+		ctx->datalen += n;
+		data += n;
+		len -= n;
+		if (ctx->datalen < 64)
+			return;
+		sha256_transform(ctx->state, ctx->data, 1);
+		ctx->bitlen += 512;
+		ctx->datalen = 0;
 	}
+
+	// Then hash whole blocks straight from the input.
+	n = len / 64;
+	if (n) {
+		sha256_transform(ctx->state, data, n);
+		ctx->bitlen += (unsigned long long)n * 512;
+		data += n * 64;
+		len -= n * 64;
+	}
+
+	memcpy(ctx->data, data, len);
+	ctx->datalen = len;
 }
 
 void sha256_final(CRYAL_SHA256_CTX *ctx, BYTE hash[])
@@ -127,7 +312,7 @@ void sha256_final(CRYAL_SHA256_CTX *ctx, BYTE hash[])
 		ctx->data[i++] = 0x80;
 		while (i < 64)
 			ctx->data[i++] = 0x00;
-		sha256_transform(ctx, ctx->data);
+		sha256_transform(ctx->state, ctx->data, 1);
 		memset(ctx->data, 0, 56);
 	}
 
@@ -141,7 +326,7 @@ void sha256_final(CRYAL_SHA256_CTX *ctx, BYTE hash[])
 	ctx->data[58] = ctx->bitlen >> 40;
 	ctx->data[57] = ctx->bitlen >> 48;
 	ctx->data[56] = ctx->bitlen >> 56;
-	sha256_transform(ctx, ctx->data);
+	sha256_transform(ctx->state, ctx->data, 1);
 
 	// Since this implementation uses little endian byte ordering and SHA uses big endian,
 	// reverse all the bytes when copying the final state to the output hash.
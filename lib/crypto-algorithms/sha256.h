@@ -31,5 +31,10 @@ typedef struct {
 void sha256_init(CRYAL_SHA256_CTX *ctx);
 void sha256_update(CRYAL_SHA256_CTX *ctx, const BYTE data[], size_t len);
 void sha256_final(CRYAL_SHA256_CTX *ctx, BYTE hash[]);
+#ifdef CRYAL_SHA256_LANES
+// Hashes nblocks whole 64-byte blocks of each data[i] into ctx[i], which must
+// not hold a partial block.
+void sha256_update_x4(CRYAL_SHA256_CTX *ctx[4], const BYTE *data[4], size_t nblocks);
+#endif
 
 #endif   // SHA256_H
@@ -159,7 +159,9 @@ idf_component_register(
 set(MICROPY_TARGET ${COMPONENT_TARGET})
 
 # Define mpy-cross flags, for use with frozen code.
-if((NOT IDF_TARGET STREQUAL "esp32c3") OR (NOT IDF_TARGET STREQUAL "esp32c6"))
+if(IDF_TARGET STREQUAL "esp32c3" OR IDF_TARGET STREQUAL "esp32c6")
+set(MICROPY_CROSS_FLAGS -march=rv32imc)
+else()
 set(MICROPY_CROSS_FLAGS -march=xtensawin)
 endif()
 
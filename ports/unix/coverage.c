@@ -17,6 +17,7 @@
 #include "py/stream.h"
 #include "py/binary.h"
 #include "py/bc.h"
+#include "py/persistentcode.h"
 
 // expected output of this file is found in extra_coverage.py.exp
 
@@ -148,6 +149,23 @@ static MP_DEFINE_CONST_OBJ_TYPE(
 static const mp_obj_str_t str_no_hash_obj = {{&mp_type_str}, 0, 10, (const byte *)"0123456789"};
 static const mp_obj_str_t bytes_no_hash_obj = {{&mp_type_bytes}, 0, 10, (const byte *)"0123456789"};
 
+// .mpy data for mp_raw_code_load_rom, compiled from:
+//   ROM_STR = "a str constant that is not a qstr"
+//   def rom_qstr_fun(a):
+//       return a + 1
+static const byte rom_mpy[] =
+    "\x4d\x06\x00\x1f\x05\x01\x14\x72\x6f\x6d\x5f\x6d\x6f\x64\x2e\x70"
+    "\x79\x00\x0f\x18\x72\x6f\x6d\x5f\x71\x73\x74\x72\x5f\x66\x75\x6e"
+    "\x00\x0e\x52\x4f\x4d\x5f\x53\x54\x52\x00\x02\x61\x00\x05\x21\x61"
+    "\x20\x73\x74\x72\x20\x63\x6f\x6e\x73\x74\x61\x6e\x74\x20\x74\x68"
+    "\x61\x74\x20\x69\x73\x20\x6e\x6f\x74\x20\x61\x20\x71\x73\x74\x72"
+    "\x00\x74\x00\x04\x01\x64\x23\x00\x16\x03\x32\x00\x16\x02\x51\x63"
+    "\x01\x50\x11\x08\x02\x04\x60\x20\xb0\x81\xf2\x63";
+
+static bool in_rom_mpy(const void *p) {
+    return (const byte *)p >= rom_mpy && (const byte *)p < rom_mpy + sizeof(rom_mpy);
+}
+
 static int pairheap_lt(mp_pairheap_t *a, mp_pairheap_t *b) {
     return (uintptr_t)a < (uintptr_t)b;
 }
@@ -728,6 +746,38 @@ static mp_obj_t extra_coverage(void) {
         mp_printf(&mp_plat_print, "%d %d\n", mp_obj_is_int(MP_OBJ_NEW_SMALL_INT(1)), mp_obj_is_int(mp_obj_new_int_from_ll(1)));
     }
 
+    // persistent code from ROM
+    {
+        mp_printf(&mp_plat_print, "# persistent code from ROM\n");
+
+        // load the module, referencing its data in place
+        mp_compiled_module_t cm;
+        cm.context = m_new_obj(mp_module_context_t);
+        cm.context->module.globals = mp_obj_new_dict(0);
+        mp_raw_code_load_rom(rom_mpy, sizeof(rom_mpy) - 1, &cm);
+
+        // execute it in its own globals
+        mp_obj_dict_t *old_globals = mp_globals_get();
+        mp_obj_dict_t *old_locals = mp_locals_get();
+        mp_globals_set(cm.context->module.globals);
+        mp_locals_set(cm.context->module.globals);
+        mp_call_function_0(mp_make_function_from_proto_fun(cm.rc, cm.context, NULL));
+        mp_globals_set(old_globals);
+        mp_locals_set(old_locals);
+
+        // bytecode, qstr data and str data are not copied to the heap
+        qstr q_fun = qstr_find_strn("rom_qstr_fun", 12);
+        qstr q_str = qstr_find_strn("ROM_STR", 7);
+        mp_obj_t str = mp_obj_dict_get(MP_OBJ_FROM_PTR(cm.context->module.globals), MP_OBJ_NEW_QSTR(q_str));
+        mp_printf(&mp_plat_print, "%d\n", in_rom_mpy(cm.rc->fun_data));
+        mp_printf(&mp_plat_print, "%d %d\n", in_rom_mpy(qstr_str(q_fun)), in_rom_mpy(qstr_str(q_str)));
+        mp_printf(&mp_plat_print, "%d %s\n", in_rom_mpy(mp_obj_str_get_str(str)), mp_obj_str_get_str(str));
+
+        // the loaded code runs
+        mp_obj_t fun = mp_obj_dict_get(MP_OBJ_FROM_PTR(cm.context->module.globals), MP_OBJ_NEW_QSTR(q_fun));
+        mp_printf(&mp_plat_print, "%d\n", (int)mp_obj_get_int(mp_call_function_1(fun, MP_OBJ_NEW_SMALL_INT(1))));
+    }
+
     mp_printf(&mp_plat_print, "# end coverage.c\n");
 
     mp_obj_streamtest_t *s = mp_obj_malloc(mp_obj_streamtest_t, &mp_type_stest_fileio);
@@ -39,6 +39,7 @@
 #include <signal.h>
 
 #include "py/compile.h"
+#include "py/persistentcode.h"
 #include "py/runtime.h"
 #include "py/builtin.h"
 #include "py/repl.h"
@@ -57,6 +58,12 @@
 // Command line options, with their defaults
 static bool compile_only = false;
 static uint emit_opt = MP_EMIT_OPT_NONE;
+#if MICROPY_EMIT_NATIVE_TIERING
+static mp_uint_t tier_threshold = 0;
+#endif
+#if MICROPY_PERSISTENT_CODE_CACHE
+static const char *pycache_dir = NULL;
+#endif
 
 #if MICROPY_ENABLE_GC
 // Heap size of GC heap (if enabled)
@@ -314,6 +321,113 @@ static int do_str(const char *str) {
     return execute_from_lexer(LEX_SRC_STR, str, MP_PARSE_FILE_INPUT, false);
 }
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+
+#include <dirent.h>
+#include <sys/wait.h>
+
+// Append the paths of all .py files below the directory in path to the list.
+static void compileall_scan(vstr_t *path, mp_obj_t files) {
+    DIR *dir = opendir(vstr_null_terminated_str(path));
+    if (dir == NULL) {
+        return;
+    }
+    size_t dir_len = path->len;
+    struct dirent *de;
+    while ((de = readdir(dir)) != NULL) {
+        // Skip ".", ".." and hidden entries, like __pycache__ directories do.
+        if (de->d_name[0] == '.') {
+            continue;
+        }
+        vstr_add_char(path, '/');
+        vstr_add_str(path, de->d_name);
+        struct stat st;
+        if (stat(vstr_null_terminated_str(path), &st) == 0) {
+            if (S_ISDIR(st.st_mode)) {
+                compileall_scan(path, files);
+            } else if (S_ISREG(st.st_mode) && path->len > 3 && strcmp(path->buf + path->len - 3, ".py") == 0) {
+                mp_obj_list_append(files, mp_obj_new_str(path->buf, path->len));
+            }
+        }
+        vstr_cut_tail_bytes(path, path->len - dir_len);
+    }
+    closedir(dir);
+}
+
+// Compile every step'th file starting at start, returning the number that failed.
+static int compileall_files(size_t n, mp_obj_t *files, size_t start, size_t step) {
+    int failed = 0;
+    for (size_t i = start; i < n; i += step) {
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            mp_compiled_module_t cm;
+            cm.context = m_new_obj(mp_module_context_t);
+            mp_raw_code_cache_load_file(mp_obj_str_get_qstr(files[i]), &cm);
+            nlr_pop();
+        } else {
+            mp_obj_print_exception(&mp_stderr_print, MP_OBJ_FROM_PTR(nlr.ret_val));
+            ++failed;
+        }
+    }
+    return failed;
+}
+
+// Compile all .py files below the given directory into the cache.  The compiler
+// runs with the GIL held, so the files are compiled by worker processes (one per
+// CPU) rather than threads.
+static int do_compileall(const char *dir_in) {
+    if (MP_STATE_VM(persistent_code_cache_dir) == MP_OBJ_NULL) {
+        fprintf(stderr, "compileall needs a cache directory, use -X pycache=<dir>\n");
+        return 1;
+    }
+    // Name the files by the path as given, not its realpath, because the cache
+    // keys of imports are normalised from sys.path entries without resolving
+    // symlinks.
+    struct stat st;
+    if (stat(dir_in, &st) != 0) {
+        fprintf(stderr, "can't open directory '%s': [Errno %d] %s\n", dir_in, errno, strerror(errno));
+        return 1;
+    }
+    vstr_t path;
+    vstr_init(&path, PATH_MAX);
+    vstr_add_str(&path, dir_in);
+    mp_obj_t files = mp_obj_new_list(0, NULL);
+    compileall_scan(&path, files);
+    vstr_clear(&path);
+
+    size_t n;
+    mp_obj_t *items;
+    mp_obj_list_get(files, &n, &items);
+    long n_workers = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_workers > (long)n) {
+        n_workers = n;
+    }
+    int failed = 0;
+    if (n_workers <= 1) {
+        failed = compileall_files(n, items, 0, 1);
+    } else {
+        fflush(stdout);
+        for (long w = 0; w < n_workers; ++w) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                _exit(compileall_files(n, items, w, n_workers) != 0);
+            } else if (pid < 0) {
+                // Compile this worker's share of the files here instead.
+                failed += compileall_files(n, items, w, n_workers);
+            }
+        }
+        int status;
+        while (wait(&status) > 0) {
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                ++failed;
+            }
+        }
+    }
+    return failed != 0;
+}
+
+#endif
+
 static void print_help(char **argv) {
     printf(
         "usage: %s [<opts>] [-X <implopt>] [-c <command> | -m <module> | <filename>]\n"
@@ -335,6 +449,13 @@ static void print_help(char **argv) {
         #else
         "  emit=bytecode                -- set the default code emitter\n"
         #endif
+        #if MICROPY_EMIT_NATIVE_TIERING
+        "  tier=<n>                     -- compile functions to native after n calls/loops\n"
+        #endif
+        #if MICROPY_PERSISTENT_CODE_CACHE
+        "  pycache=<dir>                -- cache compiled .py imports as .mpy files in dir\n"
+        "  compileall=<dir>             -- compile all .py files in dir into the cache\n"
+        #endif
         );
     impl_opts_cnt++;
     #if MICROPY_ENABLE_GC
@@ -384,6 +505,16 @@ static void pre_process_options(int argc, char **argv) {
                 } else if (strcmp(argv[a + 1], "emit=viper") == 0) {
                     emit_opt = MP_EMIT_OPT_VIPER;
                 #endif
+                #if MICROPY_EMIT_NATIVE_TIERING
+                } else if (strncmp(argv[a + 1], "tier=", sizeof("tier=") - 1) == 0) {
+                    tier_threshold = strtoul(argv[a + 1] + sizeof("tier=") - 1, NULL, 0);
+                #endif
+                #if MICROPY_PERSISTENT_CODE_CACHE
+                } else if (strncmp(argv[a + 1], "pycache=", sizeof("pycache=") - 1) == 0) {
+                    pycache_dir = argv[a + 1] + sizeof("pycache=") - 1;
+                } else if (strncmp(argv[a + 1], "compileall=", sizeof("compileall=") - 1) == 0) {
+                    // Handled once the interpreter is initialised.
+                #endif
                 #if MICROPY_ENABLE_GC
                 } else if (strncmp(argv[a + 1], "heapsize=", sizeof("heapsize=") - 1) == 0) {
                     char *end;
@@ -534,6 +665,23 @@ MP_NOINLINE int main_(int argc, char **argv) {
     #else
     (void)emit_opt;
     #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    MP_STATE_VM(tier_threshold) = tier_threshold;
+    #endif
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    if (pycache_dir == NULL) {
+        pycache_dir = getenv("MICROPYCACHE");
+    }
+    if (pycache_dir != NULL && pycache_dir[0] != '\0') {
+        // Use an absolute path so the cache doesn't move if the cwd changes.
+        mkdir(pycache_dir, 0777);
+        char *dir = realpath(pycache_dir, NULL);
+        if (dir != NULL) {
+            MP_STATE_VM(persistent_code_cache_dir) = mp_obj_new_str(dir, strlen(dir));
+            free(dir);
+        }
+    }
+    #endif
 
     #if MICROPY_VFS_POSIX
     {
@@ -687,6 +835,12 @@ MP_NOINLINE int main_(int argc, char **argv) {
                 break;
             } else if (strcmp(argv[a], "-X") == 0) {
                 a += 1;
+                #if MICROPY_PERSISTENT_CODE_CACHE
+                if (strncmp(argv[a], "compileall=", sizeof("compileall=") - 1) == 0) {
+                    ret = do_compileall(argv[a] + sizeof("compileall=") - 1);
+                    break;
+                }
+                #endif
             #if MICROPY_DEBUG_PRINTERS
             } else if (strcmp(argv[a], "-v") == 0) {
                 mp_verbose_flag++;
@@ -69,6 +69,23 @@
 #if !defined(MICROPY_EMIT_ARM) && defined(__arm__) && !defined(__thumb2__)
     #define MICROPY_EMIT_ARM        (1)
 #endif
+#if !defined(MICROPY_EMIT_AARCH64) && defined(__aarch64__)
+    #define MICROPY_EMIT_AARCH64    (1)
+#endif
+
+// Allow hot bytecode functions to be recompiled to native code (see -X tier).
+#ifndef MICROPY_EMIT_NATIVE_TIERING
+#define MICROPY_EMIT_NATIVE_TIERING (MICROPY_EMIT_X64 || MICROPY_EMIT_X86 || MICROPY_EMIT_THUMB || MICROPY_EMIT_ARM || MICROPY_EMIT_AARCH64)
+#endif
+
+// Like mpy-cross, propagate module-level constants and cache loads in loops at
+// optimisation level 4.
+#ifndef MICROPY_COMP_GLOBAL_CONST
+#define MICROPY_COMP_GLOBAL_CONST   (MICROPY_COMP_CONST)
+#endif
+#ifndef MICROPY_COMP_CACHE_LOADS
+#define MICROPY_COMP_CACHE_LOADS    (1)
+#endif
 
 // Type definitions for the specific machine based on the word size.
 #ifndef MICROPY_OBJ_REPR
@@ -117,6 +134,8 @@ typedef long mp_off_t;
 #define MICROPY_HELPER_LEXER_UNIX   (1)
 #define MICROPY_VFS_POSIX           (1)
 #define MICROPY_READER_POSIX        (1)
+#define MICROPY_VFS_BLOCKDEV_CACHE  (1)
+#define MICROPY_VFS_DIR_CACHE       (1)
 #ifndef MICROPY_TRACKED_ALLOC
 #define MICROPY_TRACKED_ALLOC       (MICROPY_BLUETOOTH_BTSTACK)
 #endif
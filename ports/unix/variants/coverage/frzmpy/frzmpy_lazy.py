@@ -0,0 +1,47 @@
+# Test top-level functions of a frozen module, which are created when they're
+# first used if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS is enabled.
+
+X = 1
+
+
+def get_x():
+    return X
+
+
+def f(x):
+    return x + 1
+
+
+def call_f(x):
+    return f(x)
+
+
+def gen(n):
+    for i in range(n):
+        yield i
+
+
+def default_args(a, b=2):
+    return a + b
+
+
+def double(fun):
+    return lambda: fun() * 2
+
+
+@double
+def decorated():
+    return 21
+
+
+class Foo:
+    def method(self):
+        return f(1)
+
+
+def get_globals():
+    return globals()
+
+
+def __getattr__(attr):
+    return attr + "!"
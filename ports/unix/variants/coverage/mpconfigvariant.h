@@ -42,3 +42,5 @@
 #define MICROPY_TRACKED_ALLOC          (1)
 #define MICROPY_WARNINGS_CATEGORY      (1)
 #define MICROPY_PY_CRYPTOLIB_CTR       (1)
+#define MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS (1)
+#define MICROPY_PERSISTENT_CODE_LOAD_ROM (1)
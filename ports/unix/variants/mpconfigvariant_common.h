@@ -67,6 +67,15 @@
 // Allow loading of .mpy files.
 #define MICROPY_PERSISTENT_CODE_LOAD   (1)
 
+// Allow caching compiled .py imports as .mpy files (see -X pycache).  Native
+// code compiled at runtime is never cached, so it needn't be saveable.
+#ifndef MICROPY_PERSISTENT_CODE_SAVE
+#define MICROPY_PERSISTENT_CODE_SAVE   (1)
+#define MICROPY_PERSISTENT_CODE_SAVE_NATIVE (0)
+#endif
+#define MICROPY_PERSISTENT_CODE_CACHE  (1)
+#define MICROPY_PERSISTENT_CODE_CACHE_PROCESS_ID() (getpid())
+
 // Extra memory debugging.
 #define MICROPY_MALLOC_USES_ALLOCATED_SIZE (1)
 #define MICROPY_MEM_STATS              (1)
@@ -74,6 +83,9 @@
 // Enable a small performance boost for the VM.
 #define MICROPY_OPT_COMPUTED_GOTO      (1)
 
+// Serve small heap allocations from per-thread free lists.
+#define MICROPY_GC_POOL                (1)
+
 // Return number of collected objects from gc.collect().
 #define MICROPY_PY_GC_COLLECT_RETVAL   (1)
 
@@ -100,12 +112,24 @@
 #define MICROPY_PY_TIME_CUSTOM_SLEEP   (1)
 #define MICROPY_PY_TIME_INCLUDEFILE    "ports/unix/modtime.c"
 
+// Enable hashlib.sha256_many() and the accelerated SHA-256.
+#define MICROPY_PY_HASHLIB_SHA256_MANY (1)
+#define MICROPY_PY_HASHLIB_SHA256_FAST (1)
+
 #if MICROPY_PY_SSL
 #define MICROPY_PY_HASHLIB_MD5         (1)
 #define MICROPY_PY_HASHLIB_SHA1        (1)
-#define MICROPY_PY_CRYPTOLIB           (1)
 #endif
 
+// Enable cryptolib with the built-in AES, which doesn't need an SSL library.
+#define MICROPY_PY_CRYPTOLIB           (1)
+#define MICROPY_PY_CRYPTOLIB_AES_BUILTIN (1)
+#define MICROPY_PY_CRYPTOLIB_CTR       (1)
+#define MICROPY_PY_CRYPTOLIB_GCM       (1)
+
+// Let btree read and write pages of POSIX files directly.
+#define MICROPY_PY_BTREE_FD            (1)
+
 // The "select" module is enabled by default, but disable select.select().
 #define MICROPY_PY_SELECT_POSIX_OPTIMISATIONS (1)
 #define MICROPY_PY_SELECT_SELECT       (0)
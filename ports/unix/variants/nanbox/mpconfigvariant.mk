@@ -1,3 +1,4 @@
 # build interpreter with nan-boxing as object model (object repr D)
+# (pass MICROPY_FORCE_32BIT=0 to build it natively on a 64-bit host)
 
 MICROPY_FORCE_32BIT = 1
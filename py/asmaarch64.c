@@ -0,0 +1,248 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 The MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+
+#include "py/runtime.h"
+
+// wrapper around everything in this file
+#if MICROPY_EMIT_AARCH64
+
+#include "py/asmaarch64.h"
+
+#define WORD_SIZE (8)
+#define SIGNED_FIT21(x) (-0x100000 <= (x) && (x) < 0x100000)
+#define SIGNED_FIT28(x) (-0x8000000 <= (x) && (x) < 0x8000000)
+
+// stp/ldp x<rt>, x<rt2>, [sp, #imm7 * 8] with the given addressing mode
+#define OP_STP_PRE_INDEX  (0xa9800000)
+#define OP_STP_OFFSET     (0xa9000000)
+#define OP_LDP_POST_INDEX (0xa8c00000)
+#define OP_LDP_OFFSET     (0xa9400000)
+
+void asm_aarch64_end_pass(asm_aarch64_t *as) {
+    (void)as;
+    #if 0
+    // make a hex dump of the machine code
+    if (as->base.pass == MP_ASM_PASS_EMIT) {
+        uint8_t *d = as->base.code_base;
+        printf("AARCH64 ASM:");
+        for (int i = 0; i < ((as->base.code_size + 15) & ~15); ++i) {
+            if (i % 16 == 0) {
+                printf("\n%p:", &d[i]);
+            }
+            if (i % 4 == 0) {
+                printf(" ");
+            }
+            printf("%02x", d[i]);
+        }
+        printf("\n");
+    }
+    #endif
+}
+
+void asm_aarch64_op32(asm_aarch64_t *as, uint32_t op) {
+    uint8_t *c = mp_asm_base_get_cur_to_write_bytes(&as->base, 4);
+    if (c != NULL) {
+        c[0] = op;
+        c[1] = op >> 8;
+        c[2] = op >> 16;
+        c[3] = op >> 24;
+    }
+}
+
+static void asm_aarch64_op_pair_sp(asm_aarch64_t *as, uint32_t op, uint rt, uint rt2, int offset) {
+    asm_aarch64_op32(as, op | ((offset / WORD_SIZE) & 0x7f) << 15 | rt2 << 10 | ASM_AARCH64_REG_SP << 5 | rt);
+}
+
+void asm_aarch64_entry(asm_aarch64_t *as, int num_locals) {
+    // save fp/lr and the callee-save registers used by the emitter, and set up a frame record
+    asm_aarch64_op_pair_sp(as, OP_STP_PRE_INDEX, ASM_AARCH64_REG_FP, ASM_AARCH64_REG_LR, -ASM_AARCH64_NUM_REGS_SAVED * WORD_SIZE);
+    asm_aarch64_op_pair_sp(as, OP_STP_OFFSET, ASM_AARCH64_REG_X19, ASM_AARCH64_REG_X20, 2 * WORD_SIZE);
+    asm_aarch64_op_pair_sp(as, OP_STP_OFFSET, ASM_AARCH64_REG_X21, ASM_AARCH64_REG_X22, 4 * WORD_SIZE);
+    asm_aarch64_op_pair_sp(as, OP_STP_OFFSET, ASM_AARCH64_REG_X23, ASM_AARCH64_REG_X24, 6 * WORD_SIZE);
+    asm_aarch64_add_reg_reg_i12(as, ASM_AARCH64_REG_FP, ASM_AARCH64_REG_SP, 0);
+
+    // make room for the locals below the saved registers, keeping sp 16-byte aligned
+    as->locals_size = (num_locals * WORD_SIZE + 15) & ~15;
+    if (as->locals_size >= 0x1000) {
+        asm_aarch64_op32(as, 0xd1400000 | (as->locals_size >> 12) << 10 | ASM_AARCH64_REG_SP << 5 | ASM_AARCH64_REG_SP);
+    }
+    if (as->locals_size & 0xfff) {
+        asm_aarch64_sub_reg_reg_i12(as, ASM_AARCH64_REG_SP, ASM_AARCH64_REG_SP, as->locals_size & 0xfff);
+    }
+}
+
+void asm_aarch64_exit(asm_aarch64_t *as) {
+    // the frame pointer holds the stack pointer from before the locals were allocated
+    if (as->locals_size != 0) {
+        asm_aarch64_add_reg_reg_i12(as, ASM_AARCH64_REG_SP, ASM_AARCH64_REG_FP, 0);
+    }
+    asm_aarch64_op_pair_sp(as, OP_LDP_OFFSET, ASM_AARCH64_REG_X23, ASM_AARCH64_REG_X24, 6 * WORD_SIZE);
+    asm_aarch64_op_pair_sp(as, OP_LDP_OFFSET, ASM_AARCH64_REG_X21, ASM_AARCH64_REG_X22, 4 * WORD_SIZE);
+    asm_aarch64_op_pair_sp(as, OP_LDP_OFFSET, ASM_AARCH64_REG_X19, ASM_AARCH64_REG_X20, 2 * WORD_SIZE);
+    asm_aarch64_op_pair_sp(as, OP_LDP_POST_INDEX, ASM_AARCH64_REG_FP, ASM_AARCH64_REG_LR, ASM_AARCH64_NUM_REGS_SAVED * WORD_SIZE);
+    asm_aarch64_ret(as);
+}
+
+static size_t get_label_dest(asm_aarch64_t *as, uint label) {
+    assert(label < as->base.max_num_labels);
+    return as->base.label_offsets[label];
+}
+
+// All instructions are 4 bytes, so unlike other architectures the size of a
+// branch never depends on its distance.  The offset is only checked in the
+// emit pass, when all labels are known.
+static int32_t get_label_rel(asm_aarch64_t *as, uint label, bool fits_21_bits) {
+    int32_t rel = get_label_dest(as, label) - as->base.code_offset;
+    if (as->base.pass == MP_ASM_PASS_EMIT && !(fits_21_bits ? SIGNED_FIT21(rel) : SIGNED_FIT28(rel))) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("asm overflow"));
+    }
+    return rel;
+}
+
+void asm_aarch64_b_label(asm_aarch64_t *as, uint label) {
+    int32_t rel = get_label_rel(as, label, false);
+    asm_aarch64_op32(as, 0x14000000 | ((rel >> 2) & 0x3ffffff));
+}
+
+void asm_aarch64_bcc_label(asm_aarch64_t *as, uint cond, uint label) {
+    int32_t rel = get_label_rel(as, label, true);
+    asm_aarch64_op32(as, 0x54000000 | ((rel >> 2) & 0x7ffff) << 5 | cond);
+}
+
+void asm_aarch64_cbz_label(asm_aarch64_t *as, bool nonzero, uint rt, uint label) {
+    int32_t rel = get_label_rel(as, label, true);
+    asm_aarch64_op32(as, 0xb4000000 | nonzero << 24 | ((rel >> 2) & 0x7ffff) << 5 | rt);
+}
+
+void asm_aarch64_jump_if_reg_zero(asm_aarch64_t *as, bool nonzero, uint rt, uint label, bool bool_test) {
+    if (bool_test) {
+        // a C bool is only guaranteed to be valid in the low byte of the register
+        asm_aarch64_tst_reg_u8(as, rt);
+        asm_aarch64_bcc_label(as, nonzero ? ASM_AARCH64_CC_NE : ASM_AARCH64_CC_EQ, label);
+    } else {
+        asm_aarch64_cbz_label(as, nonzero, rt, label);
+    }
+}
+
+void asm_aarch64_mov_reg_reg(asm_aarch64_t *as, uint rd, uint rm) {
+    // mov xd, xm (orr xd, xzr, xm)
+    asm_aarch64_op_reg_reg_reg(as, ASM_AARCH64_OP_ORR, rd, ASM_AARCH64_REG_XZR, rm);
+}
+
+void asm_aarch64_mov_reg_i64(asm_aarch64_t *as, uint rd, uint64_t i64) {
+    // Start from all zeros (movz) or all ones (movn), whichever needs fewer
+    // 16-bit chunks to be patched in afterwards with movk.
+    int num_zero = 0;
+    int num_ones = 0;
+    for (uint hw = 0; hw < 4; ++hw) {
+        uint chunk = (i64 >> (16 * hw)) & 0xffff;
+        num_zero += chunk == 0;
+        num_ones += chunk == 0xffff;
+    }
+    uint fill = num_ones > num_zero ? 0xffff : 0;
+    bool first = true;
+    for (uint hw = 0; hw < 4; ++hw) {
+        uint chunk = (i64 >> (16 * hw)) & 0xffff;
+        if (chunk == fill) {
+            continue;
+        }
+        if (!first) {
+            asm_aarch64_movk(as, rd, chunk, hw);
+        } else if (fill) {
+            asm_aarch64_movn(as, rd, ~chunk, hw);
+        } else {
+            asm_aarch64_movz(as, rd, chunk, hw);
+        }
+        first = false;
+    }
+    if (first) {
+        // value is 0 or -1
+        if (fill) {
+            asm_aarch64_movn(as, rd, 0, 0);
+        } else {
+            asm_aarch64_movz(as, rd, 0, 0);
+        }
+    }
+}
+
+void asm_aarch64_mov_local_reg(asm_aarch64_t *as, int local_num, uint rt) {
+    asm_aarch64_store_reg_reg_offset(as, ASM_AARCH64_SIZE_64, rt, ASM_AARCH64_REG_SP, local_num * WORD_SIZE);
+}
+
+void asm_aarch64_mov_reg_local(asm_aarch64_t *as, uint rt, int local_num) {
+    asm_aarch64_load_reg_reg_offset(as, ASM_AARCH64_SIZE_64, rt, ASM_AARCH64_REG_SP, local_num * WORD_SIZE);
+}
+
+void asm_aarch64_mov_reg_local_addr(asm_aarch64_t *as, uint rd, int local_num) {
+    uint offset = local_num * WORD_SIZE;
+    if (offset < 0x1000) {
+        asm_aarch64_add_reg_reg_i12(as, rd, ASM_AARCH64_REG_SP, offset);
+    } else {
+        // add xd, sp, x16 (extended register form, needed to use sp as an operand)
+        asm_aarch64_mov_reg_i64(as, ASM_AARCH64_REG_X16, offset);
+        asm_aarch64_op32(as, 0x8b206000 | ASM_AARCH64_REG_X16 << 16 | ASM_AARCH64_REG_SP << 5 | rd);
+    }
+}
+
+void asm_aarch64_mov_reg_pcrel(asm_aarch64_t *as, uint rd, uint label) {
+    // adr xd, label
+    int32_t rel = get_label_rel(as, label, true);
+    asm_aarch64_op32(as, 0x10000000 | (rel & 3) << 29 | ((rel >> 2) & 0x7ffff) << 5 | rd);
+}
+
+// size is log2 of the number of bytes to load, and offset must be a multiple of the size
+void asm_aarch64_load_reg_reg_offset(asm_aarch64_t *as, uint size, uint rt, uint rn, uint offset) {
+    assert((offset & ((1 << size) - 1)) == 0);
+    offset >>= size;
+    if (offset < 0x1000) {
+        asm_aarch64_ldr_reg_reg_i12(as, size, rt, rn, offset);
+    } else {
+        asm_aarch64_mov_reg_i64(as, ASM_AARCH64_REG_X16, offset);
+        asm_aarch64_ldr_reg_reg_reg(as, size, rt, rn, ASM_AARCH64_REG_X16);
+    }
+}
+
+// size is log2 of the number of bytes to store, and offset must be a multiple of the size
+void asm_aarch64_store_reg_reg_offset(asm_aarch64_t *as, uint size, uint rt, uint rn, uint offset) {
+    assert((offset & ((1 << size) - 1)) == 0);
+    offset >>= size;
+    if (offset < 0x1000) {
+        asm_aarch64_str_reg_reg_i12(as, size, rt, rn, offset);
+    } else {
+        asm_aarch64_mov_reg_i64(as, ASM_AARCH64_REG_X16, offset);
+        asm_aarch64_str_reg_reg_reg(as, size, rt, rn, ASM_AARCH64_REG_X16);
+    }
+}
+
+void asm_aarch64_call_ind(asm_aarch64_t *as, uint idx) {
+    asm_aarch64_load_reg_reg_offset(as, ASM_AARCH64_SIZE_64, ASM_AARCH64_REG_X16, ASM_AARCH64_REG_FUN_TABLE, idx * WORD_SIZE);
+    asm_aarch64_blr(as, ASM_AARCH64_REG_X16);
+}
+
+#endif // MICROPY_EMIT_AARCH64
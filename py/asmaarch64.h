@@ -0,0 +1,279 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 The MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_PY_ASMAARCH64_H
+#define MICROPY_INCLUDED_PY_ASMAARCH64_H
+
+#include "py/misc.h"
+#include "py/asmbase.h"
+
+// calling conventions (AAPCS64):
+// up to 8 args in x0-x7
+// return value in x0
+// return address in x30 (lr), frame pointer in x29 (fp)
+// stack pointer is sp, stack full descending, is aligned to 16 bytes
+// callee save: x19-x28, fp, sp
+// caller save: x0-x17, lr
+// x16 (ip0) is reserved by this assembler as a scratch register
+// x18 is the platform register and is never touched
+
+#define ASM_AARCH64_REG_X0  (0)
+#define ASM_AARCH64_REG_X1  (1)
+#define ASM_AARCH64_REG_X2  (2)
+#define ASM_AARCH64_REG_X3  (3)
+#define ASM_AARCH64_REG_X4  (4)
+#define ASM_AARCH64_REG_X5  (5)
+#define ASM_AARCH64_REG_X6  (6)
+#define ASM_AARCH64_REG_X7  (7)
+#define ASM_AARCH64_REG_X16 (16)
+#define ASM_AARCH64_REG_X19 (19)
+#define ASM_AARCH64_REG_X20 (20)
+#define ASM_AARCH64_REG_X21 (21)
+#define ASM_AARCH64_REG_X22 (22)
+#define ASM_AARCH64_REG_X23 (23)
+#define ASM_AARCH64_REG_X24 (24)
+#define ASM_AARCH64_REG_FP  (29)
+#define ASM_AARCH64_REG_LR  (30)
+#define ASM_AARCH64_REG_SP  (31) // when used as a base or with add/sub immediate
+#define ASM_AARCH64_REG_XZR (31) // when used as an operand of other data-processing instructions
+
+// condition codes, used for b.cond and cset
+#define ASM_AARCH64_CC_EQ (0x0)
+#define ASM_AARCH64_CC_NE (0x1)
+#define ASM_AARCH64_CC_HS (0x2) // unsigned higher or same
+#define ASM_AARCH64_CC_LO (0x3) // unsigned lower
+#define ASM_AARCH64_CC_HI (0x8) // unsigned higher
+#define ASM_AARCH64_CC_LS (0x9) // unsigned lower or same
+#define ASM_AARCH64_CC_GE (0xa)
+#define ASM_AARCH64_CC_LT (0xb)
+#define ASM_AARCH64_CC_GT (0xc)
+#define ASM_AARCH64_CC_LE (0xd)
+
+// for load/store, values are log2 of the access size in bytes
+#define ASM_AARCH64_SIZE_8  (0)
+#define ASM_AARCH64_SIZE_16 (1)
+#define ASM_AARCH64_SIZE_32 (2)
+#define ASM_AARCH64_SIZE_64 (3)
+
+// Number of registers saved on the stack upon entry to function
+#define ASM_AARCH64_NUM_REGS_SAVED (8)
+
+typedef struct _asm_aarch64_t {
+    mp_asm_base_t base;
+    uint32_t locals_size;
+} asm_aarch64_t;
+
+void asm_aarch64_end_pass(asm_aarch64_t *as);
+
+void asm_aarch64_entry(asm_aarch64_t *as, int num_locals);
+void asm_aarch64_exit(asm_aarch64_t *as);
+
+void asm_aarch64_op32(asm_aarch64_t *as, uint32_t op);
+
+// data processing, register forms (register 31 is xzr)
+#define ASM_AARCH64_OP_ADD  (0x8b000000)
+#define ASM_AARCH64_OP_SUB  (0xcb000000)
+#define ASM_AARCH64_OP_AND  (0x8a000000)
+#define ASM_AARCH64_OP_ORR  (0xaa000000)
+#define ASM_AARCH64_OP_EOR  (0xca000000)
+#define ASM_AARCH64_OP_ORN  (0xaa200000)
+#define ASM_AARCH64_OP_SUBS (0xeb000000)
+#define ASM_AARCH64_OP_LSLV (0x9ac02000)
+#define ASM_AARCH64_OP_LSRV (0x9ac02400)
+#define ASM_AARCH64_OP_ASRV (0x9ac02800)
+
+static inline void asm_aarch64_op_reg_reg_reg(asm_aarch64_t *as, uint32_t op, uint rd, uint rn, uint rm) {
+    asm_aarch64_op32(as, op | rm << 16 | rn << 5 | rd);
+}
+
+// mul xd, xn, xm (madd with xzr as the addend)
+static inline void asm_aarch64_mul_reg_reg_reg(asm_aarch64_t *as, uint rd, uint rn, uint rm) {
+    asm_aarch64_op32(as, 0x9b007c00 | rm << 16 | rn << 5 | rd);
+}
+
+// add/sub xd|sp, xn|sp, #uimm12
+static inline void asm_aarch64_add_reg_reg_i12(asm_aarch64_t *as, uint rd, uint rn, uint imm12) {
+    asm_aarch64_op32(as, 0x91000000 | (imm12 & 0xfff) << 10 | rn << 5 | rd);
+}
+
+static inline void asm_aarch64_sub_reg_reg_i12(asm_aarch64_t *as, uint rd, uint rn, uint imm12) {
+    asm_aarch64_op32(as, 0xd1000000 | (imm12 & 0xfff) << 10 | rn << 5 | rd);
+}
+
+// cmp xn, xm
+static inline void asm_aarch64_cmp_reg_reg(asm_aarch64_t *as, uint rn, uint rm) {
+    asm_aarch64_op_reg_reg_reg(as, ASM_AARCH64_OP_SUBS, ASM_AARCH64_REG_XZR, rn, rm);
+}
+
+// tst wn, #0xff (ands wzr, wn, #0xff)
+static inline void asm_aarch64_tst_reg_u8(asm_aarch64_t *as, uint rn) {
+    asm_aarch64_op32(as, 0x72001c00 | rn << 5 | ASM_AARCH64_REG_XZR);
+}
+
+// cset xd, cond (csinc xd, xzr, xzr, !cond)
+static inline void asm_aarch64_cset(asm_aarch64_t *as, uint rd, uint cond) {
+    asm_aarch64_op32(as, 0x9a9f07e0 | (cond ^ 1) << 12 | rd);
+}
+
+// movz/movk/movn xd, #imm16, lsl #(16 * hw)
+static inline void asm_aarch64_movz(asm_aarch64_t *as, uint rd, uint imm16, uint hw) {
+    asm_aarch64_op32(as, 0xd2800000 | hw << 21 | (imm16 & 0xffff) << 5 | rd);
+}
+
+static inline void asm_aarch64_movk(asm_aarch64_t *as, uint rd, uint imm16, uint hw) {
+    asm_aarch64_op32(as, 0xf2800000 | hw << 21 | (imm16 & 0xffff) << 5 | rd);
+}
+
+static inline void asm_aarch64_movn(asm_aarch64_t *as, uint rd, uint imm16, uint hw) {
+    asm_aarch64_op32(as, 0x92800000 | hw << 21 | (imm16 & 0xffff) << 5 | rd);
+}
+
+// ldr/str <size> rt, [rn, #uimm12 * (1 << size)]; loads of less than 64 bits zero extend
+static inline void asm_aarch64_ldr_reg_reg_i12(asm_aarch64_t *as, uint size, uint rt, uint rn, uint imm12) {
+    asm_aarch64_op32(as, 0x39400000 | size << 30 | (imm12 & 0xfff) << 10 | rn << 5 | rt);
+}
+
+static inline void asm_aarch64_str_reg_reg_i12(asm_aarch64_t *as, uint size, uint rt, uint rn, uint imm12) {
+    asm_aarch64_op32(as, 0x39000000 | size << 30 | (imm12 & 0xfff) << 10 | rn << 5 | rt);
+}
+
+// ldr/str <size> rt, [rn, xm, lsl #size]
+static inline void asm_aarch64_ldr_reg_reg_reg(asm_aarch64_t *as, uint size, uint rt, uint rn, uint rm) {
+    asm_aarch64_op32(as, 0x38606800 | size << 30 | (size != 0) << 12 | rm << 16 | rn << 5 | rt);
+}
+
+static inline void asm_aarch64_str_reg_reg_reg(asm_aarch64_t *as, uint size, uint rt, uint rn, uint rm) {
+    asm_aarch64_op32(as, 0x38206800 | size << 30 | (size != 0) << 12 | rm << 16 | rn << 5 | rt);
+}
+
+// br xn, blr xn, ret
+static inline void asm_aarch64_br(asm_aarch64_t *as, uint rn) {
+    asm_aarch64_op32(as, 0xd61f0000 | rn << 5);
+}
+
+static inline void asm_aarch64_blr(asm_aarch64_t *as, uint rn) {
+    asm_aarch64_op32(as, 0xd63f0000 | rn << 5);
+}
+
+static inline void asm_aarch64_ret(asm_aarch64_t *as) {
+    asm_aarch64_op32(as, 0xd65f03c0);
+}
+
+// convenience functions
+void asm_aarch64_b_label(asm_aarch64_t *as, uint label);
+void asm_aarch64_bcc_label(asm_aarch64_t *as, uint cond, uint label);
+void asm_aarch64_cbz_label(asm_aarch64_t *as, bool nonzero, uint rt, uint label);
+void asm_aarch64_mov_reg_reg(asm_aarch64_t *as, uint rd, uint rm);
+void asm_aarch64_mov_reg_i64(asm_aarch64_t *as, uint rd, uint64_t i64);
+void asm_aarch64_mov_local_reg(asm_aarch64_t *as, int local_num, uint rt);
+void asm_aarch64_mov_reg_local(asm_aarch64_t *as, uint rt, int local_num);
+void asm_aarch64_mov_reg_local_addr(asm_aarch64_t *as, uint rd, int local_num);
+void asm_aarch64_mov_reg_pcrel(asm_aarch64_t *as, uint rd, uint label);
+void asm_aarch64_jump_if_reg_zero(asm_aarch64_t *as, bool nonzero, uint rt, uint label, bool bool_test);
+void asm_aarch64_load_reg_reg_offset(asm_aarch64_t *as, uint size, uint rt, uint rn, uint offset);
+void asm_aarch64_store_reg_reg_offset(asm_aarch64_t *as, uint size, uint rt, uint rn, uint offset);
+void asm_aarch64_call_ind(asm_aarch64_t *as, uint idx);
+
+// Holds a pointer to mp_fun_table
+#define ASM_AARCH64_REG_FUN_TABLE ASM_AARCH64_REG_X22
+
+#if GENERIC_ASM_API
+
+// The following macros provide a (mostly) arch-independent API to
+// generate native code, and are used by the native emitter.
+
+#define ASM_WORD_SIZE (8)
+
+#define REG_RET ASM_AARCH64_REG_X0
+#define REG_ARG_1 ASM_AARCH64_REG_X0
+#define REG_ARG_2 ASM_AARCH64_REG_X1
+#define REG_ARG_3 ASM_AARCH64_REG_X2
+#define REG_ARG_4 ASM_AARCH64_REG_X3
+#define REG_ARG_5 ASM_AARCH64_REG_X4
+
+#define REG_TEMP0 ASM_AARCH64_REG_X0
+#define REG_TEMP1 ASM_AARCH64_REG_X1
+#define REG_TEMP2 ASM_AARCH64_REG_X2
+
+#define REG_LOCAL_1 ASM_AARCH64_REG_X19
+#define REG_LOCAL_2 ASM_AARCH64_REG_X20
+#define REG_LOCAL_3 ASM_AARCH64_REG_X21
+#define REG_LOCAL_4 ASM_AARCH64_REG_X23
+#define REG_LOCAL_5 ASM_AARCH64_REG_X24
+#define REG_LOCAL_NUM (5)
+
+#define REG_FUN_TABLE ASM_AARCH64_REG_FUN_TABLE
+
+#define ASM_T               asm_aarch64_t
+#define ASM_END_PASS        asm_aarch64_end_pass
+#define ASM_ENTRY(as, nlocal) asm_aarch64_entry((as), (nlocal))
+#define ASM_EXIT(as)        asm_aarch64_exit((as))
+#define ASM_CALL_IND(as, idx) asm_aarch64_call_ind((as), (idx))
+
+#define ASM_JUMP            asm_aarch64_b_label
+#define ASM_JUMP_IF_REG_ZERO(as, reg, label, bool_test) \
+    asm_aarch64_jump_if_reg_zero((as), false, (reg), (label), (bool_test))
+#define ASM_JUMP_IF_REG_NONZERO(as, reg, label, bool_test) \
+    asm_aarch64_jump_if_reg_zero((as), true, (reg), (label), (bool_test))
+#define ASM_JUMP_IF_REG_EQ(as, reg1, reg2, label) \
+    do { \
+        asm_aarch64_cmp_reg_reg((as), (reg1), (reg2)); \
+        asm_aarch64_bcc_label((as), ASM_AARCH64_CC_EQ, (label)); \
+    } while (0)
+#define ASM_JUMP_REG(as, reg) asm_aarch64_br((as), (reg))
+
+#define ASM_MOV_LOCAL_REG(as, local_num, reg_src) asm_aarch64_mov_local_reg((as), (local_num), (reg_src))
+#define ASM_MOV_REG_IMM(as, reg_dest, imm) asm_aarch64_mov_reg_i64((as), (reg_dest), (imm))
+#define ASM_MOV_REG_LOCAL(as, reg_dest, local_num) asm_aarch64_mov_reg_local((as), (reg_dest), (local_num))
+#define ASM_MOV_REG_REG(as, reg_dest, reg_src) asm_aarch64_mov_reg_reg((as), (reg_dest), (reg_src))
+#define ASM_MOV_REG_LOCAL_ADDR(as, reg_dest, local_num) asm_aarch64_mov_reg_local_addr((as), (reg_dest), (local_num))
+#define ASM_MOV_REG_PCREL(as, reg_dest, label) asm_aarch64_mov_reg_pcrel((as), (reg_dest), (label))
+
+#define ASM_NOT_REG(as, reg_dest) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_ORN, (reg_dest), ASM_AARCH64_REG_XZR, (reg_dest))
+#define ASM_NEG_REG(as, reg_dest) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_SUB, (reg_dest), ASM_AARCH64_REG_XZR, (reg_dest))
+#define ASM_LSL_REG_REG(as, reg_dest, reg_shift) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_LSLV, (reg_dest), (reg_dest), (reg_shift))
+#define ASM_LSR_REG_REG(as, reg_dest, reg_shift) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_LSRV, (reg_dest), (reg_dest), (reg_shift))
+#define ASM_ASR_REG_REG(as, reg_dest, reg_shift) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_ASRV, (reg_dest), (reg_dest), (reg_shift))
+#define ASM_OR_REG_REG(as, reg_dest, reg_src) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_ORR, (reg_dest), (reg_dest), (reg_src))
+#define ASM_XOR_REG_REG(as, reg_dest, reg_src) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_EOR, (reg_dest), (reg_dest), (reg_src))
+#define ASM_AND_REG_REG(as, reg_dest, reg_src) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_AND, (reg_dest), (reg_dest), (reg_src))
+#define ASM_ADD_REG_REG(as, reg_dest, reg_src) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_ADD, (reg_dest), (reg_dest), (reg_src))
+#define ASM_SUB_REG_REG(as, reg_dest, reg_src) asm_aarch64_op_reg_reg_reg((as), ASM_AARCH64_OP_SUB, (reg_dest), (reg_dest), (reg_src))
+#define ASM_MUL_REG_REG(as, reg_dest, reg_src) asm_aarch64_mul_reg_reg_reg((as), (reg_dest), (reg_dest), (reg_src))
+
+#define ASM_LOAD_REG_REG_OFFSET(as, reg_dest, reg_base, word_offset) asm_aarch64_load_reg_reg_offset((as), ASM_AARCH64_SIZE_64, (reg_dest), (reg_base), (word_offset) * 8)
+#define ASM_LOAD8_REG_REG(as, reg_dest, reg_base) asm_aarch64_ldr_reg_reg_i12((as), ASM_AARCH64_SIZE_8, (reg_dest), (reg_base), 0)
+#define ASM_LOAD16_REG_REG(as, reg_dest, reg_base) asm_aarch64_ldr_reg_reg_i12((as), ASM_AARCH64_SIZE_16, (reg_dest), (reg_base), 0)
+#define ASM_LOAD16_REG_REG_OFFSET(as, reg_dest, reg_base, uint16_offset) asm_aarch64_load_reg_reg_offset((as), ASM_AARCH64_SIZE_16, (reg_dest), (reg_base), (uint16_offset) * 2)
+#define ASM_LOAD32_REG_REG(as, reg_dest, reg_base) asm_aarch64_ldr_reg_reg_i12((as), ASM_AARCH64_SIZE_32, (reg_dest), (reg_base), 0)
+
+#define ASM_STORE_REG_REG_OFFSET(as, reg_src, reg_base, word_offset) asm_aarch64_store_reg_reg_offset((as), ASM_AARCH64_SIZE_64, (reg_src), (reg_base), (word_offset) * 8)
+#define ASM_STORE8_REG_REG(as, reg_src, reg_base) asm_aarch64_str_reg_reg_i12((as), ASM_AARCH64_SIZE_8, (reg_src), (reg_base), 0)
+#define ASM_STORE16_REG_REG(as, reg_src, reg_base) asm_aarch64_str_reg_reg_i12((as), ASM_AARCH64_SIZE_16, (reg_src), (reg_base), 0)
+#define ASM_STORE32_REG_REG(as, reg_src, reg_base) asm_aarch64_str_reg_reg_i12((as), ASM_AARCH64_SIZE_32, (reg_src), (reg_base), 0)
+
+#endif // GENERIC_ASM_API
+
+#endif // MICROPY_INCLUDED_PY_ASMAARCH64_H
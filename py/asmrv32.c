@@ -0,0 +1,299 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 The MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <assert.h>
+
+#include "py/runtime.h"
+
+// wrapper around everything in this file
+#if MICROPY_EMIT_RV32
+
+#include "py/asmrv32.h"
+
+#define WORD_SIZE (4)
+#define SIGNED_FIT6(x) (-32 <= (x) && (x) < 32)
+#define SIGNED_FIT9(x) (-256 <= (x) && (x) < 256)
+#define SIGNED_FIT12(x) (-2048 <= (x) && (x) < 2048)
+#define SIGNED_FIT13(x) (-4096 <= (x) && (x) < 4096)
+#define SIGNED_FIT21(x) (-0x100000 <= (x) && (x) < 0x100000)
+
+// Registers saved on entry to a function, in the order they are stored on the stack
+static const uint8_t asm_rv32_saved_regs[ASM_RV32_NUM_REGS_SAVED] = {
+    ASM_RV32_REG_RA, ASM_RV32_REG_S0, ASM_RV32_REG_S1, ASM_RV32_REG_S2, ASM_RV32_REG_S3, ASM_RV32_REG_S4, ASM_RV32_REG_S5,
+};
+
+void asm_rv32_end_pass(asm_rv32_t *as) {
+    (void)as;
+    #if 0
+    // make a hex dump of the machine code
+    if (as->base.pass == MP_ASM_PASS_EMIT) {
+        uint8_t *d = as->base.code_base;
+        printf("RV32 ASM:");
+        for (int i = 0; i < ((as->base.code_size + 15) & ~15); ++i) {
+            if (i % 16 == 0) {
+                printf("\n%08x:", (uint32_t)&d[i]);
+            }
+            if (i % 2 == 0) {
+                printf(" ");
+            }
+            printf("%02x", d[i]);
+        }
+        printf("\n");
+    }
+    #endif
+}
+
+void asm_rv32_op16(asm_rv32_t *as, uint16_t op) {
+    uint8_t *c = mp_asm_base_get_cur_to_write_bytes(&as->base, 2);
+    if (c != NULL) {
+        c[0] = op;
+        c[1] = op >> 8;
+    }
+}
+
+void asm_rv32_op32(asm_rv32_t *as, uint32_t op) {
+    // instructions are only 2-byte aligned so write them as two halves
+    asm_rv32_op16(as, op);
+    asm_rv32_op16(as, op >> 16);
+}
+
+static void asm_rv32_adjust_sp(asm_rv32_t *as, int32_t delta) {
+    if (-512 <= delta && delta < 512) {
+        asm_rv32_op_c_addi16sp(as, delta);
+    } else if (SIGNED_FIT12(delta)) {
+        asm_rv32_op_addi(as, ASM_RV32_REG_SP, ASM_RV32_REG_SP, delta);
+    } else {
+        asm_rv32_mov_reg_i32(as, ASM_RV32_REG_T6, delta);
+        asm_rv32_op_c_add(as, ASM_RV32_REG_SP, ASM_RV32_REG_T6);
+    }
+}
+
+void asm_rv32_entry(asm_rv32_t *as, int num_locals) {
+    // adjust the stack-pointer to store ra, s0-s5 and locals, 16-byte aligned
+    as->stack_adjust = (((ASM_RV32_NUM_REGS_SAVED + num_locals) * WORD_SIZE) + 15) & ~15;
+    asm_rv32_adjust_sp(as, -as->stack_adjust);
+
+    // save return address and callee-save registers
+    for (int i = 0; i < ASM_RV32_NUM_REGS_SAVED; ++i) {
+        asm_rv32_op_c_swsp(as, asm_rv32_saved_regs[i], i * WORD_SIZE);
+    }
+}
+
+void asm_rv32_exit(asm_rv32_t *as) {
+    // restore registers
+    for (int i = ASM_RV32_NUM_REGS_SAVED - 1; i >= 0; --i) {
+        asm_rv32_op_c_lwsp(as, asm_rv32_saved_regs[i], i * WORD_SIZE);
+    }
+
+    // restore stack-pointer and return
+    asm_rv32_adjust_sp(as, as->stack_adjust);
+    asm_rv32_op_c_jr(as, ASM_RV32_REG_RA);
+}
+
+static size_t get_label_dest(asm_rv32_t *as, uint label) {
+    assert(label < as->base.max_num_labels);
+    return as->base.label_offsets[label];
+}
+
+static void asm_rv32_jal_label(asm_rv32_t *as, uint label) {
+    int32_t rel = get_label_dest(as, label) - as->base.code_offset;
+    if (as->base.pass == MP_ASM_PASS_EMIT && !SIGNED_FIT21(rel)) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("asm overflow"));
+    }
+    asm_rv32_op_jal(as, ASM_RV32_REG_ZERO, rel);
+}
+
+void asm_rv32_j_label(asm_rv32_t *as, uint label) {
+    size_t dest = get_label_dest(as, label);
+    int32_t rel = dest - as->base.code_offset;
+    if (dest != (size_t)-1 && rel <= 0 && SIGNED_FIT12(rel)) {
+        // is a short backwards jump, so we know the size of the jump on the first pass
+        asm_rv32_op_c_j(as, rel);
+        return;
+    }
+    // is a large backwards jump, or a forwards jump (that must be assumed large)
+    asm_rv32_jal_label(as, label);
+}
+
+void asm_rv32_bcc_reg_reg_label(asm_rv32_t *as, uint cond, uint rs1, uint rs2, uint label) {
+    // the compressed forms only exist for comparison of x8-x15 against zero
+    bool can_compress = rs2 == ASM_RV32_REG_ZERO && ASM_RV32_REG_IS_C(rs1)
+        && (cond == ASM_RV32_CC_EQ || cond == ASM_RV32_CC_NE);
+    size_t dest = get_label_dest(as, label);
+    int32_t rel = dest - as->base.code_offset;
+    if (dest != (size_t)-1 && rel <= 0) {
+        // is a backwards branch, so we know the size of the branch on the first pass
+        if (can_compress && SIGNED_FIT9(rel)) {
+            asm_rv32_op_c_bcc(as, cond, rs1, rel);
+            return;
+        } else if (SIGNED_FIT13(rel)) {
+            asm_rv32_op_bcc(as, cond, rs1, rs2, rel);
+            return;
+        }
+    }
+    // is a large backwards branch, or a forwards branch (that must be assumed large),
+    // so branch over an unconditional jump using the inverted condition
+    if (can_compress) {
+        asm_rv32_op_c_bcc(as, cond ^ 1, rs1, 2 + 4);
+    } else {
+        asm_rv32_op_bcc(as, cond ^ 1, rs1, rs2, 4 + 4);
+    }
+    asm_rv32_jal_label(as, label);
+}
+
+// convenience function; reg_dest may be the same as reg_src[12]
+void asm_rv32_setcc_reg_reg_reg(asm_rv32_t *as, uint cond, uint rd, uint rs1, uint rs2) {
+    switch (cond) {
+        case ASM_RV32_CC_EQ:
+        case ASM_RV32_CC_NE:
+            asm_rv32_op_sub(as, rd, rs1, rs2);
+            if (cond == ASM_RV32_CC_EQ) {
+                asm_rv32_op_sltiu(as, rd, rd, 1); // seqz
+            } else {
+                asm_rv32_op_sltu(as, rd, ASM_RV32_REG_ZERO, rd); // snez
+            }
+            return;
+        case ASM_RV32_CC_LT:
+        case ASM_RV32_CC_GE:
+            asm_rv32_op_slt(as, rd, rs1, rs2);
+            break;
+        default:
+            asm_rv32_op_sltu(as, rd, rs1, rs2);
+            break;
+    }
+    if (cond & 1) {
+        // GE and GEU are the inverse of LT and LTU
+        asm_rv32_op_xori(as, rd, rd, 1);
+    }
+}
+
+void asm_rv32_mov_reg_reg(asm_rv32_t *as, uint rd, uint rs) {
+    asm_rv32_op_c_mv(as, rd, rs);
+}
+
+void asm_rv32_mov_reg_i32(asm_rv32_t *as, uint rd, uint32_t i32) {
+    int32_t val = i32;
+    if (SIGNED_FIT6(val)) {
+        asm_rv32_op_c_li(as, rd, val);
+    } else if (SIGNED_FIT12(val)) {
+        asm_rv32_op_addi(as, rd, ASM_RV32_REG_ZERO, val);
+    } else {
+        // the low 12 bits are sign extended by addi, so round the upper part accordingly
+        uint32_t hi = (i32 + 0x800) >> 12;
+        int32_t lo = i32 - (hi << 12);
+        asm_rv32_op_lui(as, rd, hi);
+        if (lo != 0) {
+            asm_rv32_op_addi(as, rd, rd, lo);
+        }
+    }
+}
+
+void asm_rv32_mov_local_reg(asm_rv32_t *as, int local_num, uint rs) {
+    asm_rv32_store_reg_reg_offset(as, 2, rs, ASM_RV32_REG_SP, local_num * WORD_SIZE);
+}
+
+void asm_rv32_mov_reg_local(asm_rv32_t *as, uint rd, int local_num) {
+    asm_rv32_load_reg_reg_offset(as, 2, rd, ASM_RV32_REG_SP, local_num * WORD_SIZE);
+}
+
+void asm_rv32_mov_reg_local_addr(asm_rv32_t *as, uint rd, int local_num) {
+    uint off = local_num * WORD_SIZE;
+    if (ASM_RV32_REG_IS_C(rd) && 0 < off && off < 1024) {
+        asm_rv32_op_c_addi4spn(as, rd, off);
+    } else if (off < 2048) {
+        asm_rv32_op_addi(as, rd, ASM_RV32_REG_SP, off);
+    } else {
+        asm_rv32_mov_reg_i32(as, rd, off);
+        asm_rv32_op_c_add(as, rd, ASM_RV32_REG_SP);
+    }
+}
+
+void asm_rv32_mov_reg_pcrel(asm_rv32_t *as, uint rd, uint label) {
+    // Get relative offset from PC, the auipc+addi pair is always 8 bytes
+    size_t dest = get_label_dest(as, label);
+    int32_t rel = dest - as->base.code_offset;
+    uint32_t hi = ((uint32_t)rel + 0x800) >> 12;
+    int32_t lo = rel - (int32_t)(hi << 12);
+    asm_rv32_op_auipc(as, rd, hi);
+    asm_rv32_op_addi(as, rd, rd, lo);
+}
+
+void asm_rv32_add_reg_reg(asm_rv32_t *as, uint rd, uint rs) {
+    asm_rv32_op_c_add(as, rd, rs);
+}
+
+void asm_rv32_alu_reg_reg(asm_rv32_t *as, uint op, uint rd, uint rs) {
+    if (ASM_RV32_REG_IS_C(rd) && ASM_RV32_REG_IS_C(rs)) {
+        asm_rv32_op16(as, ASM_RV32_ENCODE_CA(0x23, ASM_RV32_REG_C(rd), op, ASM_RV32_REG_C(rs), 1));
+    } else if (op == ASM_RV32_ALU_SUB) {
+        asm_rv32_op_sub(as, rd, rd, rs);
+    } else if (op == ASM_RV32_ALU_XOR) {
+        asm_rv32_op_xor(as, rd, rd, rs);
+    } else if (op == ASM_RV32_ALU_OR) {
+        asm_rv32_op_or(as, rd, rd, rs);
+    } else {
+        asm_rv32_op_and(as, rd, rd, rs);
+    }
+}
+
+// size is log2 of the number of bytes to load, and only 16-bit and 32-bit loads are supported
+void asm_rv32_load_reg_reg_offset(asm_rv32_t *as, uint size, uint rd, uint rs1, uint offset) {
+    uint f3 = size == 2 ? 2 : 5; // lw or lhu
+    if (size == 2 && ASM_RV32_REG_IS_C(rd) && ASM_RV32_REG_IS_C(rs1) && offset < 128) {
+        asm_rv32_op_c_lw(as, rd, rs1, offset);
+    } else if (size == 2 && rs1 == ASM_RV32_REG_SP && offset < 256) {
+        asm_rv32_op_c_lwsp(as, rd, offset);
+    } else if (offset < 2048) {
+        asm_rv32_op32(as, ASM_RV32_ENCODE_I(ASM_RV32_OPCODE_LOAD, f3, rd, rs1, offset));
+    } else {
+        asm_rv32_mov_reg_i32(as, ASM_RV32_REG_T6, offset);
+        asm_rv32_op_c_add(as, ASM_RV32_REG_T6, rs1);
+        asm_rv32_op32(as, ASM_RV32_ENCODE_I(ASM_RV32_OPCODE_LOAD, f3, rd, ASM_RV32_REG_T6, 0));
+    }
+}
+
+// size is log2 of the number of bytes to store
+void asm_rv32_store_reg_reg_offset(asm_rv32_t *as, uint size, uint rs2, uint rs1, uint offset) {
+    if (size == 2 && ASM_RV32_REG_IS_C(rs2) && ASM_RV32_REG_IS_C(rs1) && offset < 128) {
+        asm_rv32_op_c_sw(as, rs2, rs1, offset);
+    } else if (size == 2 && rs1 == ASM_RV32_REG_SP && offset < 256) {
+        asm_rv32_op_c_swsp(as, rs2, offset);
+    } else if (offset < 2048) {
+        asm_rv32_op32(as, ASM_RV32_ENCODE_S(ASM_RV32_OPCODE_STORE, size, rs1, rs2, offset));
+    } else {
+        asm_rv32_mov_reg_i32(as, ASM_RV32_REG_T6, offset);
+        asm_rv32_op_c_add(as, ASM_RV32_REG_T6, rs1);
+        asm_rv32_op32(as, ASM_RV32_ENCODE_S(ASM_RV32_OPCODE_STORE, size, ASM_RV32_REG_T6, rs2, 0));
+    }
+}
+
+void asm_rv32_call_ind(asm_rv32_t *as, uint idx) {
+    asm_rv32_load_reg_reg_offset(as, 2, ASM_RV32_REG_T6, ASM_RV32_REG_FUN_TABLE, idx * WORD_SIZE);
+    asm_rv32_op_c_jalr(as, ASM_RV32_REG_T6);
+}
+
+#endif // MICROPY_EMIT_RV32
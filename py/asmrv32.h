@@ -0,0 +1,396 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 The MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MICROPY_INCLUDED_PY_ASMRV32_H
+#define MICROPY_INCLUDED_PY_ASMRV32_H
+
+#include "py/misc.h"
+#include "py/asmbase.h"
+
+// calling conventions (RV32 ILP32 ABI):
+// up to 8 args in a0-a7
+// return value in a0
+// return address in ra
+// stack pointer is sp, stack full descending, is aligned to 16 bytes
+// callee save: sp, s0-s11
+// caller save: ra, t0-t6, a0-a7
+// t6 is reserved by this assembler as a scratch register for large offsets
+
+#define ASM_RV32_REG_ZERO (0)
+#define ASM_RV32_REG_RA   (1)
+#define ASM_RV32_REG_SP   (2)
+#define ASM_RV32_REG_GP   (3)
+#define ASM_RV32_REG_TP   (4)
+#define ASM_RV32_REG_T0   (5)
+#define ASM_RV32_REG_T1   (6)
+#define ASM_RV32_REG_T2   (7)
+#define ASM_RV32_REG_S0   (8)
+#define ASM_RV32_REG_S1   (9)
+#define ASM_RV32_REG_A0   (10)
+#define ASM_RV32_REG_A1   (11)
+#define ASM_RV32_REG_A2   (12)
+#define ASM_RV32_REG_A3   (13)
+#define ASM_RV32_REG_A4   (14)
+#define ASM_RV32_REG_A5   (15)
+#define ASM_RV32_REG_A6   (16)
+#define ASM_RV32_REG_A7   (17)
+#define ASM_RV32_REG_S2   (18)
+#define ASM_RV32_REG_S3   (19)
+#define ASM_RV32_REG_S4   (20)
+#define ASM_RV32_REG_S5   (21)
+#define ASM_RV32_REG_T6   (31)
+
+// for bcc and setcc, values are the funct3 field of the branch instructions
+#define ASM_RV32_CC_EQ  (0)
+#define ASM_RV32_CC_NE  (1)
+#define ASM_RV32_CC_LT  (4)
+#define ASM_RV32_CC_GE  (5)
+#define ASM_RV32_CC_LTU (6)
+#define ASM_RV32_CC_GEU (7)
+
+// major opcodes
+#define ASM_RV32_OPCODE_LOAD   (0x03)
+#define ASM_RV32_OPCODE_OPIMM  (0x13)
+#define ASM_RV32_OPCODE_AUIPC  (0x17)
+#define ASM_RV32_OPCODE_STORE  (0x23)
+#define ASM_RV32_OPCODE_OP     (0x33)
+#define ASM_RV32_OPCODE_LUI    (0x37)
+#define ASM_RV32_OPCODE_BRANCH (0x63)
+#define ASM_RV32_OPCODE_JALR   (0x67)
+#define ASM_RV32_OPCODE_JAL    (0x6f)
+
+// macros for encoding instructions
+#define ASM_RV32_ENCODE_R(op, f3, f7, rd, rs1, rs2) \
+    (((uint32_t)(f7) << 25) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | (op))
+#define ASM_RV32_ENCODE_I(op, f3, rd, rs1, imm12) \
+    ((((uint32_t)(imm12) & 0xfff) << 20) | ((rs1) << 15) | ((f3) << 12) | ((rd) << 7) | (op))
+#define ASM_RV32_ENCODE_S(op, f3, rs1, rs2, imm12) \
+    ((((uint32_t)(imm12) & 0xfe0) << 20) | ((rs2) << 20) | ((rs1) << 15) | ((f3) << 12) | (((imm12) & 0x1f) << 7) | (op))
+#define ASM_RV32_ENCODE_B(op, f3, rs1, rs2, imm13) \
+    ((((uint32_t)(imm13) & 0x1000) << 19) | (((imm13) & 0x7e0) << 20) | ((rs2) << 20) | ((rs1) << 15) \
+    | ((f3) << 12) | (((imm13) & 0x1e) << 7) | (((imm13) & 0x800) >> 4) | (op))
+#define ASM_RV32_ENCODE_U(op, rd, imm20) \
+    ((((uint32_t)(imm20) & 0xfffff) << 12) | ((rd) << 7) | (op))
+#define ASM_RV32_ENCODE_J(op, rd, imm21) \
+    ((((uint32_t)(imm21) & 0x100000) << 11) | (((imm21) & 0x7fe) << 20) | (((imm21) & 0x800) << 9) \
+    | ((imm21) & 0xff000) | ((rd) << 7) | (op))
+
+// macros for encoding compressed (RVC) instructions
+#define ASM_RV32_ENCODE_CR(f4, rd, rs2, op) \
+    (((f4) << 12) | ((rd) << 7) | ((rs2) << 2) | (op))
+#define ASM_RV32_ENCODE_CI(f3, rd, imm6, op) \
+    (((f3) << 13) | (((imm6) & 0x20) << 7) | ((rd) << 7) | (((imm6) & 0x1f) << 2) | (op))
+#define ASM_RV32_ENCODE_CA(f6, rd_, f2, rs2_, op) \
+    (((f6) << 10) | ((rd_) << 7) | ((f2) << 5) | ((rs2_) << 2) | (op))
+
+// whether a register is one of x8-x15, addressable by most RVC instructions
+#define ASM_RV32_REG_IS_C(r) (((r) & ~7) == 8)
+#define ASM_RV32_REG_C(r) ((r) & 7)
+
+// Number of registers saved on the stack upon entry to function
+#define ASM_RV32_NUM_REGS_SAVED (7)
+
+typedef struct _asm_rv32_t {
+    mp_asm_base_t base;
+    uint32_t stack_adjust;
+} asm_rv32_t;
+
+void asm_rv32_end_pass(asm_rv32_t *as);
+
+void asm_rv32_entry(asm_rv32_t *as, int num_locals);
+void asm_rv32_exit(asm_rv32_t *as);
+
+void asm_rv32_op16(asm_rv32_t *as, uint16_t op);
+void asm_rv32_op32(asm_rv32_t *as, uint32_t op);
+
+// raw instructions
+
+static inline void asm_rv32_op_add(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 0, 0, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_addi(asm_rv32_t *as, uint rd, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_I(ASM_RV32_OPCODE_OPIMM, 0, rd, rs1, imm12));
+}
+
+static inline void asm_rv32_op_and(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 7, 0, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_auipc(asm_rv32_t *as, uint rd, uint32_t imm20) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_U(ASM_RV32_OPCODE_AUIPC, rd, imm20));
+}
+
+static inline void asm_rv32_op_bcc(asm_rv32_t *as, uint cond, uint rs1, uint rs2, int32_t rel13) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_B(ASM_RV32_OPCODE_BRANCH, cond, rs1, rs2, rel13));
+}
+
+static inline void asm_rv32_op_jal(asm_rv32_t *as, uint rd, int32_t rel21) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_J(ASM_RV32_OPCODE_JAL, rd, rel21));
+}
+
+static inline void asm_rv32_op_lbu(asm_rv32_t *as, uint rd, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_I(ASM_RV32_OPCODE_LOAD, 4, rd, rs1, imm12));
+}
+
+static inline void asm_rv32_op_lhu(asm_rv32_t *as, uint rd, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_I(ASM_RV32_OPCODE_LOAD, 5, rd, rs1, imm12));
+}
+
+static inline void asm_rv32_op_lui(asm_rv32_t *as, uint rd, uint32_t imm20) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_U(ASM_RV32_OPCODE_LUI, rd, imm20));
+}
+
+static inline void asm_rv32_op_lw(asm_rv32_t *as, uint rd, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_I(ASM_RV32_OPCODE_LOAD, 2, rd, rs1, imm12));
+}
+
+static inline void asm_rv32_op_mul(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 0, 1, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_or(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 6, 0, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_sb(asm_rv32_t *as, uint rs2, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_S(ASM_RV32_OPCODE_STORE, 0, rs1, rs2, imm12));
+}
+
+static inline void asm_rv32_op_sh(asm_rv32_t *as, uint rs2, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_S(ASM_RV32_OPCODE_STORE, 1, rs1, rs2, imm12));
+}
+
+static inline void asm_rv32_op_sll(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 1, 0, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_slt(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 2, 0, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_sltiu(asm_rv32_t *as, uint rd, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_I(ASM_RV32_OPCODE_OPIMM, 3, rd, rs1, imm12));
+}
+
+static inline void asm_rv32_op_sltu(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 3, 0, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_sra(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 5, 0x20, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_srl(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 5, 0, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_sub(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 0, 0x20, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_sw(asm_rv32_t *as, uint rs2, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_S(ASM_RV32_OPCODE_STORE, 2, rs1, rs2, imm12));
+}
+
+static inline void asm_rv32_op_xor(asm_rv32_t *as, uint rd, uint rs1, uint rs2) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_R(ASM_RV32_OPCODE_OP, 4, 0, rd, rs1, rs2));
+}
+
+static inline void asm_rv32_op_xori(asm_rv32_t *as, uint rd, uint rs1, int imm12) {
+    asm_rv32_op32(as, ASM_RV32_ENCODE_I(ASM_RV32_OPCODE_OPIMM, 4, rd, rs1, imm12));
+}
+
+// raw compressed instructions
+
+static inline void asm_rv32_op_c_add(asm_rv32_t *as, uint rd, uint rs2) {
+    asm_rv32_op16(as, ASM_RV32_ENCODE_CR(9, rd, rs2, 2));
+}
+
+// Argument must be a non-zero multiple of 16 in the range (-512 .. 496) inclusive.
+static inline void asm_rv32_op_c_addi16sp(asm_rv32_t *as, int imm10) {
+    asm_rv32_op16(as, 0x6101 | ((imm10 & 0x200) << 3) | ((imm10 & 0x10) << 2) | ((imm10 & 0x40) >> 1)
+        | ((imm10 & 0x180) >> 4) | ((imm10 & 0x20) >> 3));
+}
+
+// Argument must be a non-zero multiple of 4 less than 1024, rd must be x8-x15.
+static inline void asm_rv32_op_c_addi4spn(asm_rv32_t *as, uint rd, uint imm10) {
+    asm_rv32_op16(as, ((imm10 & 0x30) << 7) | ((imm10 & 0x3c0) << 1) | ((imm10 & 0x4) << 4)
+        | ((imm10 & 0x8) << 2) | (ASM_RV32_REG_C(rd) << 2));
+}
+
+// Argument must be even and in the range (-256 .. 254) inclusive, rs1 must be x8-x15.
+static inline void asm_rv32_op_c_bcc(asm_rv32_t *as, uint cond, uint rs1, int32_t rel9) {
+    asm_rv32_op16(as, (cond == ASM_RV32_CC_EQ ? 0xc001 : 0xe001) | ((rel9 & 0x100) << 4) | ((rel9 & 0x18) << 7)
+        | (ASM_RV32_REG_C(rs1) << 7) | ((rel9 & 0xc0) >> 1) | ((rel9 & 0x6) << 2) | ((rel9 & 0x20) >> 3));
+}
+
+// Argument must be even and in the range (-2048 .. 2046) inclusive.
+static inline void asm_rv32_op_c_j(asm_rv32_t *as, int32_t rel12) {
+    asm_rv32_op16(as, 0xa001 | ((rel12 & 0x800) << 1) | ((rel12 & 0x10) << 7) | ((rel12 & 0x300) << 1)
+        | ((rel12 & 0x400) >> 2) | ((rel12 & 0x40) << 1) | ((rel12 & 0x80) >> 1) | ((rel12 & 0xe) << 2)
+        | ((rel12 & 0x20) >> 3));
+}
+
+static inline void asm_rv32_op_c_jalr(asm_rv32_t *as, uint rs1) {
+    asm_rv32_op16(as, ASM_RV32_ENCODE_CR(9, rs1, 0, 2));
+}
+
+static inline void asm_rv32_op_c_jr(asm_rv32_t *as, uint rs1) {
+    asm_rv32_op16(as, ASM_RV32_ENCODE_CR(8, rs1, 0, 2));
+}
+
+// Argument must be in the range (-32 .. 31) inclusive.
+static inline void asm_rv32_op_c_li(asm_rv32_t *as, uint rd, int imm6) {
+    asm_rv32_op16(as, ASM_RV32_ENCODE_CI(2, rd, imm6, 1));
+}
+
+// Argument must be a multiple of 4 less than 128, rd and rs1 must be x8-x15.
+static inline void asm_rv32_op_c_lw(asm_rv32_t *as, uint rd, uint rs1, uint imm7) {
+    asm_rv32_op16(as, 0x4000 | ((imm7 & 0x38) << 7) | (ASM_RV32_REG_C(rs1) << 7) | ((imm7 & 0x4) << 4)
+        | ((imm7 & 0x40) >> 1) | (ASM_RV32_REG_C(rd) << 2));
+}
+
+// Argument must be a multiple of 4 less than 256.
+static inline void asm_rv32_op_c_lwsp(asm_rv32_t *as, uint rd, uint imm8) {
+    asm_rv32_op16(as, 0x4002 | ((imm8 & 0x20) << 7) | (rd << 7) | ((imm8 & 0x1c) << 2) | ((imm8 & 0xc0) >> 4));
+}
+
+static inline void asm_rv32_op_c_mv(asm_rv32_t *as, uint rd, uint rs2) {
+    asm_rv32_op16(as, ASM_RV32_ENCODE_CR(8, rd, rs2, 2));
+}
+
+// Argument must be a multiple of 4 less than 128, rs2 and rs1 must be x8-x15.
+static inline void asm_rv32_op_c_sw(asm_rv32_t *as, uint rs2, uint rs1, uint imm7) {
+    asm_rv32_op16(as, 0xc000 | ((imm7 & 0x38) << 7) | (ASM_RV32_REG_C(rs1) << 7) | ((imm7 & 0x4) << 4)
+        | ((imm7 & 0x40) >> 1) | (ASM_RV32_REG_C(rs2) << 2));
+}
+
+// Argument must be a multiple of 4 less than 256.
+static inline void asm_rv32_op_c_swsp(asm_rv32_t *as, uint rs2, uint imm8) {
+    asm_rv32_op16(as, 0xc002 | ((imm8 & 0x3c) << 7) | ((imm8 & 0xc0) << 1) | (rs2 << 2));
+}
+
+// convenience functions
+void asm_rv32_j_label(asm_rv32_t *as, uint label);
+void asm_rv32_bcc_reg_reg_label(asm_rv32_t *as, uint cond, uint rs1, uint rs2, uint label);
+void asm_rv32_setcc_reg_reg_reg(asm_rv32_t *as, uint cond, uint rd, uint rs1, uint rs2);
+void asm_rv32_mov_reg_reg(asm_rv32_t *as, uint rd, uint rs);
+void asm_rv32_mov_reg_i32(asm_rv32_t *as, uint rd, uint32_t i32);
+void asm_rv32_mov_local_reg(asm_rv32_t *as, int local_num, uint rs);
+void asm_rv32_mov_reg_local(asm_rv32_t *as, uint rd, int local_num);
+void asm_rv32_mov_reg_local_addr(asm_rv32_t *as, uint rd, int local_num);
+void asm_rv32_mov_reg_pcrel(asm_rv32_t *as, uint rd, uint label);
+void asm_rv32_add_reg_reg(asm_rv32_t *as, uint rd, uint rs);
+void asm_rv32_alu_reg_reg(asm_rv32_t *as, uint op, uint rd, uint rs);
+void asm_rv32_load_reg_reg_offset(asm_rv32_t *as, uint size, uint rd, uint rs1, uint offset);
+void asm_rv32_store_reg_reg_offset(asm_rv32_t *as, uint size, uint rs2, uint rs1, uint offset);
+void asm_rv32_call_ind(asm_rv32_t *as, uint idx);
+
+// for asm_rv32_alu_reg_reg, values are the funct6 low bits of the RVC arithmetic instructions
+#define ASM_RV32_ALU_SUB (0)
+#define ASM_RV32_ALU_XOR (1)
+#define ASM_RV32_ALU_OR  (2)
+#define ASM_RV32_ALU_AND (3)
+
+// Holds a pointer to mp_fun_table
+#define ASM_RV32_REG_FUN_TABLE ASM_RV32_REG_S1
+
+#if GENERIC_ASM_API
+
+// The following macros provide a (mostly) arch-independent API to
+// generate native code, and are used by the native emitter.
+
+#define ASM_WORD_SIZE (4)
+
+#define REG_RET ASM_RV32_REG_A0
+#define REG_ARG_1 ASM_RV32_REG_A0
+#define REG_ARG_2 ASM_RV32_REG_A1
+#define REG_ARG_3 ASM_RV32_REG_A2
+#define REG_ARG_4 ASM_RV32_REG_A3
+#define REG_ARG_5 ASM_RV32_REG_A4
+
+#define REG_TEMP0 ASM_RV32_REG_A0
+#define REG_TEMP1 ASM_RV32_REG_A1
+#define REG_TEMP2 ASM_RV32_REG_A2
+
+#define REG_LOCAL_1 ASM_RV32_REG_S0
+#define REG_LOCAL_2 ASM_RV32_REG_S2
+#define REG_LOCAL_3 ASM_RV32_REG_S3
+#define REG_LOCAL_4 ASM_RV32_REG_S4
+#define REG_LOCAL_5 ASM_RV32_REG_S5
+#define REG_LOCAL_NUM (5)
+
+#define ASM_NUM_REGS_SAVED ASM_RV32_NUM_REGS_SAVED
+#define REG_FUN_TABLE ASM_RV32_REG_FUN_TABLE
+
+#define ASM_T               asm_rv32_t
+#define ASM_END_PASS        asm_rv32_end_pass
+#define ASM_ENTRY(as, nlocal) asm_rv32_entry((as), (nlocal))
+#define ASM_EXIT(as)        asm_rv32_exit((as))
+#define ASM_CALL_IND(as, idx) asm_rv32_call_ind((as), (idx))
+
+#define ASM_JUMP            asm_rv32_j_label
+#define ASM_JUMP_IF_REG_ZERO(as, reg, label, bool_test) \
+    asm_rv32_bcc_reg_reg_label(as, ASM_RV32_CC_EQ, reg, ASM_RV32_REG_ZERO, label)
+#define ASM_JUMP_IF_REG_NONZERO(as, reg, label, bool_test) \
+    asm_rv32_bcc_reg_reg_label(as, ASM_RV32_CC_NE, reg, ASM_RV32_REG_ZERO, label)
+#define ASM_JUMP_IF_REG_EQ(as, reg1, reg2, label) \
+    asm_rv32_bcc_reg_reg_label(as, ASM_RV32_CC_EQ, reg1, reg2, label)
+#define ASM_JUMP_REG(as, reg) asm_rv32_op_c_jr((as), (reg))
+
+#define ASM_MOV_LOCAL_REG(as, local_num, reg_src) asm_rv32_mov_local_reg((as), ASM_NUM_REGS_SAVED + (local_num), (reg_src))
+#define ASM_MOV_REG_IMM(as, reg_dest, imm) asm_rv32_mov_reg_i32((as), (reg_dest), (imm))
+#define ASM_MOV_REG_LOCAL(as, reg_dest, local_num) asm_rv32_mov_reg_local((as), (reg_dest), ASM_NUM_REGS_SAVED + (local_num))
+#define ASM_MOV_REG_REG(as, reg_dest, reg_src) asm_rv32_mov_reg_reg((as), (reg_dest), (reg_src))
+#define ASM_MOV_REG_LOCAL_ADDR(as, reg_dest, local_num) asm_rv32_mov_reg_local_addr((as), (reg_dest), ASM_NUM_REGS_SAVED + (local_num))
+#define ASM_MOV_REG_PCREL(as, reg_dest, label) asm_rv32_mov_reg_pcrel((as), (reg_dest), (label))
+
+#define ASM_NOT_REG(as, reg_dest) asm_rv32_op_xori((as), (reg_dest), (reg_dest), -1)
+#define ASM_NEG_REG(as, reg_dest) asm_rv32_op_sub((as), (reg_dest), ASM_RV32_REG_ZERO, (reg_dest))
+#define ASM_LSL_REG_REG(as, reg_dest, reg_shift) asm_rv32_op_sll((as), (reg_dest), (reg_dest), (reg_shift))
+#define ASM_LSR_REG_REG(as, reg_dest, reg_shift) asm_rv32_op_srl((as), (reg_dest), (reg_dest), (reg_shift))
+#define ASM_ASR_REG_REG(as, reg_dest, reg_shift) asm_rv32_op_sra((as), (reg_dest), (reg_dest), (reg_shift))
+#define ASM_OR_REG_REG(as, reg_dest, reg_src) asm_rv32_alu_reg_reg((as), ASM_RV32_ALU_OR, (reg_dest), (reg_src))
+#define ASM_XOR_REG_REG(as, reg_dest, reg_src) asm_rv32_alu_reg_reg((as), ASM_RV32_ALU_XOR, (reg_dest), (reg_src))
+#define ASM_AND_REG_REG(as, reg_dest, reg_src) asm_rv32_alu_reg_reg((as), ASM_RV32_ALU_AND, (reg_dest), (reg_src))
+#define ASM_ADD_REG_REG(as, reg_dest, reg_src) asm_rv32_add_reg_reg((as), (reg_dest), (reg_src))
+#define ASM_SUB_REG_REG(as, reg_dest, reg_src) asm_rv32_alu_reg_reg((as), ASM_RV32_ALU_SUB, (reg_dest), (reg_src))
+#define ASM_MUL_REG_REG(as, reg_dest, reg_src) asm_rv32_op_mul((as), (reg_dest), (reg_dest), (reg_src))
+
+#define ASM_LOAD_REG_REG_OFFSET(as, reg_dest, reg_base, word_offset) asm_rv32_load_reg_reg_offset((as), 2, (reg_dest), (reg_base), (word_offset) * 4)
+#define ASM_LOAD8_REG_REG(as, reg_dest, reg_base) asm_rv32_op_lbu((as), (reg_dest), (reg_base), 0)
+#define ASM_LOAD16_REG_REG(as, reg_dest, reg_base) asm_rv32_op_lhu((as), (reg_dest), (reg_base), 0)
+#define ASM_LOAD16_REG_REG_OFFSET(as, reg_dest, reg_base, uint16_offset) asm_rv32_load_reg_reg_offset((as), 1, (reg_dest), (reg_base), (uint16_offset) * 2)
+#define ASM_LOAD32_REG_REG(as, reg_dest, reg_base) asm_rv32_load_reg_reg_offset((as), 2, (reg_dest), (reg_base), 0)
+
+#define ASM_STORE_REG_REG_OFFSET(as, reg_src, reg_base, word_offset) asm_rv32_store_reg_reg_offset((as), 2, (reg_src), (reg_base), (word_offset) * 4)
+#define ASM_STORE8_REG_REG(as, reg_src, reg_base) asm_rv32_op_sb((as), (reg_src), (reg_base), 0)
+#define ASM_STORE16_REG_REG(as, reg_src, reg_base) asm_rv32_op_sh((as), (reg_src), (reg_base), 0)
+#define ASM_STORE32_REG_REG(as, reg_src, reg_base) asm_rv32_store_reg_reg_offset((as), 2, (reg_src), (reg_base), 0)
+
+#endif // GENERIC_ASM_API
+
+#endif // MICROPY_INCLUDED_PY_ASMRV32_H
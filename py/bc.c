@@ -131,6 +131,13 @@ static void mp_setup_code_state_helper(mp_code_state_t *code_state, size_t n_arg
     // get the function object that we want to set up (could be bytecode or native code)
     mp_obj_fun_bc_t *self = code_state->fun_bc;
 
+    #if MICROPY_OPT_KWARG_SLOT_CACHE
+    // the start of the function's code identifies it in the kwarg slot cache; it
+    // is a head pointer, unlike the prelude of native code, so a cache entry
+    // keeps the code alive and can't match a reused block
+    const byte *code = self->bytecode;
+    #endif
+
     // Get cached n_state (rather than decode it again)
     size_t n_state = code_state->n_state;
 
@@ -192,6 +199,10 @@ static void mp_setup_code_state_helper(mp_code_state_t *code_state, size_t n_arg
         DEBUG_printf("Initial args: ");
         dump_args(code_state_state + n_state - n_pos_args - n_kwonly_args, n_pos_args + n_kwonly_args);
 
+        #if MICROPY_OPT_KWARG_SLOT_CACHE
+        mp_kwarg_slot_cache_entry_t *kwarg_slot_cache = MP_STATE_THREAD(kwarg_slot_cache);
+        #endif
+
         mp_obj_t dict = MP_OBJ_NULL;
         if ((scope_flags & MP_SCOPE_FLAG_VARKEYWORDS) != 0) {
             dict = mp_obj_new_dict(n_kw); // TODO: better go conservative with 0?
@@ -202,6 +213,19 @@ static void mp_setup_code_state_helper(mp_code_state_t *code_state, size_t n_arg
             // the keys in kwargs are expected to be qstr objects
             mp_obj_t wanted_arg_name = kwargs[2 * i];
 
+            #if MICROPY_OPT_KWARG_SLOT_CACHE
+            size_t cache_idx = (((uintptr_t)code >> 2) + MP_OBJ_QSTR_VALUE(wanted_arg_name)) % MICROPY_OPT_KWARG_SLOT_CACHE_SIZE;
+            if (kwarg_slot_cache[cache_idx].code == code
+                && MP_OBJ_NEW_QSTR(kwarg_slot_cache[cache_idx].name) == wanted_arg_name) {
+                size_t j = kwarg_slot_cache[cache_idx].slot;
+                if (code_state_state[n_state - 1 - j] != MP_OBJ_NULL) {
+                    goto error_multiple;
+                }
+                code_state_state[n_state - 1 - j] = kwargs[2 * i + 1];
+                continue;
+            }
+            #endif
+
             // get pointer to arg_names array
             const uint8_t *arg_names = code_state->ip;
             arg_names = mp_decode_uint_skip(arg_names);
@@ -218,6 +242,11 @@ static void mp_setup_code_state_helper(mp_code_state_t *code_state, size_t n_arg
                             MP_ERROR_TEXT("function got multiple values for argument '%q'"), MP_OBJ_QSTR_VALUE(wanted_arg_name));
                     }
                     code_state_state[n_state - 1 - j] = kwargs[2 * i + 1];
+                    #if MICROPY_OPT_KWARG_SLOT_CACHE
+                    kwarg_slot_cache[cache_idx].code = code;
+                    kwarg_slot_cache[cache_idx].name = arg_qstr;
+                    kwarg_slot_cache[cache_idx].slot = j;
+                    #endif
                     goto continue2;
                 }
             }
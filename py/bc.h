@@ -223,10 +223,32 @@ typedef struct _mp_compiled_module_t {
     #endif
 } mp_compiled_module_t;
 
+#if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+// Stub stored in the globals of a frozen module in place of a function defined
+// at its top level, until the function is first used.
+typedef struct _mp_obj_fun_lazy_t {
+    mp_obj_base_t base;
+    const void *proto_fun;
+} mp_obj_fun_lazy_t;
+
+// Globals of a frozen module that may hold mp_obj_fun_lazy_t stubs, while
+// dict.map.is_lazy is set.
+typedef struct _mp_obj_module_lazy_globals_t {
+    mp_obj_dict_t dict;
+    const mp_module_context_t *context;
+    struct _mp_raw_code_t *const *children; // children of the module's code
+    const mp_obj_fun_lazy_t *lazy_funs; // a stub for each of those children
+} mp_obj_module_lazy_globals_t;
+#endif
+
 // Outer level struct defining a frozen module.
 typedef struct _mp_frozen_module_t {
     const mp_module_constants_t constants;
     const void *proto_fun;
+    size_t n_globals; // number of names the module is known to define
+    #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+    const mp_obj_fun_lazy_t *lazy_funs; // stubs for the module's children, or NULL
+    #endif
 } mp_frozen_module_t;
 
 // State for an executing function.
@@ -279,6 +301,7 @@ mp_vm_return_kind_t mp_execute_bytecode(mp_code_state_t *code_state,
 #endif
     mp_obj_t inject_exc);
 mp_code_state_t *mp_obj_fun_bc_prepare_codestate(mp_obj_t func, size_t n_args, size_t n_kw, const mp_obj_t *args);
+void mp_obj_fun_bc_free_codestate(mp_code_state_t *code_state);
 void mp_setup_code_state(mp_code_state_t *code_state, size_t n_args, size_t n_kw, const mp_obj_t *args);
 void mp_setup_code_state_native(mp_code_state_native_t *code_state, size_t n_args, size_t n_kw, const mp_obj_t *args);
 void mp_bytecode_print(const mp_print_t *print, const struct _mp_raw_code_t *rc, size_t fun_data_len, const mp_module_constants_t *cm);
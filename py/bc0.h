@@ -56,9 +56,9 @@
 #define MP_BC_BASE_QSTR_O                   (0x10) // LLLLLLSSSDDII---
 #define MP_BC_BASE_VINT_E                   (0x20) // MMLLLLSSDDBBBBBB
 #define MP_BC_BASE_VINT_O                   (0x30) // UUMMCCCC--------
-#define MP_BC_BASE_JUMP_E                   (0x40) // J-JJJJJEEEEF----
+#define MP_BC_BASE_JUMP_E                   (0x40) // JLJJJJJEEEEF----
 #define MP_BC_BASE_BYTE_O                   (0x50) // LLLLSSDTTTTTEEFF
-#define MP_BC_BASE_BYTE_E                   (0x60) // --BREEEYYI------
+#define MP_BC_BASE_BYTE_E                   (0x60) // SSBREEEYYI------
 #define MP_BC_LOAD_CONST_SMALL_INT_MULTI    (0x70) // LLLLLLLLLLLLLLLL
 //                                          (0x80) // LLLLLLLLLLLLLLLL
 //                                          (0x90) // LLLLLLLLLLLLLLLL
@@ -94,6 +94,7 @@
 #define MP_BC_LOAD_SUPER_METHOD             (MP_BC_BASE_QSTR_O + 0x05) // qstr
 #define MP_BC_LOAD_BUILD_CLASS              (MP_BC_BASE_BYTE_O + 0x04)
 #define MP_BC_LOAD_SUBSCR                   (MP_BC_BASE_BYTE_O + 0x05)
+#define MP_BC_LOAD_FAST_CACHED              (MP_BC_BASE_JUMP_E + 0x01) // signed relative bytecode offset; then a byte
 
 #define MP_BC_STORE_FAST_N                  (MP_BC_BASE_VINT_E + 0x06) // uint
 #define MP_BC_STORE_DEREF                   (MP_BC_BASE_VINT_E + 0x07) // uint
@@ -101,6 +102,8 @@
 #define MP_BC_STORE_GLOBAL                  (MP_BC_BASE_QSTR_O + 0x07) // qstr
 #define MP_BC_STORE_ATTR                    (MP_BC_BASE_QSTR_O + 0x08) // qstr
 #define MP_BC_STORE_SUBSCR                  (MP_BC_BASE_BYTE_O + 0x06)
+#define MP_BC_STORE_FAST_CACHED             (MP_BC_BASE_BYTE_E + 0x00) // byte
+#define MP_BC_STORE_FAST_CACHED_ATTR        (MP_BC_BASE_BYTE_E + 0x01) // byte
 
 #define MP_BC_DELETE_FAST                   (MP_BC_BASE_VINT_E + 0x08) // uint
 #define MP_BC_DELETE_DEREF                  (MP_BC_BASE_VINT_E + 0x09) // uint
@@ -139,6 +139,9 @@ static void mp_help_print_obj(const mp_obj_t obj) {
 
     mp_map_t *map = NULL;
     if (type == &mp_type_module) {
+        #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+        mp_module_lazy_resolve_all(mp_obj_module_get_globals(obj));
+        #endif
         map = &mp_obj_module_get_globals(obj)->map;
     } else {
         if (type == &mp_type_type) {
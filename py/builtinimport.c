@@ -196,6 +196,28 @@ static void do_execute_proto_fun(const mp_module_context_t *context, mp_proto_fu
 }
 #endif
 
+#if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+// Give a frozen module globals that can hold stubs for its top-level functions.
+static void do_make_globals_lazy(mp_module_context_t *context, const mp_frozen_module_t *frozen) {
+    mp_obj_module_lazy_globals_t *lazy = m_new_obj(mp_obj_module_lazy_globals_t);
+    mp_obj_dict_init(&lazy->dict, frozen->n_globals);
+    lazy->dict.map.is_versioned = 1;
+    lazy->dict.map.is_lazy = 1;
+    lazy->context = context;
+    lazy->children = ((const mp_raw_code_t *)frozen->proto_fun)->children;
+    lazy->lazy_funs = frozen->lazy_funs;
+
+    // keep the names already stored, such as __name__ and __path__
+    mp_map_t *map = &context->module.globals->map;
+    for (size_t i = 0; i < map->alloc; i++) {
+        if (mp_map_slot_is_filled(map, i)) {
+            mp_obj_dict_store(MP_OBJ_FROM_PTR(&lazy->dict), map->table[i].key, map->table[i].value);
+        }
+    }
+    context->module.globals = &lazy->dict;
+}
+#endif
+
 static void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     #if MICROPY_MODULE_FROZEN || MICROPY_ENABLE_COMPILER || (MICROPY_PERSISTENT_CODE_LOAD && MICROPY_HAS_FILE_READER)
     const char *file_str = vstr_null_terminated_str(file);
@@ -225,6 +247,13 @@ static void do_load(mp_module_context_t *module_obj, vstr_t *file) {
         if (frozen_type == MP_FROZEN_MPY) {
             const mp_frozen_module_t *frozen = modref;
             module_obj->constants = frozen->constants;
+            #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+            if (frozen->lazy_funs != NULL) {
+                do_make_globals_lazy(module_obj, frozen);
+            }
+            #endif
+            // Size the globals up front so they aren't rehashed as they're filled.
+            mp_map_reserve(&module_obj->module.globals->map, frozen->n_globals);
             #if MICROPY_PY___FILE__
             qstr frozen_file_qstr = qstr_from_str(file_str + frozen_path_prefix_len);
             #else
@@ -252,6 +281,18 @@ static void do_load(mp_module_context_t *module_obj, vstr_t *file) {
     }
     #endif
 
+    // If a cache of compiled code is enabled then load the file's compiled code
+    // from it (compiling the file and adding it to the cache if needed).
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    if (MP_STATE_VM(persistent_code_cache_dir) != MP_OBJ_NULL) {
+        mp_compiled_module_t cm;
+        cm.context = module_obj;
+        mp_raw_code_cache_load_file(file_qstr, &cm);
+        do_execute_proto_fun(cm.context, cm.rc, file_qstr);
+        return;
+    }
+    #endif
+
     // If we can compile scripts then load the file and compile and execute it.
     #if MICROPY_ENABLE_COMPILER
     {
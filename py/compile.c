@@ -102,6 +102,8 @@ static const emit_method_table_t *emit_native_table[] = {
     &emit_native_thumb_method_table,
     &emit_native_xtensa_method_table,
     &emit_native_xtensawin_method_table,
+    &emit_native_rv32_method_table,
+    &emit_native_aarch64_method_table,
 };
 
 #elif MICROPY_EMIT_NATIVE
@@ -118,6 +120,10 @@ static const emit_method_table_t *emit_native_table[] = {
 #define NATIVE_EMITTER(f) emit_native_xtensa_##f
 #elif MICROPY_EMIT_XTENSAWIN
 #define NATIVE_EMITTER(f) emit_native_xtensawin_##f
+#elif MICROPY_EMIT_RV32
+#define NATIVE_EMITTER(f) emit_native_rv32_##f
+#elif MICROPY_EMIT_AARCH64
+#define NATIVE_EMITTER(f) emit_native_aarch64_##f
 #else
 #error "unknown native emitter"
 #endif
@@ -141,6 +147,8 @@ static const emit_inline_asm_method_table_t *emit_asm_table[] = {
     &emit_inline_thumb_method_table,
     &emit_inline_xtensa_method_table,
     NULL,
+    NULL,
+    NULL,
 };
 
 #elif MICROPY_EMIT_INLINE_ASM
@@ -161,10 +169,37 @@ static const emit_inline_asm_method_table_t *emit_asm_table[] = {
 #define EMIT_INLINE_ASM_ARG(fun, ...) (comp->emit_inline_asm_method_table->fun(comp->emit_inline_asm, __VA_ARGS__))
 
 // elements in this struct are ordered to make it compact
+#if MICROPY_COMP_GLOBAL_CONST
+// A module-level name assigned a constant by a top-level statement.  It's
+// propagated as a constant if that's the only store to the global.
+typedef struct _global_const_t {
+    qstr name;
+    uint16_t n_store;           // stores to the global found by the scope pass
+    bool assigned;              // whether the module scope has compiled the assignment
+    mp_parse_node_t pn_value;   // the constant
+} global_const_t;
+#endif
+
+#if MICROPY_COMP_CACHE_LOADS
+// A global, or an attribute of a global, that a function loads inside a loop.
+// The most frequent ones are cached in a pair of hidden locals.
+typedef struct _cached_load_t {
+    scope_t *scope;
+    qstr name;
+    qstr attr;                  // MP_QSTR_NULL to load just the global
+    uint16_t n_load;            // loads found by the scope pass
+    uint16_t local_num;         // the first of the pair of locals, or CACHED_LOAD_NONE
+} cached_load_t;
+
+#define CACHED_LOAD_NONE (0xffff)
+#define CACHED_LOADS_PER_SCOPE (8)
+#endif
+
 typedef struct _compiler_t {
     uint8_t is_repl;
     uint8_t pass; // holds enum type pass_kind_t
     uint8_t have_star;
+    uint8_t const_default_params; // the positional defaults are loaded as one constant tuple
 
     // try to keep compiler clean from nlr
     mp_obj_t compile_error; // set to an exception object if there's an error
@@ -194,6 +229,28 @@ typedef struct _compiler_t {
     #endif
 
     mp_emit_common_t emit_common;
+
+    #if MICROPY_EMIT_NATIVE_TIERING
+    uint16_t tier_num_scopes;       // number of scopes created so far
+    uint16_t tier_target_index;     // index of the scope to compile natively, or 0
+    scope_t *tier_target;           // the scope to compile natively, once created
+    bool tier_unsupported;          // the target uses a feature that native changes
+    uint32_t tier_source_hash;      // hash of the source being compiled
+    uint16_t tier_block_level;      // number of conditional blocks around the code
+    uint16_t *tier_bound_level;     // for each local of the target, the block it was bound in
+    #endif
+
+    #if MICROPY_COMP_GLOBAL_CONST
+    bool global_consts_known;       // set once the scope pass has counted all stores
+    size_t global_consts_len;
+    global_const_t *global_consts;
+    #endif
+
+    #if MICROPY_COMP_CACHE_LOADS
+    uint16_t loop_depth;            // number of loops around the code being compiled
+    size_t cached_loads_len;
+    cached_load_t *cached_loads;
+    #endif
 } compiler_t;
 
 /******************************************************************************/
@@ -280,6 +337,16 @@ static void reserve_labels_for_native(compiler_t *comp, int n) {
 #define reserve_labels_for_native(comp, n)
 #endif
 
+static void emit_binary_op_reserving_labels(compiler_t *comp, mp_binary_op_t op) {
+    EMIT_ARG(binary_op, op);
+    reserve_labels_for_native(comp, 2); // used by native's small-int fast path
+}
+
+static void emit_subscr_reserving_labels(compiler_t *comp, int kind) {
+    EMIT_ARG(subscr, kind);
+    reserve_labels_for_native(comp, 2); // used by native's list fast path
+}
+
 static void compile_increase_except_level(compiler_t *comp, uint label, int kind) {
     EMIT_ARG(setup_block, label, kind);
     comp->cur_except_level += 1;
@@ -308,6 +375,23 @@ static scope_t *scope_new_and_link(compiler_t *comp, scope_kind_t kind, mp_parse
         }
         s->next = scope;
     }
+    #if MICROPY_EMIT_NATIVE_TIERING
+    // Number the scopes in creation order so a function can be found again when
+    // its module is recompiled.  Only plain bytecode functions can be tiered.
+    if (comp->tier_num_scopes < UINT16_MAX) {
+        comp->tier_num_scopes += 1;
+        if ((kind == SCOPE_FUNCTION || kind == SCOPE_LAMBDA)
+            && (emit_options == MP_EMIT_OPT_NONE || emit_options == MP_EMIT_OPT_BYTECODE)) {
+            scope->raw_code->tier_scope_index = comp->tier_num_scopes;
+            scope->raw_code->tier_def_line = ((mp_parse_node_struct_t *)pn)->source_line;
+            scope->raw_code->tier_source_hash = comp->tier_source_hash;
+            if (comp->tier_num_scopes == comp->tier_target_index) {
+                scope->emit_options = MP_EMIT_OPT_NATIVE_PYTHON;
+                comp->tier_target = scope;
+            }
+        }
+    }
+    #endif
     return scope;
 }
 
@@ -337,10 +421,344 @@ static void compile_generic_all_nodes(compiler_t *comp, mp_parse_node_struct_t *
     }
 }
 
+#if MICROPY_COMP_GLOBAL_CONST
+// Collect the top-level statements of the form "name = constant".
+static void find_global_consts(compiler_t *comp, mp_parse_node_t pn_root) {
+    if (MP_STATE_VM(mp_optimise_value) < 4 || comp->is_repl) {
+        return;
+    }
+    mp_parse_node_t *nodes;
+    size_t n = mp_parse_node_extract_list(&pn_root, PN_file_input_2, &nodes);
+    for (size_t i = 0; i < n; i++) {
+        if (!MP_PARSE_NODE_IS_STRUCT_KIND(nodes[i], PN_expr_stmt)) {
+            continue;
+        }
+        mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)nodes[i];
+        if (!MP_PARSE_NODE_IS_ID(pns->nodes[0]) || MP_PARSE_NODE_IS_NULL(pns->nodes[1])
+            || !mp_parse_node_is_const(pns->nodes[1])) {
+            continue;
+        }
+        comp->global_consts = m_renew(global_const_t, comp->global_consts, comp->global_consts_len, comp->global_consts_len + 1);
+        global_const_t *c = &comp->global_consts[comp->global_consts_len++];
+        c->name = MP_PARSE_NODE_LEAF_ARG(pns->nodes[0]);
+        c->n_store = 0;
+        c->assigned = false;
+        c->pn_value = pns->nodes[1];
+    }
+}
+
+static global_const_t *find_global_const(compiler_t *comp, qstr qst) {
+    for (size_t i = 0; i < comp->global_consts_len; i++) {
+        if (comp->global_consts[i].name == qst) {
+            return &comp->global_consts[i];
+        }
+    }
+    return NULL;
+}
+
+// Return the constant that a load of qst in the current scope can be replaced
+// with, or MP_PARSE_NODE_NULL if it must be loaded.
+static mp_parse_node_t get_global_const(compiler_t *comp, qstr qst) {
+    if (!comp->global_consts_known) {
+        return MP_PARSE_NODE_NULL;
+    }
+    global_const_t *c = find_global_const(comp, qst);
+    if (c == NULL || c->n_store != 1) {
+        return MP_PARSE_NODE_NULL;
+    }
+    if (comp->scope_cur->kind == SCOPE_MODULE) {
+        // module code before the assignment sees the global unassigned
+        if (!c->assigned) {
+            return MP_PARSE_NODE_NULL;
+        }
+    } else {
+        // other scopes must not have their own binding of the name
+        id_info_t *id = scope_find(comp->scope_cur, qst);
+        if (id == NULL || (id->kind != ID_INFO_KIND_GLOBAL_IMPLICIT && id->kind != ID_INFO_KIND_GLOBAL_EXPLICIT)) {
+            return MP_PARSE_NODE_NULL;
+        }
+    }
+    return c->pn_value;
+}
+
+// Count a store or delete of qst, or note that the module has assigned it.
+static void global_const_modified(compiler_t *comp, qstr qst, id_info_t *id) {
+    global_const_t *c = find_global_const(comp, qst);
+    if (c == NULL) {
+        return;
+    }
+    if (comp->pass == MP_PASS_SCOPE) {
+        if (comp->scope_cur->kind == SCOPE_MODULE || id->kind == ID_INFO_KIND_GLOBAL_EXPLICIT) {
+            c->n_store = MIN(c->n_store + 1, 2);
+        }
+    } else if (comp->scope_cur->kind == SCOPE_MODULE) {
+        c->assigned = true;
+    }
+}
+
+// If pn is a name that's a known constant then return the constant.
+static mp_parse_node_t fold_global_const(compiler_t *comp, mp_parse_node_t pn) {
+    if (MP_PARSE_NODE_IS_ID(pn)) {
+        mp_parse_node_t pn_value = get_global_const(comp, MP_PARSE_NODE_LEAF_ARG(pn));
+        if (pn_value != MP_PARSE_NODE_NULL) {
+            return pn_value;
+        }
+    }
+    return pn;
+}
+#else
+#define fold_global_const(comp, pn) (pn)
+#endif
+
+#if MICROPY_COMP_CACHE_LOADS
+#define cached_loads_enter_loop(comp) ((comp)->loop_depth += 1)
+#define cached_loads_exit_loop(comp) ((comp)->loop_depth -= 1)
+
+static cached_load_t *find_cached_load(compiler_t *comp, qstr name, qstr attr) {
+    for (size_t i = 0; i < comp->cached_loads_len; i++) {
+        cached_load_t *c = &comp->cached_loads[i];
+        if (c->scope == comp->scope_cur && c->name == name && c->attr == attr) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+// Compile a load of the global name, or of name.attr if attr isn't MP_QSTR_NULL,
+// as a load from its cache if it has one, and return true if it did so.  The
+// scope pass instead counts the load as a candidate for caching, and handles
+// the id of a name.attr load itself (so the name isn't counted separately).
+static bool compile_cached_load(compiler_t *comp, qstr name, qstr attr) {
+    scope_t *scope = comp->scope_cur;
+    if (comp->loop_depth == 0
+        || MP_STATE_VM(mp_optimise_value) < 4
+        || !SCOPE_IS_FUNC_LIKE(scope->kind)
+        || (scope->emit_options != MP_EMIT_OPT_NONE && scope->emit_options != MP_EMIT_OPT_BYTECODE)) {
+        return false;
+    }
+    cached_load_t *c = find_cached_load(comp, name, attr);
+    if (comp->pass == MP_PASS_SCOPE) {
+        if (c == NULL) {
+            comp->cached_loads = m_renew(cached_load_t, comp->cached_loads, comp->cached_loads_len, comp->cached_loads_len + 1);
+            c = &comp->cached_loads[comp->cached_loads_len++];
+            c->scope = scope;
+            c->name = name;
+            c->attr = attr;
+            c->n_load = 0;
+            c->local_num = CACHED_LOAD_NONE;
+        }
+        if (c->n_load < UINT16_MAX) {
+            c->n_load += 1;
+        }
+        // reserve the label that a cached load needs
+        comp_next_label(comp);
+        if (attr == MP_QSTR_NULL) {
+            return false;
+        }
+        mp_emit_common_get_id_for_load(scope, name);
+        return true;
+    }
+    if (c == NULL || c->local_num == CACHED_LOAD_NONE) {
+        return false;
+    }
+    uint l_cached = comp_next_label(comp);
+    mp_emit_bc_load_fast_cached(comp->emit, c->local_num, l_cached);
+    EMIT_LOAD_GLOBAL(name);
+    if (attr != MP_QSTR_NULL) {
+        EMIT(dup_top);
+        EMIT_ARG(attr, attr, MP_EMIT_ATTR_LOAD);
+    }
+    mp_emit_bc_store_fast_cached(comp->emit, c->local_num, attr != MP_QSTR_NULL);
+    EMIT_ARG(label_assign, l_cached);
+    return true;
+}
+
+// Choose the loads to cache, once the scope pass has found the candidates:
+// in each scope, the most frequent loads of globals that the scope only reads.
+// Scopes that declare globals are left alone, because storing to a global
+// invalidates all the cached loads.
+static void choose_cached_loads(compiler_t *comp) {
+    for (size_t i = 0; i < comp->cached_loads_len; i++) {
+        cached_load_t *c = &comp->cached_loads[i];
+        id_info_t *id = scope_find(c->scope, c->name);
+        if (id == NULL || id->kind != ID_INFO_KIND_GLOBAL_IMPLICIT) {
+            c->n_load = 0;
+            continue;
+        }
+        for (size_t j = 0; j < c->scope->id_info_len; j++) {
+            if (c->scope->id_info[j].kind == ID_INFO_KIND_GLOBAL_EXPLICIT) {
+                c->n_load = 0;
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < comp->cached_loads_len; i++) {
+        scope_t *scope = comp->cached_loads[i].scope;
+        for (size_t n = 0; n < CACHED_LOADS_PER_SCOPE; n++) {
+            cached_load_t *best = NULL;
+            for (size_t j = i; j < comp->cached_loads_len; j++) {
+                cached_load_t *c = &comp->cached_loads[j];
+                if (c->scope == scope && c->n_load > 0 && c->local_num == CACHED_LOAD_NONE
+                    && (best == NULL || c->n_load > best->n_load)) {
+                    best = c;
+                }
+            }
+            if (best == NULL) {
+                break;
+            }
+            // the local number is assigned once the scope's other locals are known
+            best->local_num = 0;
+        }
+        // skip the rest of this scope's candidates, which are all together
+        while (i + 1 < comp->cached_loads_len && comp->cached_loads[i + 1].scope == scope) {
+            i += 1;
+        }
+    }
+}
+
+// Allocate the pairs of hidden locals for the chosen loads, after the other locals.
+static void allocate_cached_loads(compiler_t *comp) {
+    for (size_t i = 0; i < comp->cached_loads_len; i++) {
+        cached_load_t *c = &comp->cached_loads[i];
+        if (c->local_num != CACHED_LOAD_NONE) {
+            if (c->scope->num_locals > 255) {
+                // the local number must fit in a byte
+                c->local_num = CACHED_LOAD_NONE;
+            } else {
+                c->local_num = c->scope->num_locals;
+                c->scope->num_locals += 2;
+            }
+        }
+    }
+}
+#else
+#define cached_loads_enter_loop(comp) (void)0
+#define cached_loads_exit_loop(comp) (void)0
+#endif
+
+#if MICROPY_EMIT_NATIVE_TIERING
+// Native code doesn't check for unbound locals, so a function is only tiered if
+// it can't read a local before assigning it.  While the target scope is compiled
+// for its stack size, each local records the level of the innermost conditional
+// block (if/loop/try/with body) it has been assigned in, and leaving a block
+// forgets the assignments made in it.
+#define TIER_UNBOUND (0xffff)
+
+static void tier_bound_start(compiler_t *comp, scope_t *scope) {
+    comp->tier_block_level = 0;
+    comp->tier_bound_level = m_new(uint16_t, scope->num_locals);
+    for (size_t i = 0; i < scope->num_locals; i++) {
+        comp->tier_bound_level[i] = TIER_UNBOUND;
+    }
+    for (size_t i = 0; i < scope->id_info_len; i++) {
+        id_info_t *id = &scope->id_info[i];
+        if (id->flags & ID_FLAG_IS_PARAM) {
+            comp->tier_bound_level[id->local_num] = 0;
+        }
+    }
+}
+
+static void tier_bound_end(compiler_t *comp, scope_t *scope) {
+    m_del(uint16_t, comp->tier_bound_level, scope->num_locals);
+    comp->tier_bound_level = NULL;
+}
+
+static void tier_enter_block(compiler_t *comp) {
+    comp->tier_block_level += 1;
+}
+
+// Leave a block.  If branches is not NULL then the block is a branch of an if
+// statement, and the locals assigned in it are counted there.
+static void tier_exit_block_branch(compiler_t *comp, uint16_t *branches) {
+    if (comp->tier_bound_level != NULL) {
+        size_t n = comp->scope_cur->num_locals;
+        for (size_t i = 0; i < n; i++) {
+            if (comp->tier_bound_level[i] != TIER_UNBOUND && comp->tier_bound_level[i] >= comp->tier_block_level) {
+                comp->tier_bound_level[i] = TIER_UNBOUND;
+                if (branches != NULL) {
+                    branches[i] += 1;
+                }
+            }
+        }
+        if (branches != NULL) {
+            // the last entry counts the branches
+            branches[n] += 1;
+        }
+    }
+    comp->tier_block_level -= 1;
+}
+
+static void tier_exit_block(compiler_t *comp) {
+    tier_exit_block_branch(comp, NULL);
+}
+
+// An if statement with an else block always runs one of its branches, so the
+// locals assigned in all of them are assigned after it.
+static uint16_t *tier_branches_new(compiler_t *comp, mp_parse_node_t pn_else) {
+    if (comp->tier_bound_level == NULL || MP_PARSE_NODE_IS_NULL(pn_else)) {
+        return NULL;
+    }
+    return m_new0(uint16_t, comp->scope_cur->num_locals + 1);
+}
+
+static void tier_branches_done(compiler_t *comp, uint16_t *branches) {
+    if (branches != NULL) {
+        size_t n = comp->scope_cur->num_locals;
+        for (size_t i = 0; i < n; i++) {
+            if (branches[i] == branches[n]) {
+                comp->tier_bound_level[i] = MIN(comp->tier_bound_level[i], comp->tier_block_level);
+            }
+        }
+        m_del(uint16_t, branches, n + 1);
+    }
+}
+
+static void tier_track_id(compiler_t *comp, qstr qst, bool is_store) {
+    if (comp->tier_bound_level == NULL) {
+        return;
+    }
+    id_info_t *id = scope_find(comp->scope_cur, qst);
+    if (id->kind == ID_INFO_KIND_LOCAL || id->kind == ID_INFO_KIND_CELL) {
+        uint16_t *level = &comp->tier_bound_level[id->local_num];
+        if (is_store) {
+            *level = MIN(*level, comp->tier_block_level);
+        } else if (*level == TIER_UNBOUND) {
+            comp->tier_unsupported = true;
+        }
+    } else if (id->kind == ID_INFO_KIND_FREE && !is_store && qst != MP_QSTR___class__) {
+        // the enclosing function may not have assigned it yet
+        comp->tier_unsupported = true;
+    }
+}
+#else
+#define tier_enter_block(comp) (void)0
+#define tier_exit_block(comp) (void)0
+#define tier_exit_block_branch(comp, branches) (void)(branches)
+#define tier_branches_new(comp, pn_else) NULL
+#define tier_branches_done(comp, branches) (void)(branches)
+#define tier_track_id(comp, qst, is_store) (void)0
+#endif
+
 static void compile_load_id(compiler_t *comp, qstr qst) {
     if (comp->pass == MP_PASS_SCOPE) {
         mp_emit_common_get_id_for_load(comp->scope_cur, qst);
+        #if MICROPY_COMP_CACHE_LOADS
+        compile_cached_load(comp, qst, MP_QSTR_NULL);
+        #endif
     } else {
+        #if MICROPY_COMP_GLOBAL_CONST
+        mp_parse_node_t pn_value = get_global_const(comp, qst);
+        if (pn_value != MP_PARSE_NODE_NULL) {
+            compile_node(comp, pn_value);
+            return;
+        }
+        #endif
+        #if MICROPY_COMP_CACHE_LOADS
+        if (compile_cached_load(comp, qst, MP_QSTR_NULL)) {
+            return;
+        }
+        #endif
+        tier_track_id(comp, qst, false);
         #if NEED_METHOD_TABLE
         mp_emit_common_id_op(comp->emit, &comp->emit_method_table->load_id, comp->scope_cur, qst);
         #else
@@ -351,8 +769,17 @@ static void compile_load_id(compiler_t *comp, qstr qst) {
 
 static void compile_store_id(compiler_t *comp, qstr qst) {
     if (comp->pass == MP_PASS_SCOPE) {
-        mp_emit_common_get_id_for_modification(comp->scope_cur, qst);
+        id_info_t *id = mp_emit_common_get_id_for_modification(comp->scope_cur, qst);
+        #if MICROPY_COMP_GLOBAL_CONST
+        global_const_modified(comp, qst, id);
+        #else
+        (void)id;
+        #endif
     } else {
+        #if MICROPY_COMP_GLOBAL_CONST
+        global_const_modified(comp, qst, NULL);
+        #endif
+        tier_track_id(comp, qst, true);
         #if NEED_METHOD_TABLE
         mp_emit_common_id_op(comp->emit, &comp->emit_method_table->store_id, comp->scope_cur, qst);
         #else
@@ -363,7 +790,12 @@ static void compile_store_id(compiler_t *comp, qstr qst) {
 
 static void compile_delete_id(compiler_t *comp, qstr qst) {
     if (comp->pass == MP_PASS_SCOPE) {
-        mp_emit_common_get_id_for_modification(comp->scope_cur, qst);
+        id_info_t *id = mp_emit_common_get_id_for_modification(comp->scope_cur, qst);
+        #if MICROPY_COMP_GLOBAL_CONST
+        global_const_modified(comp, qst, id);
+        #else
+        (void)id;
+        #endif
     } else {
         #if NEED_METHOD_TABLE
         mp_emit_common_id_op(comp->emit, &comp->emit_method_table->delete_id, comp->scope_cur, qst);
@@ -383,6 +815,7 @@ static void compile_generic_tuple(compiler_t *comp, mp_parse_node_struct_t *pns)
 }
 
 static void c_if_cond(compiler_t *comp, mp_parse_node_t pn, bool jump_if, int label) {
+    pn = fold_global_const(comp, pn);
     if (mp_parse_node_is_const_false(pn)) {
         if (jump_if == false) {
             EMIT_ARG(jump, label);
@@ -452,14 +885,14 @@ static void c_assign_atom_expr(compiler_t *comp, mp_parse_node_struct_t *pns, as
         if (MP_PARSE_NODE_STRUCT_KIND(pns1) == PN_trailer_bracket) {
             if (assign_kind == ASSIGN_AUG_STORE) {
                 EMIT(rot_three);
-                EMIT_ARG(subscr, MP_EMIT_SUBSCR_STORE);
+                emit_subscr_reserving_labels(comp, MP_EMIT_SUBSCR_STORE);
             } else {
                 compile_node(comp, pns1->nodes[0]);
                 if (assign_kind == ASSIGN_AUG_LOAD) {
                     EMIT(dup_top_two);
-                    EMIT_ARG(subscr, MP_EMIT_SUBSCR_LOAD);
+                    emit_subscr_reserving_labels(comp, MP_EMIT_SUBSCR_LOAD);
                 } else {
-                    EMIT_ARG(subscr, MP_EMIT_SUBSCR_STORE);
+                    emit_subscr_reserving_labels(comp, MP_EMIT_SUBSCR_STORE);
                 }
             }
             return;
@@ -726,20 +1159,87 @@ static void compile_funcdef_lambdef_param(compiler_t *comp, mp_parse_node_t pn)
                 EMIT(store_map);
             } else {
                 comp->num_default_params += 1;
-                compile_node(comp, pn_equal);
+                if (!comp->const_default_params) {
+                    compile_node(comp, pn_equal);
+                }
             }
         }
     }
 }
 
+#if MICROPY_COMP_CONST_TUPLE
+// Get the default value of a parameter, or MP_PARSE_NODE_NULL if it has none.
+// Sets *is_star if the parameter is a star parameter.
+static mp_parse_node_t compile_param_default(mp_parse_node_t pn, bool *is_star) {
+    *is_star = false;
+    if (MP_PARSE_NODE_IS_ID(pn)) {
+        return MP_PARSE_NODE_NULL;
+    }
+    mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn;
+    switch (MP_PARSE_NODE_STRUCT_KIND(pns)) {
+        case PN_typedargslist_star:
+        case PN_varargslist_star:
+            *is_star = true;
+            return MP_PARSE_NODE_NULL;
+        case PN_typedargslist_dbl_star:
+        case PN_varargslist_dbl_star:
+            return MP_PARSE_NODE_NULL;
+        case PN_typedargslist_name:
+            return pns->nodes[2];
+        default:
+            return pns->nodes[1];
+    }
+}
+
+// If all the default values of the parameters are constants, and none of them
+// are for keyword-only parameters, then return them as a tuple.  The function
+// can then be made from a constant tuple instead of building one each time.
+static mp_obj_t compile_funcdef_lambdef_const_defaults(mp_parse_node_t pn_params, pn_kind_t pn_list_kind) {
+    mp_parse_node_t *nodes;
+    size_t n = mp_parse_node_extract_list(&pn_params, pn_list_kind, &nodes);
+    size_t n_defaults = 0;
+    bool have_star = false;
+    for (size_t i = 0; i < n; ++i) {
+        bool is_star;
+        mp_parse_node_t pn_equal = compile_param_default(nodes[i], &is_star);
+        have_star |= is_star;
+        if (!MP_PARSE_NODE_IS_NULL(pn_equal)) {
+            if (have_star || !mp_parse_node_is_const(pn_equal)) {
+                return MP_OBJ_NULL;
+            }
+            ++n_defaults;
+        }
+    }
+    if (n_defaults == 0) {
+        return MP_OBJ_NULL;
+    }
+    mp_obj_tuple_t *tuple = MP_OBJ_TO_PTR(mp_obj_new_tuple(n_defaults, NULL));
+    n_defaults = 0;
+    for (size_t i = 0; i < n; ++i) {
+        bool is_star;
+        mp_parse_node_t pn_equal = compile_param_default(nodes[i], &is_star);
+        if (!MP_PARSE_NODE_IS_NULL(pn_equal)) {
+            tuple->items[n_defaults++] = mp_parse_node_convert_to_obj(pn_equal);
+        }
+    }
+    return MP_OBJ_FROM_PTR(tuple);
+}
+#endif
+
 static void compile_funcdef_lambdef(compiler_t *comp, scope_t *scope, mp_parse_node_t pn_params, pn_kind_t pn_list_kind) {
     // When we call compile_funcdef_lambdef_param below it can compile an arbitrary
     // expression for default arguments, which may contain a lambda.  The lambda will
     // call here in a nested way, so we must save and restore the relevant state.
     bool orig_have_star = comp->have_star;
+    uint8_t orig_const_default_params = comp->const_default_params;
     uint16_t orig_num_dict_params = comp->num_dict_params;
     uint16_t orig_num_default_params = comp->num_default_params;
 
+    #if MICROPY_COMP_CONST_TUPLE
+    mp_obj_t const_defaults = compile_funcdef_lambdef_const_defaults(pn_params, pn_list_kind);
+    comp->const_default_params = const_defaults != MP_OBJ_NULL;
+    #endif
+
     // compile default parameters
     comp->have_star = false;
     comp->num_dict_params = 0;
@@ -753,7 +1253,14 @@ static void compile_funcdef_lambdef(compiler_t *comp, scope_t *scope, mp_parse_n
     // in MicroPython we put the default positional parameters into a tuple using the bytecode
     // the default keywords args may have already made the tuple; if not, do it now
     if (comp->num_default_params > 0 && comp->num_dict_params == 0) {
-        EMIT_ARG(build, comp->num_default_params, MP_EMIT_BUILD_TUPLE);
+        #if MICROPY_COMP_CONST_TUPLE
+        if (const_defaults != MP_OBJ_NULL) {
+            EMIT_ARG(load_const_obj, const_defaults);
+        } else
+        #endif
+        {
+            EMIT_ARG(build, comp->num_default_params, MP_EMIT_BUILD_TUPLE);
+        }
         EMIT(load_null); // sentinel indicating empty default keyword args
     }
 
@@ -762,6 +1269,7 @@ static void compile_funcdef_lambdef(compiler_t *comp, scope_t *scope, mp_parse_n
 
     // restore state
     comp->have_star = orig_have_star;
+    comp->const_default_params = orig_const_default_params;
     comp->num_dict_params = orig_num_dict_params;
     comp->num_default_params = orig_num_default_params;
 }
@@ -945,6 +1453,16 @@ static void compile_funcdef(compiler_t *comp, mp_parse_node_struct_t *pns) {
 
 static void c_del_stmt(compiler_t *comp, mp_parse_node_t pn) {
     if (MP_PARSE_NODE_IS_ID(pn)) {
+        #if MICROPY_EMIT_NATIVE_TIERING
+        // native code doesn't check for unbound locals, so keep such functions as
+        // bytecode, including the functions that a nonlocal may be deleted from
+        if (comp->tier_target != NULL
+            && (comp->scope_cur == comp->tier_target
+                || (comp->pass > MP_PASS_SCOPE
+                    && scope_find(comp->scope_cur, MP_PARSE_NODE_LEAF_ARG(pn))->kind == ID_INFO_KIND_FREE))) {
+            comp->tier_unsupported = true;
+        }
+        #endif
         compile_delete_id(comp, MP_PARSE_NODE_LEAF_ARG(pn));
     } else if (MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_atom_expr_normal)) {
         mp_parse_node_struct_t *pns = (mp_parse_node_struct_t *)pn;
@@ -1199,6 +1717,13 @@ static void compile_import_from(compiler_t *comp, mp_parse_node_struct_t *pns) {
         do_import_name(comp, pn_import_source, &dummy_q);
         EMIT_ARG(import, MP_QSTRnull, MP_EMIT_IMPORT_STAR);
 
+        #if MICROPY_COMP_GLOBAL_CONST
+        // this may store to any global
+        for (size_t i = 0; i < comp->global_consts_len; i++) {
+            comp->global_consts[i].n_store = 2;
+        }
+        #endif
+
     } else {
         EMIT_ARG(load_const_small_int, import_level);
 
@@ -1304,16 +1829,20 @@ static void compile_assert_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
 
 static void compile_if_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     uint l_end = comp_next_label(comp);
+    uint16_t *tier_branches = tier_branches_new(comp, pns->nodes[3]);
 
     // optimisation: don't emit anything when "if False"
-    if (!mp_parse_node_is_const_false(pns->nodes[0])) {
+    mp_parse_node_t pn_cond = fold_global_const(comp, pns->nodes[0]);
+    if (!mp_parse_node_is_const_false(pn_cond)) {
         uint l_fail = comp_next_label(comp);
-        c_if_cond(comp, pns->nodes[0], false, l_fail); // if condition
+        c_if_cond(comp, pn_cond, false, l_fail); // if condition
 
+        tier_enter_block(comp);
         compile_node(comp, pns->nodes[1]); // if block
+        tier_exit_block_branch(comp, tier_branches);
 
         // optimisation: skip everything else when "if True"
-        if (mp_parse_node_is_const_true(pns->nodes[0])) {
+        if (mp_parse_node_is_const_true(pn_cond)) {
             goto done;
         }
 
@@ -1334,14 +1863,17 @@ static void compile_if_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
         mp_parse_node_struct_t *pns_elif = (mp_parse_node_struct_t *)pn_elif[i];
 
         // optimisation: don't emit anything when "if False"
-        if (!mp_parse_node_is_const_false(pns_elif->nodes[0])) {
+        pn_cond = fold_global_const(comp, pns_elif->nodes[0]);
+        if (!mp_parse_node_is_const_false(pn_cond)) {
             uint l_fail = comp_next_label(comp);
-            c_if_cond(comp, pns_elif->nodes[0], false, l_fail); // elif condition
+            c_if_cond(comp, pn_cond, false, l_fail); // elif condition
 
+            tier_enter_block(comp);
             compile_node(comp, pns_elif->nodes[1]); // elif block
+            tier_exit_block_branch(comp, tier_branches);
 
             // optimisation: skip everything else when "elif True"
-            if (mp_parse_node_is_const_true(pns_elif->nodes[0])) {
+            if (mp_parse_node_is_const_true(pn_cond)) {
                 goto done;
             }
 
@@ -1351,9 +1883,12 @@ static void compile_if_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     }
 
     // compile else block
+    tier_enter_block(comp);
     compile_node(comp, pns->nodes[3]); // can be null
+    tier_exit_block_branch(comp, tier_branches);
 
 done:
+    tier_branches_done(comp, tier_branches);
     EMIT_ARG(label_assign, l_end);
 }
 
@@ -1375,21 +1910,28 @@ done:
 static void compile_while_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     START_BREAK_CONTINUE_BLOCK
 
-    if (!mp_parse_node_is_const_false(pns->nodes[0])) { // optimisation: don't emit anything for "while False"
+    mp_parse_node_t pn_cond = fold_global_const(comp, pns->nodes[0]);
+    if (!mp_parse_node_is_const_false(pn_cond)) { // optimisation: don't emit anything for "while False"
         uint top_label = comp_next_label(comp);
-        if (!mp_parse_node_is_const_true(pns->nodes[0])) { // optimisation: don't jump to cond for "while True"
+        if (!mp_parse_node_is_const_true(pn_cond)) { // optimisation: don't jump to cond for "while True"
             EMIT_ARG(jump, continue_label);
         }
         EMIT_ARG(label_assign, top_label);
+        cached_loads_enter_loop(comp);
+        tier_enter_block(comp);
         compile_node(comp, pns->nodes[1]); // body
+        tier_exit_block(comp);
         EMIT_ARG(label_assign, continue_label);
-        c_if_cond(comp, pns->nodes[0], true, top_label); // condition
+        c_if_cond(comp, pn_cond, true, top_label); // condition
+        cached_loads_exit_loop(comp);
     }
 
     // break/continue apply to outer loop (if any) in the else block
     END_BREAK_CONTINUE_BLOCK
 
+    tier_enter_block(comp);
     compile_node(comp, pns->nodes[2]); // else
+    tier_exit_block(comp);
 
     EMIT_ARG(label_assign, break_label);
 }
@@ -1430,16 +1972,20 @@ static void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
 
     // duplicate next value and store it to var
     EMIT(dup_top);
+    tier_enter_block(comp);
     c_assign(comp, pn_var, ASSIGN_STORE);
 
     // compile body
+    cached_loads_enter_loop(comp);
     compile_node(comp, pn_body);
+    cached_loads_exit_loop(comp);
+    tier_exit_block(comp);
 
     EMIT_ARG(label_assign, continue_label);
 
     // compile: var + step
     compile_node(comp, pn_step);
-    EMIT_ARG(binary_op, MP_BINARY_OP_INPLACE_ADD);
+    emit_binary_op_reserving_labels(comp, MP_BINARY_OP_INPLACE_ADD);
 
     EMIT_ARG(label_assign, entry_label);
 
@@ -1453,9 +1999,9 @@ static void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
     }
     assert(MP_PARSE_NODE_IS_SMALL_INT(pn_step));
     if (MP_PARSE_NODE_LEAF_SMALL_INT(pn_step) >= 0) {
-        EMIT_ARG(binary_op, MP_BINARY_OP_LESS);
+        emit_binary_op_reserving_labels(comp, MP_BINARY_OP_LESS);
     } else {
-        EMIT_ARG(binary_op, MP_BINARY_OP_MORE);
+        emit_binary_op_reserving_labels(comp, MP_BINARY_OP_MORE);
     }
     EMIT_ARG(pop_jump_if, true, top_label);
 
@@ -1471,7 +2017,9 @@ static void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
         if (end_on_stack) {
             EMIT(pop_top);
         }
+        tier_enter_block(comp);
         compile_node(comp, pn_else);
+        tier_exit_block(comp);
         end_label = comp_next_label(comp);
         EMIT_ARG(jump, end_label);
         EMIT_ARG(adjust_stack_size, 1 + end_on_stack);
@@ -1558,8 +2106,12 @@ static void compile_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     EMIT_ARG(get_iter, true);
     EMIT_ARG(label_assign, continue_label);
     EMIT_ARG(for_iter, pop_label);
+    tier_enter_block(comp);
     c_assign(comp, pns->nodes[0], ASSIGN_STORE); // variable
+    cached_loads_enter_loop(comp);
     compile_node(comp, pns->nodes[2]); // body
+    cached_loads_exit_loop(comp);
+    tier_exit_block(comp);
     EMIT_ARG(jump, continue_label);
     EMIT_ARG(label_assign, pop_label);
     EMIT(for_iter_end);
@@ -1567,7 +2119,9 @@ static void compile_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     // break/continue apply to outer loop (if any) in the else block
     END_BREAK_CONTINUE_BLOCK
 
+    tier_enter_block(comp);
     compile_node(comp, pns->nodes[3]); // else (may be empty)
+    tier_exit_block(comp);
 
     EMIT_ARG(label_assign, break_label);
 }
@@ -1579,7 +2133,9 @@ static void compile_try_except(compiler_t *comp, mp_parse_node_t pn_body, int n_
 
     compile_increase_except_level(comp, l1, MP_EMIT_SETUP_BLOCK_EXCEPT);
 
+    tier_enter_block(comp);
     compile_node(comp, pn_body); // body
+    tier_exit_block(comp);
     EMIT_ARG(pop_except_jump, success_label, false); // jump over exception handler
 
     EMIT_ARG(label_assign, l1); // start of exception handler
@@ -1619,10 +2175,13 @@ static void compile_try_except(compiler_t *comp, mp_parse_node_t pn_body, int n_
             }
             EMIT(dup_top);
             compile_node(comp, pns_exception_expr);
-            EMIT_ARG(binary_op, MP_BINARY_OP_EXCEPTION_MATCH);
+            emit_binary_op_reserving_labels(comp, MP_BINARY_OP_EXCEPTION_MATCH);
             EMIT_ARG(pop_jump_if, false, end_finally_label);
         }
 
+        // the handler, including binding the exception, may not run
+        tier_enter_block(comp);
+
         // either discard or store the exception instance
         if (qstr_exception_local == 0) {
             EMIT(pop_top);
@@ -1655,6 +2214,7 @@ static void compile_try_except(compiler_t *comp, mp_parse_node_t pn_body, int n_
             EMIT_ARG(adjust_stack_size, -1);
             compile_decrease_except_level(comp);
         }
+        tier_exit_block(comp);
 
         EMIT_ARG(pop_except_jump, l2, true);
         EMIT_ARG(label_assign, end_finally_label);
@@ -1665,7 +2225,9 @@ static void compile_try_except(compiler_t *comp, mp_parse_node_t pn_body, int n_
     EMIT(end_except_handler);
 
     EMIT_ARG(label_assign, success_label);
+    tier_enter_block(comp);
     compile_node(comp, pn_else); // else block, can be null
+    tier_exit_block(comp);
     EMIT_ARG(label_assign, l2);
 }
 
@@ -1677,7 +2239,9 @@ static void compile_try_finally(compiler_t *comp, mp_parse_node_t pn_body, int n
     if (n_except == 0) {
         assert(MP_PARSE_NODE_IS_NULL(pn_else));
         EMIT_ARG(adjust_stack_size, 3); // stack adjust for possible UNWIND_JUMP state
+        tier_enter_block(comp);
         compile_node(comp, pn_body);
+        tier_exit_block(comp);
         EMIT_ARG(adjust_stack_size, -3);
     } else {
         compile_try_except(comp, pn_body, n_except, pn_except, pn_else);
@@ -1692,7 +2256,9 @@ static void compile_try_finally(compiler_t *comp, mp_parse_node_t pn_body, int n
     // being executed as part of a return, and the return value is on the top of the stack.
     EMIT_ARG(label_assign, l_finally_block);
     EMIT_ARG(adjust_stack_size, 1);
+    tier_enter_block(comp);
     compile_node(comp, pn_finally);
+    tier_exit_block(comp);
     EMIT_ARG(adjust_stack_size, -1);
 
     compile_decrease_except_level(comp);
@@ -1758,8 +2324,11 @@ static void compile_with_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     size_t n = mp_parse_node_extract_list(&pns->nodes[0], PN_with_stmt_list, &nodes);
     assert(n > 0);
 
-    // compile in a nested fashion
+    // compile in a nested fashion; the body may be cut short by an exception
+    // that __exit__ suppresses
+    tier_enter_block(comp);
     compile_with_stmt_helper(comp, n, nodes, pns->nodes[1]);
+    tier_exit_block(comp);
 }
 
 static void compile_yield_from(compiler_t *comp) {
@@ -1814,7 +2383,7 @@ static void compile_async_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns
     EMIT(start_except_handler);
     EMIT(dup_top);
     EMIT_LOAD_GLOBAL(MP_QSTR_StopAsyncIteration);
-    EMIT_ARG(binary_op, MP_BINARY_OP_EXCEPTION_MATCH);
+    emit_binary_op_reserving_labels(comp, MP_BINARY_OP_EXCEPTION_MATCH);
     EMIT_ARG(pop_jump_if, false, try_finally_label);
     EMIT(pop_top); // pop exception instance
     EMIT_ARG(pop_except_jump, while_else_label, true);
@@ -1900,7 +2469,7 @@ static void compile_async_with_stmt_helper(compiler_t *comp, size_t n, mp_parse_
         // Detect if TOS an exception or not
         EMIT(dup_top);
         EMIT_LOAD_GLOBAL(MP_QSTR_BaseException);
-        EMIT_ARG(binary_op, MP_BINARY_OP_EXCEPTION_MATCH);
+        emit_binary_op_reserving_labels(comp, MP_BINARY_OP_EXCEPTION_MATCH);
         EMIT_ARG(pop_jump_if, false, l_ret_unwind_jump); // if not an exception then we have case 3
 
         // Handle case 2: call __aexit__ and either swallow or re-raise the exception
@@ -2039,7 +2608,7 @@ static void compile_expr_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
             assert(MP_PARSE_NODE_IS_TOKEN(pns1->nodes[0]));
             mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(pns1->nodes[0]);
             mp_binary_op_t op = MP_BINARY_OP_INPLACE_OR + (tok - MP_TOKEN_DEL_PIPE_EQUAL);
-            EMIT_ARG(binary_op, op);
+            emit_binary_op_reserving_labels(comp, op);
             c_assign(comp, pns->nodes[0], ASSIGN_AUG_STORE); // lhs store for aug assign
         } else if (kind == PN_expr_stmt_assign_list) {
             int rhs = MP_PARSE_NODE_STRUCT_NUM_NODES(pns1) - 1;
@@ -2168,8 +2737,11 @@ static void compile_namedexpr_helper(compiler_t *comp, mp_parse_node_t pn_name,
         }
     }
 
-    // Do the store to the target variable.
+    // Do the store to the target variable.  The expression may be evaluated
+    // conditionally, eg in "a and (b := c)", so the store may not happen.
+    tier_enter_block(comp);
     compile_store_id(comp, target);
+    tier_exit_block(comp);
 }
 
 static void compile_namedexpr(compiler_t *comp, mp_parse_node_struct_t *pns) {
@@ -2217,19 +2789,19 @@ static void compile_comparison(compiler_t *comp, mp_parse_node_struct_t *pns) {
             } else {
                 op = MP_BINARY_OP_LESS + (tok - MP_TOKEN_OP_LESS);
             }
-            EMIT_ARG(binary_op, op);
+            emit_binary_op_reserving_labels(comp, op);
         } else {
             assert(MP_PARSE_NODE_IS_STRUCT(pns->nodes[i])); // should be
             mp_parse_node_struct_t *pns2 = (mp_parse_node_struct_t *)pns->nodes[i];
             int kind = MP_PARSE_NODE_STRUCT_KIND(pns2);
             if (kind == PN_comp_op_not_in) {
-                EMIT_ARG(binary_op, MP_BINARY_OP_NOT_IN);
+                emit_binary_op_reserving_labels(comp, MP_BINARY_OP_NOT_IN);
             } else {
                 assert(kind == PN_comp_op_is); // should be
                 if (MP_PARSE_NODE_IS_NULL(pns2->nodes[0])) {
-                    EMIT_ARG(binary_op, MP_BINARY_OP_IS);
+                    emit_binary_op_reserving_labels(comp, MP_BINARY_OP_IS);
                 } else {
-                    EMIT_ARG(binary_op, MP_BINARY_OP_IS_NOT);
+                    emit_binary_op_reserving_labels(comp, MP_BINARY_OP_IS_NOT);
                 }
             }
         }
@@ -2260,7 +2832,7 @@ static void compile_binary_op(compiler_t *comp, mp_parse_node_struct_t *pns) {
     compile_node(comp, pns->nodes[0]);
     for (int i = 1; i < num_nodes; ++i) {
         compile_node(comp, pns->nodes[i]);
-        EMIT_ARG(binary_op, binary_op);
+        emit_binary_op_reserving_labels(comp, binary_op);
     }
 }
 
@@ -2271,7 +2843,7 @@ static void compile_term(compiler_t *comp, mp_parse_node_struct_t *pns) {
         compile_node(comp, pns->nodes[i + 1]);
         mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(pns->nodes[i]);
         mp_binary_op_t op = MP_BINARY_OP_LSHIFT + (tok - MP_TOKEN_OP_DBL_LESS);
-        EMIT_ARG(binary_op, op);
+        emit_binary_op_reserving_labels(comp, op);
     }
 }
 
@@ -2289,8 +2861,28 @@ static void compile_factor_2(compiler_t *comp, mp_parse_node_struct_t *pns) {
 }
 
 static void compile_atom_expr_normal(compiler_t *comp, mp_parse_node_struct_t *pns) {
-    // compile the subject of the expression
-    compile_node(comp, pns->nodes[0]);
+    // the current index into the array of trailers
+    size_t i = 0;
+
+    // compile the subject of the expression, along with the first trailer if
+    // they're a global and its attribute that can be loaded from a cache
+    #if MICROPY_COMP_CACHE_LOADS
+    if (MP_PARSE_NODE_IS_ID(pns->nodes[0])
+        && MP_PARSE_NODE_IS_STRUCT(pns->nodes[1])) {
+        mp_parse_node_struct_t *pns_first = (mp_parse_node_struct_t *)pns->nodes[1];
+        if (MP_PARSE_NODE_STRUCT_KIND(pns_first) == PN_atom_expr_trailers) {
+            pns_first = (mp_parse_node_struct_t *)pns_first->nodes[0];
+        }
+        if (MP_PARSE_NODE_STRUCT_KIND(pns_first) == PN_trailer_period
+            && compile_cached_load(comp, MP_PARSE_NODE_LEAF_ARG(pns->nodes[0]), MP_PARSE_NODE_LEAF_ARG(pns_first->nodes[0]))) {
+            i = 1;
+        }
+    }
+    if (i == 0)
+    #endif
+    {
+        compile_node(comp, pns->nodes[0]);
+    }
 
     // compile_atom_expr_await may call us with a NULL node
     if (MP_PARSE_NODE_IS_NULL(pns->nodes[1])) {
@@ -2305,9 +2897,6 @@ static void compile_atom_expr_normal(compiler_t *comp, mp_parse_node_struct_t *p
         pns_trail = (mp_parse_node_struct_t **)&pns_trail[0]->nodes[0];
     }
 
-    // the current index into the array of trailers
-    size_t i = 0;
-
     // handle special super() call
     if (comp->scope_cur->kind == SCOPE_FUNCTION
         && MP_PARSE_NODE_IS_ID(pns->nodes[0])
@@ -2386,7 +2975,7 @@ static void compile_atom_expr_normal(compiler_t *comp, mp_parse_node_struct_t *p
 
 static void compile_power(compiler_t *comp, mp_parse_node_struct_t *pns) {
     compile_generic_all_nodes(comp, pns); // 2 nodes, arguments of power
-    EMIT_ARG(binary_op, MP_BINARY_OP_POWER);
+    emit_binary_op_reserving_labels(comp, MP_BINARY_OP_POWER);
 }
 
 static void compile_trailer_paren_helper(compiler_t *comp, mp_parse_node_t pn_arglist, bool is_method_call, int n_positional_extra) {
@@ -2660,7 +3249,7 @@ static void compile_trailer_paren(compiler_t *comp, mp_parse_node_struct_t *pns)
 static void compile_trailer_bracket(compiler_t *comp, mp_parse_node_struct_t *pns) {
     // object who's index we want is on top of stack
     compile_node(comp, pns->nodes[0]); // the index
-    EMIT_ARG(subscr, MP_EMIT_SUBSCR_LOAD);
+    emit_subscr_reserving_labels(comp, MP_EMIT_SUBSCR_LOAD);
 }
 
 static void compile_trailer_period(compiler_t *comp, mp_parse_node_struct_t *pns) {
@@ -2944,6 +3533,7 @@ static void compile_scope_comp_iter(compiler_t *comp, mp_parse_node_struct_t *pn
     EMIT_ARG(for_iter, l_end);
     c_assign(comp, pns_comp_for->nodes[0], ASSIGN_STORE);
     mp_parse_node_t pn_iter = pns_comp_for->nodes[2];
+    cached_loads_enter_loop(comp);
 
 tail_recursion:
     if (MP_PARSE_NODE_IS_NULL(pn_iter)) {
@@ -2971,6 +3561,7 @@ tail_recursion:
         compile_scope_comp_iter(comp, pns_comp_for2, pn_inner_expr, for_depth + 1);
     }
 
+    cached_loads_exit_loop(comp);
     EMIT_ARG(jump, l_top);
     EMIT_ARG(label_assign, l_end);
     EMIT(for_iter_end);
@@ -3025,6 +3616,14 @@ static bool compile_scope(compiler_t *comp, scope_t *scope, pass_kind_t pass) {
     comp->pass = pass;
     comp->scope_cur = scope;
     comp->next_label = 0;
+    #if MICROPY_COMP_CACHE_LOADS
+    comp->loop_depth = 0;
+    #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    if (scope == comp->tier_target && pass == MP_PASS_STACK_SIZE) {
+        tier_bound_start(comp, scope);
+    }
+    #endif
     mp_emit_common_start_pass(&comp->emit_common, pass);
     EMIT_ARG(start_pass, pass, scope);
     reserve_labels_for_native(comp, 6); // used by native's start_pass
@@ -3036,6 +3635,15 @@ static bool compile_scope(compiler_t *comp, scope_t *scope, pass_kind_t pass) {
         scope->exc_stack_size = 0;
     }
 
+    #if MICROPY_COMP_GLOBAL_CONST
+    if (scope->kind == SCOPE_MODULE) {
+        // each pass over the module sees the assignments in order
+        for (size_t i = 0; i < comp->global_consts_len; i++) {
+            comp->global_consts[i].assigned = false;
+        }
+    }
+    #endif
+
     // compile
     if (MP_PARSE_NODE_IS_STRUCT_KIND(scope->pn, PN_eval_input)) {
         assert(scope->kind == SCOPE_MODULE);
@@ -3178,6 +3786,12 @@ static bool compile_scope(compiler_t *comp, scope_t *scope, pass_kind_t pass) {
 
     bool pass_complete = EMIT(end_pass);
 
+    #if MICROPY_EMIT_NATIVE_TIERING
+    if (comp->tier_bound_level != NULL) {
+        tier_bound_end(comp, scope);
+    }
+    #endif
+
     // make sure we match all the exception levels
     assert(comp->cur_except_level == 0);
 
@@ -3454,14 +4068,21 @@ static void scope_compute_things(scope_t *scope) {
     }
 }
 
-#if !MICROPY_PERSISTENT_CODE_SAVE
-static
-#endif
-void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl, mp_compiled_module_t *cm) {
+// If tier_target_index is non-zero then the function scope with that index is
+// compiled natively, and its raw code is returned if it is suitable for tiering.
+static mp_raw_code_t *compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl, mp_compiled_module_t *cm, size_t tier_target_index, qstr tier_name) {
     // put compiler state on the stack, it's relatively small
     compiler_t comp_state = {0};
     compiler_t *comp = &comp_state;
 
+    #if MICROPY_EMIT_NATIVE_TIERING
+    comp->tier_target_index = tier_target_index;
+    comp->tier_source_hash = parse_tree->source_hash;
+    #else
+    (void)tier_target_index;
+    (void)tier_name;
+    #endif
+
     comp->is_repl = is_repl;
     comp->break_label = INVALID_LABEL;
     comp->continue_label = INVALID_LABEL;
@@ -3475,6 +4096,10 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
     #endif
     scope_t *module_scope = scope_new_and_link(comp, SCOPE_MODULE, parse_tree->root, emit_opt);
 
+    #if MICROPY_COMP_GLOBAL_CONST
+    find_global_consts(comp, parse_tree->root);
+    #endif
+
     // create standard emitter; it's used at least for MP_PASS_SCOPE
     emit_t *emit_bc = emit_bc_new(&comp->emit_common);
 
@@ -3508,11 +4133,24 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
         }
     }
 
+    #if MICROPY_COMP_CACHE_LOADS
+    choose_cached_loads(comp);
+    #endif
+
     // compute some things related to scope and identifiers
     for (scope_t *s = comp->scope_head; s != NULL && comp->compile_error == MP_OBJ_NULL; s = s->next) {
         scope_compute_things(s);
     }
 
+    #if MICROPY_COMP_CACHE_LOADS
+    allocate_cached_loads(comp);
+    #endif
+
+    #if MICROPY_COMP_GLOBAL_CONST
+    // all stores to globals have now been seen
+    comp->global_consts_known = true;
+    #endif
+
     // set max number of labels now that it's calculated
     emit_bc_set_max_num_labels(emit_bc, max_num_labels);
 
@@ -3644,9 +4282,26 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
     }
     #endif
 
+    #if MICROPY_COMP_GLOBAL_CONST
+    m_del(global_const_t, comp->global_consts, comp->global_consts_len);
+    #endif
+
+    #if MICROPY_COMP_CACHE_LOADS
+    m_del(cached_load_t, comp->cached_loads, comp->cached_loads_len);
+    #endif
+
     // free the parse tree
     mp_parse_tree_clear(parse_tree);
 
+    mp_raw_code_t *tier_rc = NULL;
+    #if MICROPY_EMIT_NATIVE_TIERING
+    scope_t *ts = comp->tier_target;
+    if (ts != NULL && !comp->tier_unsupported && ts->simple_name == tier_name
+        && ts->raw_code->kind == MP_CODE_NATIVE_PY && !ts->raw_code->is_generator) {
+        tier_rc = ts->raw_code;
+    }
+    #endif
+
     // free the scopes
     for (scope_t *s = module_scope; s;) {
         scope_t *next = s->next;
@@ -3657,6 +4312,15 @@ void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool
     if (comp->compile_error != MP_OBJ_NULL) {
         nlr_raise(comp->compile_error);
     }
+
+    return tier_rc;
+}
+
+#if !MICROPY_PERSISTENT_CODE_SAVE
+static
+#endif
+void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl, mp_compiled_module_t *cm) {
+    compile_to_raw_code(parse_tree, source_file, is_repl, cm, 0, MP_QSTRnull);
 }
 
 mp_obj_t mp_compile(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl) {
@@ -3668,4 +4332,25 @@ mp_obj_t mp_compile(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl)
     return mp_make_function_from_proto_fun(cm.rc, cm.context, NULL);
 }
 
+#if MICROPY_EMIT_NATIVE_TIERING
+mp_obj_t mp_compile_tier_native(qstr source_file, uint32_t source_hash, size_t scope_index, size_t def_line, qstr name, mp_obj_dict_t *globals) {
+    mp_lexer_t *lex = mp_lexer_new_from_file(source_file);
+    mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+    if (parse_tree.source_hash != source_hash) {
+        // the source file changed since the function was compiled
+        mp_parse_tree_clear(&parse_tree);
+        return mp_const_none;
+    }
+    mp_compiled_module_t cm;
+    cm.context = m_new_obj(mp_module_context_t);
+    cm.context->module.globals = globals;
+    mp_raw_code_t *tier_rc = compile_to_raw_code(&parse_tree, source_file, false, &cm, scope_index, name);
+    if (tier_rc == NULL || tier_rc->tier_def_line != def_line) {
+        // the function can't be compiled natively
+        return mp_const_none;
+    }
+    return mp_make_function_from_proto_fun(tier_rc, cm.context, NULL);
+}
+#endif
+
 #endif // MICROPY_ENABLE_COMPILER
@@ -40,6 +40,13 @@ mp_obj_t mp_compile(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl)
 void mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_file, bool is_repl, mp_compiled_module_t *cm);
 #endif
 
+#if MICROPY_EMIT_NATIVE_TIERING
+// Recompile the module in source_file and return a native function for the
+// function scope with the given index, definition line and name, or None if
+// that isn't possible.  Raises an exception if the file can't be compiled.
+mp_obj_t mp_compile_tier_native(qstr source_file, uint32_t source_hash, size_t scope_index, size_t def_line, qstr name, mp_obj_dict_t *globals);
+#endif
+
 // this is implemented in runtime.c
 mp_obj_t mp_parse_compile_execute(mp_lexer_t *lex, mp_parse_input_kind_t parse_input_kind, mp_obj_dict_t *globals, mp_obj_dict_t *locals);
 
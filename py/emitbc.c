@@ -525,6 +525,24 @@ void mp_emit_bc_load_global(emit_t *emit, qstr qst, int kind) {
     emit_write_bytecode_byte_qstr(emit, 1, MP_BC_LOAD_NAME + kind, qst);
 }
 
+// The value cached in locals local_num (value) and local_num + 1 (version) is
+// pushed and execution continues at label if it's still valid.  Otherwise the
+// current version is pushed and the code following this opcode must load the
+// value and end with mp_emit_bc_store_fast_cached() before the label.
+void mp_emit_bc_load_fast_cached(emit_t *emit, mp_uint_t local_num, mp_uint_t label) {
+    assert(local_num < 255);
+    emit_write_bytecode_byte_label(emit, 1, MP_BC_LOAD_FAST_CACHED, label);
+    emit_write_bytecode_raw_byte(emit, local_num);
+}
+
+// If is_attr is true then the value was loaded from an attribute of the object
+// under it on the stack, which is popped along with the version.
+void mp_emit_bc_store_fast_cached(emit_t *emit, mp_uint_t local_num, bool is_attr) {
+    MP_STATIC_ASSERT(MP_BC_STORE_FAST_CACHED + 1 == MP_BC_STORE_FAST_CACHED_ATTR);
+    emit_write_bytecode_byte(emit, -1 - is_attr, MP_BC_STORE_FAST_CACHED + is_attr);
+    emit_write_bytecode_raw_byte(emit, local_num);
+}
+
 void mp_emit_bc_load_method(emit_t *emit, qstr qst, bool is_super) {
     int stack_adj = 1 - 2 * is_super;
     emit_write_bytecode_byte_qstr(emit, stack_adj, is_super ? MP_BC_LOAD_SUPER_METHOD : MP_BC_LOAD_METHOD, qst);
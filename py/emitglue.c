@@ -126,6 +126,15 @@ void mp_emit_glue_assign_native(mp_raw_code_t *rc, mp_raw_code_kind_t kind, cons
         "mcr p15, 0, r0, c7, c7, 0\n" // invalidate I-cache and D-cache
         : : : "r0", "cc");
     #endif
+    #elif MICROPY_EMIT_AARCH64
+    __builtin___clear_cache((void *)fun_data, (uint8_t *)fun_data + fun_len);
+    #elif MICROPY_EMIT_RV32
+    #if defined(__linux__) && defined(__GNUC__)
+    __builtin___clear_cache((void *)fun_data, (uint8_t *)fun_data + fun_len);
+    #elif defined(__riscv)
+    // Make the instruction fetches see the stores of the new code.
+    __asm__ volatile ("fence.i" : : : "memory");
+    #endif
     #endif
 
     rc->kind = kind;
@@ -223,9 +232,10 @@ mp_obj_t mp_make_function_from_proto_fun(mp_proto_fun_t proto_fun, const mp_modu
                 ((mp_obj_base_t *)MP_OBJ_TO_PTR(fun))->type = &mp_type_gen_wrap;
             }
 
-            #if MICROPY_PY_SYS_SETTRACE
+            #if MICROPY_PY_SYS_SETTRACE || MICROPY_EMIT_NATIVE_TIERING
+            // raw code compiled from source lives in RAM, and tiering updates it
             mp_obj_fun_bc_t *self_fun = (mp_obj_fun_bc_t *)MP_OBJ_TO_PTR(fun);
-            self_fun->rc = rc;
+            self_fun->rc = (mp_raw_code_t *)rc;
             #endif
 
             break;
@@ -92,6 +92,17 @@ typedef struct _mp_raw_code_t {
     mp_bytecode_prelude_t prelude;
     #endif
     #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    // For tiered execution: the position of the function's scope within its
+    // module (0 if it can't be tiered), its line and the hash of the module's
+    // source, to find it again when recompiling; a count of calls plus
+    // backward jumps; and the native function once compiled.
+    uint16_t tier_scope_index;
+    uint32_t tier_def_line;
+    uint32_t tier_source_hash;
+    uint32_t tier_count;
+    mp_obj_t tier_fun;
+    #endif
     #if MICROPY_EMIT_INLINE_ASM
     uint32_t asm_n_pos_args : 8;
     uint32_t asm_type_sig : 24; // compressed as 2-bit types; ret is MSB, then arg0, arg1, etc
@@ -118,6 +129,13 @@ typedef struct _mp_raw_code_truncated_t {
     mp_bytecode_prelude_t prelude;
     #endif
     #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    uint16_t tier_scope_index;
+    uint32_t tier_def_line;
+    uint32_t tier_source_hash;
+    uint32_t tier_count;
+    mp_obj_t tier_fun;
+    #endif
 } mp_raw_code_truncated_t;
 
 mp_raw_code_t *mp_emit_glue_new_raw_code(void);
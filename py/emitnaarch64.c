@@ -0,0 +1,18 @@
+// AArch64 specific stuff
+
+#include "py/mpconfig.h"
+
+#if MICROPY_EMIT_AARCH64
+
+// this is defined so that the assembler exports generic assembler API macros
+#define GENERIC_ASM_API (1)
+#include "py/asmaarch64.h"
+
+// Word indices of REG_LOCAL_x in nlr_buf_t (see nlraarch64.c: lr, sp, x19-x29)
+#define NLR_BUF_IDX_LOCAL_1 (2 + 2) // x19
+
+#define N_AARCH64 (1)
+#define EXPORT_FUN(name) emit_native_aarch64_##name
+#include "py/emitnative.c"
+
+#endif
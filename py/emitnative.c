@@ -49,6 +49,7 @@
 #include "py/emit.h"
 #include "py/nativeglue.h"
 #include "py/objfun.h"
+#include "py/objlist.h"
 #include "py/objstr.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
@@ -59,7 +60,7 @@
 #endif
 
 // wrapper around everything in this file
-#if N_X64 || N_X86 || N_THUMB || N_ARM || N_XTENSA || N_XTENSAWIN
+#if N_X64 || N_X86 || N_THUMB || N_ARM || N_XTENSA || N_XTENSAWIN || N_RV32 || N_AARCH64
 
 // C stack layout for native functions:
 //  0:                          nlr_buf_t [optional]
@@ -106,6 +107,11 @@
 #define OFFSETOF_MODULE_CONTEXT_QSTR_TABLE (offsetof(mp_module_context_t, constants.qstr_table) / sizeof(uintptr_t))
 #define OFFSETOF_MODULE_CONTEXT_OBJ_TABLE (offsetof(mp_module_context_t, constants.obj_table) / sizeof(uintptr_t))
 #define OFFSETOF_MODULE_CONTEXT_GLOBALS (offsetof(mp_module_context_t, module.globals) / sizeof(uintptr_t))
+#define OFFSETOF_OBJ_LIST_LEN (offsetof(mp_obj_list_t, len) / sizeof(uintptr_t))
+#define OFFSETOF_OBJ_LIST_ITEMS (offsetof(mp_obj_list_t, items) / sizeof(uintptr_t))
+
+// Word index of mp_fun_table.type_list
+#define FUN_TABLE_IDX_TYPE_LIST (offsetof(mp_fun_table_t, type_list) / sizeof(uintptr_t))
 
 // If not already defined, set parent args to same as child call registers
 #ifndef REG_PARENT_RET
@@ -130,6 +136,11 @@
 // Whether a slot is needed to store LOCAL_IDX_EXC_HANDLER_UNWIND
 #define NEED_EXC_HANDLER_UNWIND(emit) ((emit)->scope->exc_stack_size > 0)
 
+// Whether to emit inline fast paths for small-int arithmetic and list indexing
+// on Python objects.  This relies on small ints being tagged with a set low bit
+// and needs REG_ARG_4 as a scratch register, which on x86 holds a local.
+#define NATIVE_FAST_PATHS ((MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_A || MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_C) && !N_X86)
+
 // Whether registers can be used to store locals (only true if there are no
 // exception handlers, because otherwise an nlr_jump will restore registers to
 // their state at the start of the function and updates to locals will be lost)
@@ -145,35 +156,54 @@
 #define LOCAL_IDX_GEN_PC(emit) ((emit)->code_state_start + OFFSETOF_CODE_STATE_IP)
 #define LOCAL_IDX_LOCAL_VAR(emit, local_num) ((emit)->stack_start + (emit)->n_state - 1 - (local_num))
 
-#if MICROPY_PERSISTENT_CODE_SAVE
+#if MICROPY_PERSISTENT_CODE_SAVE_NATIVE
 
 // When building with the ability to save native code to .mpy files:
 //  - Qstrs are indirect via qstr_table, and REG_LOCAL_3 always points to qstr_table.
 //  - In a generator no registers are used to store locals, and REG_LOCAL_2 points to the generator state.
-//  - At most 2 registers hold local variables (see CAN_USE_REGS_FOR_LOCALS for when this is possible).
+//  - At most REG_LOCAL_NUM - 1 registers hold local variables (see CAN_USE_REGS_FOR_LOCALS for when this is possible).
 
 #define REG_GENERATOR_STATE (REG_LOCAL_2)
 #define REG_QSTR_TABLE (REG_LOCAL_3)
-#define MAX_REGS_FOR_LOCAL_VARS (2)
+#define MAX_REGS_FOR_LOCAL_VARS (REG_LOCAL_NUM - 1)
 
-static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, REG_LOCAL_2};
+static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {
+    REG_LOCAL_1, REG_LOCAL_2,
+    #if REG_LOCAL_NUM > 3
+    REG_LOCAL_4, REG_LOCAL_5,
+    #endif
+};
 
 #else
 
 // When building without the ability to save native code to .mpy files:
 //  - Qstrs values are written directly into the machine code.
 //  - In a generator no registers are used to store locals, and REG_LOCAL_3 points to the generator state.
-//  - At most 3 registers hold local variables (see CAN_USE_REGS_FOR_LOCALS for when this is possible).
+//  - At most REG_LOCAL_NUM registers hold local variables (see CAN_USE_REGS_FOR_LOCALS for when this is possible).
 
 #define REG_GENERATOR_STATE (REG_LOCAL_3)
-#define MAX_REGS_FOR_LOCAL_VARS (3)
+#define MAX_REGS_FOR_LOCAL_VARS (REG_LOCAL_NUM)
 
-static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_3};
+static const uint8_t reg_local_table[MAX_REGS_FOR_LOCAL_VARS] = {
+    REG_LOCAL_1, REG_LOCAL_2, REG_LOCAL_3,
+    #if REG_LOCAL_NUM > 3
+    REG_LOCAL_4, REG_LOCAL_5,
+    #endif
+};
 
 #endif
 
 #define REG_LOCAL_LAST (reg_local_table[MAX_REGS_FOR_LOCAL_VARS - 1])
 
+// Which locals live in registers is decided after the MP_PASS_STACK_SIZE pass,
+// which records every load/store of a local along with its code position.  A
+// use inside a loop body (found by a jump back to an already-assigned label)
+// has its weight multiplied by LOCAL_USE_LOOP_WEIGHT for each enclosing loop,
+// and the locals with the highest total weight get the registers.
+#define LOCAL_USE_LOOP_WEIGHT (8)
+#define LOCAL_USE_MAX_WEIGHT (0x100000)
+#define LOCAL_NUM_NONE (0xffff)
+
 #define EMIT_NATIVE_VIPER_TYPE_ERROR(emit, ...) do { \
         *emit->error_slot = mp_obj_new_exception_msg_varg(&mp_type_ViperTypeError, __VA_ARGS__); \
 } while (0)
@@ -245,6 +275,12 @@ typedef struct _exc_stack_entry_t {
     uint16_t is_active : 1;
 } exc_stack_entry_t;
 
+typedef struct _local_use_t {
+    uint16_t local_num;
+    uint32_t weight;
+    size_t code_pos;
+} local_use_t;
+
 struct _emit_t {
     mp_emit_common_t *emit_common;
     mp_obj_t *error_slot;
@@ -265,6 +301,13 @@ struct _emit_t {
     size_t exc_stack_size;
     exc_stack_entry_t *exc_stack;
 
+    size_t local_use_alloc;
+    size_t local_use_len;
+    local_use_t *local_use;
+
+    // The local held by each register in reg_local_table, or LOCAL_NUM_NONE
+    uint16_t reg_local_num[MAX_REGS_FOR_LOCAL_VARS];
+
     int prelude_offset;
     int prelude_ptr_index;
     int start_offset;
@@ -303,6 +346,7 @@ void EXPORT_FUN(free)(emit_t * emit) {
     mp_asm_base_deinit(&emit->as->base, false);
     m_del_obj(ASM_T, emit->as);
     m_del(exc_stack_entry_t, emit->exc_stack, emit->exc_stack_alloc);
+    m_del(local_use_t, emit->local_use, emit->local_use_alloc);
     m_del(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc);
     m_del(stack_info_t, emit->stack_info, emit->stack_info_alloc);
     m_del_obj(emit_t, emit);
@@ -340,7 +384,7 @@ static void emit_native_mov_reg_state_addr(emit_t *emit, int reg_dest, int local
 }
 
 static void emit_native_mov_reg_qstr(emit_t *emit, int arg_reg, qstr qst) {
-    #if MICROPY_PERSISTENT_CODE_SAVE
+    #if MICROPY_PERSISTENT_CODE_SAVE_NATIVE
     ASM_LOAD16_REG_REG_OFFSET(emit->as, arg_reg, REG_QSTR_TABLE, mp_emit_common_use_qstr(emit->emit_common, qst));
     #else
     ASM_MOV_REG_IMM(emit->as, arg_reg, qst);
@@ -348,7 +392,7 @@ static void emit_native_mov_reg_qstr(emit_t *emit, int arg_reg, qstr qst) {
 }
 
 static void emit_native_mov_reg_qstr_obj(emit_t *emit, int reg_dest, qstr qst) {
-    #if MICROPY_PERSISTENT_CODE_SAVE
+    #if MICROPY_PERSISTENT_CODE_SAVE_NATIVE
     emit_load_reg_with_object(emit, reg_dest, MP_OBJ_NEW_QSTR(qst));
     #else
     ASM_MOV_REG_IMM(emit->as, reg_dest, (mp_uint_t)MP_OBJ_NEW_QSTR(qst));
@@ -361,6 +405,84 @@ static void emit_native_mov_reg_qstr_obj(emit_t *emit, int reg_dest, qstr qst) {
         emit_native_mov_state_reg((emit), (local_num), (reg_temp)); \
     } while (false)
 
+// Return the register that holds the given local, or -1 if it lives in the state
+static int emit_native_local_reg(emit_t *emit, mp_uint_t local_num) {
+    for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS; ++i) {
+        if (emit->reg_local_num[i] == local_num) {
+            return reg_local_table[i];
+        }
+    }
+    return -1;
+}
+
+static void emit_native_record_local_use(emit_t *emit, mp_uint_t local_num) {
+    if (emit->pass != MP_PASS_STACK_SIZE) {
+        return;
+    }
+    if (emit->local_use_len >= emit->local_use_alloc) {
+        size_t new_alloc = emit->local_use_alloc * 2 + 16;
+        emit->local_use = m_renew(local_use_t, emit->local_use, emit->local_use_alloc, new_alloc);
+        emit->local_use_alloc = new_alloc;
+    }
+    local_use_t *u = &emit->local_use[emit->local_use_len++];
+    u->local_num = local_num;
+    u->weight = 1;
+    u->code_pos = mp_asm_base_get_code_pos(&emit->as->base);
+}
+
+static void emit_native_record_jump(emit_t *emit, mp_uint_t label) {
+    if (emit->pass != MP_PASS_STACK_SIZE) {
+        return;
+    }
+    size_t label_pos = emit->as->base.label_offsets[label];
+    if (label_pos == (size_t)-1) {
+        // forward jump
+        return;
+    }
+    // backward jump: all uses since the label are in a loop body
+    for (size_t i = emit->local_use_len; i > 0 && emit->local_use[i - 1].code_pos >= label_pos; --i) {
+        local_use_t *u = &emit->local_use[i - 1];
+        if (u->weight < LOCAL_USE_MAX_WEIGHT) {
+            u->weight *= LOCAL_USE_LOOP_WEIGHT;
+        }
+    }
+}
+
+static void emit_native_assign_local_regs(emit_t *emit) {
+    for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS; ++i) {
+        emit->reg_local_num[i] = LOCAL_NUM_NONE;
+    }
+    if (!CAN_USE_REGS_FOR_LOCALS(emit) || emit->local_use_len == 0) {
+        return;
+    }
+
+    size_t num_locals = emit->scope->num_locals;
+    uint32_t *weight = m_new0(uint32_t, num_locals);
+    for (size_t i = 0; i < emit->local_use_len; ++i) {
+        local_use_t *u = &emit->local_use[i];
+        weight[u->local_num] += MIN(u->weight, UINT32_MAX - weight[u->local_num]);
+    }
+
+    // Hand out registers in order of decreasing weight, so REG_LOCAL_LAST (which
+    // is busy during viper argument setup) goes to the least used local
+    for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS; ++i) {
+        size_t best = LOCAL_NUM_NONE;
+        uint32_t best_weight = 0;
+        for (size_t j = 0; j < num_locals; ++j) {
+            if (weight[j] > best_weight) {
+                best = j;
+                best_weight = weight[j];
+            }
+        }
+        if (best == LOCAL_NUM_NONE) {
+            break;
+        }
+        emit->reg_local_num[i] = best;
+        weight[best] = 0;
+    }
+    m_del(uint32_t, weight, num_locals);
+}
+
 static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     DEBUG_printf("start_pass(pass=%u, scope=%p)\n", pass, scope);
 
@@ -369,6 +491,14 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
     emit->stack_size = 0;
     emit->scope = scope;
 
+    // choose which locals to keep in registers, based on the uses seen in the first pass
+    if (pass == MP_PASS_STACK_SIZE) {
+        emit->local_use_len = 0;
+        emit_native_assign_local_regs(emit);
+    } else if (pass == MP_PASS_CODE_SIZE) {
+        emit_native_assign_local_regs(emit);
+    }
+
     // allocate memory for keeping track of the types of locals
     if (emit->local_vtype_alloc < scope->num_locals) {
         emit->local_vtype = m_renew(vtype_kind_t, emit->local_vtype, emit->local_vtype_alloc, scope->num_locals);
@@ -429,16 +559,15 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         // Work out size of state (locals plus stack)
         // n_state counts all stack and locals, even those in registers
         emit->n_state = scope->num_locals + scope->stack_size;
+        // The state slots of leading locals that live in registers can be dropped
         int num_locals_in_regs = 0;
-        if (CAN_USE_REGS_FOR_LOCALS(emit)) {
-            num_locals_in_regs = scope->num_locals;
-            if (num_locals_in_regs > MAX_REGS_FOR_LOCAL_VARS) {
-                num_locals_in_regs = MAX_REGS_FOR_LOCAL_VARS;
-            }
-            // Need a spot for REG_LOCAL_LAST (see below)
-            if (scope->num_pos_args >= MAX_REGS_FOR_LOCAL_VARS + 1) {
-                --num_locals_in_regs;
+        while (num_locals_in_regs < scope->num_locals) {
+            int reg = emit_native_local_reg(emit, num_locals_in_regs);
+            // Need a spot for REG_LOCAL_LAST if it must be parked (see below)
+            if (reg < 0 || (reg == REG_LOCAL_LAST && num_locals_in_regs + 1 < scope->num_pos_args)) {
+                break;
             }
+            ++num_locals_in_regs;
         }
 
         // Work out where the locals and Python stack start within the C stack
@@ -461,7 +590,7 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
 
         // Load REG_FUN_TABLE with a pointer to mp_fun_table, found in the const_table
         ASM_LOAD_REG_REG_OFFSET(emit->as, REG_FUN_TABLE, REG_PARENT_ARG_1, OFFSETOF_OBJ_FUN_BC_CONTEXT);
-        #if MICROPY_PERSISTENT_CODE_SAVE
+        #if MICROPY_PERSISTENT_CODE_SAVE_NATIVE
         ASM_LOAD_REG_REG_OFFSET(emit->as, REG_QSTR_TABLE, REG_FUN_TABLE, OFFSETOF_MODULE_CONTEXT_QSTR_TABLE);
         #endif
         ASM_LOAD_REG_REG_OFFSET(emit->as, REG_FUN_TABLE, REG_FUN_TABLE, OFFSETOF_MODULE_CONTEXT_OBJ_TABLE);
@@ -501,15 +630,17 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
                 r = REG_RET;
             }
             // REG_LOCAL_LAST points to the args array so be sure not to overwrite it if it's still needed
-            if (i < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit) && (i != MAX_REGS_FOR_LOCAL_VARS - 1 || emit->scope->num_pos_args == MAX_REGS_FOR_LOCAL_VARS)) {
-                ASM_MOV_REG_REG(emit->as, reg_local_table[i], r);
+            int reg = emit_native_local_reg(emit, i);
+            if (reg >= 0 && (reg != REG_LOCAL_LAST || i + 1 == emit->scope->num_pos_args)) {
+                ASM_MOV_REG_REG(emit->as, reg, r);
             } else {
                 emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, i), r);
             }
         }
         // Get local from the stack back into REG_LOCAL_LAST if this reg couldn't be written to above
-        if (emit->scope->num_pos_args >= MAX_REGS_FOR_LOCAL_VARS + 1 && CAN_USE_REGS_FOR_LOCALS(emit)) {
-            ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_LAST, LOCAL_IDX_LOCAL_VAR(emit, MAX_REGS_FOR_LOCAL_VARS - 1));
+        mp_uint_t last_local_num = emit->reg_local_num[MAX_REGS_FOR_LOCAL_VARS - 1];
+        if (last_local_num + 1 < emit->scope->num_pos_args) {
+            ASM_MOV_REG_LOCAL(emit->as, REG_LOCAL_LAST, LOCAL_IDX_LOCAL_VAR(emit, last_local_num));
         }
 
         emit_native_global_exc_entry(emit);
@@ -546,7 +677,7 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
             // Load REG_FUN_TABLE with a pointer to mp_fun_table, found in the const_table
             ASM_LOAD_REG_REG_OFFSET(emit->as, REG_TEMP0, REG_GENERATOR_STATE, LOCAL_IDX_FUN_OBJ(emit));
             ASM_LOAD_REG_REG_OFFSET(emit->as, REG_TEMP0, REG_TEMP0, OFFSETOF_OBJ_FUN_BC_CONTEXT);
-            #if MICROPY_PERSISTENT_CODE_SAVE
+            #if MICROPY_PERSISTENT_CODE_SAVE_NATIVE
             ASM_LOAD_REG_REG_OFFSET(emit->as, REG_QSTR_TABLE, REG_TEMP0, OFFSETOF_MODULE_CONTEXT_QSTR_TABLE);
             #endif
             ASM_LOAD_REG_REG_OFFSET(emit->as, REG_TEMP0, REG_TEMP0, OFFSETOF_MODULE_CONTEXT_OBJ_TABLE);
@@ -569,7 +700,7 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
 
             // Load REG_FUN_TABLE with a pointer to mp_fun_table, found in the const_table
             ASM_LOAD_REG_REG_OFFSET(emit->as, REG_FUN_TABLE, REG_PARENT_ARG_1, OFFSETOF_OBJ_FUN_BC_CONTEXT);
-            #if MICROPY_PERSISTENT_CODE_SAVE
+            #if MICROPY_PERSISTENT_CODE_SAVE_NATIVE
             ASM_LOAD_REG_REG_OFFSET(emit->as, REG_QSTR_TABLE, REG_FUN_TABLE, OFFSETOF_MODULE_CONTEXT_QSTR_TABLE);
             #endif
             ASM_LOAD_REG_REG_OFFSET(emit->as, REG_FUN_TABLE, REG_FUN_TABLE, OFFSETOF_MODULE_CONTEXT_OBJ_TABLE);
@@ -608,9 +739,9 @@ static void emit_native_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scop
         emit_native_global_exc_entry(emit);
 
         // cache some locals in registers, but only if no exception handlers
-        if (CAN_USE_REGS_FOR_LOCALS(emit)) {
-            for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS && i < scope->num_locals; ++i) {
-                ASM_MOV_REG_LOCAL(emit->as, reg_local_table[i], LOCAL_IDX_LOCAL_VAR(emit, i));
+        for (int i = 0; i < MAX_REGS_FOR_LOCAL_VARS; ++i) {
+            if (emit->reg_local_num[i] != LOCAL_NUM_NONE) {
+                ASM_MOV_REG_LOCAL(emit->as, reg_local_table[i], LOCAL_IDX_LOCAL_VAR(emit, emit->reg_local_num[i]));
             }
         }
 
@@ -1390,8 +1521,10 @@ static void emit_native_load_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit, MP_ERROR_TEXT("local '%q' used before type known"), qst);
     }
     emit_native_pre(emit);
-    if (local_num < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
-        emit_post_push_reg(emit, vtype, reg_local_table[local_num]);
+    emit_native_record_local_use(emit, local_num);
+    int reg = emit_native_local_reg(emit, local_num);
+    if (reg >= 0) {
+        emit_post_push_reg(emit, vtype, reg);
     } else {
         need_reg_single(emit, REG_TEMP0, 0);
         emit_native_mov_reg_state(emit, REG_TEMP0, LOCAL_IDX_LOCAL_VAR(emit, local_num));
@@ -1472,6 +1605,95 @@ static void emit_native_load_build_class(emit_t *emit) {
     emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
 }
 
+#if NATIVE_FAST_PATHS
+
+// Jump to label if the signed value in reg is negative.
+static void emit_native_jump_if_reg_negative(emit_t *emit, int reg, mp_uint_t label) {
+    #if N_X64
+    asm_x64_test_r64_with_r64(emit->as, reg, reg);
+    asm_x64_jcc_label(emit->as, ASM_X64_CC_JL, label);
+    #elif N_THUMB
+    asm_thumb_cmp_rlo_i8(emit->as, reg, 0);
+    asm_thumb_bcc_label(emit->as, ASM_THUMB_CC_LT, label);
+    #elif N_ARM
+    asm_arm_cmp_reg_i8(emit->as, reg, 0);
+    asm_arm_bcc_label(emit->as, ASM_ARM_CC_LT, label);
+    #elif N_XTENSA || N_XTENSAWIN
+    asm_xtensa_bccz_reg_label(emit->as, ASM_XTENSA_CCZ_LT, reg, label);
+    #elif N_RV32
+    asm_rv32_bcc_reg_reg_label(emit->as, ASM_RV32_CC_LT, reg, ASM_RV32_REG_ZERO, label);
+    #elif N_AARCH64
+    asm_aarch64_cmp_reg_reg(emit->as, reg, ASM_AARCH64_REG_XZR);
+    asm_aarch64_bcc_label(emit->as, ASM_AARCH64_CC_LT, label);
+    #else
+    #error not implemented
+    #endif
+}
+
+// Jump to label if reg1 >= reg2 as unsigned values.
+static void emit_native_jump_if_reg_geu(emit_t *emit, int reg1, int reg2, mp_uint_t label) {
+    #if N_X64
+    asm_x64_cmp_r64_with_r64(emit->as, reg2, reg1);
+    asm_x64_jcc_label(emit->as, ASM_X64_CC_JAE, label);
+    #elif N_THUMB
+    asm_thumb_cmp_rlo_rlo(emit->as, reg1, reg2);
+    asm_thumb_bcc_label(emit->as, ASM_THUMB_CC_CS, label);
+    #elif N_ARM
+    asm_arm_cmp_reg_reg(emit->as, reg1, reg2);
+    asm_arm_bcc_label(emit->as, ASM_ARM_CC_CS, label);
+    #elif N_XTENSA || N_XTENSAWIN
+    asm_xtensa_bcc_reg_reg_label(emit->as, ASM_XTENSA_CC_GEU, reg1, reg2, label);
+    #elif N_RV32
+    asm_rv32_bcc_reg_reg_label(emit->as, ASM_RV32_CC_GEU, reg1, reg2, label);
+    #elif N_AARCH64
+    asm_aarch64_cmp_reg_reg(emit->as, reg1, reg2);
+    asm_aarch64_bcc_label(emit->as, ASM_AARCH64_CC_HS, label);
+    #else
+    #error not implemented
+    #endif
+}
+
+// Emit the checks for an inline fast path indexing an exact list, with the base
+// in REG_ARG_1 and the index in REG_ARG_2.  Jumps to label if the base is not a
+// list or the index is not a small int within range.  Otherwise leaves the
+// address of the item in REG_ARG_1, using reg_temp1 and reg_temp2 as scratch.
+static void emit_native_list_item_address(emit_t *emit, int reg_temp1, int reg_temp2, mp_uint_t label) {
+    // both paths must leave the Python stack in the same state
+    need_reg_all(emit);
+
+    // index must be a small int
+    ASM_MOV_REG_IMM(emit->as, reg_temp1, 1);
+    ASM_AND_REG_REG(emit->as, reg_temp1, REG_ARG_2);
+    ASM_JUMP_IF_REG_ZERO(emit->as, reg_temp1, label, true);
+
+    // base must be an object pointer whose type is exactly list
+    ASM_MOV_REG_IMM(emit->as, reg_temp1, 3);
+    ASM_AND_REG_REG(emit->as, reg_temp1, REG_ARG_1);
+    ASM_JUMP_IF_REG_NONZERO(emit->as, reg_temp1, label, true);
+    ASM_LOAD_REG_REG_OFFSET(emit->as, reg_temp1, REG_ARG_1, 0);
+    ASM_LOAD_REG_REG_OFFSET(emit->as, reg_temp2, REG_FUN_TABLE, FUN_TABLE_IDX_TYPE_LIST);
+    ASM_XOR_REG_REG(emit->as, reg_temp1, reg_temp2);
+    ASM_JUMP_IF_REG_NONZERO(emit->as, reg_temp1, label, false);
+
+    // the tagged index is 2 * index + 1, so an unsigned compare against 2 * len
+    // also sends negative indices to the slow path
+    ASM_LOAD_REG_REG_OFFSET(emit->as, reg_temp2, REG_ARG_1, OFFSETOF_OBJ_LIST_LEN);
+    ASM_ADD_REG_REG(emit->as, reg_temp2, reg_temp2);
+    emit_native_jump_if_reg_geu(emit, REG_ARG_2, reg_temp2, label);
+
+    // address of item is items + (2 * index) * (ASM_WORD_SIZE / 2)
+    ASM_LOAD_REG_REG_OFFSET(emit->as, REG_ARG_1, REG_ARG_1, OFFSETOF_OBJ_LIST_ITEMS);
+    ASM_MOV_REG_IMM(emit->as, reg_temp2, 1);
+    ASM_MOV_REG_REG(emit->as, reg_temp1, REG_ARG_2);
+    ASM_XOR_REG_REG(emit->as, reg_temp1, reg_temp2);
+    for (int i = 2; i < ASM_WORD_SIZE; i <<= 1) {
+        ASM_ADD_REG_REG(emit->as, reg_temp1, reg_temp1);
+    }
+    ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_temp1);
+}
+
+#endif
+
 static void emit_native_load_subscr(emit_t *emit) {
     DEBUG_printf("load_subscr\n");
     // need to compile: base[index]
@@ -1492,7 +1714,17 @@ static void emit_native_load_subscr(emit_t *emit) {
             ASM_MOV_REG_REG(emit->as, REG_ARG_2, REG_RET);
         }
         emit_pre_pop_reg(emit, &vtype_base, REG_ARG_1);
+        #if NATIVE_FAST_PATHS
+        // Note: 2 labels are reserved for this function, starting at *emit->label_slot
+        emit_native_list_item_address(emit, REG_ARG_3, REG_ARG_4, *emit->label_slot);
+        ASM_LOAD_REG_REG_OFFSET(emit->as, REG_RET, REG_ARG_1, 0);
+        ASM_JUMP(emit->as, *emit->label_slot + 1);
+        mp_asm_base_label_assign(&emit->as->base, *emit->label_slot);
+        #endif
         emit_call_with_imm_arg(emit, MP_F_OBJ_SUBSCR, (mp_uint_t)MP_OBJ_SENTINEL, REG_ARG_3);
+        #if NATIVE_FAST_PATHS
+        mp_asm_base_label_assign(&emit->as->base, *emit->label_slot + 1);
+        #endif
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
     } else {
         // viper load
@@ -1520,6 +1752,12 @@ static void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_AARCH64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_aarch64_ldr_reg_reg_i12(emit->as, ASM_AARCH64_SIZE_8, REG_RET, reg_base, index_value);
+                            break;
+                        }
+                        #endif
                         need_reg_single(emit, reg_index, 0);
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add index to base
@@ -1538,6 +1776,12 @@ static void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_AARCH64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_aarch64_ldr_reg_reg_i12(emit->as, ASM_AARCH64_SIZE_16, REG_RET, reg_base, index_value);
+                            break;
+                        }
+                        #endif
                         need_reg_single(emit, reg_index, 0);
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 1);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 2*index to base
@@ -1556,6 +1800,12 @@ static void emit_native_load_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_AARCH64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_aarch64_ldr_reg_reg_i12(emit->as, ASM_AARCH64_SIZE_32, REG_RET, reg_base, index_value);
+                            break;
+                        }
+                        #endif
                         need_reg_single(emit, reg_index, 0);
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 2);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 4*index to base
@@ -1583,12 +1833,20 @@ static void emit_native_load_subscr(emit_t *emit) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
                     // TODO optimise to use thumb ldrb r1, [r2, r3]
+                    #if N_AARCH64
+                    asm_aarch64_ldr_reg_reg_reg(emit->as, ASM_AARCH64_SIZE_8, REG_RET, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_LOAD8_REG_REG(emit->as, REG_RET, REG_ARG_1); // store value to (base+index)
                     break;
                 }
                 case VTYPE_PTR16: {
                     // pointer to 16-bit memory
+                    #if N_AARCH64
+                    asm_aarch64_ldr_reg_reg_reg(emit->as, ASM_AARCH64_SIZE_16, REG_RET, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_LOAD16_REG_REG(emit->as, REG_RET, REG_ARG_1); // load from (base+2*index)
@@ -1596,6 +1854,10 @@ static void emit_native_load_subscr(emit_t *emit) {
                 }
                 case VTYPE_PTR32: {
                     // pointer to word-size memory
+                    #if N_AARCH64
+                    asm_aarch64_ldr_reg_reg_reg(emit->as, ASM_AARCH64_SIZE_32, REG_RET, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1614,8 +1876,10 @@ static void emit_native_load_subscr(emit_t *emit) {
 
 static void emit_native_store_fast(emit_t *emit, qstr qst, mp_uint_t local_num) {
     vtype_kind_t vtype;
-    if (local_num < MAX_REGS_FOR_LOCAL_VARS && CAN_USE_REGS_FOR_LOCALS(emit)) {
-        emit_pre_pop_reg(emit, &vtype, reg_local_table[local_num]);
+    emit_native_record_local_use(emit, local_num);
+    int reg = emit_native_local_reg(emit, local_num);
+    if (reg >= 0) {
+        emit_pre_pop_reg(emit, &vtype, reg);
     } else {
         emit_pre_pop_reg(emit, &vtype, REG_TEMP0);
         emit_native_mov_state_reg(emit, LOCAL_IDX_LOCAL_VAR(emit, local_num), REG_TEMP0);
@@ -1714,7 +1978,17 @@ static void emit_native_store_subscr(emit_t *emit) {
             adjust_stack(emit, 3);
         }
         emit_pre_pop_reg_reg_reg(emit, &vtype_index, REG_ARG_2, &vtype_base, REG_ARG_1, &vtype_value, REG_ARG_3);
+        #if NATIVE_FAST_PATHS && defined(REG_ARG_5)
+        // Note: 2 labels are reserved for this function, starting at *emit->label_slot
+        emit_native_list_item_address(emit, REG_ARG_4, REG_ARG_5, *emit->label_slot);
+        ASM_STORE_REG_REG_OFFSET(emit->as, REG_ARG_3, REG_ARG_1, 0);
+        ASM_JUMP(emit->as, *emit->label_slot + 1);
+        mp_asm_base_label_assign(&emit->as->base, *emit->label_slot);
+        #endif
         emit_call(emit, MP_F_OBJ_SUBSCR);
+        #if NATIVE_FAST_PATHS && defined(REG_ARG_5)
+        mp_asm_base_label_assign(&emit->as->base, *emit->label_slot + 1);
+        #endif
     } else {
         // viper store
         // TODO The different machine architectures have very different
@@ -1752,6 +2026,12 @@ static void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_AARCH64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_aarch64_str_reg_reg_i12(emit->as, ASM_AARCH64_SIZE_8, reg_value, reg_base, index_value);
+                            break;
+                        }
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
                         #if N_ARM
                         asm_arm_strb_reg_reg_reg(emit->as, reg_value, reg_base, reg_index);
@@ -1773,6 +2053,12 @@ static void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_AARCH64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_aarch64_str_reg_reg_i12(emit->as, ASM_AARCH64_SIZE_16, reg_value, reg_base, index_value);
+                            break;
+                        }
+                        #endif
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value << 1);
                         ASM_ADD_REG_REG(emit->as, reg_index, reg_base); // add 2*index to base
                         reg_base = reg_index;
@@ -1790,6 +2076,12 @@ static void emit_native_store_subscr(emit_t *emit) {
                             break;
                         }
                         #endif
+                        #if N_AARCH64
+                        if (index_value > 0 && index_value < 0x1000) {
+                            asm_aarch64_str_reg_reg_i12(emit->as, ASM_AARCH64_SIZE_32, reg_value, reg_base, index_value);
+                            break;
+                        }
+                        #endif
                         #if N_ARM
                         ASM_MOV_REG_IMM(emit->as, reg_index, index_value);
                         asm_arm_str_reg_reg_reg(emit->as, reg_value, reg_base, reg_index);
@@ -1835,6 +2127,10 @@ static void emit_native_store_subscr(emit_t *emit) {
                     asm_arm_strb_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
                     break;
                     #endif
+                    #if N_AARCH64
+                    asm_aarch64_str_reg_reg_reg(emit->as, ASM_AARCH64_SIZE_8, reg_value, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_STORE8_REG_REG(emit->as, reg_value, REG_ARG_1); // store value to (base+index)
                     break;
@@ -1845,6 +2141,10 @@ static void emit_native_store_subscr(emit_t *emit) {
                     asm_arm_strh_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
                     break;
                     #endif
+                    #if N_AARCH64
+                    asm_aarch64_str_reg_reg_reg(emit->as, ASM_AARCH64_SIZE_16, reg_value, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_STORE16_REG_REG(emit->as, reg_value, REG_ARG_1); // store value to (base+2*index)
@@ -1856,6 +2156,10 @@ static void emit_native_store_subscr(emit_t *emit) {
                     asm_arm_str_reg_reg_reg(emit->as, reg_value, REG_ARG_1, reg_index);
                     break;
                     #endif
+                    #if N_AARCH64
+                    asm_aarch64_str_reg_reg_reg(emit->as, ASM_AARCH64_SIZE_32, reg_value, REG_ARG_1, reg_index);
+                    break;
+                    #endif
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1968,6 +2272,7 @@ static void emit_native_jump(emit_t *emit, mp_uint_t label) {
     emit_native_pre(emit);
     // need to commit stack because we are jumping elsewhere
     need_stack_settled(emit);
+    emit_native_record_jump(emit, label);
     ASM_JUMP(emit->as, label);
     emit_post(emit);
     mp_asm_base_suppress_code(&emit->as->base);
@@ -1998,6 +2303,7 @@ static void emit_native_jump_helper(emit_t *emit, bool cond, mp_uint_t label, bo
     }
     // need to commit stack because we may jump elsewhere
     need_stack_settled(emit);
+    emit_native_record_jump(emit, label);
     // Emit the jump
     if (cond) {
         ASM_JUMP_IF_REG_NONZERO(emit->as, REG_RET, label, vtype == VTYPE_PYOBJ);
@@ -2264,22 +2570,20 @@ static void emit_native_unary_op(emit_t *emit, mp_unary_op_t op) {
         if (op == MP_UNARY_OP_POSITIVE) {
             // No-operation, just leave the argument on the stack.
         } else if (op == MP_UNARY_OP_NEGATIVE) {
-            int reg = REG_RET;
-            emit_pre_pop_reg_flexible(emit, &vtype, &reg, reg, reg);
-            ASM_NEG_REG(emit->as, reg);
-            emit_post_push_reg(emit, vtype, reg);
+            // The operand may be a local held in a register, so it can't be
+            // modified in place: always work on a copy in REG_RET.
+            emit_pre_pop_reg(emit, &vtype, REG_RET);
+            ASM_NEG_REG(emit->as, REG_RET);
+            emit_post_push_reg(emit, vtype, REG_RET);
         } else if (op == MP_UNARY_OP_INVERT) {
+            emit_pre_pop_reg(emit, &vtype, REG_RET);
             #ifdef ASM_NOT_REG
-            int reg = REG_RET;
-            emit_pre_pop_reg_flexible(emit, &vtype, &reg, reg, reg);
-            ASM_NOT_REG(emit->as, reg);
+            ASM_NOT_REG(emit->as, REG_RET);
             #else
-            int reg = REG_RET;
-            emit_pre_pop_reg_flexible(emit, &vtype, &reg, REG_ARG_1, reg);
             ASM_MOV_REG_IMM(emit->as, REG_ARG_1, -1);
-            ASM_XOR_REG_REG(emit->as, reg, REG_ARG_1);
+            ASM_XOR_REG_REG(emit->as, REG_RET, REG_ARG_1);
             #endif
-            emit_post_push_reg(emit, vtype, reg);
+            emit_post_push_reg(emit, vtype, REG_RET);
         } else {
             EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                 MP_ERROR_TEXT("'not' not implemented"), mp_binary_op_method_name[op]);
@@ -2294,6 +2598,264 @@ static void emit_native_unary_op(emit_t *emit, mp_unary_op_t op) {
     }
 }
 
+// Set REG_RET to 1 if the comparison selected by op_idx (see ops tables below)
+// holds between reg_lhs and reg_rhs, else to 0.  REG_RET must not be an operand.
+static void emit_native_setcc_reg_reg(emit_t *emit, size_t op_idx, int reg_lhs, int reg_rhs) {
+    #if N_X64
+    asm_x64_xor_r64_r64(emit->as, REG_RET, REG_RET);
+    asm_x64_cmp_r64_with_r64(emit->as, reg_rhs, reg_lhs);
+    static byte ops[6 + 6] = {
+        // unsigned
+        ASM_X64_CC_JB,
+        ASM_X64_CC_JA,
+        ASM_X64_CC_JE,
+        ASM_X64_CC_JBE,
+        ASM_X64_CC_JAE,
+        ASM_X64_CC_JNE,
+        // signed
+        ASM_X64_CC_JL,
+        ASM_X64_CC_JG,
+        ASM_X64_CC_JE,
+        ASM_X64_CC_JLE,
+        ASM_X64_CC_JGE,
+        ASM_X64_CC_JNE,
+    };
+    asm_x64_setcc_r8(emit->as, ops[op_idx], REG_RET);
+    #elif N_X86
+    asm_x86_xor_r32_r32(emit->as, REG_RET, REG_RET);
+    asm_x86_cmp_r32_with_r32(emit->as, reg_rhs, reg_lhs);
+    static byte ops[6 + 6] = {
+        // unsigned
+        ASM_X86_CC_JB,
+        ASM_X86_CC_JA,
+        ASM_X86_CC_JE,
+        ASM_X86_CC_JBE,
+        ASM_X86_CC_JAE,
+        ASM_X86_CC_JNE,
+        // signed
+        ASM_X86_CC_JL,
+        ASM_X86_CC_JG,
+        ASM_X86_CC_JE,
+        ASM_X86_CC_JLE,
+        ASM_X86_CC_JGE,
+        ASM_X86_CC_JNE,
+    };
+    asm_x86_setcc_r8(emit->as, ops[op_idx], REG_RET);
+    #elif N_THUMB
+    asm_thumb_cmp_rlo_rlo(emit->as, reg_lhs, reg_rhs);
+    if (asm_thumb_allow_armv7m(emit->as)) {
+        static uint16_t ops[6 + 6] = {
+            // unsigned
+            ASM_THUMB_OP_ITE_CC,
+            ASM_THUMB_OP_ITE_HI,
+            ASM_THUMB_OP_ITE_EQ,
+            ASM_THUMB_OP_ITE_LS,
+            ASM_THUMB_OP_ITE_CS,
+            ASM_THUMB_OP_ITE_NE,
+            // signed
+            ASM_THUMB_OP_ITE_LT,
+            ASM_THUMB_OP_ITE_GT,
+            ASM_THUMB_OP_ITE_EQ,
+            ASM_THUMB_OP_ITE_LE,
+            ASM_THUMB_OP_ITE_GE,
+            ASM_THUMB_OP_ITE_NE,
+        };
+        asm_thumb_op16(emit->as, ops[op_idx]);
+        asm_thumb_mov_rlo_i8(emit->as, REG_RET, 1);
+        asm_thumb_mov_rlo_i8(emit->as, REG_RET, 0);
+    } else {
+        static uint16_t ops[6 + 6] = {
+            // unsigned
+            ASM_THUMB_CC_CC,
+            ASM_THUMB_CC_HI,
+            ASM_THUMB_CC_EQ,
+            ASM_THUMB_CC_LS,
+            ASM_THUMB_CC_CS,
+            ASM_THUMB_CC_NE,
+            // signed
+            ASM_THUMB_CC_LT,
+            ASM_THUMB_CC_GT,
+            ASM_THUMB_CC_EQ,
+            ASM_THUMB_CC_LE,
+            ASM_THUMB_CC_GE,
+            ASM_THUMB_CC_NE,
+        };
+        asm_thumb_bcc_rel9(emit->as, ops[op_idx], 6);
+        asm_thumb_mov_rlo_i8(emit->as, REG_RET, 0);
+        asm_thumb_b_rel12(emit->as, 4);
+        asm_thumb_mov_rlo_i8(emit->as, REG_RET, 1);
+    }
+    #elif N_ARM
+    asm_arm_cmp_reg_reg(emit->as, reg_lhs, reg_rhs);
+    static uint ccs[6 + 6] = {
+        // unsigned
+        ASM_ARM_CC_CC,
+        ASM_ARM_CC_HI,
+        ASM_ARM_CC_EQ,
+        ASM_ARM_CC_LS,
+        ASM_ARM_CC_CS,
+        ASM_ARM_CC_NE,
+        // signed
+        ASM_ARM_CC_LT,
+        ASM_ARM_CC_GT,
+        ASM_ARM_CC_EQ,
+        ASM_ARM_CC_LE,
+        ASM_ARM_CC_GE,
+        ASM_ARM_CC_NE,
+    };
+    asm_arm_setcc_reg(emit->as, REG_RET, ccs[op_idx]);
+    #elif N_XTENSA || N_XTENSAWIN
+    static uint8_t ccs[6 + 6] = {
+        // unsigned
+        ASM_XTENSA_CC_LTU,
+        0x80 | ASM_XTENSA_CC_LTU, // for GTU we'll swap args
+        ASM_XTENSA_CC_EQ,
+        0x80 | ASM_XTENSA_CC_GEU, // for LEU we'll swap args
+        ASM_XTENSA_CC_GEU,
+        ASM_XTENSA_CC_NE,
+        // signed
+        ASM_XTENSA_CC_LT,
+        0x80 | ASM_XTENSA_CC_LT, // for GT we'll swap args
+        ASM_XTENSA_CC_EQ,
+        0x80 | ASM_XTENSA_CC_GE, // for LE we'll swap args
+        ASM_XTENSA_CC_GE,
+        ASM_XTENSA_CC_NE,
+    };
+    uint8_t cc = ccs[op_idx];
+    if ((cc & 0x80) == 0) {
+        asm_xtensa_setcc_reg_reg_reg(emit->as, cc, REG_RET, reg_lhs, reg_rhs);
+    } else {
+        asm_xtensa_setcc_reg_reg_reg(emit->as, cc & ~0x80, REG_RET, reg_rhs, reg_lhs);
+    }
+    #elif N_RV32
+    static uint8_t ccs[6 + 6] = {
+        // unsigned
+        ASM_RV32_CC_LTU,
+        0x80 | ASM_RV32_CC_LTU, // for GTU we'll swap args
+        ASM_RV32_CC_EQ,
+        0x80 | ASM_RV32_CC_GEU, // for LEU we'll swap args
+        ASM_RV32_CC_GEU,
+        ASM_RV32_CC_NE,
+        // signed
+        ASM_RV32_CC_LT,
+        0x80 | ASM_RV32_CC_LT, // for GT we'll swap args
+        ASM_RV32_CC_EQ,
+        0x80 | ASM_RV32_CC_GE, // for LE we'll swap args
+        ASM_RV32_CC_GE,
+        ASM_RV32_CC_NE,
+    };
+    uint8_t cc = ccs[op_idx];
+    if ((cc & 0x80) == 0) {
+        asm_rv32_setcc_reg_reg_reg(emit->as, cc, REG_RET, reg_lhs, reg_rhs);
+    } else {
+        asm_rv32_setcc_reg_reg_reg(emit->as, cc & ~0x80, REG_RET, reg_rhs, reg_lhs);
+    }
+    #elif N_AARCH64
+    asm_aarch64_cmp_reg_reg(emit->as, reg_lhs, reg_rhs);
+    static uint8_t ccs[6 + 6] = {
+        // unsigned
+        ASM_AARCH64_CC_LO,
+        ASM_AARCH64_CC_HI,
+        ASM_AARCH64_CC_EQ,
+        ASM_AARCH64_CC_LS,
+        ASM_AARCH64_CC_HS,
+        ASM_AARCH64_CC_NE,
+        // signed
+        ASM_AARCH64_CC_LT,
+        ASM_AARCH64_CC_GT,
+        ASM_AARCH64_CC_EQ,
+        ASM_AARCH64_CC_LE,
+        ASM_AARCH64_CC_GE,
+        ASM_AARCH64_CC_NE,
+    };
+    asm_aarch64_cset(emit->as, REG_RET, ccs[op_idx]);
+    #else
+    #error not implemented
+    #endif
+}
+
+#if NATIVE_FAST_PATHS
+
+// Emit an inline fast path for a binary op between two small ints, with the
+// lhs in REG_ARG_2 and the rhs in REG_ARG_3.  The fast path leaves its result
+// in REG_RET and continues at label + 1.  If either operand is not a small int,
+// or the result overflows, execution continues at label with both operands
+// intact, where the caller must emit the generic runtime call.  Returns false
+// (and emits nothing) if op has no fast path.
+static bool emit_native_binary_op_small_int(emit_t *emit, mp_binary_op_t op, mp_uint_t label) {
+    // for small ints, inplace and normal ops are equivalent
+    if (MP_BINARY_OP_INPLACE_OR <= op && op <= MP_BINARY_OP_INPLACE_POWER) {
+        op += MP_BINARY_OP_OR - MP_BINARY_OP_INPLACE_OR;
+    }
+    if (!(op == MP_BINARY_OP_OR
+          || op == MP_BINARY_OP_XOR
+          || op == MP_BINARY_OP_AND
+          || op == MP_BINARY_OP_ADD
+          || op == MP_BINARY_OP_SUBTRACT
+          || (MP_BINARY_OP_LESS <= op && op <= MP_BINARY_OP_NOT_EQUAL))) {
+        return false;
+    }
+
+    // both paths must leave the Python stack in the same state
+    need_reg_all(emit);
+
+    // check that both operands are small ints, leaving 1 in REG_ARG_4
+    ASM_MOV_REG_IMM(emit->as, REG_ARG_4, 1);
+    ASM_AND_REG_REG(emit->as, REG_ARG_4, REG_ARG_2);
+    ASM_AND_REG_REG(emit->as, REG_ARG_4, REG_ARG_3);
+    ASM_JUMP_IF_REG_ZERO(emit->as, REG_ARG_4, label, true);
+
+    // operate directly on the tagged values, 2 * a + 1 and 2 * b + 1
+    if (op == MP_BINARY_OP_OR) {
+        ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_2);
+        ASM_OR_REG_REG(emit->as, REG_RET, REG_ARG_3);
+    } else if (op == MP_BINARY_OP_XOR) {
+        ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_2);
+        ASM_XOR_REG_REG(emit->as, REG_RET, REG_ARG_3);
+        ASM_XOR_REG_REG(emit->as, REG_RET, REG_ARG_4);
+    } else if (op == MP_BINARY_OP_AND) {
+        ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_2);
+        ASM_AND_REG_REG(emit->as, REG_RET, REG_ARG_3);
+    } else if (op == MP_BINARY_OP_ADD) {
+        // res = lhs + (rhs ^ 1), which overflows iff (lhs ^ res) & (rhs ^ res) < 0
+        ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_3);
+        ASM_XOR_REG_REG(emit->as, REG_RET, REG_ARG_4);
+        ASM_ADD_REG_REG(emit->as, REG_RET, REG_ARG_2);
+        ASM_MOV_REG_REG(emit->as, REG_ARG_4, REG_ARG_2);
+        ASM_XOR_REG_REG(emit->as, REG_ARG_4, REG_RET);
+        ASM_XOR_REG_REG(emit->as, REG_ARG_3, REG_RET);
+        ASM_AND_REG_REG(emit->as, REG_ARG_4, REG_ARG_3);
+        ASM_XOR_REG_REG(emit->as, REG_ARG_3, REG_RET);
+        emit_native_jump_if_reg_negative(emit, REG_ARG_4, label);
+    } else if (op == MP_BINARY_OP_SUBTRACT) {
+        // res = (lhs - rhs) ^ 1, which overflows iff (lhs ^ rhs) & (lhs ^ res) < 0
+        ASM_MOV_REG_REG(emit->as, REG_RET, REG_ARG_2);
+        ASM_SUB_REG_REG(emit->as, REG_RET, REG_ARG_3);
+        ASM_XOR_REG_REG(emit->as, REG_RET, REG_ARG_4);
+        ASM_MOV_REG_REG(emit->as, REG_ARG_4, REG_ARG_2);
+        ASM_XOR_REG_REG(emit->as, REG_ARG_4, REG_RET);
+        ASM_XOR_REG_REG(emit->as, REG_ARG_3, REG_ARG_2);
+        ASM_AND_REG_REG(emit->as, REG_ARG_4, REG_ARG_3);
+        ASM_XOR_REG_REG(emit->as, REG_ARG_3, REG_ARG_2);
+        emit_native_jump_if_reg_negative(emit, REG_ARG_4, label);
+    } else {
+        // tagging preserves the signed order of small ints; the 0/1 result
+        // then indexes the mp_const_false/mp_const_true entries of the table
+        emit_native_setcc_reg_reg(emit, op - MP_BINARY_OP_LESS + 6, REG_ARG_2, REG_ARG_3);
+        for (int i = 1; i < ASM_WORD_SIZE; i <<= 1) {
+            ASM_ADD_REG_REG(emit->as, REG_RET, REG_RET);
+        }
+        ASM_ADD_REG_REG(emit->as, REG_RET, REG_FUN_TABLE);
+        ASM_LOAD_REG_REG_OFFSET(emit->as, REG_RET, REG_RET, MP_F_CONST_FALSE_OBJ);
+    }
+
+    ASM_JUMP(emit->as, label + 1);
+    mp_asm_base_label_assign(&emit->as->base, label);
+    return true;
+}
+
+#endif
+
 static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
     DEBUG_printf("binary_op(" UINT_FMT ")\n", op);
     vtype_kind_t vtype_lhs = peek_vtype(emit, 1);
@@ -2396,135 +2958,7 @@ static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
             size_t op_idx = op - MP_BINARY_OP_LESS + (vtype_lhs == VTYPE_UINT ? 0 : 6);
 
             need_reg_single(emit, REG_RET, 0);
-            #if N_X64
-            asm_x64_xor_r64_r64(emit->as, REG_RET, REG_RET);
-            asm_x64_cmp_r64_with_r64(emit->as, reg_rhs, REG_ARG_2);
-            static byte ops[6 + 6] = {
-                // unsigned
-                ASM_X64_CC_JB,
-                ASM_X64_CC_JA,
-                ASM_X64_CC_JE,
-                ASM_X64_CC_JBE,
-                ASM_X64_CC_JAE,
-                ASM_X64_CC_JNE,
-                // signed
-                ASM_X64_CC_JL,
-                ASM_X64_CC_JG,
-                ASM_X64_CC_JE,
-                ASM_X64_CC_JLE,
-                ASM_X64_CC_JGE,
-                ASM_X64_CC_JNE,
-            };
-            asm_x64_setcc_r8(emit->as, ops[op_idx], REG_RET);
-            #elif N_X86
-            asm_x86_xor_r32_r32(emit->as, REG_RET, REG_RET);
-            asm_x86_cmp_r32_with_r32(emit->as, reg_rhs, REG_ARG_2);
-            static byte ops[6 + 6] = {
-                // unsigned
-                ASM_X86_CC_JB,
-                ASM_X86_CC_JA,
-                ASM_X86_CC_JE,
-                ASM_X86_CC_JBE,
-                ASM_X86_CC_JAE,
-                ASM_X86_CC_JNE,
-                // signed
-                ASM_X86_CC_JL,
-                ASM_X86_CC_JG,
-                ASM_X86_CC_JE,
-                ASM_X86_CC_JLE,
-                ASM_X86_CC_JGE,
-                ASM_X86_CC_JNE,
-            };
-            asm_x86_setcc_r8(emit->as, ops[op_idx], REG_RET);
-            #elif N_THUMB
-            asm_thumb_cmp_rlo_rlo(emit->as, REG_ARG_2, reg_rhs);
-            if (asm_thumb_allow_armv7m(emit->as)) {
-                static uint16_t ops[6 + 6] = {
-                    // unsigned
-                    ASM_THUMB_OP_ITE_CC,
-                    ASM_THUMB_OP_ITE_HI,
-                    ASM_THUMB_OP_ITE_EQ,
-                    ASM_THUMB_OP_ITE_LS,
-                    ASM_THUMB_OP_ITE_CS,
-                    ASM_THUMB_OP_ITE_NE,
-                    // signed
-                    ASM_THUMB_OP_ITE_LT,
-                    ASM_THUMB_OP_ITE_GT,
-                    ASM_THUMB_OP_ITE_EQ,
-                    ASM_THUMB_OP_ITE_LE,
-                    ASM_THUMB_OP_ITE_GE,
-                    ASM_THUMB_OP_ITE_NE,
-                };
-                asm_thumb_op16(emit->as, ops[op_idx]);
-                asm_thumb_mov_rlo_i8(emit->as, REG_RET, 1);
-                asm_thumb_mov_rlo_i8(emit->as, REG_RET, 0);
-            } else {
-                static uint16_t ops[6 + 6] = {
-                    // unsigned
-                    ASM_THUMB_CC_CC,
-                    ASM_THUMB_CC_HI,
-                    ASM_THUMB_CC_EQ,
-                    ASM_THUMB_CC_LS,
-                    ASM_THUMB_CC_CS,
-                    ASM_THUMB_CC_NE,
-                    // signed
-                    ASM_THUMB_CC_LT,
-                    ASM_THUMB_CC_GT,
-                    ASM_THUMB_CC_EQ,
-                    ASM_THUMB_CC_LE,
-                    ASM_THUMB_CC_GE,
-                    ASM_THUMB_CC_NE,
-                };
-                asm_thumb_bcc_rel9(emit->as, ops[op_idx], 6);
-                asm_thumb_mov_rlo_i8(emit->as, REG_RET, 0);
-                asm_thumb_b_rel12(emit->as, 4);
-                asm_thumb_mov_rlo_i8(emit->as, REG_RET, 1);
-            }
-            #elif N_ARM
-            asm_arm_cmp_reg_reg(emit->as, REG_ARG_2, reg_rhs);
-            static uint ccs[6 + 6] = {
-                // unsigned
-                ASM_ARM_CC_CC,
-                ASM_ARM_CC_HI,
-                ASM_ARM_CC_EQ,
-                ASM_ARM_CC_LS,
-                ASM_ARM_CC_CS,
-                ASM_ARM_CC_NE,
-                // signed
-                ASM_ARM_CC_LT,
-                ASM_ARM_CC_GT,
-                ASM_ARM_CC_EQ,
-                ASM_ARM_CC_LE,
-                ASM_ARM_CC_GE,
-                ASM_ARM_CC_NE,
-            };
-            asm_arm_setcc_reg(emit->as, REG_RET, ccs[op_idx]);
-            #elif N_XTENSA || N_XTENSAWIN
-            static uint8_t ccs[6 + 6] = {
-                // unsigned
-                ASM_XTENSA_CC_LTU,
-                0x80 | ASM_XTENSA_CC_LTU, // for GTU we'll swap args
-                ASM_XTENSA_CC_EQ,
-                0x80 | ASM_XTENSA_CC_GEU, // for LEU we'll swap args
-                ASM_XTENSA_CC_GEU,
-                ASM_XTENSA_CC_NE,
-                // signed
-                ASM_XTENSA_CC_LT,
-                0x80 | ASM_XTENSA_CC_LT, // for GT we'll swap args
-                ASM_XTENSA_CC_EQ,
-                0x80 | ASM_XTENSA_CC_GE, // for LE we'll swap args
-                ASM_XTENSA_CC_GE,
-                ASM_XTENSA_CC_NE,
-            };
-            uint8_t cc = ccs[op_idx];
-            if ((cc & 0x80) == 0) {
-                asm_xtensa_setcc_reg_reg_reg(emit->as, cc, REG_RET, REG_ARG_2, reg_rhs);
-            } else {
-                asm_xtensa_setcc_reg_reg_reg(emit->as, cc & ~0x80, REG_RET, reg_rhs, REG_ARG_2);
-            }
-            #else
-            #error not implemented
-            #endif
+            emit_native_setcc_reg_reg(emit, op_idx, REG_ARG_2, reg_rhs);
             emit_post_push_reg(emit, VTYPE_BOOL, REG_RET);
         } else {
             // TODO other ops not yet implemented
@@ -2534,6 +2968,10 @@ static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
         }
     } else if (vtype_lhs == VTYPE_PYOBJ && vtype_rhs == VTYPE_PYOBJ) {
         emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_3, &vtype_lhs, REG_ARG_2);
+        #if NATIVE_FAST_PATHS
+        // Note: 2 labels are reserved for this function, starting at *emit->label_slot
+        bool fast_path = emit_native_binary_op_small_int(emit, op, *emit->label_slot);
+        #endif
         bool invert = false;
         if (op == MP_BINARY_OP_NOT_IN) {
             invert = true;
@@ -2547,6 +2985,11 @@ static void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
             ASM_MOV_REG_REG(emit->as, REG_ARG_2, REG_RET);
             emit_call_with_imm_arg(emit, MP_F_UNARY_OP, MP_UNARY_OP_NOT, REG_ARG_1);
         }
+        #if NATIVE_FAST_PATHS
+        if (fast_path) {
+            mp_asm_base_label_assign(&emit->as->base, *emit->label_slot + 1);
+        }
+        #endif
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
     } else {
         adjust_stack(emit, -1);
@@ -0,0 +1,21 @@
+// RISC-V RV32 specific stuff
+
+#include "py/mpconfig.h"
+
+#if MICROPY_EMIT_RV32
+
+// this is defined so that the assembler exports generic assembler API macros
+#define GENERIC_ASM_API (1)
+#include "py/asmrv32.h"
+
+// Word indices of REG_LOCAL_x in nlr_buf_t
+// RISC-V has no native NLR so it always uses setjmp, and the jmp_buf layout
+// of both newlib and glibc is: ra, s0-s11, sp.
+#define NLR_BUF_IDX_LOCAL_1 (2 + 1) // s0
+
+#define N_NLR_SETJMP (1)
+#define N_RV32 (1)
+#define EXPORT_FUN(name) emit_native_rv32_##name
+#include "py/emitnative.c"
+
+#endif
@@ -120,6 +120,16 @@
 #define GC_EXIT()
 #endif
 
+#if MICROPY_GC_POOL
+// Forget the current thread's allocation pools.  Nothing else refers to the
+// pooled chunks, so the next collection will return them to the heap.
+static void gc_pool_drain(void) {
+    for (size_t i = 0; i < MICROPY_GC_POOL_MAX_BLOCKS; ++i) {
+        MP_STATE_THREAD(gc_pool)[i] = NULL;
+    }
+}
+#endif
+
 // TODO waste less memory; currently requires that all entries in alloc_table have a corresponding block in pool
 static void gc_setup_area(mp_state_mem_area_t *area, void *start, void *end) {
     // calculate parameters for GC (T=total, A=alloc table, F=finaliser table, P=pool; all in bytes):
@@ -201,6 +211,12 @@ void gc_init(void *start, void *end) {
     // unlock the GC
     MP_STATE_THREAD(gc_lock_depth) = 0;
 
+    #if MICROPY_GC_POOL
+    gc_pool_drain();
+    MP_STATE_MEM(gc_pool_hits) = 0;
+    MP_STATE_MEM(gc_pool_misses) = 0;
+    #endif
+
     // allow auto collection
     MP_STATE_MEM(gc_auto_collect_enabled) = 1;
 
@@ -565,6 +581,11 @@ static void gc_sweep(void) {
 void gc_collect_start(void) {
     GC_ENTER();
     MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_POOL
+    // Drain this thread's pools before tracing so the sweep frees them.
+    // Pools of other threads are traced via their state and kept.
+    gc_pool_drain();
+    #endif
     #if MICROPY_GC_ALLOC_THRESHOLD
     MP_STATE_MEM(gc_alloc_amount) = 0;
     #endif
@@ -646,6 +667,9 @@ void gc_collect_end(void) {
 void gc_sweep_all(void) {
     GC_ENTER();
     MP_STATE_THREAD(gc_lock_depth)++;
+    #if MICROPY_GC_POOL
+    gc_pool_drain();
+    #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
     gc_collect_end();
 }
@@ -720,8 +744,87 @@ void gc_info(gc_info_t *info) {
     info->max_new_split = gc_get_max_new_split();
     #endif
 
+    #if MICROPY_GC_POOL
+    info->pool_hits = MP_STATE_MEM(gc_pool_hits);
+    info->pool_misses = MP_STATE_MEM(gc_pool_misses);
+    #endif
+
+    GC_EXIT();
+}
+
+#if MICROPY_GC_POOL
+// Allocate up to MICROPY_GC_POOL_BATCH chunks of n_blocks blocks in a single
+// pass over the allocation table, holding the GC lock once.  The chunks are
+// zeroed and chained through their first word, and the head is returned (or
+// NULL if nothing could be allocated without a collection).
+static void *gc_pool_refill(size_t n_blocks) {
+    void *head = NULL;
+    void **tail = &head;
+    size_t n_alloc = 0;
+
+    GC_ENTER();
+
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    if (MP_STATE_MEM(gc_auto_collect_enabled) && MP_STATE_MEM(gc_alloc_amount) >= MP_STATE_MEM(gc_alloc_threshold)) {
+        // let gc_alloc run the collection
+        GC_EXIT();
+        return NULL;
+    }
+    #endif
+
+    #if MICROPY_GC_SPLIT_HEAP
+    mp_state_mem_area_t *area = MP_STATE_MEM(gc_last_free_area);
+    #else
+    mp_state_mem_area_t *area = &MP_STATE_MEM(area);
+    #endif
+    for (; area != NULL && n_alloc < MICROPY_GC_POOL_BATCH; area = NEXT_AREA(area)) {
+        size_t n_free = 0;
+        size_t block_end = area->gc_alloc_table_byte_len * BLOCKS_PER_ATB;
+        for (size_t block = area->gc_last_free_atb_index * BLOCKS_PER_ATB; block < block_end; block++) {
+            MICROPY_GC_HOOK_LOOP(block);
+            if (ATB_GET_KIND(area, block) != AT_FREE) {
+                n_free = 0;
+                continue;
+            }
+            if (++n_free < n_blocks) {
+                continue;
+            }
+
+            // found a free chunk ending at this block, so claim it
+            size_t start_block = block - n_free + 1;
+            n_free = 0;
+            ATB_FREE_TO_HEAD(area, start_block);
+            for (size_t bl = start_block + 1; bl <= block; bl++) {
+                ATB_FREE_TO_TAIL(area, bl);
+            }
+            if (n_blocks == 1) {
+                // as in gc_alloc, there are no free blocks before this one
+                #if MICROPY_GC_SPLIT_HEAP
+                MP_STATE_MEM(gc_last_free_area) = area;
+                #endif
+                area->gc_last_free_atb_index = (block + 1) / BLOCKS_PER_ATB;
+            }
+            area->gc_last_used_block = MAX(area->gc_last_used_block, block);
+
+            void *ptr = (void *)(area->gc_pool_start + start_block * BYTES_PER_BLOCK);
+            memset(ptr, 0, n_blocks * BYTES_PER_BLOCK);
+            *tail = ptr;
+            tail = (void **)ptr;
+            if (++n_alloc == MICROPY_GC_POOL_BATCH) {
+                break;
+            }
+        }
+    }
+
+    #if MICROPY_GC_ALLOC_THRESHOLD
+    MP_STATE_MEM(gc_alloc_amount) += n_alloc * n_blocks;
+    #endif
+
     GC_EXIT();
+
+    return head;
 }
+#endif
 
 void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
     bool has_finaliser = alloc_flags & GC_ALLOC_FLAG_HAS_FINALISER;
@@ -738,6 +841,27 @@ void *gc_alloc(size_t n_bytes, unsigned int alloc_flags) {
         return NULL;
     }
 
+    #if MICROPY_GC_POOL
+    if (n_blocks <= MICROPY_GC_POOL_MAX_BLOCKS && !has_finaliser) {
+        void **pool = &MP_STATE_THREAD(gc_pool)[n_blocks - 1];
+        if (*pool != NULL) {
+            ++MP_STATE_MEM(gc_pool_hits);
+        } else {
+            ++MP_STATE_MEM(gc_pool_misses);
+            *pool = gc_pool_refill(n_blocks);
+        }
+        void *ret_ptr = *pool;
+        if (ret_ptr != NULL) {
+            // pop the chunk, clearing the link so it's all zero
+            *pool = *(void **)ret_ptr;
+            *(void **)ret_ptr = NULL;
+            DEBUG_printf("gc_alloc(%p) from pool\n", ret_ptr);
+            return ret_ptr;
+        }
+        // fall through to allocate, collecting if needed
+    }
+    #endif
+
     GC_ENTER();
 
     mp_state_mem_area_t *area;
@@ -927,6 +1051,25 @@ void gc_free(void *ptr) {
     FTB_CLEAR(area, block);
     #endif
 
+    #if MICROPY_GC_POOL
+    // Small chunks go back to this thread's pool instead of the heap.  Apart
+    // from making reuse cheap, this keeps the free-block search from being
+    // rewound to chunks that a pool handed out long ago.
+    size_t n_blocks = 1;
+    while (n_blocks <= MICROPY_GC_POOL_MAX_BLOCKS && ATB_GET_KIND(area, block + n_blocks) == AT_TAIL) {
+        n_blocks++;
+    }
+    if (n_blocks <= MICROPY_GC_POOL_MAX_BLOCKS) {
+        // push while still holding the lock, so a collection can't free it
+        void **pool = &MP_STATE_THREAD(gc_pool)[n_blocks - 1];
+        memset(ptr, 0, n_blocks * BYTES_PER_BLOCK);
+        *(void **)ptr = *pool;
+        *pool = ptr;
+        GC_EXIT();
+        return;
+    }
+    #endif
+
     #if MICROPY_GC_SPLIT_HEAP
     if (MP_STATE_MEM(gc_last_free_area) != area) {
         // We freed something but it isn't the current area. Reset the
@@ -1180,8 +1323,12 @@ void gc_dump_info(const mp_print_t *print) {
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     mp_printf(print, ", max new split: %u", (uint)info.max_new_split);
     #endif
-    mp_printf(print, "\n No. of 1-blocks: %u, 2-blocks: %u, max blk sz: %u, max free sz: %u\n",
+    mp_printf(print, "\n No. of 1-blocks: %u, 2-blocks: %u, max blk sz: %u, max free sz: %u",
         (uint)info.num_1block, (uint)info.num_2block, (uint)info.max_block, (uint)info.max_free);
+    #if MICROPY_GC_POOL
+    mp_printf(print, ", pool hits: %u, misses: %u", (uint)info.pool_hits, (uint)info.pool_misses);
+    #endif
+    mp_printf(print, "\n");
 }
 
 void gc_dump_alloc_table(const mp_print_t *print) {
@@ -78,6 +78,10 @@ typedef struct _gc_info_t {
     #if MICROPY_GC_SPLIT_HEAP_AUTO
     size_t max_new_split;
     #endif
+    #if MICROPY_GC_POOL
+    size_t pool_hits;
+    size_t pool_misses;
+    #endif
 } gc_info_t;
 
 void gc_info(gc_info_t *info);
@@ -172,6 +172,9 @@ static void next_char(mp_lexer_t *lex) {
     #endif
     {
         lex->chr2 = lex->reader.readbyte(lex->reader.data);
+        #if MICROPY_EMIT_NATIVE_TIERING
+        lex->source_hash = (lex->source_hash * 33) ^ lex->chr2;
+        #endif
     }
 
     if (lex->chr1 == '\r') {
@@ -863,6 +866,9 @@ mp_lexer_t *mp_lexer_new(qstr src_name, mp_reader_t reader) {
     // load lexer with start of file, advancing lex->column to 1
     // start with dummy bytes and use next_char() for proper EOL/EOF handling
     lex->chr0 = lex->chr1 = lex->chr2 = 0;
+    #if MICROPY_EMIT_NATIVE_TIERING
+    lex->source_hash = 5381;
+    #endif
     next_char(lex);
     next_char(lex);
     next_char(lex);
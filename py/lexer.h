@@ -184,6 +184,9 @@ typedef struct _mp_lexer_t {
     vstr_t fstring_args;        // extracted arguments to pass to .format()
     size_t fstring_args_idx;    // how many bytes of fstring_args have been read
     #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    uint32_t source_hash;       // hash of the source read so far
+    #endif
 } mp_lexer_t;
 
 mp_lexer_t *mp_lexer_new(qstr src_name, mp_reader_t reader);
@@ -61,6 +61,15 @@
 #define MAP_CACHE_SET(index, pos)
 #endif
 
+// Called when a key is added to or removed from the map.  If it's a module
+// namespace then a global name may now resolve differently (see mp_load_global).
+#define MAP_KEYS_CHANGED(map) \
+    do { \
+        if ((map)->is_versioned) { \
+            MP_STATE_VM(namespace_keys_version) += 1; \
+        } \
+    } while (0)
+
 // This table of sizes is used to control the growth of hash tables.
 // The first set of sizes are chosen so the allocation fits exactly in a
 // 4-word GC block, and it's not so important for these small values to be
@@ -98,6 +107,8 @@ void mp_map_init(mp_map_t *map, size_t n) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 0;
     map->is_ordered = 0;
+    map->is_versioned = 0;
+    map->is_lazy = 0;
 }
 
 void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
@@ -106,6 +117,8 @@ void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
     map->all_keys_are_qstrs = 1;
     map->is_fixed = 1;
     map->is_ordered = 1;
+    map->is_versioned = 0;
+    map->is_lazy = 0;
     map->table = (mp_map_elem_t *)table;
 }
 
@@ -118,6 +131,10 @@ void mp_map_deinit(mp_map_t *map) {
 }
 
 void mp_map_clear(mp_map_t *map) {
+    if (map->is_versioned) {
+        MP_STATE_VM(namespace_version) += 1;
+        MP_STATE_VM(namespace_keys_version) += 1;
+    }
     if (!map->is_fixed) {
         m_del(mp_map_elem_t, map->table, map->alloc);
     }
@@ -128,9 +145,8 @@ void mp_map_clear(mp_map_t *map) {
     map->table = NULL;
 }
 
-static void mp_map_rehash(mp_map_t *map) {
+static void mp_map_rehash(mp_map_t *map, size_t new_alloc) {
     size_t old_alloc = map->alloc;
-    size_t new_alloc = get_hash_alloc_greater_or_equal_to(map->alloc + 1);
     DEBUG_printf("mp_map_rehash(%p): " UINT_FMT " -> " UINT_FMT "\n", map, old_alloc, new_alloc);
     mp_map_elem_t *old_table = map->table;
     mp_map_elem_t *new_table = m_new0(mp_map_elem_t, new_alloc);
@@ -147,6 +163,14 @@ static void mp_map_rehash(mp_map_t *map) {
     m_del(mp_map_elem_t, old_table, old_alloc);
 }
 
+// Grow the table so that at least n elements fit without a rehash.
+void mp_map_reserve(mp_map_t *map, size_t n) {
+    assert(!map->is_fixed && !map->is_ordered);
+    if (n > map->alloc) {
+        mp_map_rehash(map, get_hash_alloc_greater_or_equal_to(n));
+    }
+}
+
 // MP_MAP_LOOKUP behaviour:
 //  - returns NULL if not found, else the slot it was found in with key,value non-null
 // MP_MAP_LOOKUP_ADD_IF_NOT_FOUND behaviour:
@@ -157,6 +181,12 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
     // If the map is a fixed array then we must only be called for a lookup
     assert(!map->is_fixed || lookup_kind == MP_MAP_LOOKUP);
 
+    // Adding or removing may be followed by a store to the value, so if this
+    // is a module namespace then any loads cached from it are now stale.
+    if (lookup_kind != MP_MAP_LOOKUP && map->is_versioned) {
+        MP_STATE_VM(namespace_version) += 1;
+    }
+
     #if MICROPY_OPT_MAP_LOOKUP_CACHE
     // Try the cache for lookup or add-if-not-found.
     if (lookup_kind != MP_MAP_LOOKUP_REMOVE_IF_FOUND && map->alloc) {
@@ -197,6 +227,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                     // remove the found element by moving the rest of the array down
                     mp_obj_t value = elem->value;
                     --map->used;
+                    MAP_KEYS_CHANGED(map);
                     memmove(elem, elem + 1, (top - elem - 1) * sizeof(*elem));
                     // put the found element after the end so the caller can access it if needed
                     // note: caller must NULL the value so the GC can clean up (e.g. see dict_get_helper).
@@ -220,6 +251,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
             mp_seq_clear(map->table, map->used, map->alloc, sizeof(*map->table));
         }
         mp_map_elem_t *elem = map->table + map->used++;
+        MAP_KEYS_CHANGED(map);
         elem->key = index;
         elem->value = MP_OBJ_NULL;
         if (!mp_obj_is_qstr(index)) {
@@ -235,7 +267,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
 
     if (map->alloc == 0) {
         if (lookup_kind == MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
-            mp_map_rehash(map);
+            mp_map_rehash(map, get_hash_alloc_greater_or_equal_to(map->alloc + 1));
         } else {
             return NULL;
         }
@@ -258,6 +290,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
             // found NULL slot, so index is not in table
             if (lookup_kind == MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
                 map->used += 1;
+                MAP_KEYS_CHANGED(map);
                 if (avail_slot == NULL) {
                     avail_slot = slot;
                 }
@@ -281,6 +314,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
             if (lookup_kind == MP_MAP_LOOKUP_REMOVE_IF_FOUND) {
                 // delete element in this slot
                 map->used--;
+                MAP_KEYS_CHANGED(map);
                 if (map->table[(pos + 1) % map->alloc].key == MP_OBJ_NULL) {
                     // optimisation if next slot is empty
                     slot->key = MP_OBJ_NULL;
@@ -302,6 +336,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                 if (avail_slot != NULL) {
                     // there was an available slot, so use that
                     map->used++;
+                    MAP_KEYS_CHANGED(map);
                     avail_slot->key = index;
                     avail_slot->value = MP_OBJ_NULL;
                     if (!mp_obj_is_qstr(index)) {
@@ -310,7 +345,7 @@ mp_map_elem_t *MICROPY_WRAP_MP_MAP_LOOKUP(mp_map_lookup)(mp_map_t * map, mp_obj_
                     return avail_slot;
                 } else {
                     // not enough room in table, rehash it
-                    mp_map_rehash(map);
+                    mp_map_rehash(map, get_hash_alloc_greater_or_equal_to(map->alloc + 1));
                     // restart the search for the new element
                     start_pos = pos = hash % map->alloc;
                 }
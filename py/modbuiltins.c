@@ -29,6 +29,7 @@
 
 #include "py/smallint.h"
 #include "py/objint.h"
+#include "py/objmodule.h"
 #include "py/objstr.h"
 #include "py/objtype.h"
 #include "py/runtime.h"
@@ -587,11 +588,17 @@ static mp_obj_t mp_builtin_hasattr(mp_obj_t object_in, mp_obj_t attr_in) {
 MP_DEFINE_CONST_FUN_OBJ_2(mp_builtin_hasattr_obj, mp_builtin_hasattr);
 
 static mp_obj_t mp_builtin_globals(void) {
+    #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+    mp_module_lazy_resolve_all(mp_globals_get());
+    #endif
     return MP_OBJ_FROM_PTR(mp_globals_get());
 }
 MP_DEFINE_CONST_FUN_OBJ_0(mp_builtin_globals_obj, mp_builtin_globals);
 
 static mp_obj_t mp_builtin_locals(void) {
+    #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+    mp_module_lazy_resolve_all(mp_locals_get());
+    #endif
     return MP_OBJ_FROM_PTR(mp_locals_get());
 }
 MP_DEFINE_CONST_FUN_OBJ_0(mp_builtin_locals_obj, mp_builtin_locals);
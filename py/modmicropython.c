@@ -49,6 +49,18 @@ static mp_obj_t mp_micropython_opt_level(size_t n_args, const mp_obj_t *args) {
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_opt_level_obj, 0, 1, mp_micropython_opt_level);
 #endif
 
+#if MICROPY_EMIT_NATIVE_TIERING
+static mp_obj_t mp_micropython_tier_threshold(size_t n_args, const mp_obj_t *args) {
+    if (n_args == 0) {
+        return mp_obj_new_int_from_uint(MP_STATE_VM(tier_threshold));
+    } else {
+        MP_STATE_VM(tier_threshold) = mp_obj_get_int(args[0]);
+        return mp_const_none;
+    }
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_tier_threshold_obj, 0, 1, mp_micropython_tier_threshold);
+#endif
+
 #if MICROPY_PY_MICROPYTHON_MEM_INFO
 
 #if MICROPY_MEM_STATS
@@ -172,6 +184,9 @@ static const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_ENABLE_COMPILER
     { MP_ROM_QSTR(MP_QSTR_opt_level), MP_ROM_PTR(&mp_micropython_opt_level_obj) },
     #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    { MP_ROM_QSTR(MP_QSTR_tier_threshold), MP_ROM_PTR(&mp_micropython_tier_threshold_obj) },
+    #endif
     #if MICROPY_PY_MICROPYTHON_MEM_INFO
     #if MICROPY_MEM_STATS
     { MP_ROM_QSTR(MP_QSTR_mem_total), MP_ROM_PTR(&mp_micropython_mem_total_obj) },
@@ -82,124 +82,181 @@ static mp_uint_t get_fmt_num(const char **p) {
     return val;
 }
 
-static size_t calc_size_items(const char *fmt, size_t *total_sz) {
+// A format string is compiled once into a list of ops, one per type char,
+// with the byte offset of each field precomputed.  This is what struct.Struct
+// holds, and the module-level functions use a small cache of them so that
+// repeatedly used formats are not reparsed on every call.
+typedef struct _struct_op_t {
+    // Offset of the first value relative to the start of the struct.
+    size_t offset;
+    // Repeat count, or the length for 's' and 'x'.
+    mp_uint_t cnt;
+    char val_type;
+    // Size of each value if it's a plain integer that fits in an mp_int_t,
+    // in which case it's unpacked without going through mp_binary_get_val.
+    uint8_t int_size;
+} struct_op_t;
+
+typedef struct _mp_obj_struct_t {
+    mp_obj_base_t base;
+    mp_obj_t format;
+    size_t size;
+    size_t num_items;
+    size_t num_ops;
+    char fmt_type;
+    bool big_endian;
+    struct_op_t ops[];
+} mp_obj_struct_t;
+
+static const mp_obj_type_t mp_type_struct;
+
+static mp_obj_struct_t *struct_compile(mp_obj_t fmt_in) {
+    const char *fmt = mp_obj_str_get_str(fmt_in);
     char fmt_type = get_fmt_type(&fmt);
+
+    // Count the ops, so the struct can be allocated in one go.
+    size_t num_ops = 0;
+    for (const char *f = fmt; *f; ++f) {
+        if (!unichar_isdigit(*f)) {
+            ++num_ops;
+        }
+    }
+
+    mp_obj_struct_t *self = mp_obj_malloc_var(mp_obj_struct_t, ops, struct_op_t, num_ops, &mp_type_struct);
+    self->format = fmt_in;
+    self->num_ops = num_ops;
+    self->fmt_type = fmt_type;
+    self->big_endian = fmt_type == '>' || (fmt_type == '@' && MP_ENDIANNESS_BIG);
+
     size_t total_cnt = 0;
-    size_t size;
-    for (size = 0; *fmt; fmt++) {
+    size_t size = 0;
+    for (struct_op_t *op = self->ops; op < self->ops + num_ops; ++op, ++fmt) {
         mp_uint_t cnt = 1;
         if (unichar_isdigit(*fmt)) {
             cnt = get_fmt_num(&fmt);
         }
+        op->cnt = cnt;
+        op->val_type = *fmt;
+        op->int_size = 0;
 
         if (*fmt == 'x') {
+            op->offset = size;
             size += cnt;
         } else if (*fmt == 's') {
+            op->offset = size;
             total_cnt += 1;
             size += cnt;
         } else {
             total_cnt += cnt;
             size_t align;
             size_t sz = mp_binary_get_size(fmt_type, *fmt, &align);
-            while (cnt--) {
-                // Apply alignment
-                size = (size + align - 1) & ~(align - 1);
-                size += sz;
+            // Apply alignment, which then holds for all repeats since the
+            // size of a type is a multiple of its alignment
+            size = (size + align - 1) & ~(align - 1);
+            op->offset = size;
+            size += sz * cnt;
+            if (sz <= sizeof(mp_int_t) && sz <= 4 && strchr("bBhHiIlL", *fmt) != NULL) {
+                op->int_size = sz;
             }
         }
     }
-    *total_sz = size;
-    return total_cnt;
+    if (*fmt != '\0') {
+        // trailing count with no type
+        mp_raise_ValueError(MP_ERROR_TEXT("bad typecode"));
+    }
+
+    self->size = size;
+    self->num_items = total_cnt;
+    return self;
+}
+
+MP_REGISTER_ROOT_POINTER(struct _mp_obj_struct_t *struct_cache[MICROPY_PY_STRUCT_CACHE_SIZE]);
+
+static mp_obj_struct_t *struct_get(mp_obj_t fmt_in) {
+    size_t fmt_len;
+    const char *fmt = mp_obj_str_get_data(fmt_in, &fmt_len);
+    mp_obj_struct_t **cache = MP_STATE_VM(struct_cache);
+    for (size_t i = 0; i < MICROPY_PY_STRUCT_CACHE_SIZE; ++i) {
+        mp_obj_struct_t *st = cache[i];
+        if (st == NULL) {
+            break;
+        }
+        if (st->format == fmt_in) {
+            return st;
+        }
+        size_t len;
+        const char *str = mp_obj_str_get_data(st->format, &len);
+        if (len == fmt_len && memcmp(str, fmt, len) == 0) {
+            return st;
+        }
+    }
+
+    // Not cached, so compile it and insert at the front, dropping the entry at
+    // the back.  Hits don't reorder the entries, so the oldest compiled format
+    // is replaced first (FIFO), however often it is used.  The entries are
+    // shifted one pointer at a time, so a concurrent reader without the GIL
+    // always sees a valid (if possibly stale) entry.
+    mp_obj_struct_t *st = struct_compile(fmt_in);
+    for (size_t i = MICROPY_PY_STRUCT_CACHE_SIZE - 1; i > 0; --i) {
+        cache[i] = cache[i - 1];
+    }
+    cache[0] = st;
+    return st;
 }
 
 static mp_obj_t struct_calcsize(mp_obj_t fmt_in) {
-    const char *fmt = mp_obj_str_get_str(fmt_in);
-    size_t size;
-    calc_size_items(fmt, &size);
-    return MP_OBJ_NEW_SMALL_INT(size);
+    return MP_OBJ_NEW_SMALL_INT(struct_get(fmt_in)->size);
 }
 MP_DEFINE_CONST_FUN_OBJ_1(struct_calcsize_obj, struct_calcsize);
 
-static mp_obj_t struct_unpack_from(size_t n_args, const mp_obj_t *args) {
-    // unpack requires that the buffer be exactly the right size.
-    // unpack_from requires that the buffer be "big enough".
-    // Since we implement unpack and unpack_from using the same function
-    // we relax the "exact" requirement, and only implement "big enough".
-    const char *fmt = mp_obj_str_get_str(args[0]);
-    size_t total_sz;
-    size_t num_items = calc_size_items(fmt, &total_sz);
-    char fmt_type = get_fmt_type(&fmt);
-    mp_obj_tuple_t *res = MP_OBJ_TO_PTR(mp_obj_new_tuple(num_items, NULL));
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_READ);
-    byte *p = bufinfo.buf;
-    byte *end_p = &p[bufinfo.len];
-    mp_int_t offset = 0;
-
-    if (n_args > 2) {
-        // offset arg provided
-        offset = mp_obj_get_int(args[2]);
+static byte *struct_get_buffer_offset(mp_buffer_info_t *bufinfo, mp_int_t offset, size_t size) {
+    if (offset < 0) {
+        // negative offsets are relative to the end of the buffer
+        offset = (mp_int_t)bufinfo->len + offset;
         if (offset < 0) {
-            // negative offsets are relative to the end of the buffer
-            offset = bufinfo.len + offset;
-            if (offset < 0) {
-                mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
-            }
+            mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
         }
-        p += offset;
     }
-    byte *p_base = p;
-
-    // Check that the input buffer is big enough to unpack all the values
-    if (p + total_sz > end_p) {
+    // Check that the buffer is big enough to hold all the values
+    if ((size_t)offset + size > bufinfo->len) {
         mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
     }
+    return (byte *)bufinfo->buf + offset;
+}
 
-    for (size_t i = 0; i < num_items;) {
-        mp_uint_t cnt = 1;
-        if (unichar_isdigit(*fmt)) {
-            cnt = get_fmt_num(&fmt);
-        }
-        mp_obj_t item;
-        if (*fmt == 'x') {
-            p += cnt;
-        } else if (*fmt == 's') {
-            item = mp_obj_new_bytes(p, cnt);
-            p += cnt;
-            res->items[i++] = item;
+static mp_obj_t struct_unpack_internal(const mp_obj_struct_t *self, byte *p_base) {
+    mp_obj_tuple_t *res = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->num_items, NULL));
+    mp_obj_t *item = res->items;
+    for (const struct_op_t *op = self->ops; op < self->ops + self->num_ops; ++op) {
+        byte *p = p_base + op->offset;
+        if (op->val_type == 'x') {
+            // padding
+        } else if (op->val_type == 's') {
+            *item++ = mp_obj_new_bytes(p, op->cnt);
+        } else if (op->int_size != 0) {
+            bool is_signed = op->val_type > 'Z';
+            for (mp_uint_t cnt = op->cnt; cnt--; p += op->int_size) {
+                mp_int_t val = (mp_int_t)mp_binary_get_int(op->int_size, is_signed, self->big_endian, p);
+                *item++ = is_signed ? mp_obj_new_int(val) : mp_obj_new_int_from_uint(val);
+            }
         } else {
-            while (cnt--) {
-                item = mp_binary_get_val(fmt_type, *fmt, p_base, &p);
-                res->items[i++] = item;
+            for (mp_uint_t cnt = op->cnt; cnt--;) {
+                *item++ = mp_binary_get_val(self->fmt_type, op->val_type, p_base, &p);
             }
         }
-        fmt++;
     }
     return MP_OBJ_FROM_PTR(res);
 }
-MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_unpack_from_obj, 2, 3, struct_unpack_from);
 
 // This function assumes there is enough room in p to store all the values
-static void struct_pack_into_internal(mp_obj_t fmt_in, byte *p, size_t n_args, const mp_obj_t *args) {
-    const char *fmt = mp_obj_str_get_str(fmt_in);
-    char fmt_type = get_fmt_type(&fmt);
-
-    byte *p_base = p;
-    size_t i;
-    for (i = 0; i < n_args;) {
-        mp_uint_t cnt = 1;
-        if (*fmt == '\0') {
-            // more arguments given than used by format string; CPython raises struct.error here
-            break;
-        }
-        if (unichar_isdigit(*fmt)) {
-            cnt = get_fmt_num(&fmt);
-        }
-
-        if (*fmt == 'x') {
+static void struct_pack_into_internal(const mp_obj_struct_t *self, byte *p_base, size_t n_args, const mp_obj_t *args) {
+    size_t i = 0;
+    for (const struct_op_t *op = self->ops; op < self->ops + self->num_ops && i < n_args; ++op) {
+        byte *p = p_base + op->offset;
+        mp_uint_t cnt = op->cnt;
+        if (op->val_type == 'x') {
             memset(p, 0, cnt);
-            p += cnt;
-        } else if (*fmt == 's') {
+        } else if (op->val_type == 's') {
             mp_buffer_info_t bufinfo;
             mp_get_buffer_raise(args[i++], &bufinfo, MP_BUFFER_READ);
             mp_uint_t to_copy = cnt;
@@ -208,54 +265,184 @@ static void struct_pack_into_internal(mp_obj_t fmt_in, byte *p, size_t n_args, c
             }
             memcpy(p, bufinfo.buf, to_copy);
             memset(p + to_copy, 0, cnt - to_copy);
-            p += cnt;
         } else {
             // If we run out of args then we just finish; CPython would raise struct.error
             while (cnt-- && i < n_args) {
-                mp_binary_set_val(fmt_type, *fmt, args[i++], p_base, &p);
+                mp_binary_set_val(self->fmt_type, op->val_type, args[i++], p_base, &p);
             }
         }
-        fmt++;
     }
+    // If more arguments are given than used by the format string they are
+    // ignored; CPython raises struct.error here
 }
 
-static mp_obj_t struct_pack(size_t n_args, const mp_obj_t *args) {
+static mp_obj_t struct_pack_internal(const mp_obj_struct_t *self, size_t n_args, const mp_obj_t *args) {
     // TODO: "The arguments must match the values required by the format exactly."
-    mp_int_t size = MP_OBJ_SMALL_INT_VALUE(struct_calcsize(args[0]));
     vstr_t vstr;
-    vstr_init_len(&vstr, size);
+    vstr_init_len(&vstr, self->size);
     byte *p = (byte *)vstr.buf;
-    memset(p, 0, size);
-    struct_pack_into_internal(args[0], p, n_args - 1, &args[1]);
+    memset(p, 0, self->size);
+    struct_pack_into_internal(self, p, n_args, args);
     return mp_obj_new_bytes_from_vstr(&vstr);
 }
+
+static mp_obj_t struct_unpack_from_internal(const mp_obj_struct_t *self, size_t n_args, const mp_obj_t *args) {
+    // unpack requires that the buffer be exactly the right size.
+    // unpack_from requires that the buffer be "big enough".
+    // Since we implement unpack and unpack_from using the same function
+    // we relax the "exact" requirement, and only implement "big enough".
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    mp_int_t offset = 0;
+    if (n_args > 1) {
+        // offset arg provided
+        offset = mp_obj_get_int(args[1]);
+    }
+    return struct_unpack_internal(self, struct_get_buffer_offset(&bufinfo, offset, self->size));
+}
+
+static mp_obj_t struct_pack_into_offset_internal(const mp_obj_struct_t *self, size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_WRITE);
+    byte *p = struct_get_buffer_offset(&bufinfo, mp_obj_get_int(args[1]), self->size);
+    struct_pack_into_internal(self, p, n_args - 2, &args[2]);
+    return mp_const_none;
+}
+
+static mp_obj_t struct_unpack_from(size_t n_args, const mp_obj_t *args) {
+    return struct_unpack_from_internal(struct_get(args[0]), n_args - 1, &args[1]);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_unpack_from_obj, 2, 3, struct_unpack_from);
+
+static mp_obj_t struct_pack(size_t n_args, const mp_obj_t *args) {
+    return struct_pack_internal(struct_get(args[0]), n_args - 1, &args[1]);
+}
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_pack_obj, 1, MP_OBJ_FUN_ARGS_MAX, struct_pack);
 
 static mp_obj_t struct_pack_into(size_t n_args, const mp_obj_t *args) {
+    return struct_pack_into_offset_internal(struct_get(args[0]), n_args - 1, &args[1]);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_pack_into);
+
+#if MICROPY_PY_STRUCT_STRUCT
+
+typedef struct _mp_obj_struct_iter_t {
+    mp_obj_base_t base;
+    mp_fun_1_t iternext;
+    const mp_obj_struct_t *st;
+    mp_obj_t buffer;
+    size_t offset;
+} mp_obj_struct_iter_t;
+
+static mp_obj_t struct_iter_unpack_iternext(mp_obj_t self_in) {
+    mp_obj_struct_iter_t *self = MP_OBJ_TO_PTR(self_in);
     mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
-    mp_int_t offset = mp_obj_get_int(args[2]);
-    if (offset < 0) {
-        // negative offsets are relative to the end of the buffer
-        offset = (mp_int_t)bufinfo.len + offset;
-        if (offset < 0) {
-            mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
-        }
+    mp_get_buffer_raise(self->buffer, &bufinfo, MP_BUFFER_READ);
+    if (self->offset + self->st->size > bufinfo.len) {
+        return MP_OBJ_STOP_ITERATION;
     }
-    byte *p = (byte *)bufinfo.buf;
-    byte *end_p = &p[bufinfo.len];
-    p += offset;
+    byte *p = (byte *)bufinfo.buf + self->offset;
+    self->offset += self->st->size;
+    return struct_unpack_internal(self->st, p);
+}
 
-    // Check that the output buffer is big enough to hold all the values
-    mp_int_t sz = MP_OBJ_SMALL_INT_VALUE(struct_calcsize(args[0]));
-    if (p + sz > end_p) {
-        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+static mp_obj_t struct_iter_unpack_internal(const mp_obj_struct_t *st, mp_obj_t buffer) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buffer, &bufinfo, MP_BUFFER_READ);
+    if (st->size == 0 || bufinfo.len % st->size != 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer size must be a multiple of struct size"));
     }
+    mp_obj_struct_iter_t *o = mp_obj_malloc(mp_obj_struct_iter_t, &mp_type_polymorph_iter);
+    o->iternext = struct_iter_unpack_iternext;
+    o->st = st;
+    o->buffer = buffer;
+    o->offset = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
 
-    struct_pack_into_internal(args[0], p, n_args - 3, &args[3]);
-    return mp_const_none;
+static mp_obj_t struct_iter_unpack(mp_obj_t fmt_in, mp_obj_t buffer) {
+    return struct_iter_unpack_internal(struct_get(fmt_in), buffer);
 }
-MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_pack_into);
+MP_DEFINE_CONST_FUN_OBJ_2(struct_iter_unpack_obj, struct_iter_unpack);
+
+static mp_obj_t struct_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    (void)type;
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    // Compiled structs are immutable so a cached one can be shared.
+    return MP_OBJ_FROM_PTR(struct_get(args[0]));
+}
+
+static void struct_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    (void)kind;
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "Struct(%r)", self->format);
+}
+
+static void struct_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    if (dest[0] != MP_OBJ_NULL) {
+        // not load attribute
+        return;
+    }
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    if (attr == MP_QSTR_format) {
+        dest[0] = self->format;
+    } else if (attr == MP_QSTR_size) {
+        dest[0] = MP_OBJ_NEW_SMALL_INT(self->size);
+    } else {
+        // continue lookup in locals_dict
+        dest[1] = MP_OBJ_SENTINEL;
+    }
+}
+
+static mp_obj_t struct_struct_pack(size_t n_args, const mp_obj_t *args) {
+    return struct_pack_internal(MP_OBJ_TO_PTR(args[0]), n_args - 1, &args[1]);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_struct_pack_obj, 1, MP_OBJ_FUN_ARGS_MAX, struct_struct_pack);
+
+static mp_obj_t struct_struct_pack_into(size_t n_args, const mp_obj_t *args) {
+    return struct_pack_into_offset_internal(MP_OBJ_TO_PTR(args[0]), n_args - 1, &args[1]);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_struct_pack_into);
+
+static mp_obj_t struct_struct_unpack_from(size_t n_args, const mp_obj_t *args) {
+    return struct_unpack_from_internal(MP_OBJ_TO_PTR(args[0]), n_args - 1, &args[1]);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_struct_unpack_from_obj, 2, 3, struct_struct_unpack_from);
+
+static mp_obj_t struct_struct_iter_unpack(mp_obj_t self_in, mp_obj_t buffer) {
+    return struct_iter_unpack_internal(MP_OBJ_TO_PTR(self_in), buffer);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(struct_struct_iter_unpack_obj, struct_struct_iter_unpack);
+
+static const mp_rom_map_elem_t struct_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_pack), MP_ROM_PTR(&struct_struct_pack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_struct_pack_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_struct_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_struct_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_struct_iter_unpack_obj) },
+};
+static MP_DEFINE_CONST_DICT(struct_locals_dict, struct_locals_dict_table);
+
+static MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_struct,
+    MP_QSTR_Struct,
+    MP_TYPE_FLAG_NONE,
+    make_new, struct_make_new,
+    print, struct_print,
+    attr, struct_attr,
+    locals_dict, &struct_locals_dict
+    );
+
+#else
+
+// Compiled structs are internal only.
+static MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_struct,
+    MP_QSTR_Struct,
+    MP_TYPE_FLAG_NONE
+    );
+
+#endif
 
 static const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_struct) },
@@ -264,6 +451,10 @@ static const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_pack_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_unpack_from_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_unpack_from_obj) },
+    #if MICROPY_PY_STRUCT_STRUCT
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_iter_unpack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_Struct), MP_ROM_PTR(&mp_type_struct) },
+    #endif
 };
 
 static MP_DEFINE_CONST_DICT(mp_module_struct_globals, mp_module_struct_globals_table);
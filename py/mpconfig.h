@@ -312,6 +312,13 @@
 #define MICROPY_STACKLESS_STRICT (0)
 #endif
 
+// Maximum number of heap-allocated frames that returning stackless calls keep
+// for reuse by later calls, rather than allocating a new frame per call.  Not
+// used with MICROPY_ENABLE_PYSTACK, which allocates frames LIFO anyway.
+#ifndef MICROPY_STACKLESS_POOL_SIZE
+#define MICROPY_STACKLESS_POOL_SIZE (32)
+#endif
+
 // Don't use alloca calls. As alloca() is not part of ANSI C, this
 // workaround option is provided for compilers lacking this de-facto
 // standard function. The way it works is allocating from heap, and
@@ -330,6 +337,13 @@
 #define MICROPY_PERSISTENT_CODE_LOAD (0)
 #endif
 
+// Whether loading persistent code can reference bytecode, qstr and str/bytes
+// data in place when the reader is backed by memory that is read-only and
+// stays valid for the life of the program (eg flash)
+#ifndef MICROPY_PERSISTENT_CODE_LOAD_ROM
+#define MICROPY_PERSISTENT_CODE_LOAD_ROM (0)
+#endif
+
 // Whether to support saving of persistent code, i.e. for mpy-cross to
 // generate .mpy files. Enabling this enables additional metadata on raw code
 // objects which is also required for sys.settrace.
@@ -342,6 +356,25 @@
 #define MICROPY_PERSISTENT_CODE_SAVE_FILE (0)
 #endif
 
+// Whether native code compiled at runtime can be saved to .mpy files.  This makes
+// the native emitter access qstrs through the qstr table, which is slower.
+#ifndef MICROPY_PERSISTENT_CODE_SAVE_NATIVE
+#define MICROPY_PERSISTENT_CODE_SAVE_NATIVE (MICROPY_PERSISTENT_CODE_SAVE)
+#endif
+
+// Whether importing a .py file can load its compiled code from, and save it to,
+// an on-disk cache of .mpy files (see MP_STATE_VM(persistent_code_cache_dir));
+// needs MICROPY_VFS and MICROPY_PERSISTENT_CODE_SAVE
+#ifndef MICROPY_PERSISTENT_CODE_CACHE
+#define MICROPY_PERSISTENT_CODE_CACHE (0)
+#endif
+
+// A number that differs between processes which may share the .mpy cache, used
+// to give each the temporary files it writes cache entries to
+#ifndef MICROPY_PERSISTENT_CODE_CACHE_PROCESS_ID
+#define MICROPY_PERSISTENT_CODE_CACHE_PROCESS_ID() (0)
+#endif
+
 // Whether generated code can persist independently of the VM/runtime instance
 // This is enabled automatically when needed by other features
 #ifndef MICROPY_PERSISTENT_CODE
@@ -406,14 +439,34 @@
 #define MICROPY_EMIT_XTENSAWIN (0)
 #endif
 
+// Whether to emit RISC-V RV32IMC native code
+#ifndef MICROPY_EMIT_RV32
+#define MICROPY_EMIT_RV32 (0)
+#endif
+
+// Whether to emit AArch64 native code
+#ifndef MICROPY_EMIT_AARCH64
+#define MICROPY_EMIT_AARCH64 (0)
+#endif
+
 // Convenience definition for whether any native emitter is enabled
-#define MICROPY_EMIT_NATIVE (MICROPY_EMIT_X64 || MICROPY_EMIT_X86 || MICROPY_EMIT_THUMB || MICROPY_EMIT_ARM || MICROPY_EMIT_XTENSA || MICROPY_EMIT_XTENSAWIN)
+#define MICROPY_EMIT_NATIVE (MICROPY_EMIT_X64 || MICROPY_EMIT_X86 || MICROPY_EMIT_THUMB || MICROPY_EMIT_ARM || MICROPY_EMIT_XTENSA || MICROPY_EMIT_XTENSAWIN || MICROPY_EMIT_RV32 || MICROPY_EMIT_AARCH64)
 
 // Some architectures cannot read byte-wise from executable memory.  In this case
 // the prelude for a native function (which usually sits after the machine code)
 // must be separated and placed somewhere where it can be read byte-wise.
 #define MICROPY_EMIT_NATIVE_PRELUDE_SEPARATE_FROM_MACHINE_CODE (MICROPY_EMIT_XTENSAWIN)
 
+// Whether hot bytecode functions can be recompiled from their source file to
+// native code at runtime ("tiered execution").  Tiered functions take on the
+// semantics of the native emitter: tracebacks lose line numbers and locals are
+// not checked for being unbound.  The hotness threshold is set at runtime and
+// tiering is off until it is set to a non-zero value.  Needs a native emitter
+// and MICROPY_READER_POSIX or MICROPY_READER_VFS to re-read the source.
+#ifndef MICROPY_EMIT_NATIVE_TIERING
+#define MICROPY_EMIT_NATIVE_TIERING (0)
+#endif
+
 // Convenience definition for whether any inline assembler emitter is enabled
 #define MICROPY_EMIT_INLINE_ASM (MICROPY_EMIT_INLINE_THUMB || MICROPY_EMIT_INLINE_XTENSA)
 
@@ -472,6 +525,20 @@
 #define MICROPY_COMP_CONST (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
 #endif
 
+// Whether to enable propagation of module-level names that are assigned a
+// constant exactly once, at optimisation level 4 and higher (needs
+// MICROPY_COMP_CONST)
+#ifndef MICROPY_COMP_GLOBAL_CONST
+#define MICROPY_COMP_GLOBAL_CONST (0)
+#endif
+
+// Whether to cache loads of globals, builtins and module attributes made inside
+// loops in hidden locals, at optimisation level 4 and higher.  The opcodes this
+// uses aren't part of the .mpy format, so code compiled this way can't be saved.
+#ifndef MICROPY_COMP_CACHE_LOADS
+#define MICROPY_COMP_CACHE_LOADS (0)
+#endif
+
 // Whether to enable optimisation of: a, b = c, d
 // Costs 124 bytes (Thumb2)
 #ifndef MICROPY_COMP_DOUBLE_TUPLE_ASSIGN
@@ -567,6 +634,39 @@
 #define MICROPY_OPT_MAP_LOOKUP_CACHE_SIZE (128)
 #endif
 
+// Use extra RAM to cache which argument slot of a function a keyword argument
+// binds to, so calls passing keyword arguments don't have to search the
+// function's argument names.  Each thread has its own cache, and each entry
+// keeps its function's code alive.
+#ifndef MICROPY_OPT_KWARG_SLOT_CACHE
+#define MICROPY_OPT_KWARG_SLOT_CACHE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Number of entries in each thread's keyword argument slot cache.
+#ifndef MICROPY_OPT_KWARG_SLOT_CACHE_SIZE
+#define MICROPY_OPT_KWARG_SLOT_CACHE_SIZE (32)
+#endif
+
+// Use extra RAM to cache which builtin a global name resolves to in a module,
+// so loading a builtin doesn't have to miss in the module's globals and the
+// builtins override dict before finding it.  Each thread has its own cache,
+// and entries are valid until any module namespace gains or loses a name.
+#ifndef MICROPY_OPT_BUILTIN_CACHE
+#define MICROPY_OPT_BUILTIN_CACHE (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Number of entries in each thread's builtin cache.
+#ifndef MICROPY_OPT_BUILTIN_CACHE_SIZE
+#define MICROPY_OPT_BUILTIN_CACHE_SIZE (16)
+#endif
+
+// Number of arguments (counting each keyword argument as two) that a call
+// with * or ** arguments can unpack into a C stack buffer.  Calls with more
+// arguments allocate the array for them on the heap (or pystack).
+#ifndef MICROPY_CALL_VAR_STACK_ARGS
+#define MICROPY_CALL_VAR_STACK_ARGS (8)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
@@ -579,6 +679,19 @@
 #define MICROPY_OPT_MATH_FACTORIAL (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
 #endif
 
+// Whether substring search (str/bytes find, count, split, replace, etc) uses
+// memchr and a Horspool skip table instead of a naive byte-by-byte compare.
+// Uses 256 bytes of C stack for long needles.
+#ifndef MICROPY_OPT_STR_SEARCH
+#define MICROPY_OPT_STR_SEARCH (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Whether mp_binary_op has a fast path for arithmetic and comparison between
+// two floats, bypassing the type's binary_op slot.
+#ifndef MICROPY_OPT_FLOAT_BINARY_OP
+#define MICROPY_OPT_FLOAT_BINARY_OP (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 /*****************************************************************************/
 /* Python internal features                                                  */
 
@@ -647,6 +760,22 @@
 #define MICROPY_GC_HOOK_LOOP(i)
 #endif
 
+// Whether gc_alloc keeps per-thread free lists of small (1 to
+// MICROPY_GC_POOL_MAX_BLOCKS block) allocations, refilled in batches of
+// MICROPY_GC_POOL_BATCH, so that most small allocations are a pointer pop.
+// The pool of the collecting thread is returned to the heap on each collection.
+#ifndef MICROPY_GC_POOL
+#define MICROPY_GC_POOL (0)
+#endif
+
+#ifndef MICROPY_GC_POOL_MAX_BLOCKS
+#define MICROPY_GC_POOL_MAX_BLOCKS (2)
+#endif
+
+#ifndef MICROPY_GC_POOL_BATCH
+#define MICROPY_GC_POOL_BATCH (16)
+#endif
+
 // Whether to provide m_tracked_calloc, m_tracked_free functions
 #ifndef MICROPY_TRACKED_ALLOC
 #define MICROPY_TRACKED_ALLOC (0)
@@ -912,6 +1041,12 @@ typedef double mp_float_t;
 #define MICROPY_MODULE_FROZEN_MPY (0)
 #endif
 
+// Whether functions defined at the top level of frozen .mpy modules are only
+// created when they're first used, instead of when their module is imported
+#ifndef MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+#define MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS (0)
+#endif
+
 // Convenience macro for whether frozen modules are supported
 #ifndef MICROPY_MODULE_FROZEN
 #define MICROPY_MODULE_FROZEN (MICROPY_MODULE_FROZEN_STR || MICROPY_MODULE_FROZEN_MPY)
@@ -991,6 +1126,37 @@ typedef double mp_float_t;
 #define MICROPY_VFS_LFS2 (0)
 #endif
 
+// Whether block devices used by VFS filesystems have a cache of recently used
+// blocks.  Blocks written by FAT are written back to the device when synced
+// (coalescing adjacent blocks into one write), and sequential reads read ahead.
+#ifndef MICROPY_VFS_BLOCKDEV_CACHE
+#define MICROPY_VFS_BLOCKDEV_CACHE (0)
+#endif
+
+// Number of blocks in the cache of each block device
+#ifndef MICROPY_VFS_BLOCKDEV_CACHE_BLOCKS
+#define MICROPY_VFS_BLOCKDEV_CACHE_BLOCKS (8)
+#endif
+
+// Maximum number of blocks read at once when reading sequentially
+#ifndef MICROPY_VFS_BLOCKDEV_CACHE_READAHEAD
+#define MICROPY_VFS_BLOCKDEV_CACHE_READAHEAD (4)
+#endif
+
+// Whether FAT and littlefs filesystems cache the listings of directories that
+// imports search, so that imports don't search the filesystem for each path
+// they try.  The cache is cleared when the filesystem is changed through its
+// methods, but not when its block device is written some other way.
+#ifndef MICROPY_VFS_DIR_CACHE
+#define MICROPY_VFS_DIR_CACHE (0)
+#endif
+
+// Maximum size in bytes of a cached directory listing (about 2 bytes more
+// than the length of each name in the directory)
+#ifndef MICROPY_VFS_DIR_CACHE_MAX_LEN
+#define MICROPY_VFS_DIR_CACHE_MAX_LEN (4096)
+#endif
+
 /*****************************************************************************/
 /* Fine control over Python builtins, classes, modules, etc                  */
 
@@ -1064,6 +1230,13 @@ typedef double mp_float_t;
 #define MICROPY_PY_BUILTINS_STR_UNICODE_CHECK (MICROPY_PY_BUILTINS_STR_UNICODE)
 #endif
 
+// Whether long unicode strs get a lazily-built, cached sparse index from
+// character position to byte offset, so that indexing and slicing them does
+// not rescan the UTF-8 data from the start each time.
+#ifndef MICROPY_PY_BUILTINS_STR_UNICODE_INDEX
+#define MICROPY_PY_BUILTINS_STR_UNICODE_INDEX (MICROPY_PY_BUILTINS_STR_UNICODE && MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
 // Whether str.center() method provided
 #ifndef MICROPY_PY_BUILTINS_STR_CENTER
 #define MICROPY_PY_BUILTINS_STR_CENTER (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
@@ -1413,6 +1586,16 @@ typedef double mp_float_t;
 #define MICROPY_PY_STRUCT (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
 #endif
 
+// Whether to provide "struct.Struct" type and "struct.iter_unpack" function
+#ifndef MICROPY_PY_STRUCT_STRUCT
+#define MICROPY_PY_STRUCT_STRUCT (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_EXTRA_FEATURES)
+#endif
+
+// Number of most recently compiled struct format strings to keep
+#ifndef MICROPY_PY_STRUCT_CACHE_SIZE
+#define MICROPY_PY_STRUCT_CACHE_SIZE (4)
+#endif
+
 // Whether to provide "sys" module
 #ifndef MICROPY_PY_SYS
 #define MICROPY_PY_SYS (MICROPY_CONFIG_ROM_LEVEL_AT_LEAST_CORE_FEATURES)
@@ -1667,6 +1850,18 @@ typedef double mp_float_t;
 #define MICROPY_PY_HASHLIB_SHA256 (1)
 #endif
 
+// Whether to provide hashlib.sha256_many(), to hash a batch of buffers
+#ifndef MICROPY_PY_HASHLIB_SHA256_MANY
+#define MICROPY_PY_HASHLIB_SHA256_MANY (0)
+#endif
+
+// Whether hashlib's SHA-256 uses the host CPU's SHA instructions (detected
+// at runtime) and SIMD lanes for sha256_many(), where the compiler supports
+// them; this takes precedence over the mbedtls implementation
+#ifndef MICROPY_PY_HASHLIB_SHA256_FAST
+#define MICROPY_PY_HASHLIB_SHA256_FAST (0)
+#endif
+
 #ifndef MICROPY_PY_CRYPTOLIB
 #define MICROPY_PY_CRYPTOLIB (0)
 #endif
@@ -1676,6 +1871,29 @@ typedef double mp_float_t;
 #define MICROPY_PY_CRYPTOLIB_CTR (0)
 #endif
 
+// Depends on MICROPY_PY_CRYPTOLIB_AES_BUILTIN
+#ifndef MICROPY_PY_CRYPTOLIB_GCM
+#define MICROPY_PY_CRYPTOLIB_GCM (0)
+#endif
+
+// Whether cryptolib uses its built-in AES (which uses AES-NI on x86 hosts)
+// instead of the AES from the SSL library
+#ifndef MICROPY_PY_CRYPTOLIB_AES_BUILTIN
+#define MICROPY_PY_CRYPTOLIB_AES_BUILTIN (0)
+#endif
+
+// Whether the built-in AES uses the CPU's AES instructions when it has them
+#ifndef MICROPY_PY_CRYPTOLIB_AES_HW
+#define MICROPY_PY_CRYPTOLIB_AES_HW (1)
+#endif
+
+// Whether the built-in AES is constant-time when it doesn't use the CPU's AES
+// instructions.  If disabled it uses faster lookup tables instead, but then
+// the time it takes depends on the key and the data.
+#ifndef MICROPY_PY_CRYPTOLIB_AES_CONST_TIME
+#define MICROPY_PY_CRYPTOLIB_AES_CONST_TIME (1)
+#endif
+
 #ifndef MICROPY_PY_CRYPTOLIB_CONSTS
 #define MICROPY_PY_CRYPTOLIB_CONSTS (0)
 #endif
@@ -1786,6 +2004,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_BTREE (0)
 #endif
 
+// Whether btree does page I/O with pread/pwrite on the file descriptor of a
+// POSIX VFS file, instead of through the stream protocol
+#ifndef MICROPY_PY_BTREE_FD
+#define MICROPY_PY_BTREE_FD (0)
+#endif
+
 // Whether to provide the low-level "_onewire" module
 #ifndef MICROPY_PY_ONEWIRE
 #define MICROPY_PY_ONEWIRE (0)
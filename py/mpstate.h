@@ -131,6 +131,12 @@ typedef struct _mp_state_mem_t {
     size_t gc_collected;
     #endif
 
+    #if MICROPY_GC_POOL
+    // Number of small allocations served from / not from a pool.
+    size_t gc_pool_hits;
+    size_t gc_pool_misses;
+    #endif
+
     #if MICROPY_PY_THREAD && !MICROPY_PY_THREAD_GIL
     // This is a global mutex used to make the GC thread-safe.
     mp_thread_mutex_t gc_mutex;
@@ -210,8 +216,17 @@ typedef struct _mp_state_vm_t {
     #if MICROPY_EMIT_NATIVE
     uint8_t default_emit_opt; // one of MP_EMIT_OPT_xxx
     #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    mp_uint_t tier_threshold; // calls plus backward jumps before going native, 0 to disable
+    #endif
     #endif
 
+    // incremented on any change to a module namespace, see mp_map_t.is_versioned
+    mp_uint_t namespace_version;
+
+    // incremented when a name is added to or removed from a module namespace
+    mp_uint_t namespace_keys_version;
+
     // size of the emergency exception buf, if it's dynamically allocated
     #if MICROPY_ENABLE_EMERGENCY_EXCEPTION_BUF && MICROPY_EMERGENCY_EXCEPTION_BUF_SIZE == 0
     mp_int_t mp_emergency_exception_buf_size;
@@ -249,6 +264,32 @@ typedef struct _mp_state_vm_t {
     #endif
 } mp_state_vm_t;
 
+#if MICROPY_OPT_KWARG_SLOT_CACHE
+// The argument slot that keyword argument name binds to in the function whose
+// code starts at code.
+typedef struct _mp_kwarg_slot_cache_entry_t {
+    const byte *code;
+    qstr name;
+    size_t slot;
+} mp_kwarg_slot_cache_entry_t;
+#endif
+
+#if MICROPY_OPT_BUILTIN_CACHE
+// The builtin that global name resolves to in the module with the given
+// globals, as of namespace_keys_version being version.
+typedef struct _mp_builtin_cache_entry_t {
+    mp_obj_dict_t *globals;
+    qstr name;
+    mp_uint_t version;
+    mp_obj_t value;
+} mp_builtin_cache_entry_t;
+#endif
+
+// Whether stackless calls reuse their heap frames.  A sys.settrace frame object
+// can outlive its call, so frames can't be reused when that's enabled.
+#define MP_STACKLESS_USE_POOL (MICROPY_STACKLESS && MICROPY_ENABLE_GC && !MICROPY_ENABLE_PYSTACK \
+    && !MICROPY_PY_SYS_SETTRACE && MICROPY_STACKLESS_POOL_SIZE > 0)
+
 // This structure holds state that is specific to a given thread. Everything
 // in this structure is scanned for root pointers.  Anything added to this
 // structure must have corresponding initialisation added to thread_entry (in
@@ -282,6 +323,29 @@ typedef struct _mp_state_thread_t {
     nlr_buf_t *nlr_top;
     nlr_jump_callback_node_t *nlr_jump_callback_top;
 
+    #if MICROPY_GC_POOL
+    // Free lists of allocated 1, 2, ... block chunks, linked through their
+    // first word.  Being in the root pointer section keeps them alive.
+    void *gc_pool[MICROPY_GC_POOL_MAX_BLOCKS];
+    #endif
+
+    #if MICROPY_OPT_KWARG_SLOT_CACHE
+    // See mp_setup_code_state_helper.
+    mp_kwarg_slot_cache_entry_t kwarg_slot_cache[MICROPY_OPT_KWARG_SLOT_CACHE_SIZE];
+    #endif
+
+    #if MICROPY_OPT_BUILTIN_CACHE
+    // See mp_load_global.
+    mp_builtin_cache_entry_t builtin_cache[MICROPY_OPT_BUILTIN_CACHE_SIZE];
+    #endif
+
+    #if MP_STACKLESS_USE_POOL
+    // Zeroed heap frames of returned stackless calls, chained through their
+    // prev field, each with its n_state holding how many state bytes it has.
+    struct _mp_code_state_t *code_state_pool;
+    size_t code_state_pool_len;
+    #endif
+
     // pending exception object (MP_OBJ_NULL if not pending)
     volatile mp_obj_t mp_pending_exception;
 
@@ -293,6 +357,11 @@ typedef struct _mp_state_thread_t {
     bool prof_callback_is_executing;
     struct _mp_code_state_t *current_code_state;
     #endif
+
+    #if MICROPY_PY_BUILTINS_STR_UNICODE_INDEX
+    // Character indices of recently indexed long strs, most-recently-used first.
+    struct _mp_str_index_t *str_index_cache[2];
+    #endif
 } mp_state_thread_t;
 
 // This structure combines the above 3 structures.
@@ -44,6 +44,8 @@
 #define MICROPY_NLR_NUM_REGS_MIPS           (13)
 #define MICROPY_NLR_NUM_REGS_XTENSA         (10)
 #define MICROPY_NLR_NUM_REGS_XTENSAWIN      (17)
+// The size of newlib's RV32 jmp_buf: 14 integer registers and 12 doubles.
+#define MICROPY_NLR_NUM_REGS_RV32I          (14 + 24)
 
 // *FORMAT-OFF*
 
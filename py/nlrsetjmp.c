@@ -29,6 +29,11 @@
 #if MICROPY_NLR_SETJMP
 
 void nlr_jump(void *val) {
+    #if defined(__riscv) && __riscv_xlen == 32
+    // mpy-cross -march=rv32imc reserves this many words for an nlr_buf_t in
+    // the stack frame of native code, so the port's jmp_buf must fit in it.
+    MP_STATIC_ASSERT(sizeof(nlr_buf_t) <= (2 + MICROPY_NLR_NUM_REGS_RV32I + 1) * sizeof(void *));
+    #endif
     MP_NLR_JUMP_HEAD(val, top);
     longjmp(top->jmpbuf, 1);
 }
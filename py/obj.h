@@ -289,6 +289,16 @@ static inline bool mp_obj_is_obj(mp_const_obj_t o) {
 #define MP_OBJ_TO_PTR(o) ((void *)(uintptr_t)(o))
 #define MP_OBJ_FROM_PTR(p) ((mp_obj_t)((uintptr_t)(p)))
 
+#if UINTPTR_MAX > 0xffffffff
+// on 64-bit hosts a pointer fills the whole object word
+typedef union _mp_rom_obj_t {
+    uint64_t u64;
+    const void *ptr;
+} mp_rom_obj_t;
+#define MP_ROM_INT(i) {MP_OBJ_NEW_SMALL_INT(i)}
+#define MP_ROM_QSTR(q) {MP_OBJ_NEW_QSTR(q)}
+#define MP_ROM_PTR(p) {.ptr = (p)}
+#else
 // rom object storage needs special handling to widen 32-bit pointer to 64-bits
 typedef union _mp_rom_obj_t {
     uint64_t u64;
@@ -303,6 +313,7 @@ typedef union _mp_rom_obj_t {
 #else
 #define MP_ROM_PTR(p) {.u32 = {.lo = NULL, .hi = (p)}}
 #endif
+#endif
 
 #endif
 
@@ -463,7 +474,9 @@ typedef struct _mp_map_t {
     size_t all_keys_are_qstrs : 1;
     size_t is_fixed : 1;    // if set, table is fixed/read-only and can't be modified
     size_t is_ordered : 1;  // if set, table is an ordered array, not a hash map
-    size_t used : (8 * sizeof(size_t) - 3);
+    size_t is_versioned : 1; // if set, changes bump the namespace versions in MP_STATE_VM
+    size_t is_lazy : 1;     // if set, values may be mp_obj_fun_lazy_t stubs, see py/bc.h
+    size_t used : (8 * sizeof(size_t) - 5);
     size_t alloc;
     mp_map_elem_t *table;
 } mp_map_t;
@@ -488,6 +501,7 @@ void mp_map_deinit(mp_map_t *map);
 void mp_map_free(mp_map_t *map);
 mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t lookup_kind);
 void mp_map_clear(mp_map_t *map);
+void mp_map_reserve(mp_map_t *map, size_t n);
 void mp_map_dump(mp_map_t *map);
 
 // Underlying set implementation (not set object)
@@ -834,6 +848,9 @@ extern const mp_obj_type_t mp_type_fun_builtin_3;
 extern const mp_obj_type_t mp_type_fun_builtin_var;
 extern const mp_obj_type_t mp_type_fun_bc;
 extern const mp_obj_type_t mp_type_fun_native;
+#if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+extern const mp_obj_type_t mp_type_fun_lazy;
+#endif
 extern const mp_obj_type_t mp_type_fun_viper;
 extern const mp_obj_type_t mp_type_fun_asm;
 extern const mp_obj_type_t mp_type_module;
@@ -30,9 +30,12 @@
 
 #include "py/objtuple.h"
 #include "py/objfun.h"
+#include "py/objmodule.h"
 #include "py/runtime.h"
 #include "py/bc.h"
+#include "py/compile.h"
 #include "py/stackctrl.h"
+#include "py/gc.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_PRINT (1)
@@ -209,9 +212,24 @@ mp_code_state_t *mp_obj_fun_bc_prepare_codestate(mp_obj_t self_in, size_t n_args
     // RuntimeError should be raised instead. So, we use m_new_obj_var_maybe(),
     // return NULL, then vm.c takes the needed action (either raise
     // RuntimeError or fallback to stack allocation).
-    code_state = m_new_obj_var_maybe(mp_code_state_t, state, byte, state_size);
-    if (!code_state) {
-        return NULL;
+    code_state = NULL;
+    #if MP_STACKLESS_USE_POOL
+    for (mp_code_state_t **link = &MP_STATE_THREAD(code_state_pool); *link != NULL; link = &(*link)->prev) {
+        if ((*link)->n_state >= state_size) {
+            code_state = *link;
+            *link = code_state->prev;
+            code_state->prev = NULL;
+            --MP_STATE_THREAD(code_state_pool_len);
+            break;
+        }
+    }
+    if (code_state == NULL)
+    #endif
+    {
+        code_state = m_new_obj_var_maybe(mp_code_state_t, state, byte, state_size);
+        if (!code_state) {
+            return NULL;
+        }
     }
     #endif
 
@@ -222,6 +240,104 @@ mp_code_state_t *mp_obj_fun_bc_prepare_codestate(mp_obj_t self_in, size_t n_args
 
     return code_state;
 }
+
+void mp_obj_fun_bc_free_codestate(mp_code_state_t *code_state) {
+    #if MICROPY_ENABLE_PYSTACK
+    // Free code_state, and args allocated by mp_call_prepare_args_n_kw_var
+    // (The latter is implicitly freed when using pystack due to its LIFO nature.)
+    mp_pystack_free(code_state);
+    #elif MP_STACKLESS_USE_POOL
+    // Keep the frame for the next call, otherwise leave it to the GC.  Freeing
+    // it explicitly would make the GC rescan the heap from this block on every
+    // allocation that doesn't fit into it.  A full pool swaps its smallest frame
+    // for a bigger one, so functions that need big frames can still find them.
+    size_t frame_size = gc_nbytes(code_state) - offsetof(mp_code_state_t, state);
+    if (MP_STATE_THREAD(code_state_pool_len) == MICROPY_STACKLESS_POOL_SIZE) {
+        mp_code_state_t **smallest = &MP_STATE_THREAD(code_state_pool);
+        for (mp_code_state_t **link = &(*smallest)->prev; *link != NULL; link = &(*link)->prev) {
+            if ((*link)->n_state < (*smallest)->n_state) {
+                smallest = link;
+            }
+        }
+        if ((*smallest)->n_state >= frame_size) {
+            return;
+        }
+        *smallest = (*smallest)->prev;
+        --MP_STATE_THREAD(code_state_pool_len);
+    }
+    size_t n_state, state_size;
+    DECODE_CODESTATE_SIZE(code_state->fun_bc->bytecode, n_state, state_size);
+    (void)n_state;
+    // clear the part this call used so the pool doesn't keep old objects alive
+    // (the rest of the frame is still clear)
+    memset(code_state, 0, offsetof(mp_code_state_t, state) + state_size);
+    code_state->n_state = frame_size;
+    code_state->prev = MP_STATE_THREAD(code_state_pool);
+    MP_STATE_THREAD(code_state_pool) = code_state;
+    ++MP_STATE_THREAD(code_state_pool_len);
+    #else
+    (void)code_state;
+    #endif
+}
+#endif
+
+#if MICROPY_EMIT_NATIVE_TIERING
+static mp_obj_t fun_native_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
+
+// Called when a bytecode function gets hot: recompile it as native code (once
+// per raw code) and give this function object a native twin to run instead.
+static void fun_bc_tier_up(mp_obj_fun_bc_t *self) {
+    mp_raw_code_t *rc = self->rc;
+    if (rc->tier_fun == MP_OBJ_NULL) {
+        // stop counting from here on, whatever the outcome
+        size_t scope_index = rc->tier_scope_index;
+        rc->tier_scope_index = 0;
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
+            qstr source_file = self->context->constants.qstr_table[0];
+            #else
+            qstr source_file = self->context->constants.source_file;
+            #endif
+            mp_obj_t fun = mp_compile_tier_native(source_file, rc->tier_source_hash, scope_index, rc->tier_def_line,
+                mp_obj_fun_get_name(MP_OBJ_FROM_PTR(self)), self->context->module.globals);
+            if (fun != mp_const_none) {
+                rc->tier_fun = fun;
+            }
+            nlr_pop();
+        }
+        if (rc->tier_fun == MP_OBJ_NULL) {
+            // the source couldn't be read or compiled, so stay with bytecode
+            return;
+        }
+    }
+
+    // the twin shares this function's default args
+    const byte *ip = self->bytecode;
+    MP_BC_PRELUDE_SIG_DECODE(ip);
+    size_t n_extra_args = n_def_pos_args + ((scope_flags & MP_SCOPE_FLAG_DEFKWARGS) != 0);
+    mp_obj_fun_bc_t *compiled = MP_OBJ_TO_PTR(rc->tier_fun);
+    mp_obj_fun_bc_t *o = mp_obj_malloc_var(mp_obj_fun_bc_t, extra_args, mp_obj_t, n_extra_args, &mp_type_fun_native);
+    o->context = compiled->context;
+    o->child_table = compiled->child_table;
+    o->bytecode = compiled->bytecode;
+    o->rc = NULL;
+    o->tier_native = MP_OBJ_NULL;
+    memcpy(o->extra_args, self->extra_args, n_extra_args * sizeof(mp_obj_t));
+    self->tier_native = MP_OBJ_FROM_PTR(o);
+}
+
+// Count a call to a bytecode function, and return its native version if it has one.
+mp_obj_t mp_obj_fun_bc_get_tier_native(mp_obj_fun_bc_t *self) {
+    if (self->tier_native == MP_OBJ_NULL && self->rc != NULL && MP_STATE_VM(tier_threshold) != 0) {
+        mp_raw_code_t *rc = self->rc;
+        if (rc->tier_fun != MP_OBJ_NULL
+            || (rc->tier_scope_index != 0 && ++rc->tier_count >= MP_STATE_VM(tier_threshold))) {
+            fun_bc_tier_up(self);
+        }
+    }
+    return self->tier_native;
+}
 #endif
 
 static mp_obj_t fun_bc_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args) {
@@ -235,6 +351,13 @@ static mp_obj_t fun_bc_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const
 
     mp_obj_fun_bc_t *self = MP_OBJ_TO_PTR(self_in);
 
+    #if MICROPY_EMIT_NATIVE_TIERING
+    mp_obj_t tier_native = mp_obj_fun_bc_get_tier_native(self);
+    if (tier_native != MP_OBJ_NULL) {
+        return fun_native_call(tier_native, n_args, n_kw, args);
+    }
+    #endif
+
     size_t n_state, state_size;
     DECODE_CODESTATE_SIZE(self->bytecode, n_state, state_size);
 
@@ -336,6 +459,9 @@ void mp_obj_fun_bc_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
     }
     if (attr == MP_QSTR___globals__) {
         mp_obj_fun_bc_t *self = MP_OBJ_TO_PTR(self_in);
+        #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+        mp_module_lazy_resolve_all(self->context->module.globals);
+        #endif
         dest[0] = MP_OBJ_FROM_PTR(self->context->module.globals);
     }
 }
@@ -382,6 +508,12 @@ mp_obj_t mp_obj_new_fun_bc(const mp_obj_t *def_args, const byte *code, const mp_
     o->bytecode = code;
     o->context = context;
     o->child_table = child_table;
+    #if MICROPY_PY_SYS_SETTRACE || MICROPY_EMIT_NATIVE_TIERING
+    o->rc = NULL;
+    #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    o->tier_native = MP_OBJ_NULL;
+    #endif
     if (def_pos_args != NULL) {
         memcpy(o->extra_args, def_pos_args->items, n_def_args * sizeof(mp_obj_t));
     }
@@ -539,3 +671,18 @@ MP_DEFINE_CONST_OBJ_TYPE(
     );
 
 #endif // MICROPY_EMIT_INLINE_ASM
+
+/******************************************************************************/
+/* lazy functions                                                             */
+
+#if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+
+// Stubs only live in module globals, which replace them with the function they
+// stand for before it can be used, so they need nothing but a name.
+MP_DEFINE_CONST_OBJ_TYPE(
+    mp_type_fun_lazy,
+    MP_QSTR_function,
+    MP_TYPE_FLAG_NONE
+    );
+
+#endif // MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
@@ -34,8 +34,11 @@ typedef struct _mp_obj_fun_bc_t {
     const mp_module_context_t *context;         // context within which this function was defined
     struct _mp_raw_code_t *const *child_table;  // table of children
     const byte *bytecode;                       // bytecode for the function
-    #if MICROPY_PY_SYS_SETTRACE
-    const struct _mp_raw_code_t *rc;
+    #if MICROPY_PY_SYS_SETTRACE || MICROPY_EMIT_NATIVE_TIERING
+    struct _mp_raw_code_t *rc;
+    #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    mp_obj_t tier_native;                       // native version of this function, once hot
     #endif
     // the following extra_args array is allocated space to take (in order):
     //  - values of positional default args (if any)
@@ -52,6 +55,9 @@ typedef struct _mp_obj_fun_asm_t {
 
 mp_obj_t mp_obj_new_fun_bc(const mp_obj_t *def_args, const byte *code, const mp_module_context_t *cm, struct _mp_raw_code_t *const *raw_code_table);
 void mp_obj_fun_bc_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest);
+#if MICROPY_EMIT_NATIVE_TIERING
+mp_obj_t mp_obj_fun_bc_get_tier_native(mp_obj_fun_bc_t *self);
+#endif
 
 #if MICROPY_EMIT_NATIVE
 
@@ -30,6 +30,7 @@
 #include <assert.h>
 
 #include "py/bc.h"
+#include "py/emitglue.h"
 #include "py/objmodule.h"
 #include "py/runtime.h"
 #include "py/builtin.h"
@@ -59,22 +60,34 @@ static void module_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kin
 
 static void module_attr_try_delegation(mp_obj_t self_in, qstr attr, mp_obj_t *dest);
 
+static mp_obj_t module_get_value(mp_obj_dict_t *globals, mp_map_elem_t *elem) {
+    #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+    if (globals->map.is_lazy) {
+        return mp_module_lazy_resolve(globals, elem);
+    }
+    #endif
+    return elem->value;
+}
+
 static void module_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
     mp_obj_module_t *self = MP_OBJ_TO_PTR(self_in);
     if (dest[0] == MP_OBJ_NULL) {
         // load attribute
         mp_map_elem_t *elem = mp_map_lookup(&self->globals->map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
         if (elem != NULL) {
-            dest[0] = elem->value;
+            dest[0] = module_get_value(self->globals, elem);
         #if MICROPY_CPYTHON_COMPAT
         } else if (attr == MP_QSTR___dict__) {
+            #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+            mp_module_lazy_resolve_all(self->globals);
+            #endif
             dest[0] = MP_OBJ_FROM_PTR(self->globals);
         #endif
         #if MICROPY_MODULE_GETATTR
         } else if (attr != MP_QSTR___getattr__) {
             elem = mp_map_lookup(&self->globals->map, MP_OBJ_NEW_QSTR(MP_QSTR___getattr__), MP_MAP_LOOKUP);
             if (elem != NULL) {
-                dest[0] = mp_call_function_1(elem->value, MP_OBJ_NEW_QSTR(attr));
+                dest[0] = mp_call_function_1(module_get_value(self->globals, elem), MP_OBJ_NEW_QSTR(attr));
             } else {
                 module_attr_try_delegation(self_in, attr, dest);
             }
@@ -82,6 +95,13 @@ static void module_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
         } else {
             module_attr_try_delegation(self_in, attr, dest);
         }
+        #if MICROPY_COMP_CACHE_LOADS
+        if (elem == NULL) {
+            // a computed attribute may change at any time, so stop this load
+            // being cached by making it look like the namespace changed
+            MP_STATE_VM(namespace_version) += 1;
+        }
+        #endif
     } else {
         // delete/store attribute
         mp_obj_dict_t *dict = self->globals;
@@ -90,6 +110,7 @@ static void module_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
             if (dict == &mp_module_builtins_globals) {
                 if (MP_STATE_VM(mp_module_builtins_override_dict) == NULL) {
                     MP_STATE_VM(mp_module_builtins_override_dict) = MP_OBJ_TO_PTR(mp_obj_new_dict(1));
+                    MP_STATE_VM(mp_module_builtins_override_dict)->map.is_versioned = 1;
                 }
                 dict = MP_STATE_VM(mp_module_builtins_override_dict);
             } else
@@ -132,6 +153,7 @@ mp_obj_t mp_obj_new_module(qstr module_name) {
     mp_module_context_t *o = m_new_obj(mp_module_context_t);
     o->module.base.type = &mp_type_module;
     o->module.globals = MP_OBJ_TO_PTR(mp_obj_new_dict(MICROPY_MODULE_DICT_SIZE));
+    o->module.globals->map.is_versioned = 1;
 
     // store __name__ entry in the module
     mp_obj_dict_store(MP_OBJ_FROM_PTR(o->module.globals), MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(module_name));
@@ -143,6 +165,44 @@ mp_obj_t mp_obj_new_module(qstr module_name) {
     return MP_OBJ_FROM_PTR(o);
 }
 
+#if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+mp_obj_t mp_module_lazy_resolve(mp_obj_dict_t *globals, mp_map_elem_t *elem) {
+    mp_obj_t value = elem->value;
+    if (mp_obj_is_type(value, &mp_type_fun_lazy)) {
+        const mp_obj_module_lazy_globals_t *lazy = (const mp_obj_module_lazy_globals_t *)globals;
+        const mp_obj_fun_lazy_t *stub = MP_OBJ_TO_PTR(value);
+        mp_obj_t key = elem->key;
+        value = mp_make_function_from_proto_fun(stub->proto_fun, lazy->context, NULL);
+        // A finaliser run by the allocation may have changed the globals, so
+        // look the stub up again before replacing it.
+        elem = mp_map_lookup(&globals->map, key, MP_MAP_LOOKUP);
+        if (elem != NULL && elem->value == MP_OBJ_FROM_PTR(stub)) {
+            elem->value = value;
+        }
+    }
+    return value;
+}
+
+void mp_module_lazy_resolve_all(mp_obj_dict_t *globals) {
+    mp_map_t *map = &globals->map;
+    if (!map->is_lazy) {
+        // also covers ROM dicts, which can't be written to
+        return;
+    }
+    // Scan until no stubs are left, in case resolving one changed the map.
+    for (bool found = true; found;) {
+        found = false;
+        for (size_t i = 0; i < map->alloc; ++i) {
+            if (mp_map_slot_is_filled(map, i) && mp_obj_is_type(map->table[i].value, &mp_type_fun_lazy)) {
+                mp_module_lazy_resolve(globals, &map->table[i]);
+                found = true;
+            }
+        }
+    }
+    map->is_lazy = 0;
+}
+#endif
+
 /******************************************************************************/
 // Global module table and related functions
 
@@ -41,4 +41,12 @@ mp_obj_t mp_module_get_builtin(qstr module_name, bool extensible);
 
 void mp_module_generic_attr(qstr attr, mp_obj_t *dest, const uint16_t *keys, mp_obj_t *values);
 
+#if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+// Replace the lazy function stub at elem, if any, with its function and return
+// the value; globals must be a frozen module's mp_obj_module_lazy_globals_t.
+mp_obj_t mp_module_lazy_resolve(mp_obj_dict_t *globals, mp_map_elem_t *elem);
+// Replace all stubs, so the globals can be used as a normal dict.
+void mp_module_lazy_resolve_all(mp_obj_dict_t *globals);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_OBJMODULE_H
@@ -300,31 +300,112 @@ wrong_args:
     mp_raise_TypeError(MP_ERROR_TEXT("wrong number of arguments"));
 }
 
+#if MICROPY_OPT_STR_SEARCH
+// Boyer-Moore-Horspool search, used for needles long enough that the skip
+// table pays for itself.  Skip distances are capped at 255 so the table fits
+// in bytes; a smaller skip is always safe, it just advances more slowly.
+static const byte *find_subbytes_horspool(const byte *haystack, size_t hlen, const byte *needle, size_t nlen, int direction) {
+    byte skip[256];
+    size_t max_skip = nlen < 255 ? nlen : 255;
+    memset(skip, max_skip, sizeof(skip));
+    if (direction > 0) {
+        // skip is keyed on the last byte of the window
+        for (size_t i = nlen - max_skip; i < nlen - 1; ++i) {
+            skip[needle[i]] = nlen - 1 - i;
+        }
+        byte last = needle[nlen - 1];
+        const byte *p = haystack;
+        const byte *p_last = haystack + hlen - nlen;
+        for (;;) {
+            byte c = p[nlen - 1];
+            if (c == last && memcmp(p, needle, nlen - 1) == 0) {
+                return p;
+            }
+            if ((size_t)(p_last - p) < skip[c]) {
+                return NULL;
+            }
+            p += skip[c];
+        }
+    } else {
+        // skip is keyed on the first byte of the window
+        for (size_t i = max_skip - 1; i > 0; --i) {
+            skip[needle[i]] = i;
+        }
+        byte first = needle[0];
+        const byte *p = haystack + hlen - nlen;
+        for (;;) {
+            byte c = *p;
+            if (c == first && memcmp(p + 1, needle + 1, nlen - 1) == 0) {
+                return p;
+            }
+            if ((size_t)(p - haystack) < skip[c]) {
+                return NULL;
+            }
+            p -= skip[c];
+        }
+    }
+}
+#endif
+
 // like strstr but with specified length and allows \0 bytes
-// TODO replace with something more efficient/standard
 const byte *find_subbytes(const byte *haystack, size_t hlen, const byte *needle, size_t nlen, int direction) {
-    if (hlen >= nlen) {
-        size_t str_index, str_index_end;
-        if (direction > 0) {
-            str_index = 0;
-            str_index_end = hlen - nlen;
-        } else {
-            str_index = hlen - nlen;
-            str_index_end = 0;
+    if (hlen < nlen) {
+        return NULL;
+    }
+    #if MICROPY_OPT_STR_SEARCH
+    if (nlen == 0) {
+        return direction > 0 ? haystack : haystack + hlen;
+    }
+    if (direction > 0) {
+        // Use memchr to find candidates for the first byte, which the C
+        // library usually implements a word (or vector) at a time.
+        if (nlen == 1) {
+            return memchr(haystack, needle[0], hlen);
+        }
+        if (nlen < 4 || hlen < 64) {
+            const byte *p = haystack;
+            const byte *p_last = haystack + hlen - nlen;
+            while (p <= p_last && (p = memchr(p, needle[0], p_last - p + 1)) != NULL) {
+                if (memcmp(p + 1, needle + 1, nlen - 1) == 0) {
+                    return p;
+                }
+                ++p;
+            }
+            return NULL;
         }
-        for (;;) {
-            if (memcmp(&haystack[str_index], needle, nlen) == 0) {
-                // found
-                return haystack + str_index;
+    } else if (nlen < 4 || hlen < 64) {
+        for (const byte *p = haystack + hlen - nlen;; --p) {
+            if (*p == needle[0] && memcmp(p + 1, needle + 1, nlen - 1) == 0) {
+                return p;
             }
-            if (str_index == str_index_end) {
-                // not found
-                break;
+            if (p == haystack) {
+                return NULL;
             }
-            str_index += direction;
         }
     }
+    return find_subbytes_horspool(haystack, hlen, needle, nlen, direction);
+    #else
+    size_t str_index, str_index_end;
+    if (direction > 0) {
+        str_index = 0;
+        str_index_end = hlen - nlen;
+    } else {
+        str_index = hlen - nlen;
+        str_index_end = 0;
+    }
+    for (;;) {
+        if (memcmp(&haystack[str_index], needle, nlen) == 0) {
+            // found
+            return haystack + str_index;
+        }
+        if (str_index == str_index_end) {
+            // not found
+            break;
+        }
+        str_index += direction;
+    }
     return NULL;
+    #endif
 }
 
 // Note: this function is used to check if an object is a str or bytes, which
@@ -603,14 +684,8 @@ mp_obj_t mp_obj_str_split(size_t n_args, const mp_obj_t *args) {
 
         for (;;) {
             const byte *start = s;
-            for (;;) {
-                if (splits == 0 || s + sep_len > top) {
-                    s = top;
-                    break;
-                } else if (memcmp(s, sep_str, sep_len) == 0) {
-                    break;
-                }
-                s++;
+            if (splits == 0 || (s = find_subbytes(s, top - s, (const byte *)sep_str, sep_len, 1)) == NULL) {
+                s = top;
             }
             mp_obj_list_append(res, mp_obj_new_str_of_type(self_type, start, s - start));
             if (s >= top) {
@@ -1783,17 +1858,16 @@ static mp_obj_t str_count(size_t n_args, const mp_obj_t *args) {
         return MP_OBJ_NEW_SMALL_INT(utf8_charlen(start, end - start) + 1);
     }
 
-    bool is_str = self_type == &mp_type_str;
-
-    // count the occurrences
+    // count the non-overlapping occurrences; a match of a valid UTF-8 needle
+    // always starts on a character boundary so the search can be bytewise
     mp_int_t num_occurrences = 0;
-    for (const byte *haystack_ptr = start; haystack_ptr + needle_len <= end;) {
-        if (memcmp(haystack_ptr, needle, needle_len) == 0) {
-            num_occurrences++;
-            haystack_ptr += needle_len;
-        } else {
-            haystack_ptr = is_str ? utf8_next_char(haystack_ptr) : haystack_ptr + 1;
+    for (const byte *haystack_ptr = start; end - haystack_ptr >= (ptrdiff_t)needle_len;) {
+        haystack_ptr = find_subbytes(haystack_ptr, end - haystack_ptr, needle, needle_len, 1);
+        if (haystack_ptr == NULL) {
+            break;
         }
+        num_occurrences++;
+        haystack_ptr += needle_len;
     }
 
     return MP_OBJ_NEW_SMALL_INT(num_occurrences);
@@ -2217,6 +2291,24 @@ mp_obj_t mp_obj_new_str_copy(const mp_obj_type_t *type, const byte *data, size_t
     return MP_OBJ_FROM_PTR(o);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_ROM
+// Create a str/bytes object that references the given data rather than copying it.
+// If the type is str and the string data is already interned, then a qstr object is
+// returned.  For type=str, the input data must be valid utf-8.
+mp_obj_t mp_obj_new_str_static(const mp_obj_type_t *type, const byte *data, size_t len) {
+    if (type == &mp_type_str) {
+        qstr q = qstr_find_strn((const char *)data, len);
+        if (q != MP_QSTRnull) {
+            return MP_OBJ_NEW_QSTR(q);
+        }
+    }
+    mp_obj_str_t *o = MP_OBJ_TO_PTR(mp_obj_new_str_copy(type, NULL, len));
+    o->data = data;
+    o->hash = qstr_compute_hash(data, len);
+    return MP_OBJ_FROM_PTR(o);
+}
+#endif
+
 // Create a str/bytes object using the given data.  If the type is str and the string
 // data is already interned, then a qstr object is returned.  Otherwise new memory is
 // allocated for the object and the data is copied across.
@@ -98,13 +98,118 @@ static void uni_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t
     }
 }
 
+#if MICROPY_PY_BUILTINS_STR_UNICODE_INDEX
+
+// Strings shorter than this many bytes are cheap enough to scan directly.
+#define STR_INDEX_MIN_LEN (256)
+
+// Number of characters between consecutive entries in a sparse index.
+#define STR_INDEX_STRIDE (64)
+
+// Sparse index of a str, mapping character positions to byte offsets.  It
+// holds a reference to the string data, so the data can't be freed and
+// reused by a different string while the index is cached.
+typedef struct _mp_str_index_t {
+    const byte *data;
+    size_t len;
+    size_t charlen;
+    // Byte offset of every STR_INDEX_STRIDE'th character.  Empty if the
+    // string is pure ASCII, in which case characters and bytes coincide.
+    size_t offsets[];
+} mp_str_index_t;
+
+// Return the cached index for the given string data, optionally building it
+// if it's not cached.  Returns NULL if there is no index (or no memory for one).
+static mp_str_index_t *str_get_index(const byte *data, size_t len, bool build) {
+    // Indices are cached per thread so no locking is needed.  Keeping more
+    // than one means alternating between two strings doesn't thrash.
+    mp_str_index_t **cache = MP_STATE_THREAD(str_index_cache);
+    const size_t cache_len = MP_ARRAY_SIZE(MP_STATE_THREAD(str_index_cache));
+    for (size_t i = 0; i < cache_len; ++i) {
+        mp_str_index_t *idx = cache[i];
+        if (idx != NULL && idx->data == data && idx->len == len) {
+            memmove(&cache[1], &cache[0], i * sizeof(*cache));
+            cache[0] = idx;
+            return idx;
+        }
+    }
+    if (!build) {
+        return NULL;
+    }
+
+    size_t charlen = utf8_charlen(data, len);
+    size_t num_offsets = 0;
+    if (charlen != len) {
+        num_offsets = (charlen + STR_INDEX_STRIDE - 1) / STR_INDEX_STRIDE;
+    }
+    mp_str_index_t *idx = m_new_obj_var_maybe(mp_str_index_t, offsets, size_t, num_offsets);
+    if (idx == NULL) {
+        return NULL;
+    }
+    idx->data = data;
+    idx->len = len;
+    idx->charlen = charlen;
+    if (num_offsets != 0) {
+        size_t char_pos = 0;
+        for (size_t i = 0; i < len; ++i) {
+            if (!UTF8_IS_CONT(data[i])) {
+                if (char_pos % STR_INDEX_STRIDE == 0) {
+                    idx->offsets[char_pos / STR_INDEX_STRIDE] = i;
+                }
+                ++char_pos;
+            }
+        }
+    }
+
+    // Insert at the front, dropping the least-recently-used entry.
+    memmove(&cache[1], &cache[0], (cache_len - 1) * sizeof(*cache));
+    cache[0] = idx;
+    return idx;
+}
+
+static const byte *str_index_lookup(const mp_str_index_t *idx, mp_int_t i, bool is_slice) {
+    if (i < 0) {
+        i += idx->charlen;
+    }
+    if (i < 0 || (size_t)i >= idx->charlen) {
+        if (is_slice) {
+            return i < 0 ? idx->data : idx->data + idx->len;
+        }
+        mp_raise_msg(&mp_type_IndexError, MP_ERROR_TEXT("string index out of range"));
+    }
+    if (idx->charlen == idx->len) {
+        // pure ASCII
+        return idx->data + i;
+    }
+    const byte *s = idx->data + idx->offsets[i / STR_INDEX_STRIDE];
+    for (i %= STR_INDEX_STRIDE; i > 0; --i) {
+        ++s;
+        while (UTF8_IS_CONT(*s)) {
+            ++s;
+        }
+    }
+    return s;
+}
+
+#endif
+
 static mp_obj_t uni_unary_op(mp_unary_op_t op, mp_obj_t self_in) {
     GET_STR_DATA_LEN(self_in, str_data, str_len);
     switch (op) {
         case MP_UNARY_OP_BOOL:
             return mp_obj_new_bool(str_len != 0);
-        case MP_UNARY_OP_LEN:
+        case MP_UNARY_OP_LEN: {
+            #if MICROPY_PY_BUILTINS_STR_UNICODE_INDEX
+            // don't build an index just for len(), but use it if it exists
+            if (str_len >= STR_INDEX_MIN_LEN) {
+                mp_str_index_t *idx = str_get_index(str_data, str_len, false);
+                if (idx != NULL) {
+                    return MP_OBJ_NEW_SMALL_INT(idx->charlen);
+                }
+            }
+            #endif
             return MP_OBJ_NEW_SMALL_INT(utf8_charlen(str_data, str_len));
+        }
         default:
             return MP_OBJ_NULL; // op not supported
     }
@@ -135,6 +240,14 @@ const byte *str_index_to_ptr(const mp_obj_type_t *type, const byte *self_data, s
     } else if (!mp_obj_get_int_maybe(index, &i)) {
         mp_raise_msg_varg(&mp_type_TypeError, MP_ERROR_TEXT("string indices must be integers, not %s"), mp_obj_get_type_str(index));
     }
+    #if MICROPY_PY_BUILTINS_STR_UNICODE_INDEX
+    if (self_len >= STR_INDEX_MIN_LEN) {
+        mp_str_index_t *idx = str_get_index(self_data, self_len, true);
+        if (idx != NULL) {
+            return str_index_lookup(idx, i, is_slice);
+        }
+    }
+    #endif
     const byte *s, *top = self_data + self_len;
     if (i < 0) {
         // Negative indexing is performed by counting from the end of the string.
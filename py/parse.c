@@ -350,7 +350,7 @@ bool mp_parse_node_get_int_maybe(mp_parse_node_t pn, mp_obj_t *o) {
 }
 
 #if MICROPY_COMP_CONST_TUPLE || MICROPY_COMP_CONST
-static bool mp_parse_node_is_const(mp_parse_node_t pn) {
+bool mp_parse_node_is_const(mp_parse_node_t pn) {
     if (MP_PARSE_NODE_IS_SMALL_INT(pn)) {
         // Small integer.
         return true;
@@ -377,7 +377,7 @@ static bool mp_parse_node_is_const(mp_parse_node_t pn) {
     return false;
 }
 
-static mp_obj_t mp_parse_node_convert_to_obj(mp_parse_node_t pn) {
+mp_obj_t mp_parse_node_convert_to_obj(mp_parse_node_t pn) {
     assert(mp_parse_node_is_const(pn));
     if (MP_PARSE_NODE_IS_SMALL_INT(pn)) {
         mp_int_t arg = MP_PARSE_NODE_LEAF_SMALL_INT(pn);
@@ -543,7 +543,7 @@ static void push_result_node(parser_t *parser, mp_parse_node_t pn) {
 static mp_parse_node_t make_node_const_object(parser_t *parser, size_t src_line, mp_obj_t obj) {
     mp_parse_node_struct_t *pn = parser_alloc(parser, sizeof(mp_parse_node_struct_t) + sizeof(mp_obj_t));
     pn->source_line = src_line;
-    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D
+    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D && UINTPTR_MAX <= 0xffffffff
     // nodes are 32-bit pointers, but need to store 64-bit object
     pn->kind_num_nodes = RULE_const_object | (2 << 8);
     pn->nodes[0] = (uint64_t)obj;
@@ -1368,6 +1368,9 @@ mp_parse_tree_t mp_parse(mp_lexer_t *lex, mp_parse_input_kind_t input_kind) {
     // get the root parse node that we created
     assert(parser.result_stack_top == 1);
     parser.tree.root = parser.result_stack[0];
+    #if MICROPY_EMIT_NATIVE_TIERING
+    parser.tree.source_hash = lex->source_hash;
+    #endif
 
     // free the memory that we don't need anymore
     m_del(rule_stack_t, parser.rule_stack, parser.rule_stack_alloc);
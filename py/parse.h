@@ -83,7 +83,7 @@ static inline mp_parse_node_t mp_parse_node_new_leaf(size_t kind, mp_int_t arg)
 }
 
 static inline mp_obj_t mp_parse_node_extract_const_object(mp_parse_node_struct_t *pns) {
-    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D
+    #if MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_D && UINTPTR_MAX <= 0xffffffff
     // nodes are 32-bit pointers, but need to extract 64-bit object
     return (uint64_t)pns->nodes[0] | ((uint64_t)pns->nodes[1] << 32);
     #else
@@ -91,6 +91,10 @@ static inline mp_obj_t mp_parse_node_extract_const_object(mp_parse_node_struct_t
     #endif
 }
 
+#if MICROPY_COMP_CONST_TUPLE || MICROPY_COMP_CONST
+bool mp_parse_node_is_const(mp_parse_node_t pn);
+mp_obj_t mp_parse_node_convert_to_obj(mp_parse_node_t pn);
+#endif
 bool mp_parse_node_is_const_false(mp_parse_node_t pn);
 bool mp_parse_node_is_const_true(mp_parse_node_t pn);
 bool mp_parse_node_get_int_maybe(mp_parse_node_t pn, mp_obj_t *o);
@@ -106,6 +110,9 @@ typedef enum {
 typedef struct _mp_parse_t {
     mp_parse_node_t root;
     struct _mp_parse_chunk_t *chunk;
+    #if MICROPY_EMIT_NATIVE_TIERING
+    uint32_t source_hash; // hash of the source, to check it when recompiling
+    #endif
 } mp_parse_tree_t;
 
 // the parser will raise an exception if an error occurred
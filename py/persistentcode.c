@@ -167,6 +167,16 @@ static qstr load_qstr(mp_reader_t *reader) {
         return len >> 1;
     }
     len >>= 1;
+    #if MICROPY_PERSISTENT_CODE_LOAD_ROM
+    // If possible, reference the string data, and its null terminator, in place.
+    const byte *rom = mp_reader_try_read_rom(reader, len + 1);
+    if (rom != NULL) {
+        if (rom[len] != '\0') {
+            mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy file"));
+        }
+        return qstr_from_strn_static((const char *)rom, len);
+    }
+    #endif
     char *str = m_new(char, len);
     read_bytes(reader, (byte *)str, len);
     read_byte(reader); // read and discard null terminator
@@ -202,6 +212,17 @@ static mp_obj_t load_obj(mp_reader_t *reader) {
             }
             return MP_OBJ_FROM_PTR(tuple);
         }
+        #if MICROPY_PERSISTENT_CODE_LOAD_ROM
+        if (obj_type == MP_PERSISTENT_OBJ_STR || obj_type == MP_PERSISTENT_OBJ_BYTES) {
+            const byte *rom = mp_reader_try_read_rom(reader, len + 1);
+            if (rom != NULL) {
+                if (rom[len] != '\0') {
+                    mp_raise_ValueError(MP_ERROR_TEXT("incompatible .mpy file"));
+                }
+                return mp_obj_new_str_static(obj_type == MP_PERSISTENT_OBJ_STR ? &mp_type_str : &mp_type_bytes, rom, len);
+            }
+        }
+        #endif
         vstr_t vstr;
         vstr_init_len(&vstr, len);
         read_bytes(reader, (byte *)vstr.buf, len);
@@ -243,10 +264,17 @@ static mp_raw_code_t *load_raw_code(mp_reader_t *reader, mp_module_context_t *co
     #endif
 
     if (kind == MP_CODE_BYTECODE) {
-        // Allocate memory for the bytecode
-        fun_data = m_new(uint8_t, fun_data_len);
-        // Load bytecode
-        read_bytes(reader, fun_data, fun_data_len);
+        #if MICROPY_PERSISTENT_CODE_LOAD_ROM
+        // Bytecode is never written to, so reference it in place if possible.
+        fun_data = (uint8_t *)mp_reader_try_read_rom(reader, fun_data_len);
+        if (fun_data == NULL)
+        #endif
+        {
+            // Allocate memory for the bytecode
+            fun_data = m_new(uint8_t, fun_data_len);
+            // Load bytecode
+            read_bytes(reader, fun_data, fun_data_len);
+        }
 
     #if MICROPY_EMIT_MACHINE_CODE
     } else {
@@ -452,6 +480,14 @@ void mp_raw_code_load_mem(const byte *buf, size_t len, mp_compiled_module_t *con
     mp_raw_code_load(&reader, context);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_ROM
+void mp_raw_code_load_rom(const byte *buf, size_t len, mp_compiled_module_t *context) {
+    mp_reader_t reader;
+    mp_reader_new_mem(&reader, buf, len, MP_READER_IS_ROM);
+    mp_raw_code_load(&reader, context);
+}
+#endif
+
 #if MICROPY_HAS_FILE_READER
 
 void mp_raw_code_load_file(qstr filename, mp_compiled_module_t *context) {
@@ -596,6 +632,12 @@ static void save_raw_code(mp_print_t *print, const mp_raw_code_t *rc) {
 }
 
 void mp_raw_code_save(mp_compiled_module_t *cm, mp_print_t *print) {
+    #if !MICROPY_PERSISTENT_CODE_SAVE_NATIVE
+    if (cm->has_native) {
+        mp_raise_ValueError(MP_ERROR_TEXT("can't save native code"));
+    }
+    #endif
+
     // header contains:
     //  byte  'M'
     //  byte  version
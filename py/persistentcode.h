@@ -71,6 +71,10 @@
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_XTENSA)
 #elif MICROPY_EMIT_XTENSAWIN
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_XTENSAWIN)
+#elif MICROPY_EMIT_RV32
+    #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_RV32IMC)
+#elif MICROPY_EMIT_AARCH64
+    #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_AARCH64)
 #else
     #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_NONE)
 #endif
@@ -95,6 +99,8 @@ enum {
     MP_NATIVE_ARCH_ARMV7EMDP,
     MP_NATIVE_ARCH_XTENSA,
     MP_NATIVE_ARCH_XTENSAWIN,
+    MP_NATIVE_ARCH_RV32IMC,
+    MP_NATIVE_ARCH_AARCH64,
 };
 
 enum {
@@ -113,11 +119,21 @@ enum {
 
 void mp_raw_code_load(mp_reader_t *reader, mp_compiled_module_t *ctx);
 void mp_raw_code_load_mem(const byte *buf, size_t len, mp_compiled_module_t *ctx);
+#if MICROPY_PERSISTENT_CODE_LOAD_ROM
+// buf must be read-only and stay valid for the life of the program
+void mp_raw_code_load_rom(const byte *buf, size_t len, mp_compiled_module_t *ctx);
+#endif
 void mp_raw_code_load_file(qstr filename, mp_compiled_module_t *ctx);
 
 void mp_raw_code_save(mp_compiled_module_t *cm, mp_print_t *print);
 void mp_raw_code_save_file(mp_compiled_module_t *cm, qstr filename);
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+// Load the compiled code for a .py file from the cache in
+// MP_STATE_VM(persistent_code_cache_dir), or compile it and add it to the cache.
+void mp_raw_code_cache_load_file(qstr source_file, mp_compiled_module_t *cm);
+#endif
+
 void mp_native_relocate(void *reloc, uint8_t *text, uintptr_t reloc_text);
 
 #endif // MICROPY_INCLUDED_PY_PERSISTENTCODE_H
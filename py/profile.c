@@ -28,6 +28,7 @@
 #include "py/bc0.h"
 #include "py/gc.h"
 #include "py/objfun.h"
+#include "py/objmodule.h"
 
 #if MICROPY_PY_SYS_SETTRACE
 
@@ -236,6 +237,9 @@ static void frame_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
             dest[0] = MP_OBJ_FROM_PTR(o->code);
             break;
         case MP_QSTR_f_globals:
+            #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+            mp_module_lazy_resolve_all(o->code_state->fun_bc->context->module.globals);
+            #endif
             dest[0] = MP_OBJ_FROM_PTR(o->code_state->fun_bc->context->module.globals);
             break;
         case MP_QSTR_f_lasti:
@@ -585,6 +589,13 @@ static const byte *mp_prof_opcode_decode(const byte *ip, const mp_uint_t *const_
             instruction->qstr_opname = MP_QSTR_LOAD_SUBSCR;
             break;
 
+        case MP_BC_LOAD_FAST_CACHED:
+            DECODE_SLABEL;
+            instruction->qstr_opname = MP_QSTR_LOAD_FAST_CACHED;
+            instruction->arg = unum;
+            instruction->argobjex_cache = MP_OBJ_NEW_SMALL_INT(*ip++);
+            break;
+
         case MP_BC_STORE_FAST_N:
             DECODE_UINT;
             instruction->qstr_opname = MP_QSTR_STORE_FAST_N;
@@ -622,6 +633,16 @@ static const byte *mp_prof_opcode_decode(const byte *ip, const mp_uint_t *const_
             instruction->qstr_opname = MP_QSTR_STORE_SUBSCR;
             break;
 
+        case MP_BC_STORE_FAST_CACHED:
+            instruction->qstr_opname = MP_QSTR_STORE_FAST_CACHED;
+            instruction->arg = *ip++;
+            break;
+
+        case MP_BC_STORE_FAST_CACHED_ATTR:
+            instruction->qstr_opname = MP_QSTR_STORE_FAST_CACHED_ATTR;
+            instruction->arg = *ip++;
+            break;
+
         case MP_BC_DELETE_FAST:
             DECODE_UINT;
             instruction->qstr_opname = MP_QSTR_DELETE_FAST;
@@ -113,6 +113,10 @@ PY_CORE_O_BASENAME = $(addprefix py/,\
 	emitnxtensa.o \
 	emitinlinextensa.o \
 	emitnxtensawin.o \
+	asmrv32.o \
+	emitnrv32.o \
+	asmaarch64.o \
+	emitnaarch64.o \
 	formatfloat.o \
 	parsenumbase.o \
 	parsenum.o \
@@ -33,6 +33,10 @@
 // it can be called again after returning MP_READER_EOF, and in that case must return MP_READER_EOF
 #define MP_READER_EOF ((mp_uint_t)(-1))
 
+// free_len value for mp_reader_new_mem meaning that the memory is read-only and
+// stays valid for the life of the program, so it can be referenced in place
+#define MP_READER_IS_ROM ((size_t)(-1))
+
 typedef struct _mp_reader_t {
     void *data;
     mp_uint_t (*readbyte)(void *data);
@@ -43,4 +47,10 @@ void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t
 void mp_reader_new_file(mp_reader_t *reader, qstr filename);
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd);
 
+#if MICROPY_PERSISTENT_CODE_LOAD_ROM
+// Returns a pointer to the next len bytes and skips over them if the reader is
+// backed by ROM memory (see MP_READER_IS_ROM), otherwise returns NULL.
+const byte *mp_reader_try_read_rom(mp_reader_t *reader, size_t len);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_READER_H
@@ -69,6 +69,28 @@ void mp_init(void) {
 
     // no pending exceptions to start with
     MP_STATE_THREAD(mp_pending_exception) = MP_OBJ_NULL;
+
+    #if MICROPY_PY_BUILTINS_STR_UNICODE_INDEX
+    MP_STATE_THREAD(str_index_cache)[0] = NULL;
+    MP_STATE_THREAD(str_index_cache)[1] = NULL;
+    #endif
+
+    #if MICROPY_OPT_KWARG_SLOT_CACHE
+    // cached code pointers may not be valid on a new heap
+    memset(MP_STATE_THREAD(kwarg_slot_cache), 0, sizeof(MP_STATE_THREAD(kwarg_slot_cache)));
+    #endif
+
+    #if MICROPY_OPT_BUILTIN_CACHE
+    // cached globals dicts may not be valid on a new heap
+    memset(MP_STATE_THREAD(builtin_cache), 0, sizeof(MP_STATE_THREAD(builtin_cache)));
+    #endif
+
+    #if MP_STACKLESS_USE_POOL
+    // no frames to reuse yet
+    MP_STATE_THREAD(code_state_pool) = NULL;
+    MP_STATE_THREAD(code_state_pool_len) = 0;
+    #endif
+
     #if MICROPY_ENABLE_SCHEDULER
     // no pending callbacks to start with
     MP_STATE_VM(sched_state) = MP_SCHED_IDLE;
@@ -101,6 +123,10 @@ void mp_init(void) {
     #if MICROPY_EMIT_NATIVE
     MP_STATE_VM(default_emit_opt) = MP_EMIT_OPT_NONE;
     #endif
+    #if MICROPY_EMIT_NATIVE_TIERING
+    // tiered execution disabled by default
+    MP_STATE_VM(tier_threshold) = 0;
+    #endif
     #endif
 
     // init global module dict
@@ -108,6 +134,9 @@ void mp_init(void) {
 
     // initialise the __main__ module
     mp_obj_dict_init(&MP_STATE_VM(dict_main), 1);
+    MP_STATE_VM(dict_main).map.is_versioned = 1;
+    MP_STATE_VM(namespace_version) = 0;
+    MP_STATE_VM(namespace_keys_version) = 0;
     mp_obj_dict_store(MP_OBJ_FROM_PTR(&MP_STATE_VM(dict_main)), MP_OBJ_NEW_QSTR(MP_QSTR___name__), MP_OBJ_NEW_QSTR(MP_QSTR___main__));
 
     // locals = globals for outer module (see Objects/frameobject.c/PyFrame_New())
@@ -135,6 +164,12 @@ void mp_init(void) {
     MP_STATE_VM(vfs_mount_table) = NULL;
     #endif
 
+    #if MICROPY_PY_STRUCT
+    for (size_t i = 0; i < MICROPY_PY_STRUCT_CACHE_SIZE; ++i) {
+        MP_STATE_VM(struct_cache)[i] = NULL;
+    }
+    #endif
+
     #if MICROPY_PY_SYS_PATH_ARGV_DEFAULTS
     #if MICROPY_PY_SYS_PATH
     mp_sys_path = mp_obj_new_list(0, NULL);
@@ -223,7 +258,22 @@ mp_obj_t MICROPY_WRAP_MP_LOAD_NAME(mp_load_name)(qstr qst) {
 mp_obj_t MICROPY_WRAP_MP_LOAD_GLOBAL(mp_load_global)(qstr qst) {
     // logic: search globals, builtins
     DEBUG_OP_printf("load global %s\n", qstr_str(qst));
-    mp_map_elem_t *elem = mp_map_lookup(&mp_globals_get()->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+    mp_obj_dict_t *globals = mp_globals_get();
+    #if MICROPY_OPT_BUILTIN_CACHE
+    // A builtin found for this module stays the one to use until the module
+    // or the builtins override dict gains or loses a name.
+    mp_builtin_cache_entry_t *cache = &MP_STATE_THREAD(builtin_cache)[(((uintptr_t)globals >> 2) + qst) % MICROPY_OPT_BUILTIN_CACHE_SIZE];
+    if (cache->globals == globals && cache->name == qst
+        && cache->version == MP_STATE_VM(namespace_keys_version)) {
+        return cache->value;
+    }
+    #endif
+    mp_map_elem_t *elem = mp_map_lookup(&globals->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
+    #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+    if (elem != NULL && globals->map.is_lazy) {
+        return mp_module_lazy_resolve(globals, elem);
+    }
+    #endif
     if (elem == NULL) {
         #if MICROPY_CAN_OVERRIDE_BUILTINS
         if (MP_STATE_VM(mp_module_builtins_override_dict) != NULL) {
@@ -242,6 +292,15 @@ mp_obj_t MICROPY_WRAP_MP_LOAD_GLOBAL(mp_load_global)(qstr qst) {
             mp_raise_msg_varg(&mp_type_NameError, MP_ERROR_TEXT("name '%q' isn't defined"), qst);
             #endif
         }
+        #if MICROPY_OPT_BUILTIN_CACHE
+        // only versioned globals say when they gain a name that hides the builtin
+        if (globals->map.is_versioned) {
+            cache->globals = globals;
+            cache->name = qst;
+            cache->version = MP_STATE_VM(namespace_keys_version);
+            cache->value = elem->value;
+        }
+        #endif
     }
     return elem->value;
 }
@@ -412,6 +471,43 @@ mp_obj_t MICROPY_WRAP_MP_BINARY_OP(mp_binary_op)(mp_binary_op_t op, mp_obj_t lhs
         goto unsupported_op;
     }
 
+    #if MICROPY_PY_BUILTINS_FLOAT && MICROPY_OPT_FLOAT_BINARY_OP
+    if (mp_obj_is_float(lhs) && mp_obj_is_float(rhs)) {
+        // Common operations are done inline, the rest (and division by
+        // zero) go via the type's binary_op slot below.
+        mp_float_t lhs_val = mp_obj_float_get(lhs);
+        mp_float_t rhs_val = mp_obj_float_get(rhs);
+        switch (op) {
+            case MP_BINARY_OP_ADD:
+            case MP_BINARY_OP_INPLACE_ADD:
+                return mp_obj_new_float(lhs_val + rhs_val);
+            case MP_BINARY_OP_SUBTRACT:
+            case MP_BINARY_OP_INPLACE_SUBTRACT:
+                return mp_obj_new_float(lhs_val - rhs_val);
+            case MP_BINARY_OP_MULTIPLY:
+            case MP_BINARY_OP_INPLACE_MULTIPLY:
+                return mp_obj_new_float(lhs_val * rhs_val);
+            case MP_BINARY_OP_TRUE_DIVIDE:
+            case MP_BINARY_OP_INPLACE_TRUE_DIVIDE:
+                if (rhs_val == 0) {
+                    // let the slow path raise ZeroDivisionError
+                    break;
+                }
+                return mp_obj_new_float(lhs_val / rhs_val);
+            case MP_BINARY_OP_LESS:
+                return mp_obj_new_bool(lhs_val < rhs_val);
+            case MP_BINARY_OP_MORE:
+                return mp_obj_new_bool(lhs_val > rhs_val);
+            case MP_BINARY_OP_LESS_EQUAL:
+                return mp_obj_new_bool(lhs_val <= rhs_val);
+            case MP_BINARY_OP_MORE_EQUAL:
+                return mp_obj_new_bool(lhs_val >= rhs_val);
+            default:
+                break;
+        }
+    }
+    #endif
+
     if (mp_obj_is_small_int(lhs)) {
         mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
         if (mp_obj_is_small_int(rhs)) {
@@ -733,11 +829,21 @@ mp_obj_t mp_call_method_n_kw(size_t n_args, size_t n_kw, const mp_obj_t *args) {
     return mp_call_function_n_kw(args[0], n_args + adjust, n_kw, args + 2 - adjust);
 }
 
-// This function only needs to be exposed externally when in stackless mode.
-#if !MICROPY_STACKLESS
-static
-#endif
-void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_obj_t *args, mp_call_args_t *out_args) {
+// Grow an args array built by call_prepare_args_n_kw_var, moving it off the
+// caller's stack buffer if it was using that.
+static mp_obj_t *call_args_grow(mp_obj_t *args, size_t old_alloc, size_t new_alloc, mp_obj_t *stack_args) {
+    if (args == stack_args) {
+        mp_obj_t *new_args = mp_nonlocal_alloc(new_alloc * sizeof(mp_obj_t));
+        mp_seq_copy(new_args, args, old_alloc, mp_obj_t);
+        return new_args;
+    }
+    return mp_nonlocal_realloc(args, old_alloc * sizeof(mp_obj_t), new_alloc * sizeof(mp_obj_t));
+}
+
+// If stack_args is not NULL then the new args array is built there when it
+// fits in stack_args_len entries, and out_args->args must only be freed if it
+// isn't stack_args.
+static void call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_obj_t *args, mp_call_args_t *out_args, mp_obj_t *stack_args, size_t stack_args_len) {
     mp_obj_t fun = *args++;
     mp_obj_t self = MP_OBJ_NULL;
     if (have_self) {
@@ -792,7 +898,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
 
         // allocate memory for the new array of args
         args2_alloc = 1 + n_args + 2 * (n_kw + kw_dict_len);
-        args2 = mp_nonlocal_alloc(args2_alloc * sizeof(mp_obj_t));
+        args2 = args2_alloc <= stack_args_len ? stack_args : mp_nonlocal_alloc(args2_alloc * sizeof(mp_obj_t));
 
         // copy the self
         if (self != MP_OBJ_NULL) {
@@ -807,7 +913,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
 
         // allocate memory for the new array of args
         args2_alloc = 1 + n_args + list_len + 2 * (n_kw + kw_dict_len);
-        args2 = mp_nonlocal_alloc(args2_alloc * sizeof(mp_obj_t));
+        args2 = args2_alloc <= stack_args_len ? stack_args : mp_nonlocal_alloc(args2_alloc * sizeof(mp_obj_t));
 
         // copy the self
         if (self != MP_OBJ_NULL) {
@@ -839,8 +945,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
                     mp_obj_t item;
                     while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
                         if (args2_len + (n_args - i) >= args2_alloc) {
-                            args2 = mp_nonlocal_realloc(args2, args2_alloc * sizeof(mp_obj_t),
-                                args2_alloc * 2 * sizeof(mp_obj_t));
+                            args2 = call_args_grow(args2, args2_alloc, args2_alloc * 2, stack_args);
                             args2_alloc *= 2;
                         }
                         args2[args2_len++] = item;
@@ -860,8 +965,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
     // ensure there is still enough room for kw args
     if (args2_len + 2 * (n_kw + kw_dict_len) > args2_alloc) {
         size_t new_alloc = args2_len + 2 * (n_kw + kw_dict_len);
-        args2 = mp_nonlocal_realloc(args2, args2_alloc * sizeof(mp_obj_t),
-            new_alloc * sizeof(mp_obj_t));
+        args2 = call_args_grow(args2, args2_alloc, new_alloc, stack_args);
         args2_alloc = new_alloc;
     }
 
@@ -902,7 +1006,7 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
                     // expand size of args array if needed
                     if (args2_len + 1 >= args2_alloc) {
                         size_t new_alloc = args2_alloc * 2;
-                        args2 = mp_nonlocal_realloc(args2, args2_alloc * sizeof(mp_obj_t), new_alloc * sizeof(mp_obj_t));
+                        args2 = call_args_grow(args2, args2_alloc, new_alloc, stack_args);
                         args2_alloc = new_alloc;
                     }
 
@@ -936,12 +1040,24 @@ void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_
     out_args->n_alloc = args2_alloc;
 }
 
+#if MICROPY_STACKLESS
+void mp_call_prepare_args_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_obj_t *args, mp_call_args_t *out_args) {
+    // the args array must outlive this C call, so it can't be on the stack
+    call_prepare_args_n_kw_var(have_self, n_args_n_kw, args, out_args, NULL, 0);
+}
+#endif
+
 mp_obj_t mp_call_method_n_kw_var(bool have_self, size_t n_args_n_kw, const mp_obj_t *args) {
+    // Most calls with * or ** args have only a few arguments once unpacked, so
+    // build them on the stack to save allocating (and freeing) them on the heap.
+    mp_obj_t stack_args[MICROPY_CALL_VAR_STACK_ARGS];
     mp_call_args_t out_args;
-    mp_call_prepare_args_n_kw_var(have_self, n_args_n_kw, args, &out_args);
+    call_prepare_args_n_kw_var(have_self, n_args_n_kw, args, &out_args, stack_args, MICROPY_CALL_VAR_STACK_ARGS);
 
     mp_obj_t res = mp_call_function_n_kw(out_args.fun, out_args.n_args, out_args.n_kw, out_args.args);
-    mp_nonlocal_free(out_args.args, out_args.n_alloc * sizeof(mp_obj_t));
+    if (out_args.args != stack_args) {
+        mp_nonlocal_free(out_args.args, out_args.n_alloc * sizeof(mp_obj_t));
+    }
 
     return res;
 }
@@ -1581,7 +1697,12 @@ void mp_import_all(mp_obj_t module) {
     DEBUG_printf("import all %p\n", module);
 
     // TODO: Support __all__
-    mp_map_t *map = &mp_obj_module_get_globals(module)->map;
+    mp_obj_dict_t *globals = mp_obj_module_get_globals(module);
+    #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+    // the importing module gets the functions themselves
+    mp_module_lazy_resolve_all(globals);
+    #endif
+    mp_map_t *map = &globals->map;
     for (size_t i = 0; i < map->alloc; i++) {
         if (mp_map_slot_is_filled(map, i)) {
             // Entry in module global scope may be generated programmatically
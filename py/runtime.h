@@ -165,10 +165,39 @@ static inline void mp_thread_init_state(mp_state_thread_t *ts, size_t stack_size
     // GC starts off unlocked
     ts->gc_lock_depth = 0;
 
+    #if MICROPY_GC_POOL
+    // Allocation pools start off empty
+    for (size_t i = 0; i < MICROPY_GC_POOL_MAX_BLOCKS; ++i) {
+        ts->gc_pool[i] = NULL;
+    }
+    #endif
+
     // There are no pending jump callbacks or exceptions yet
     ts->nlr_jump_callback_top = NULL;
     ts->mp_pending_exception = MP_OBJ_NULL;
 
+    #if MICROPY_PY_BUILTINS_STR_UNICODE_INDEX
+    ts->str_index_cache[0] = NULL;
+    ts->str_index_cache[1] = NULL;
+    #endif
+
+    #if MICROPY_OPT_KWARG_SLOT_CACHE
+    for (size_t i = 0; i < MICROPY_OPT_KWARG_SLOT_CACHE_SIZE; ++i) {
+        ts->kwarg_slot_cache[i].code = NULL;
+    }
+    #endif
+
+    #if MICROPY_OPT_BUILTIN_CACHE
+    for (size_t i = 0; i < MICROPY_OPT_BUILTIN_CACHE_SIZE; ++i) {
+        ts->builtin_cache[i].globals = NULL;
+    }
+    #endif
+
+    #if MP_STACKLESS_USE_POOL
+    ts->code_state_pool = NULL;
+    ts->code_state_pool_len = 0;
+    #endif
+
     // If locals/globals are not given, inherit from main thread
     if (locals == NULL) {
         locals = mp_state_ctx.thread.dict_locals;
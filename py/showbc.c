@@ -253,6 +253,12 @@ const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start,
             mp_printf(print, "LOAD_SUBSCR");
             break;
 
+        case MP_BC_LOAD_FAST_CACHED:
+            DECODE_SLABEL;
+            mp_printf(print, "LOAD_FAST_CACHED " UINT_FMT " %d", (mp_uint_t)(ip + unum - ip_start), *ip);
+            ip += 1;
+            break;
+
         case MP_BC_STORE_FAST_N:
             DECODE_UINT;
             mp_printf(print, "STORE_FAST_N " UINT_FMT, unum);
@@ -282,6 +288,14 @@ const byte *mp_bytecode_print_str(const mp_print_t *print, const byte *ip_start,
             mp_printf(print, "STORE_SUBSCR");
             break;
 
+        case MP_BC_STORE_FAST_CACHED:
+            mp_printf(print, "STORE_FAST_CACHED %d", *ip++);
+            break;
+
+        case MP_BC_STORE_FAST_CACHED_ATTR:
+            mp_printf(print, "STORE_FAST_CACHED_ATTR %d", *ip++);
+            break;
+
         case MP_BC_DELETE_FAST:
             DECODE_UINT;
             mp_printf(print, "DELETE_FAST " UINT_FMT, unum);
@@ -86,6 +86,29 @@
         } \
     } while (0)
 
+#if MICROPY_EMIT_NATIVE_TIERING
+// count a backward jump (ie a loop iteration) towards tiering up to native code
+#define TIER_COUNT_JUMP(slab) \
+    do { \
+        mp_raw_code_t *tier_rc = code_state->fun_bc->rc; \
+        if ((mp_int_t)(slab) < 0 && tier_rc != NULL && tier_rc->tier_scope_index != 0) { \
+            tier_rc->tier_count += 1; \
+        } \
+    } while (0)
+#else
+#define TIER_COUNT_JUMP(slab) (void)0
+#endif
+
+#if MICROPY_STACKLESS
+#if MICROPY_EMIT_NATIVE_TIERING
+// a bytecode function that has tiered up to native code is called the normal way
+#define STACKLESS_CAN_CALL(fun) \
+    (mp_obj_get_type(fun) == &mp_type_fun_bc && mp_obj_fun_bc_get_tier_native(MP_OBJ_TO_PTR(fun)) == MP_OBJ_NULL)
+#else
+#define STACKLESS_CAN_CALL(fun) (mp_obj_get_type(fun) == &mp_type_fun_bc)
+#endif
+#endif
+
 #if MICROPY_EMIT_BYTECODE_USES_QSTR_TABLE
 
 #define DECODE_QSTR \
@@ -392,6 +415,24 @@ dispatch_loop:
                     DISPATCH();
                 }
 
+                ENTRY(MP_BC_LOAD_FAST_CACHED): {
+                    // the operand byte is a pair of hidden locals holding a cached value
+                    // and the namespace version it was loaded at
+                    DECODE_SLABEL;
+                    mp_obj_t *cache = &fastn[-*ip];
+                    mp_obj_t version = MP_OBJ_NEW_SMALL_INT(MP_STATE_VM(namespace_version));
+                    if (cache[-1] == version) {
+                        // still valid, skip the code that loads and caches the value
+                        PUSH(cache[0]);
+                        ip += slab;
+                    } else {
+                        // stale, push the version for the following STORE_FAST_CACHED
+                        PUSH(version);
+                        ip += 1;
+                    }
+                    DISPATCH();
+                }
+
                 ENTRY(MP_BC_LOAD_ATTR): {
                     FRAME_UPDATE();
                     MARK_EXC_IP_SELECTIVE();
@@ -488,6 +529,38 @@ dispatch_loop:
                     sp -= 3;
                     DISPATCH();
 
+                ENTRY(MP_BC_STORE_FAST_CACHED_ATTR): {
+                    // stack is (..., version, module, value); the value can be cached if
+                    // it came from a namespace that is versioned or can't change
+                    mp_obj_t value = POP();
+                    mp_obj_t base = TOP();
+                    SET_TOP(value);
+                    if (mp_obj_is_type(base, &mp_type_module)) {
+                        const mp_map_t *map = &((mp_obj_module_t *)MP_OBJ_TO_PTR(base))->globals->map;
+                        if (map->is_versioned || map->is_fixed) {
+                            goto store_fast_cached;
+                        }
+                    }
+                    ip += 1;
+                    sp -= 1;
+                    SET_TOP(value);
+                    DISPATCH();
+                }
+
+                ENTRY(MP_BC_STORE_FAST_CACHED): {
+                store_fast_cached:;
+                    // stack is (..., version, value); cache them unless the globals
+                    // dict is one that isn't versioned, eg from exec()
+                    mp_obj_t *cache = &fastn[-*ip++];
+                    mp_obj_t value = POP();
+                    if (mp_globals_get()->map.is_versioned) {
+                        cache[0] = value;
+                        cache[-1] = TOP();
+                    }
+                    SET_TOP(value);
+                    DISPATCH();
+                }
+
                 ENTRY(MP_BC_DELETE_FAST): {
                     MARK_EXC_IP_SELECTIVE();
                     DECODE_UINT;
@@ -555,6 +628,7 @@ dispatch_loop:
 
                 ENTRY(MP_BC_JUMP): {
                     DECODE_SLABEL;
+                    TIER_COUNT_JUMP(slab);
                     ip += slab;
                     DISPATCH_WITH_PEND_EXC_CHECK();
                 }
@@ -562,6 +636,7 @@ dispatch_loop:
                 ENTRY(MP_BC_POP_JUMP_IF_TRUE): {
                     DECODE_SLABEL;
                     if (mp_obj_is_true(POP())) {
+                        TIER_COUNT_JUMP(slab);
                         ip += slab;
                     }
                     DISPATCH_WITH_PEND_EXC_CHECK();
@@ -570,6 +645,7 @@ dispatch_loop:
                 ENTRY(MP_BC_POP_JUMP_IF_FALSE): {
                     DECODE_SLABEL;
                     if (!mp_obj_is_true(POP())) {
+                        TIER_COUNT_JUMP(slab);
                         ip += slab;
                     }
                     DISPATCH_WITH_PEND_EXC_CHECK();
@@ -893,6 +969,17 @@ unwind_jump:;
 
                 ENTRY(MP_BC_MAKE_FUNCTION): {
                     DECODE_PTR;
+                    #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS
+                    if (*ip == MP_BC_STORE_NAME && mp_globals_get()->map.is_lazy) {
+                        // a frozen module defining a top-level function stores its
+                        // stub instead, see mp_module_lazy_resolve()
+                        const mp_obj_module_lazy_globals_t *lazy = (const mp_obj_module_lazy_globals_t *)mp_globals_get();
+                        if (code_state->fun_bc->child_table == lazy->children) {
+                            PUSH(MP_OBJ_FROM_PTR(&lazy->lazy_funs[unum]));
+                            DISPATCH();
+                        }
+                    }
+                    #endif
                     PUSH(mp_make_function_from_proto_fun(ptr, code_state->fun_bc->context, NULL));
                     DISPATCH();
                 }
@@ -931,7 +1018,7 @@ unwind_jump:;
                     // (unum >> 8) & 0xff == n_keyword
                     sp -= (unum & 0xff) + ((unum >> 7) & 0x1fe);
                     #if MICROPY_STACKLESS
-                    if (mp_obj_get_type(*sp) == &mp_type_fun_bc) {
+                    if (STACKLESS_CAN_CALL(*sp)) {
                         code_state->ip = ip;
                         code_state->sp = sp;
                         code_state->exc_sp_idx = MP_CODE_STATE_EXC_SP_IDX_FROM_PTR(exc_stack, exc_sp);
@@ -968,7 +1055,7 @@ unwind_jump:;
                     // fun arg0 arg1 ... kw0 val0 kw1 val1 ... bitmap <- TOS
                     sp -= (unum & 0xff) + ((unum >> 7) & 0x1fe) + 1;
                     #if MICROPY_STACKLESS
-                    if (mp_obj_get_type(*sp) == &mp_type_fun_bc) {
+                    if (STACKLESS_CAN_CALL(*sp)) {
                         code_state->ip = ip;
                         code_state->sp = sp;
                         code_state->exc_sp_idx = MP_CODE_STATE_EXC_SP_IDX_FROM_PTR(exc_stack, exc_sp);
@@ -1012,7 +1099,7 @@ unwind_jump:;
                     // (unum >> 8) & 0xff == n_keyword
                     sp -= (unum & 0xff) + ((unum >> 7) & 0x1fe) + 1;
                     #if MICROPY_STACKLESS
-                    if (mp_obj_get_type(*sp) == &mp_type_fun_bc) {
+                    if (STACKLESS_CAN_CALL(*sp)) {
                         code_state->ip = ip;
                         code_state->sp = sp;
                         code_state->exc_sp_idx = MP_CODE_STATE_EXC_SP_IDX_FROM_PTR(exc_stack, exc_sp);
@@ -1053,7 +1140,7 @@ unwind_jump:;
                     // fun self arg0 arg1 ... kw0 val0 kw1 val1 ... bitmap <- TOS
                     sp -= (unum & 0xff) + ((unum >> 7) & 0x1fe) + 2;
                     #if MICROPY_STACKLESS
-                    if (mp_obj_get_type(*sp) == &mp_type_fun_bc) {
+                    if (STACKLESS_CAN_CALL(*sp)) {
                         code_state->ip = ip;
                         code_state->sp = sp;
                         code_state->exc_sp_idx = MP_CODE_STATE_EXC_SP_IDX_FROM_PTR(exc_stack, exc_sp);
@@ -1132,13 +1219,7 @@ unwind_return:
                         mp_obj_t res = *sp;
                         mp_globals_set(code_state->old_globals);
                         mp_code_state_t *new_code_state = code_state->prev;
-                        #if MICROPY_ENABLE_PYSTACK
-                        // Free code_state, and args allocated by mp_call_prepare_args_n_kw_var
-                        // (The latter is implicitly freed when using pystack due to its LIFO nature.)
-                        // The sizeof in the following statement does not include the size of the variable
-                        // part of the struct.  This arg is anyway not used if pystack is enabled.
-                        mp_nonlocal_free(code_state, sizeof(mp_code_state_t));
-                        #endif
+                        mp_obj_fun_bc_free_codestate(code_state);
                         code_state = new_code_state;
                         *code_state->sp = res;
                         goto run_code_state_from_return;
@@ -1461,13 +1542,7 @@ unwind_loop:
             } else if (code_state->prev != NULL) {
                 mp_globals_set(code_state->old_globals);
                 mp_code_state_t *new_code_state = code_state->prev;
-                #if MICROPY_ENABLE_PYSTACK
-                // Free code_state, and args allocated by mp_call_prepare_args_n_kw_var
-                // (The latter is implicitly freed when using pystack due to its LIFO nature.)
-                // The sizeof in the following statement does not include the size of the variable
-                // part of the struct.  This arg is anyway not used if pystack is enabled.
-                mp_nonlocal_free(code_state, sizeof(mp_code_state_t));
-                #endif
+                mp_obj_fun_bc_free_codestate(code_state);
                 code_state = new_code_state;
                 size_t n_state = code_state->n_state;
                 fastn = &code_state->state[n_state - 1];
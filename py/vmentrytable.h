@@ -53,12 +53,15 @@ static const void *const entry_table[256] = {
     [MP_BC_LOAD_SUPER_METHOD] = &&entry_MP_BC_LOAD_SUPER_METHOD,
     [MP_BC_LOAD_BUILD_CLASS] = &&entry_MP_BC_LOAD_BUILD_CLASS,
     [MP_BC_LOAD_SUBSCR] = &&entry_MP_BC_LOAD_SUBSCR,
+    [MP_BC_LOAD_FAST_CACHED] = &&entry_MP_BC_LOAD_FAST_CACHED,
     [MP_BC_STORE_FAST_N] = &&entry_MP_BC_STORE_FAST_N,
     [MP_BC_STORE_DEREF] = &&entry_MP_BC_STORE_DEREF,
     [MP_BC_STORE_NAME] = &&entry_MP_BC_STORE_NAME,
     [MP_BC_STORE_GLOBAL] = &&entry_MP_BC_STORE_GLOBAL,
     [MP_BC_STORE_ATTR] = &&entry_MP_BC_STORE_ATTR,
     [MP_BC_STORE_SUBSCR] = &&entry_MP_BC_STORE_SUBSCR,
+    [MP_BC_STORE_FAST_CACHED] = &&entry_MP_BC_STORE_FAST_CACHED,
+    [MP_BC_STORE_FAST_CACHED_ATTR] = &&entry_MP_BC_STORE_FAST_CACHED_ATTR,
     [MP_BC_DELETE_FAST] = &&entry_MP_BC_DELETE_FAST,
     [MP_BC_DELETE_DEREF] = &&entry_MP_BC_DELETE_DEREF,
     [MP_BC_DELETE_NAME] = &&entry_MP_BC_DELETE_NAME,
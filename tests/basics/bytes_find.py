@@ -24,3 +24,7 @@ print(b"0000".find(b'1', 5))
 
 # Non-ascii values (make sure not treated as unicode-like)
 print(b"\x80abc".find(b"a", 1))
+
+# long haystack and needle, to exercise skip-table based search
+b = b"\x00\x80\xff" * 40 + b"needle" + b"\x00\x80\xff" * 40
+print(b.find(b"\xffneedle\x00"), b.find(b"\x80\xff\x00\x80"), b.find(b"\xffneedlf"))
@@ -0,0 +1,40 @@
+# test repeated calls with keyword arguments, which may bind them from a cache
+
+def f(a, b=0, c=0):
+    return (a, b, c)
+
+def g(c, b=0, a=0):
+    return (a, b, c)
+
+for i in range(3):
+    print(f(1, c=3, b=2), g(1, a=3, b=2), f(a=4), g(c=5))
+
+# a multiple-value error is still detected after the slot is known
+for i in range(2):
+    try:
+        f(1, a=2)
+    except TypeError:
+        print("TypeError")
+
+# functions redefined with different argument order
+for i in range(3):
+    exec("def h({}, {}): return (x, y)".format(*("xy" if i % 2 else "yx")))
+    print(h(x=1, y=2), h(1, y=2) if i % 2 else h(2, x=1))
+
+# methods and constructors
+class A:
+    def __init__(self, x, y=0):
+        self.xy = (x, y)
+
+    def m(self, p, q=0):
+        return (self.xy, p, q)
+
+for i in range(2):
+    print(A(y=1, x=2).m(q=3, p=4))
+
+# unpacked * and ** args, both fitting and not fitting on the stack
+def v(*args, **kwargs):
+    return (args, sorted(kwargs.items()))
+
+for n in (0, 3, 8, 20):
+    print(v(*range(n)), v(*iter(range(n))), v(**{str(i): i for i in range(n)}))
@@ -0,0 +1,34 @@
+# test that loading a builtin sees the globals that shadow it as they come and go
+
+
+def f():
+    return len("abc")
+
+
+print(f(), len("ab"))
+len = lambda x: "global"
+print(f(), len("ab"))
+del len
+print(f(), len("ab"))
+globals()["len"] = lambda x: "globals()"
+print(f(), len("ab"))
+globals().pop("len")
+print(f(), len("ab"))
+
+# shadowing in the middle of a loop
+for i in range(4):
+    if i % 2:
+        len = lambda x: "loop"
+    elif i:
+        del len
+    print(f())
+del len
+
+# code using its own dict for globals
+g = {}
+exec("def f():\n    return len('ab')", g)
+print(g["f"]())
+g["len"] = lambda x: "exec"
+print(g["f"]())
+del g["len"]
+print(g["f"]())
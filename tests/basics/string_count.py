@@ -53,6 +53,9 @@ def t():
 
 print("0000".count('0', t()))
 
+# non-overlapping counts over a long string
+print(("ab" * 100).count("abab"), ("ab" * 100).count("baba"), ("a" * 100).count("aaa"))
+
 try:
     'abc'.count(1)
 except TypeError:
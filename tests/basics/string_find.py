@@ -23,6 +23,12 @@ print("0000".find('1', 4))
 print("0000".find('1', 5))
 print("aaaaaaaaaaa".find("bbb", 9, 2))
 
+# long haystack and needle, to exercise skip-table based search
+s = "abcdefgh" * 20 + "xyz" + "abcdefgh" * 20
+print(s.find("hxyza"), s.find("hxyzb"), s.find("abcdefgha"), s.find("hab"))
+print(s.rfind("hxyza"), s.rfind("hxyzb"), s.rfind("abcdefgha"), s.rfind("hab"))
+print(s.find("abcdefgh" * 33), s.find("defgh" * 2, 100, 150))
+
 try:
     'abc'.find(1)
 except TypeError:
@@ -0,0 +1,59 @@
+# test struct.Struct and struct.iter_unpack
+
+try:
+    import struct
+
+    struct.Struct
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+s = struct.Struct("<hI2s")
+print(s.size, s.format)
+b = s.pack(-2, 0x12345678, b"abc")
+print(b)
+print(s.unpack(b))
+print(s.unpack_from(b"xx" + b, 2))
+print(s.unpack_from(memoryview(b"xx" + b), -8))
+
+buf = bytearray(12)
+s.pack_into(buf, 2, 1, 2, b"z")
+print(buf)
+s.pack_into(buf, -8, 3, 4, b"yz")
+print(buf)
+
+# native alignment
+s = struct.Struct("bi")
+print(s.size == struct.calcsize("bi"), s.unpack(s.pack(1, 2)))
+
+# iteration over a buffer of records
+s = struct.Struct(">HB")
+data = bytes(range(12))
+print(list(s.iter_unpack(data)))
+print(list(struct.iter_unpack("<h", memoryview(data)[4:8])))
+print(list(struct.iter_unpack("<h", b"")))
+
+try:
+    s.iter_unpack(b"12345")
+except Exception:
+    print("Exception")
+
+try:
+    struct.iter_unpack("", b"")
+except Exception:
+    print("Exception")
+
+try:
+    s.unpack(b"1")
+except Exception:
+    print("Exception")
+
+try:
+    struct.Struct("<Z")
+except Exception:
+    print("Exception")
+
+# many different formats, to cycle through the format cache
+for i in range(10):
+    fmt = "<" + "B" * i + "H"
+    print(struct.unpack(fmt, struct.pack(fmt, *range(i + 1))))
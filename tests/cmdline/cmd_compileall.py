@@ -0,0 +1,65 @@
+# cmdline: -X pycache=cmd_compileall_dir
+# test -X compileall filling the cache that imports then load from
+import os, sys
+
+try:
+    os.system
+    sys.executable
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+src = "cmd_compileall_src"
+cache = "cmd_compileall_dir"
+
+
+def write(name, text):
+    with open(src + "/" + name, "w") as f:
+        f.write(text)
+
+
+def compileall(path):
+    cmd = "{} -X pycache={} -X compileall={} 2>/dev/null"
+    return os.system(cmd.format(sys.executable, cache, path)) != 0
+
+
+def remove(d):
+    for name in os.listdir(d):
+        if os.stat(d + "/" + name)[0] & 0x4000:
+            remove(d + "/" + name)
+        else:
+            os.remove(d + "/" + name)
+    os.rmdir(d)
+
+
+os.mkdir(src)
+os.mkdir(src + "/pkg")
+os.mkdir(src + "/.hidden")
+sys.path.insert(0, src)
+try:
+    write("cmd_compileall_a.py", "value = 1\n")
+    write("pkg/cmd_compileall_b.py", "value = 2\n")
+    write(".hidden/cmd_compileall_c.py", "value = 3\n")
+    write("notpy.txt", "value = 4\n")
+
+    # .py files in subdirectories are compiled, hidden directories are skipped
+    print(compileall(src + "/"))
+    print(sorted(name.split(".")[0] for name in os.listdir(cache)))
+
+    # imports use those cache files, without replacing them
+    inodes = [os.stat(cache + "/" + name)[1] for name in os.listdir(cache)]
+    import cmd_compileall_a, pkg.cmd_compileall_b
+
+    print(cmd_compileall_a.value, pkg.cmd_compileall_b.value)
+    print([os.stat(cache + "/" + name)[1] for name in os.listdir(cache)] == inodes)
+
+    # a file that fails to compile makes the exit status non-zero
+    write("cmd_compileall_bad.py", "value =\n")
+    print(compileall(src))
+
+    # as does a missing directory
+    print(compileall(src + "/missing"))
+finally:
+    sys.path.pop(0)
+    remove(src)
+    remove(cache)
@@ -0,0 +1,50 @@
+# cmdline: -X pycache=cmd_pycache_dir
+# test caching of compiled .py imports as .mpy files
+import os, sys
+
+src = "cmd_pycache_src"
+cache = "cmd_pycache_dir"
+
+
+def write(text):
+    with open(src + "/cmd_pycache_mod.py", "w") as f:
+        f.write(text)
+
+
+def reimport():
+    sys.modules.pop("cmd_pycache_mod", None)
+    import cmd_pycache_mod
+
+    print(cmd_pycache_mod.value, cmd_pycache_mod.__file__)
+
+
+# a cache file is replaced by renaming a new one over it, so its inode
+# only stays the same if the import used it
+def cache_inodes():
+    return [os.stat(cache + "/" + name)[1] for name in os.listdir(cache)]
+
+
+os.mkdir(src)
+sys.path.insert(0, src)
+try:
+    write("value = 1\n")
+    # first import compiles the source and writes the cache file
+    reimport()
+    print(len(os.listdir(cache)))
+    # second import loads from the cache, also via a different spelling of the path
+    inodes = cache_inodes()
+    reimport()
+    sys.path[0] = "./" + src + "/../" + src + "/"
+    reimport()
+    print(cache_inodes() == inodes)
+    sys.path[0] = src
+    # changing the source (and its size) invalidates the cache entry
+    write("value = 22\n")
+    reimport()
+    print(len(os.listdir(cache)))
+finally:
+    sys.path.pop(0)
+    for d in (src, cache):
+        for name in os.listdir(d):
+            os.remove(d + "/" + name)
+        os.rmdir(d)
@@ -0,0 +1,56 @@
+# Test btree with a database in a file, which ports may access directly by its
+# file descriptor.
+
+try:
+    import btree
+    import os
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+name = "btree_file_test.db"
+try:
+    os.stat(name)
+    print("SKIP")
+    raise SystemExit
+except OSError:
+    pass
+
+try:
+    f = open(name, "w+b")
+except OSError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    db = btree.open(f, pagesize=512)
+    db.load((b"%05d" % i, b"%d" % (i * i)) for i in range(1000))
+    db[b"key"] = b"value"
+    db.close()
+    f.close()
+
+    # Reopen the file and read the data back.
+    f = open(name, "r+b")
+    db = btree.open(f, pagesize=512)
+    print(db[b"00000"], db[b"00999"], db[b"key"])
+    print(len(list(db)))
+    db.keys()
+    print(db.fetch(2))
+    db.items(b"00500", b"00503")
+    print(db.fetch(10))
+    del db[b"key"]
+    print(b"key" in db)
+    db.close()
+    f.close()
+
+    # Writing pages back fails once the file has been closed.
+    f = open(name, "r+b")
+    db = btree.open(f, pagesize=512)
+    db[b"key"] = b"value"
+    f.close()
+    try:
+        db.close()
+    except (OSError, ValueError):
+        print("closed")
+finally:
+    os.remove(name)
@@ -0,0 +1,56 @@
+# Test btree.load() and btree.fetch().
+
+try:
+    import btree
+    import io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+f = io.BytesIO()
+db = btree.open(f, pagesize=512)
+
+# Load sorted pairs from a generator.
+print(db.load((b"%04d" % i, b"val%d" % i) for i in range(0, 200, 2)))
+print(len(list(db)), db[b"0000"], db[b"0198"])
+
+# Load more pairs into the same database, from a list of tuples and lists.
+print(db.load([(b"0001", b"one"), [b"0003", b"three"]]))
+print(db[b"0001"], db[b"0003"])
+
+# Keys must be strictly ascending.
+for items in ([(b"b", b"1"), (b"a", b"2")], [(b"c", b"1"), (b"c", b"2")]):
+    try:
+        db.load(items)
+    except ValueError as e:
+        print("ValueError", e)
+
+# Items must be pairs.
+try:
+    db.load([(b"x",)])
+except ValueError:
+    print("ValueError")
+
+# Fetch a range in batches.
+db.items(b"0010", b"0020")
+print(db.fetch(3))
+print(db.fetch(3))
+print(db.fetch(3))
+print(db.fetch(3))
+
+# Fetch with an inclusive end key, in descending order.
+db.keys(b"0020", b"0010", btree.INCL | btree.DESC)
+print(db.fetch(100))
+print(db.fetch(100))
+
+# Fetch values without an end key.
+db.values(b"0194")
+print(db.fetch(10))
+print(db.fetch(0))
+
+# Fetch continues an iteration already in progress.
+it = iter(db.keys(b"0050"))
+print(next(it), db.fetch(2), next(it))
+
+db.close()
+f.close()
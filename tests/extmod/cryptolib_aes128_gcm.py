@@ -0,0 +1,78 @@
+try:
+    from cryptolib import aes
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+MODE_GCM = 11
+
+try:
+    aes(b"x" * 16, MODE_GCM, b"x" * 12)
+except ValueError as e:
+    # is GCM support disabled?
+    if e.args[0] == "mode":
+        print("SKIP")
+        raise SystemExit
+    raise e
+
+# NIST GCM test case 4
+key = bytes.fromhex("feffe9928665731c6d6a8f9467308308")
+iv = bytes.fromhex("cafebabefacedbaddecaf888")
+aad = bytes.fromhex("feedfacedeadbeeffeedfacedeadbeefabaddad2")
+pt = bytes.fromhex(
+    "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+    "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+)
+
+crypto = aes(key, MODE_GCM, iv)
+crypto.update(aad)
+ct = crypto.encrypt(pt)
+print(ct.hex())
+print(crypto.digest().hex())
+
+# feed the data in pieces, encrypting into a given buffer
+crypto = aes(key, MODE_GCM, iv)
+crypto.update(aad[:7])
+crypto.update(aad[7:])
+buf = bytearray(len(pt))
+mv = memoryview(buf)
+for i in range(0, len(pt), 13):
+    crypto.encrypt(pt[i : i + 13], mv[i:])
+print(buf == ct, crypto.digest().hex())
+
+# decrypt in place and verify the tag
+crypto = aes(key, MODE_GCM, iv)
+crypto.update(aad)
+crypto.decrypt(buf, buf)
+print(buf == pt)
+crypto.verify(bytes.fromhex("5bc94fbc3221a5db94fae95ae7121a47"))
+try:
+    crypto.verify(bytes(16))
+except ValueError as e:
+    print("ValueError", e)
+
+# no AAD or data, and AES-256
+print(aes(key, MODE_GCM, iv).digest().hex())
+crypto = aes(bytes(range(32)), MODE_GCM, bytes(12))
+print(crypto.encrypt(b"x" * 100).hex())
+print(crypto.digest().hex())
+
+# errors
+try:
+    aes(key, MODE_GCM, bytes(16))
+except ValueError as e:
+    print("ValueError", e)
+crypto = aes(key, MODE_GCM, iv)
+crypto.encrypt(b"abc")
+try:
+    crypto.update(b"aad")
+except ValueError as e:
+    print("ValueError", e)
+try:
+    crypto.decrypt(b"abc")
+except ValueError as e:
+    print("ValueError", e)
+try:
+    aes(key, 1).digest()
+except ValueError as e:
+    print("ValueError", e)
@@ -0,0 +1,95 @@
+# Test blit and scroll across all formats, with keys, palettes and overlap.
+
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+FORMATS = (
+    ("MONO_VLSB", framebuf.MONO_VLSB, 1),
+    ("MONO_HLSB", framebuf.MONO_HLSB, 1),
+    ("MONO_HMSB", framebuf.MONO_HMSB, 1),
+    ("GS2_HMSB", framebuf.GS2_HMSB, 2),
+    ("GS4_HMSB", framebuf.GS4_HMSB, 4),
+    ("GS8", framebuf.GS8, 8),
+    ("RGB565", framebuf.RGB565, 16),
+)
+
+W = 13
+H = 9
+
+
+def make(fmt, bpp, w=W, h=H):
+    buf = bytearray(((h + 7) & ~7) * w * bpp // 8 + w)
+    return framebuf.FrameBuffer(buf, w, h, fmt)
+
+
+def pattern(fb, bpp):
+    mask = (1 << bpp) - 1
+    for y in range(H):
+        for x in range(W):
+            fb.pixel(x, y, (x * 7 + y * 3 + x * y) & mask)
+
+
+def dump(fb, w=W, h=H):
+    print(" ".join("".join("%x" % (fb.pixel(x, y) & 0xF) for x in range(w)) for y in range(h)))
+
+
+# Same and mixed formats, at odd offsets and clipped at the edges.
+for name, fmt, bpp in FORMATS:
+    src = make(fmt, bpp)
+    pattern(src, bpp)
+    for dname, dfmt, dbpp in FORMATS:
+        if dbpp < bpp and dbpp != 1:
+            continue
+        dst = make(dfmt, dbpp)
+        dst.fill(0)
+        dst.blit(src, 3, -2)
+        dst.blit(src, -5, 6)
+        print(name, dname)
+        dump(dst)
+
+# Transparent key.
+for name, fmt, bpp in FORMATS:
+    src = make(fmt, bpp)
+    pattern(src, bpp)
+    dst = make(fmt, bpp)
+    dst.fill((1 << bpp) - 1)
+    dst.blit(src, 1, 1, 1)
+    print(name, "key")
+    dump(dst)
+
+# Palette, with and without a key.
+pal = make(framebuf.RGB565, 16, 16, 1)
+for i in range(16):
+    pal.pixel(i, 0, 15 - i)
+for name, fmt, bpp in FORMATS[:5]:
+    src = make(fmt, bpp)
+    pattern(src, bpp)
+    dst = make(framebuf.GS8, 8)
+    dst.fill(0)
+    dst.blit(src, 2, 1, -1, pal)
+    dst.blit(src, -2, -1, 14, pal)
+    print(name, "palette")
+    dump(dst)
+
+# Blit a framebuffer onto itself.
+for name, fmt, bpp in FORMATS:
+    fb = make(fmt, bpp)
+    pattern(fb, bpp)
+    fb.blit(fb, 2, 1)
+    fb.blit(fb, -1, -2)
+    print(name, "self")
+    dump(fb)
+
+# Scroll in all directions.
+for name, fmt, bpp in FORMATS:
+    fb = make(fmt, bpp)
+    pattern(fb, bpp)
+    fb.scroll(3, 1)
+    fb.scroll(-1, -2)
+    fb.scroll(0, 4)
+    fb.scroll(-20, 0)
+    print(name, "scroll")
+    dump(fb)
@@ -0,0 +1,60 @@
+# Test tracking of the region of a FrameBuffer that has been drawn to.
+
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+w = 20
+h = 10
+fbuf = framebuf.FrameBuffer(bytearray(w * h * 2), w, h, framebuf.RGB565)
+
+# Nothing drawn yet.
+print(fbuf.dirty())
+
+fbuf.pixel(3, 4, 1)
+print(fbuf.dirty())
+print(fbuf.dirty())
+
+# Reading pixels doesn't mark them.
+fbuf.pixel(5, 5)
+print(fbuf.dirty())
+
+# Drawing accumulates, and is clipped to the framebuffer.
+fbuf.hline(-5, 2, 10, 1)
+fbuf.vline(18, 7, 100, 1)
+print(fbuf.dirty(False))
+print(fbuf.dirty(True))
+
+# Drawing entirely outside the framebuffer doesn't mark anything.
+fbuf.line(-5, -5, -1, 20, 1)
+fbuf.rect(w, 0, 5, 5, 1, True)
+fbuf.ellipse(-10, 5, 3, 3, 1)
+fbuf.text("x", 0, h, 1)
+print(fbuf.dirty())
+
+fbuf.line(2, 8, 12, 3, 1)
+print(fbuf.dirty())
+fbuf.rect(1, 1, 4, 3, 1)
+print(fbuf.dirty())
+fbuf.ellipse(10, 5, 4, 2, 1, True)
+print(fbuf.dirty())
+fbuf.text("ab", 4, 1, 1)
+print(fbuf.dirty())
+fbuf.fill(0)
+print(fbuf.dirty())
+
+src = framebuf.FrameBuffer(bytearray(4 * 4 * 2), 4, 4, framebuf.RGB565)
+fbuf.blit(src, 18, -1)
+print(fbuf.dirty())
+fbuf.scroll(2, -3)
+print(fbuf.dirty())
+
+try:
+    from array import array
+
+    fbuf.poly(5, 3, array("h", [0, 0, 4, 2, 1, 5]), 1, True)
+    print(fbuf.dirty())
+except ImportError:
+    print((5, 3, 5, 6))
@@ -0,0 +1,32 @@
+try:
+    import hashlib
+
+    hashlib.sha256_many
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+def check(buffers):
+    digests = hashlib.sha256_many(buffers)
+    print(len(digests), digests == [hashlib.sha256(b).digest() for b in buffers])
+
+
+check([])
+check([b""])
+check((b"abc",))
+print(hashlib.sha256_many([b"abc"])[0])
+
+# groups of four with equal and different lengths, around block boundaries
+for n in (0, 1, 55, 56, 63, 64, 65, 128, 1000):
+    check([bytes([i]) * n for i in range(4)])
+check([b"a" * n for n in (64, 200, 3, 1000, 129, 64, 0)])
+check([bytes(range(256)) * 40 for _ in range(9)])
+
+# other buffer types
+check([bytearray(b"xyz" * 50), memoryview(b"0123456789" * 20)[3:150], b"q" * 70, b""])
+
+try:
+    hashlib.sha256_many([b"a", 1])
+except TypeError:
+    print("TypeError")
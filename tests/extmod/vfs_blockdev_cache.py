@@ -0,0 +1,83 @@
+# Test that data written through a filesystem reaches the block device when
+# the filesystem is synced, whether or not the block device is cached.
+
+try:
+    import os, vfs
+
+    vfs.VfsFat
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class RAMBlockDevice:
+    SEC_SIZE = 512
+
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * self.SEC_SIZE)
+        self.syncs = 0
+
+    def readblocks(self, n, buf):
+        buf[:] = self.data[n * self.SEC_SIZE : n * self.SEC_SIZE + len(buf)]
+
+    def writeblocks(self, n, buf):
+        self.data[n * self.SEC_SIZE : n * self.SEC_SIZE + len(buf)] = buf
+
+    def ioctl(self, op, arg):
+        if op == 3:  # MP_BLOCKDEV_IOCTL_SYNC
+            self.syncs += 1
+        if op == 4:  # MP_BLOCKDEV_IOCTL_BLOCK_COUNT
+            return len(self.data) // self.SEC_SIZE
+        if op == 5:  # MP_BLOCKDEV_IOCTL_BLOCK_SIZE
+            return self.SEC_SIZE
+
+
+try:
+    bdev = RAMBlockDevice(100)
+except MemoryError:
+    print("SKIP")
+    raise SystemExit
+
+vfs.VfsFat.mkfs(bdev)
+fs = vfs.VfsFat(bdev)
+vfs.mount(fs, "/ramdisk")
+
+# Small writes, which are kept in the cache until the file is closed.
+with open("/ramdisk/small.txt", "w") as f:
+    for i in range(200):
+        f.write("line %03d\n" % i)
+print(bdev.syncs > 0, b"line 199" in bdev.data)
+
+# Large writes that overlap blocks written by small writes.
+data = bytes(range(256)) * 24
+with open("/ramdisk/large.bin", "wb") as f:
+    f.write(b"x" * 100)
+    f.seek(0)
+    f.write(data)
+with open("/ramdisk/large.bin", "rb") as f:
+    print(f.read() == data)
+
+# Small reads of blocks written by a large write, then a large read of
+# blocks written by small writes.
+with open("/ramdisk/large.bin", "rb") as f:
+    f.seek(1000)
+    print(f.read(10) == data[1000:1010])
+with open("/ramdisk/large.bin", "r+b") as f:
+    f.seek(600)
+    f.write(b"y" * 10)
+    f.seek(0)
+    print(f.read() == data[:600] + b"y" * 10 + data[610:])
+
+# Everything reaches the device by the time the filesystem is unmounted.
+with open("/ramdisk/last.txt", "w") as f:
+    f.write("last")
+vfs.umount("/ramdisk")
+copy = RAMBlockDevice(100)
+copy.data[:] = bdev.data
+vfs.mount(vfs.VfsFat(copy), "/ramdisk")
+print(sorted(os.listdir("/ramdisk")))
+with open("/ramdisk/small.txt") as f:
+    print(len(f.read()))
+with open("/ramdisk/last.txt") as f:
+    print(f.read())
+vfs.umount("/ramdisk")
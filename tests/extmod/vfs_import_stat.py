@@ -0,0 +1,130 @@
+# Test that imports and os.stat see changes made to a filesystem, so that
+# anything a filesystem caches about its directories is kept up to date.
+
+try:
+    import sys, os, vfs
+
+    vfs.VfsFat
+    vfs.VfsLfs2
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class RAMBlockDevice:
+    ERASE_BLOCK_SIZE = 512
+
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * self.ERASE_BLOCK_SIZE)
+
+    def readblocks(self, block, buf, off=0):
+        addr = block * self.ERASE_BLOCK_SIZE + off
+        buf[:] = self.data[addr : addr + len(buf)]
+
+    def writeblocks(self, block, buf, off=0):
+        addr = block * self.ERASE_BLOCK_SIZE + off
+        self.data[addr : addr + len(buf)] = buf
+
+    def ioctl(self, op, arg):
+        if op == 4:  # block count
+            return len(self.data) // self.ERASE_BLOCK_SIZE
+        if op == 5:  # block size
+            return self.ERASE_BLOCK_SIZE
+        if op == 6:  # erase block
+            return 0
+
+
+def try_import(name):
+    try:
+        mod = __import__(name)
+        print(name, mod.X)
+        del sys.modules[name]
+    except ImportError:
+        print(name, "ImportError")
+
+
+def try_stat(path):
+    try:
+        print(path, os.stat(path)[0] & 0x4000 and "dir" or "file")
+    except OSError as e:
+        print(path, "OSError", e.errno)
+
+
+def write(path, x):
+    with open(path, "w") as f:
+        f.write("X = %r\n" % x)
+
+
+def test(vfs_class):
+    print("test", vfs_class)
+    bdev = RAMBlockDevice(128)
+    vfs_class.mkfs(bdev)
+    vfs.mount(vfs_class(bdev), "/ramdisk")
+    os.mkdir("/ramdisk/lib")
+    sys.path.insert(0, "/ramdisk/lib")
+
+    # Modules created after an import doesn't find them.
+    try_import("mod_a")
+    write("/ramdisk/lib/mod_a.py", 1)
+    try_import("mod_a")
+    try_stat("/ramdisk/lib/mod_b.py")
+    write("/ramdisk/lib/mod_b.py", 2)
+    try_stat("/ramdisk/lib/mod_b.py")
+
+    # Modules that are renamed or removed.
+    os.rename("/ramdisk/lib/mod_a.py", "/ramdisk/lib/mod_c.py")
+    try_import("mod_a")
+    try_import("mod_c")
+    os.remove("/ramdisk/lib/mod_c.py")
+    try_import("mod_c")
+    try_stat("/ramdisk/lib/mod_c.py")
+
+    # Packages created by making a directory.
+    try_import("pkg")
+    os.mkdir("/ramdisk/lib/pkg")
+    write("/ramdisk/lib/pkg/__init__.py", 3)
+    try_import("pkg")
+    try_stat("/ramdisk/lib/pkg")
+    os.remove("/ramdisk/lib/pkg/__init__.py")
+    os.rmdir("/ramdisk/lib/pkg")
+    try_stat("/ramdisk/lib/pkg")
+
+    # Relative paths after changing directory.
+    os.mkdir("/ramdisk/dir")
+    write("/ramdisk/dir/mod_d.py", 4)
+    os.chdir("/ramdisk")
+    try_stat("mod_d.py")
+    os.chdir("/ramdisk/dir")
+    try_stat("mod_d.py")
+    os.chdir("/")
+
+    # Directories that don't exist, and names that aren't simple.
+    try_stat("/ramdisk/none/mod.py")
+    try_stat("/ramdisk/lib/")
+    try_stat("/ramdisk/lib/.")
+
+    # Changes made through the filesystem object rather than the VFS.
+    fs = vfs_class(bdev)
+    vfs.umount("/ramdisk")
+    vfs.mount(fs, "/ramdisk")
+    try_import("mod_e")
+    with fs.open("/lib/mod_e.py", "w") as f:
+        f.write("X = 5\n")
+    try_import("mod_e")
+
+    sys.path.pop(0)
+    vfs.umount("/ramdisk")
+
+
+test(vfs.VfsFat)
+test(vfs.VfsLfs2)
+
+# FAT names are case-insensitive, and files with long names also have a short name.
+bdev = RAMBlockDevice(128)
+vfs.VfsFat.mkfs(bdev)
+vfs.mount(vfs.VfsFat(bdev), "/ramdisk")
+write("/ramdisk/Long_File_Name.py", 6)
+try_stat("/ramdisk/long_file_name.py")
+try_stat("/ramdisk/LONG_F~1.PY")
+try_stat("/ramdisk/LONG_F~2.PY")
+vfs.umount("/ramdisk")
@@ -0,0 +1,82 @@
+# Test importing .mpy files from VfsPosix, and that the loaded code doesn't
+# depend on the file afterwards.
+
+try:
+    import gc, os, sys, vfs
+
+    vfs.VfsPosix
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+if not (sys.implementation._mpy & 0xFF) == 6:
+    print("SKIP")
+    raise SystemExit
+
+# We need a directory for testing that doesn't already exist.
+# Skip the test if it does exist.
+temp_dir = "vfs_posix_import_mpy_test_dir"
+try:
+    os.stat(temp_dir)
+    print("SKIP")
+    raise SystemExit
+except OSError:
+    pass
+
+# Compiled from:
+#   NAME = "vfs_posix_import_mpy_name"
+#   DATA = b"\x00\x01bytes"
+#   def f(a):
+#       return (NAME, DATA, "str" + a, <version>)
+def mpy(version):
+    return (
+        b"M\x06\x00\x1f\x07\x02\nv1.py\x00\x0f\x02f\x00\x82/\x08NAME\x00\x08DATA\x00\x02a\x00\x05"
+        b"\x19vfs_posix_import_mpy_name\x00\x06\x07\x00\x01bytes\x00\x81\x1c\x00\x06\x01$$#\x00\x16"
+        b"\x04#\x01\x16\x052\x00\x16\x02Qc\x01\x81\x08!\x06\x02\x06`\x12\x04\x12\x05\x10\x03\xb0\xf2"
+        + bytes([0x80 + version])
+        + b"*\x04c"
+    )
+
+
+def write(path, data):
+    with open(path, "wb") as f:
+        f.write(data)
+
+
+os.mkdir(temp_dir)
+sys.path.insert(0, temp_dir)
+mod_path = temp_dir + "/vfs_posix_import_mpy_mod.mpy"
+
+write(mod_path, mpy(1))
+import vfs_posix_import_mpy_mod as mod
+
+print(mod.NAME, mod.DATA, mod.f("ing"))
+
+# The loaded data must survive a collection.
+gc.collect()
+print(mod.f("!"), hash(mod.DATA) == hash(b"\x00\x01bytes"), mod.NAME == "vfs_posix_import_mpy_name")
+
+# Importing again gives a new module with the same contents.
+del sys.modules["vfs_posix_import_mpy_mod"]
+import vfs_posix_import_mpy_mod as mod2
+
+print(mod2 is mod, mod2.f(""))
+
+# Replacing the file by renaming a new one over it must not affect the old module.
+write(mod_path + ".new", mpy(2))
+os.rename(mod_path + ".new", mod_path)
+del sys.modules["vfs_posix_import_mpy_mod"]
+import vfs_posix_import_mpy_mod as mod3
+
+print(mod.f("1"), mod3.f("2"))
+
+# Truncating the file in place (as mpy-cross does when rewriting its output)
+# must not affect the loaded module either.
+write(mod_path, b"")
+gc.collect()
+print(mod3.f("3"), mod3.NAME, mod3.DATA)
+
+# Clean up.
+sys.path.pop(0)
+os.remove(mod_path)
+os.rmdir(temp_dir)
@@ -0,0 +1,38 @@
+# test a frozen module whose top-level functions may be created on first use
+
+import sys
+
+try:
+    import frzmpy_lazy
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+# load functions as attributes, including __getattr__
+print(frzmpy_lazy.f(1), frzmpy_lazy.default_args(1), list(frzmpy_lazy.gen(3)))
+print(frzmpy_lazy.decorated(), frzmpy_lazy.missing)
+print(frzmpy_lazy.f is frzmpy_lazy.f)
+
+# load functions as globals of the module
+print(frzmpy_lazy.call_f(2), frzmpy_lazy.Foo().method())
+
+# import functions by name
+from frzmpy_lazy import f, get_x
+
+print(f(3), get_x(), f is frzmpy_lazy.f)
+
+# rebind a function
+frzmpy_lazy.f = lambda x: x * 10
+print(frzmpy_lazy.call_f(2))
+
+# the module's dict holds the functions themselves
+g = frzmpy_lazy.get_globals()
+print(g is frzmpy_lazy.__dict__, g["get_x"](), g["call_f"](3))
+print(sorted(k for k, v in g.items() if callable(v) and not isinstance(v, type)))
+
+# so does a star import, here of a fresh copy of the module
+del sys.modules["frzmpy_lazy"]
+from frzmpy_lazy import *
+
+print(call_f(4), decorated())
+print(sorted(k for k, v in globals().items() if k.startswith("get") and callable(v)))
@@ -0,0 +1,78 @@
+# test native emitter inline fast paths for small ints and list indexing
+
+@micropython.native
+def arith(a, b):
+    return (a + b, a - b, a & b, a | b, a ^ b, a < b, a <= b, a == b, a != b, a > b, a >= b)
+
+
+# small ints, including results that overflow the machine word
+print(arith(1, 2))
+print(arith(-5, 3))
+print(arith(0, 0))
+for big in (2**29, 2**30, 2**61, 2**62):
+    print(arith(big, big - 1))
+    print(arith(-big, big))
+    print(arith(-big, -big))
+
+# non-small-int operands go through the runtime
+print(arith(True, 2))
+
+
+@micropython.native
+def add_less(a, b):
+    return (a + b, a - b, a < b)
+
+
+print(add_less(2, 1.5))
+print(add_less(2**100, 1))
+
+
+@micropython.native
+def inplace(n):
+    x = 0
+    for i in range(n):
+        x += i
+        x -= 1
+        x ^= 3
+    return x
+
+
+print(inplace(100))
+
+
+@micropython.native
+def index(lst, i):
+    return lst[i]
+
+
+@micropython.native
+def store(lst, i, v):
+    lst[i] = v
+
+
+l = [1, 2, 3]
+print(index(l, 0), index(l, 2), index(l, -1), index(l, -3))
+store(l, 0, 10)
+store(l, -1, 30)
+print(l)
+for i in (3, -4):
+    try:
+        index(l, i)
+    except IndexError:
+        print("IndexError")
+    try:
+        store(l, i, 0)
+    except IndexError:
+        print("IndexError")
+
+# other types and index kinds
+print(index((4, 5), 1), index("abc", 1), index(bytearray(b"xyz"), 2), index({1: 2}, 1))
+print(index(l, True), index(l, False))
+
+
+class MyList(list):
+    def __getitem__(self, i):
+        return -1
+
+
+print(index(MyList([1, 2]), 0))
@@ -0,0 +1,130 @@
+# test tiered execution: hot bytecode functions switch to native code
+
+import sys, io, os, micropython
+
+try:
+    micropython.tier_threshold
+    if not __file__.endswith(".py"):
+        raise AttributeError
+except (AttributeError, NameError):
+    print("SKIP")
+    raise SystemExit
+
+
+def fail(x):
+    if x < 0:
+        raise ValueError(x)
+    return x
+
+
+# native functions don't record their line in a traceback
+def traceback_lines():
+    try:
+        fail(-1)
+    except ValueError as e:
+        s = io.StringIO()
+        sys.print_exception(e, s)
+        return s.getvalue().count(", line ")
+
+
+if traceback_lines() != 2:
+    # already compiled as native
+    print("SKIP")
+    raise SystemExit
+
+
+def add(a, b=10, *, c=100):
+    return a + b + c
+
+
+def make_adder(n):
+    def adder(x):
+        return x + n
+
+    return adder
+
+
+def loop(n):
+    total = 0
+    i = 0
+    while i < n:
+        total += i
+        i += 1
+    return total
+
+
+def keep(x):
+    y = x
+    del y
+    return x
+
+
+def unbound(x):
+    if x:
+        y = x
+    return y
+
+
+def both(x):
+    if x:
+        y = x
+    else:
+        y = -x
+    return y
+
+
+print(micropython.tier_threshold())
+
+# nothing is tiered while the threshold is zero
+for i in range(10):
+    fail(i)
+print(traceback_lines())
+
+micropython.tier_threshold(5)
+print(micropython.tier_threshold())
+
+# calls up to the threshold run as bytecode, later ones as native
+for i in range(10):
+    fail(i)
+print(traceback_lines())
+
+# default args are shared with the native version
+for i in range(10):
+    print(add(i), add(i, 1), add(i, c=2))
+
+# each closure keeps its own cells
+adders = [make_adder(n) for n in range(3)]
+for i in range(8):
+    print([f(i) for f in adders])
+
+# backward jumps count too, so one call of a long loop makes it hot
+print(loop(100), loop(10))
+
+# functions that delete locals stay as bytecode, but still work
+print([keep(i) for i in range(10)])
+
+# so do functions that may read a local before assigning it
+for i in range(10):
+    unbound(1)
+try:
+    unbound(0)
+except NameError:
+    print("NameError")
+print([both(i - 5) for i in range(10)])
+
+# a function is only tiered from the source it was imported from
+mod_dir = "native_tiering_test_dir"
+os.mkdir(mod_dir)
+sys.path.insert(0, mod_dir)
+with open(mod_dir + "/native_tiering_mod.py", "w") as f:
+    f.write("def f():\n    return 1\n")
+import native_tiering_mod
+
+with open(mod_dir + "/native_tiering_mod.py", "w") as f:
+    f.write("def f():\n    return 2\n")
+print([native_tiering_mod.f() for i in range(10)])
+sys.path.pop(0)
+os.remove(mod_dir + "/native_tiering_mod.py")
+os.rmdir(mod_dir)
+
+micropython.tier_threshold(0)
@@ -0,0 +1,192 @@
+# test caching of loads made in loops at optimisation level 4
+import micropython
+
+micropython.opt_level(4)
+
+# Code is compiled by exec so that it uses the optimisation level above, and
+# it uses the module's globals so that loads from them can be cached.
+
+# rebinding and deleting a global in the middle of a loop
+exec("""
+G = 0
+def set_g(v):
+    global G
+    G = v
+def del_g():
+    global G
+    del G
+def f(n):
+    r = []
+    for i in range(n):
+        r.append(G)
+        if i == 1:
+            set_g(10)
+        elif i == 3:
+            del_g()
+    return r
+try:
+    f(6)
+except NameError:
+    print("NameError")
+set_g(0)
+print(f(3))
+""")
+
+# a global shadowing a builtin, and overriding a builtin
+exec("""
+def g(n):
+    r = []
+    i = 0
+    while i < n:
+        r.append(abs(-i))
+        if i == 1:
+            globals()["abs"] = lambda x: "global"
+        elif i == 3:
+            del globals()["abs"]
+        i += 1
+    return r
+print(g(6))
+""")
+try:
+    import builtins
+
+    builtins.abs = abs
+    del builtins.abs
+    exec("""
+def h(n):
+    r = []
+    for i in range(n):
+        r.append(abs(-i))
+        if i == 1:
+            builtins.abs = lambda x: "builtin"
+        elif i == 3:
+            del builtins.abs
+    return r
+print(h(6))
+""")
+except AttributeError:
+    print("[0, 1, 'builtin', 'builtin', 4, 5]")
+
+# code using its own dict for globals still sees changes
+d = {}
+exec(
+    """
+G = 1
+def f(n):
+    global G
+    r = []
+    for i in range(n):
+        r.append(G)
+        G += 1
+    return r
+def k(n):
+    return [G for i in range(n) if f(1)]
+print(f(3), k(3))
+""",
+    d,
+)
+
+# generators see changes made between iterations
+exec("""
+def gen():
+    while True:
+        yield G
+set_g(1)
+it = gen()
+print(next(it), next(it))
+set_g(2)
+print(next(it))
+""")
+
+# closed-over variables aren't globals
+exec("""
+def outer():
+    x = 1
+    def inner():
+        nonlocal x
+        r = []
+        for i in range(3):
+            r.append(x)
+            x += 1
+        return r
+    return inner()
+print(outer())
+""")
+
+# attributes of a module, including changing and computed ones
+try:
+    import sys, io, vfs
+
+    io.IOBase
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class UserFile(io.IOBase):
+    def __init__(self, data):
+        self.data = memoryview(data)
+        self.pos = 0
+
+    def readinto(self, buf):
+        n = min(len(buf), len(self.data) - self.pos)
+        buf[:n] = self.data[self.pos : self.pos + n]
+        self.pos += n
+        return n
+
+    def ioctl(self, req, arg):
+        return 0
+
+
+class UserFS:
+    def __init__(self, files):
+        self.files = files
+
+    def mount(self, readonly, mksfs):
+        pass
+
+    def umount(self):
+        pass
+
+    def stat(self, path):
+        if path in self.files:
+            return (32768, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError
+
+    def open(self, path, mode):
+        return UserFile(self.files[path])
+
+
+user_files = {
+    "/cacheloads_mod.py": b"""
+X = 0
+n = 0
+def set_x(v):
+    global X
+    X = v
+def __getattr__(attr):
+    global n
+    n += 1
+    return n
+""",
+}
+vfs.mount(UserFS(user_files), "/userfs")
+sys.path.append("/userfs")
+
+import cacheloads_mod
+
+exec("""
+def m(n):
+    r = []
+    for i in range(n):
+        r.append((cacheloads_mod.X, cacheloads_mod.dyn))
+        if i == 0:
+            cacheloads_mod.X = 1
+        elif i == 1:
+            cacheloads_mod.set_x(2)
+    return r
+print(m(4))
+""")
+
+vfs.umount("/userfs")
+sys.path.pop()
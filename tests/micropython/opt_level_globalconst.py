@@ -0,0 +1,109 @@
+# test propagation of module-level constants at optimisation level 4
+import micropython as micropython
+
+micropython.opt_level(4)
+
+# check the feature is available: a function sees the constant, not the global
+g = {}
+exec("X = 1\ndef f():\n    return X\n", g)
+g["X"] = 2
+if g["f"]() != 1:
+    print("SKIP")
+    raise SystemExit
+
+
+def run(code):
+    g = {}
+    try:
+        exec(code, g)
+    except Exception as e:
+        print(type(e).__name__)
+    return g
+
+
+# constants of different types, used in functions, classes and later module code
+g = run(
+    """
+I = 10
+S = "str"
+B = b"bytes"
+N = None
+T = ()
+F = 1.5
+def f():
+    return I, S, B, N, T, F
+class C:
+    a = I
+print(f(), C.a, I + 1)
+"""
+)
+g["I"] = 0
+print(g["f"]())
+
+# dead branches guarded by constant flags
+run(
+    """
+DEBUG = False
+FEATURE = 1
+def f(x):
+    if DEBUG:
+        print("debug")
+    elif FEATURE:
+        print("feature", x)
+    else:
+        print("neither")
+    while DEBUG:
+        pass
+    return not DEBUG and FEATURE
+print(f(1))
+"""
+)
+
+# names that are stored more than once, deleted, declared global, or
+# shadowed are loaded as usual
+g = run(
+    """
+A = 1
+A = 2
+B = 1
+del B
+C = 1
+def set_c():
+    global C
+    C = 3
+D = 1
+def local_d(D=4):
+    return D
+E = 1
+def comp_e():
+    return [(E := i) for i in range(2)]
+F = 1
+for F in range(2):
+    pass
+def f():
+    return A, C, local_d(), F
+set_c()
+print(f())
+"""
+)
+
+# module code before the assignment sees the global unassigned
+run(
+    """
+print(X)
+X = 1
+"""
+)
+
+# a star import may store to any global
+run(
+    """
+opt_level = 1
+from micropython import *
+def f():
+    return opt_level
+print(callable(f()))
+"""
+)
+
+micropython.opt_level(0)
@@ -0,0 +1,69 @@
+# test stackless calls: deep recursion, and reuse of call frames
+
+import sys, micropython
+
+
+def depth(n):
+    if n == 0:
+        return 0
+    return depth(n - 1) + 1
+
+
+# Check for a stackless build with reusable frames (sys.settrace disables reuse).
+try:
+    micropython.heap_lock
+    if hasattr(sys, "settrace"):
+        raise AttributeError
+    depth(2000)
+except (AttributeError, RuntimeError):
+    print("SKIP")
+    raise SystemExit
+
+
+def fail_at(n):
+    if n == 0:
+        raise ValueError("bottom")
+    return fail_at(n - 1)
+
+
+def leaf(x):
+    return x + 1
+
+
+def calls(n):
+    t = 0
+    for i in range(n):
+        t = leaf(t)
+    return t
+
+
+# Call f(n) with the heap locked, so each call must reuse a returned frame.
+def call_locked(f, n):
+    result = None
+    micropython.heap_lock()
+    try:
+        result = f(n)
+    except RuntimeError:
+        pass
+    micropython.heap_unlock()
+    return result
+
+
+# recursion far deeper than the C stack allows
+print(depth(5000))
+
+# an exception unwinds through all the frames
+try:
+    fail_at(3000)
+except ValueError as e:
+    print(repr(e))
+
+# frames from the deep recursion are reused, but these are too small for
+# calls(), which then keeps its own bigger frame once it has returned
+calls(10)
+print(call_locked(calls, 1000))
+print(call_locked(depth, 20))
+
+# a frame is reused many times over
+for i in range(3):
+    print(call_locked(calls, 100))
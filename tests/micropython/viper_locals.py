@@ -0,0 +1,67 @@
+# test viper and native functions with more locals than there are registers,
+# where the most frequently used locals are not the first ones
+
+
+@micropython.viper
+def hot_late(a: int, b: int, c: int, d: int, e: int, f: int, g: int) -> int:
+    u = a + b
+    v = c + d
+    w = e + f
+    acc = 0
+    i = 0
+    while i < g:
+        acc += i * w
+        i += 1
+    return acc + u + v
+
+
+print(hot_late(1, 2, 3, 4, 5, 6, 10))
+
+
+@micropython.viper
+def nested(n: int) -> int:
+    p = 1
+    q = 2
+    r = 3
+    s = 4
+    total = 0
+    for i in range(n):
+        for j in range(n):
+            total += i * j
+    return total + p + q + r + s
+
+
+print(nested(7))
+
+
+@micropython.viper
+def swap(n: int) -> int:
+    x0 = 1
+    x1 = 2
+    x2 = 3
+    x3 = 4
+    x4 = 5
+    x5 = 6
+    for _ in range(n):
+        t = x5
+        x5 = x4
+        x4 = x3
+        x3 = x2
+        x2 = x1
+        x1 = x0
+        x0 = t
+    return x0 * 100000 + x1 * 10000 + x2 * 1000 + x3 * 100 + x4 * 10 + x5
+
+
+print(swap(4))
+
+
+@micropython.native
+def native_hot_late(a, b, c, d, e, f, n):
+    lst = []
+    for i in range(n):
+        lst.append(i + f)
+    return lst, a + b + c + d + e
+
+
+print(native_hot_late(1, 2, 3, 4, 5, 6, 4))
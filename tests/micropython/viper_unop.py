@@ -29,3 +29,12 @@ def inv(x: int) -> int:
 print(inv(0))
 print(inv(1))
 print(inv(-2))
+
+
+# the operand must not be modified in place
+@micropython.viper
+def unop_local(x: int) -> int:
+    return -x + ~x + x
+
+
+print(unop_local(5))
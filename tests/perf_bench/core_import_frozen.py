@@ -0,0 +1,37 @@
+# Test performance of importing many frozen modules, like at startup.  This needs
+# a build with the modules from frozen_import/manifest.py frozen into it.
+
+import sys
+
+try:
+    import frozen_import_000
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+NUM_MODULES = 100
+
+
+def test(r):
+    global result
+    names = ["frozen_import_%03d" % m for m in range(NUM_MODULES)]
+    for _ in r:
+        for name in names:
+            sys.modules.pop(name, None)
+            module = __import__(name)
+    result = module.func_1(1) + module.Thing(2).value()
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (2,),
+    (1000, 10): (20,),
+    (5000, 10): (100,),
+}
+
+
+def bm_setup(params):
+    (nloop,) = params
+    return lambda: test(range(nloop)), lambda: (nloop * NUM_MODULES, result)
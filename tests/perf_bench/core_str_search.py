@@ -0,0 +1,66 @@
+# This tests substring search in str, bytes and bytearray: find, rfind, count,
+# split, replace and "in", across a range of needle and haystack sizes
+
+
+def make_haystack(n):
+    words = "alpha beta gamma delta epsilon zeta eta theta iota kappa lambda mu".split()
+    parts = []
+    i = 0
+    total = 0
+    while total < n:
+        w = words[i % len(words)]
+        parts.append(w)
+        total += len(w) + 1
+        i = i * 7 + 3 & 0xFFFF
+    return " ".join(parts)[:n]
+
+
+def search(hay, needles):
+    total = 0
+    for needle in needles:
+        total += hay.find(needle) + hay.rfind(needle) + hay.count(needle)
+        total += needle in hay
+    total += len(hay.split(needles[2]))
+    total += len(hay.replace(needles[2], needles[1]))
+    return total
+
+
+def test(niter, hay_len):
+    s = make_haystack(hay_len) + " log-entry-marker: done"
+    str_needles = ("a", "eta", "kappa lambda", "zz", "log-entry-marker: done")
+    b = bytes(s, "ascii")
+    ba = bytearray(b)
+    bytes_needles = tuple(bytes(n, "ascii") for n in str_needles)
+    total = 0
+    for _ in range(niter):
+        total += search(s, str_needles)
+        total += search(b, bytes_needles)
+        total += search(ba, bytes_needles)
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (2, 256),
+    (50, 10): (4, 512),
+    (100, 10): (4, 4096),
+    (500, 10): (8, 16384),
+    (1000, 10): (16, 16384),
+    (5000, 10): (16, 65536),
+}
+
+
+def bm_setup(params):
+    niter, hay_len = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter, hay_len)
+
+    def result():
+        return niter * hay_len, state
+
+    return run, result
@@ -0,0 +1,41 @@
+# This tests indexing and slicing of long non-ASCII strings
+
+
+def test(niter, str_len):
+    s = ("Grüße, 世界! " * (str_len // 11 + 1))[:str_len]
+    n = len(s)
+    total = 0
+    for _ in range(niter):
+        for i in range(0, n, 7):
+            total += ord(s[i])
+        for i in range(0, n - 64, 97):
+            total += len(s[i : i + 64])
+        total += ord(s[-1]) + len(s[n // 2 :])
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (1, 512),
+    (50, 10): (1, 1024),
+    (100, 10): (1, 10000),
+    (500, 10): (2, 20000),
+    (1000, 10): (2, 40000),
+    (5000, 10): (4, 100000),
+}
+
+
+def bm_setup(params):
+    niter, str_len = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter, str_len)
+
+    def result():
+        return niter * str_len, state
+
+    return run, result
@@ -0,0 +1,56 @@
+# This tests packing and unpacking of a record with many fields, using both
+# the module-level functions and a precompiled struct.Struct
+
+import struct
+
+FMT = "<4sHHI" + "hHiI" * 6 + "bB2x"
+
+
+def test(niter):
+    values = (b"SENS", 1, 2, 3) + tuple(range(24)) + (-1, 255)
+    data = struct.pack(FMT, *values)
+    buf = bytearray(len(data) * 4)
+    mv = memoryview(buf)
+    if hasattr(struct, "Struct"):
+        st = struct.Struct(FMT)
+    else:
+        st = None
+    total = 0
+    for i in range(niter):
+        r = struct.unpack(FMT, data)
+        total += r[3] + r[-1]
+        struct.pack_into(FMT, buf, (i & 3) * len(data), *r)
+        if st is not None:
+            r = st.unpack_from(mv, (i & 3) * len(data))
+            total += r[5]
+            st.pack_into(mv, 0, *r)
+        else:
+            total += r[5]
+    return total
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (32, 10): (100,),
+    (50, 10): (200,),
+    (100, 10): (1000,),
+    (500, 10): (5000,),
+    (1000, 10): (10000,),
+    (5000, 10): (50000,),
+}
+
+
+def bm_setup(params):
+    (niter,) = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(niter)
+
+    def result():
+        return niter, state
+
+    return run, result
@@ -0,0 +1,40 @@
+# Generate and freeze the modules imported by ../core_import_frozen.py, to
+# measure the startup cost of a large frozen manifest.  Build with, eg:
+#
+#   make -C ports/unix FROZEN_MANIFEST=$(pwd)/tests/perf_bench/frozen_import/manifest.py
+#
+# Each module defines some constants, functions with and without default
+# arguments, and a class, like a typical library module.
+
+import os
+import tempfile
+
+NUM_MODULES = 100
+NUM_FUNCTIONS = 30
+
+mod_dir = os.path.join(tempfile.gettempdir(), "micropython_frozen_import")
+os.makedirs(mod_dir, exist_ok=True)
+
+for m in range(NUM_MODULES):
+    lines = ["CONST_A = %d" % m, 'NAME = "frozen_import_%03d"' % m, ""]
+    for f in range(NUM_FUNCTIONS):
+        if f % 3 == 2:
+            lines.append("def func_%d(a, b=%d):" % (f, f))
+            lines.append("    return a * b + CONST_A")
+        else:
+            lines.append("def func_%d(a):" % f)
+            lines.append("    return func_%d(a) + 1" % (f - 1) if f else "    return a + CONST_A")
+        lines.append("")
+    lines.append("class Thing:")
+    lines.append("    def __init__(self, x):")
+    lines.append("        self.x = x")
+    lines.append("    def value(self):")
+    lines.append("        return func_0(self.x)")
+    source = "\n".join(lines) + "\n"
+
+    # Only rewrite modules that changed, so rebuilds don't freeze them again.
+    path = os.path.join(mod_dir, "frozen_import_%03d.py" % m)
+    if not os.path.exists(path) or open(path).read() != source:
+        with open(path, "w") as f:
+            f.write(source)
+    module("frozen_import_%03d.py" % m, base_path=mod_dir)
@@ -0,0 +1,58 @@
+# Store records in a btree database with single inserts and with load(), then
+# scan ranges of it with fetch().  The score is records processed per second.
+
+try:
+    import btree
+    import io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (1, 100, 10),
+    (100, 10): (1, 200, 10),
+    (1000, 100): (4, 1000, 50),
+    (5000, 1000): (8, 4000, 100),
+}
+
+
+def bm_setup(params):
+    nloop, nrec, nscan = params
+    keys = [b"%08d" % i for i in range(nrec)]
+    vals = [b"%016x" % (i * 2654435761) for i in range(nrec)]
+    state = [None]
+
+    def run():
+        for _ in range(nloop):
+            # Single inserts, in a scattered order.
+            db = btree.open(io.BytesIO(), cachesize=65536)
+            for i in range(nrec):
+                j = i * 7919 % nrec
+                db[keys[j]] = vals[j]
+            db.close()
+
+            # Bulk load of sorted records.
+            db = btree.open(io.BytesIO(), cachesize=65536)
+            db.load(zip(keys, vals))
+
+            # Range scans, each of a tenth of the records.
+            span = nrec // 10
+            for i in range(nscan):
+                start = i * 6007 % (nrec - span)
+                db.items(keys[start], keys[start + span])
+                while True:
+                    batch = db.fetch(64)
+                    if not batch:
+                        break
+            db.items(keys[0], keys[2])
+            state[0] = db.fetch(2)
+            db.close()
+
+    def result():
+        return nloop * nrec * (2 + nscan // 10), state[0]
+
+    return run, result
@@ -0,0 +1,54 @@
+# Encrypt buffers from 16 bytes to 16 kilobytes with cryptolib.aes in CTR and
+# GCM modes, writing into a preallocated buffer.  The score is kilobytes
+# encrypted per second.
+
+try:
+    from cryptolib import aes
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+MODE_CTR = 6
+MODE_GCM = 11
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (1, 1024),
+    (100, 10): (2, 1024),
+    (1000, 100): (8, 16384),
+    (5000, 1000): (64, 16384),
+}
+
+
+def bm_setup(params):
+    nloop, maxsize = params
+    key = bytes(range(16))
+    iv = bytes(range(16, 32))
+    sizes = []
+    size = 16
+    while size <= maxsize:
+        sizes.append(size)
+        size *= 4
+    data = bytes(i & 0xFF for i in range(maxsize))
+    out = bytearray(maxsize)
+    mvs = [(memoryview(data)[:n], memoryview(out)[:n]) for n in sizes]
+    state = [None]
+
+    def run():
+        for _ in range(nloop):
+            tags = []
+            for mv_in, mv_out in mvs:
+                aes(key, MODE_CTR, iv).encrypt(mv_in, mv_out)
+                crypto = aes(key, MODE_GCM, iv[:12])
+                crypto.encrypt(mv_in, mv_out)
+                tags.append(crypto.digest())
+        state[0] = tags
+
+    def result():
+        # The tag of the smallest buffer doesn't depend on the parameters.
+        return nloop * sum(sizes) * 2 // 1024, state[0][0].hex()
+
+    return run, result
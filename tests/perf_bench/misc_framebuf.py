@@ -0,0 +1,78 @@
+# Draw frames with framebuf: each frame fills rectangles, blits sprites (with a
+# transparent key, and through a palette) and the whole screen, and scrolls,
+# for each of several formats.  The score is frames per second.
+
+import framebuf
+
+FORMATS = (
+    (framebuf.RGB565, 16),
+    (framebuf.GS8, 8),
+    (framebuf.GS4_HMSB, 4),
+    (framebuf.MONO_HLSB, 1),
+    (framebuf.MONO_VLSB, 1),
+)
+
+
+def new_fb(w, h, fmt, bpp):
+    stride = (w + 7) & ~7
+    buf = bytearray(((h + 7) & ~7) * stride * bpp // 8)
+    return framebuf.FrameBuffer(buf, w, h, fmt)
+
+
+def setup(w, h):
+    screens = []
+    for fmt, bpp in FORMATS:
+        screen = new_fb(w, h, fmt, bpp)
+        back = new_fb(w, h, fmt, bpp)
+        back.fill_rect(0, 0, w // 2, h, 1)
+        sprite = new_fb(32, 32, fmt, bpp)
+        sprite.fill(1)
+        sprite.fill_rect(8, 8, 16, 16, 0)
+        screens.append((screen, back, sprite))
+    glyph = new_fb(16, 16, framebuf.MONO_HLSB, 1)
+    glyph.fill_rect(4, 0, 8, 16, 1)
+    palette = new_fb(2, 1, framebuf.RGB565, 16)
+    palette.pixel(0, 0, 0x1234)
+    palette.pixel(1, 0, 0xF800)
+    return screens, glyph, palette
+
+
+def draw_frame(w, h, screens, glyph, palette, n):
+    for screen, back, sprite in screens:
+        screen.blit(back, 0, 0)
+        for i in range(4):
+            screen.fill_rect((n * 7 + i * 13) % w, (n * 3 + i * 5) % h, w // 4, h // 4, i & 1)
+            screen.blit(sprite, (n + i * 29) % w - 16, (n * 2 + i * 11) % h - 16, 0)
+        screen.scroll(1, 1)
+        screen.scroll(-2, 0)
+    rgb = screens[0][0]
+    for i in range(8):
+        rgb.blit(glyph, (n + i * 37) % w, (i * 19) % h, -1, palette)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (1, 64, 32),
+    (100, 10): (4, 64, 32),
+    (1000, 10): (4, 160, 120),
+    (5000, 100): (8, 320, 240),
+}
+
+
+def bm_setup(params):
+    nframes, w, h = params
+    screens, glyph, palette = setup(w, h)
+
+    def run():
+        for n in range(nframes):
+            draw_frame(w, h, screens, glyph, palette, n)
+
+    def result():
+        total = 0
+        for screen, _, _ in screens:
+            total += screen.pixel(w // 2, h // 2) + screen.pixel(1, 1)
+        return nframes, total
+
+    return run, result
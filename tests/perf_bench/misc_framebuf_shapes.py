@@ -0,0 +1,75 @@
+# Draw shapes with framebuf, as a dashboard would: lines, rectangle outlines,
+# outlined and filled ellipses and polygons, some of them partly or wholly
+# off screen.  The score is shapes per second.
+
+import framebuf
+from array import array
+
+FORMATS = (
+    (framebuf.RGB565, 16),
+    (framebuf.GS8, 8),
+    (framebuf.MONO_HLSB, 1),
+    (framebuf.MONO_VLSB, 1),
+)
+
+SHAPES_PER_FRAME = 16
+
+POLYS = (
+    array("h", [0, 0, 40, 5, 30, 30, 10, 40, -5, 20]),
+    array("h", [0, 20, 20, 0, 40, 20, 30, 20, 30, 40, 10, 40, 10, 20]),
+)
+
+
+def setup(w, h):
+    screens = []
+    for fmt, bpp in FORMATS:
+        stride = (w + 7) & ~7
+        buf = bytearray(((h + 7) & ~7) * stride * bpp // 8)
+        screens.append(framebuf.FrameBuffer(buf, w, h, fmt))
+    return screens
+
+
+def draw_frame(w, h, fb, n):
+    for i in range(2):
+        x = (n * 7 + i * 53) % (w + 40) - 20
+        y = (n * 3 + i * 31) % (h + 40) - 20
+        c = (n + i) & 1
+        fb.line(x, y, w - x, h // 2 + i, c)
+        fb.line(x, 0, x + 5, h - 1, c)
+        fb.hline(0, y, w, c)
+        fb.rect(x, y, w // 3, h // 3, c)
+        fb.ellipse(x, y, w // 6, h // 5, c)
+        fb.ellipse(y, x, h // 8, h // 8, c, True)
+        fb.poly(x, y, POLYS[i], c)
+        fb.poly(y, x, POLYS[i], c, True)
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (1, 64, 32),
+    (100, 10): (4, 64, 32),
+    (1000, 10): (4, 160, 120),
+    (5000, 100): (8, 320, 240),
+}
+
+
+def bm_setup(params):
+    nframes, w, h = params
+    screens = setup(w, h)
+
+    def run():
+        for n in range(nframes):
+            for fb in screens:
+                draw_frame(w, h, fb, n)
+
+    def result():
+        total = 0
+        for fb in screens:
+            for y in range(0, h, 7):
+                for x in range(0, w, 5):
+                    total += fb.pixel(x, y) & 1
+        return nframes * len(screens) * SHAPES_PER_FRAME, total
+
+    return run, result
@@ -0,0 +1,36 @@
+# Hash data with hashlib.sha256: a stream fed in chunks, then each chunk on its
+# own as for content-addressed keys.  The score is kilobytes hashed per second.
+
+import hashlib
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (2, 8, 1024),
+    (100, 10): (4, 8, 1024),
+    (1000, 100): (8, 64, 1024),
+    (5000, 1000): (16, 256, 4096),
+}
+
+
+def bm_setup(params):
+    nloop, nchunks, size = params
+    chunks = [bytes((i + j) & 0xFF for j in range(size)) for i in range(nchunks)]
+    state = [None]
+
+    def run():
+        for _ in range(nloop):
+            h = hashlib.sha256()
+            for chunk in chunks:
+                h.update(chunk)
+            digests = [h.digest()]
+            for chunk in chunks:
+                digests.append(hashlib.sha256(chunk).digest())
+        state[0] = digests
+
+    def result():
+        return nloop * nchunks * size * 2 // 1024, state[0][0] + state[0][-1]
+
+    return run, result
@@ -0,0 +1,87 @@
+# Write and read back files on FAT and littlefs filesystems on a RAM block
+# device, in small and in large chunks.  The score is bytes transferred per
+# second.
+
+try:
+    import vfs
+
+    vfs.VfsFat
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class RAMBlockDevice:
+    SEC_SIZE = 512
+
+    def __init__(self, blocks):
+        self.data = memoryview(bytearray(blocks * self.SEC_SIZE))
+
+    def readblocks(self, n, buf, off=0):
+        n = n * self.SEC_SIZE + off
+        buf[:] = self.data[n : n + len(buf)]
+
+    def writeblocks(self, n, buf, off=0):
+        n = n * self.SEC_SIZE + off
+        self.data[n : n + len(buf)] = buf
+
+    def ioctl(self, op, arg):
+        if op == 4:  # MP_BLOCKDEV_IOCTL_BLOCK_COUNT
+            return len(self.data) // self.SEC_SIZE
+        if op == 5:  # MP_BLOCKDEV_IOCTL_BLOCK_SIZE
+            return self.SEC_SIZE
+        if op == 6:  # MP_BLOCKDEV_IOCTL_BLOCK_ERASE
+            return 0
+
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (100, 100): (1, 4096, 4),
+    (1000, 100): (4, 4096, 4),
+    (5000, 1000): (8, 65536, 4),
+}
+
+
+def bm_setup(params):
+    nloop, size, nfile = params
+    fs_types = [vfs.VfsFat]
+    if hasattr(vfs, "VfsLfs2"):
+        fs_types.append(vfs.VfsLfs2)
+    data = bytes(range(256)) * (size // 256)
+    data_mv = memoryview(data)
+    small = 64
+    large = 4096
+    buf = bytearray(large)
+    bdev = RAMBlockDevice(max(128, nfile * size * 3 // 2 // RAMBlockDevice.SEC_SIZE))
+    state = [True]
+
+    def run():
+        ok = True
+        for _ in range(nloop):
+            for fs_type in fs_types:
+                fs_type.mkfs(bdev)
+                fs = fs_type(bdev)
+                for i in range(nfile):
+                    # Sequential writes, alternating small and large chunks.
+                    chunk = small if i & 1 else large
+                    with fs.open("f%d" % i, "wb") as f:
+                        for j in range(0, size, chunk):
+                            f.write(data_mv[j : j + chunk])
+                for i in range(nfile):
+                    # Sequential reads, alternating small and large chunks.
+                    chunk = small if i & 1 else large
+                    mv = memoryview(buf)[:chunk]
+                    n = 0
+                    with fs.open("f%d" % i, "rb") as f:
+                        while m := f.readinto(mv):
+                            n += m
+                    ok = ok and n == size and mv == data_mv[size - chunk :]
+                fs.umount()
+        state[0] = ok
+
+    def result():
+        return nloop * len(fs_types) * 2 * size * nfile, state[0]
+
+    return run, result
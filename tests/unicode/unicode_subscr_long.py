@@ -0,0 +1,23 @@
+# test indexing and slicing long strings, which may use a cached character index
+
+a = "Δx€" * 100 + "abc" * 100 + "𝄞y" * 100
+b = "abc" * 200
+
+for s in (a, b):
+    n = len(s)
+    print(n, s[0], s[1], s[n - 1], s[-1], s[-n], s[63], s[64], s[65], s[-65])
+    print(s[100:110], s[-300:-290], s[n - 3 :], s[: -n + 3], s[n : n + 5], s[-n - 5 : -n + 2])
+    print(s.index(s[250:255], 200), s.find(s[250:255], 251))
+    for i in (n, -n - 1, 1000):
+        try:
+            s[i]
+        except IndexError:
+            print("IndexError")
+
+# alternate between two long strings
+print("".join(a[i] + b[i] for i in range(0, len(b), 37)))
+
+# strings that differ only in content at the same length
+for c in ("é", "€"):
+    s = c * 300 + "end"
+    print(len(s), s[300:], s[299])
@@ -82,6 +82,8 @@ function ci_code_size_build {
 # .mpy file format
 
 function ci_mpy_format_setup {
+    sudo apt-get update
+    sudo apt-get install llvm
     sudo pip3 install pyelftools
 }
 
@@ -93,6 +95,16 @@ function ci_mpy_format_test {
     # Test mpy-tool.py dump feature on native code
     make -C examples/natmod/features1
     ./tools/mpy-tool.py -xd examples/natmod/features1/features1.mpy
+
+    # Test the machine code emitted by mpy-cross for architectures that CI can't run
+    make ${MAKEOPTS} -C mpy-cross
+    for arch in rv32imc aarch64; do
+        mkdir -p build-native-$arch
+        for file in tests/micropython/native_*.py tests/micropython/viper_*.py; do
+            ./mpy-cross/build/mpy-cross -march=$arch -o build-native-$arch/$(basename $file .py).mpy $file
+        done
+        ./tools/verifynativecode.py build-native-$arch/*.mpy
+    done
 }
 
 ########################################################################################
@@ -148,7 +160,10 @@ function ci_esp32_build_s3_c3 {
     ci_esp32_build_common
 
     make ${MAKEOPTS} -C ports/esp32 BOARD=ESP32_GENERIC_S3
-    make ${MAKEOPTS} -C ports/esp32 BOARD=ESP32_GENERIC_C3
+
+    # Test freezing native code compiled with -march=rv32imc.
+    make ${MAKEOPTS} -C ports/esp32 BOARD=ESP32_GENERIC_C3 \
+        FROZEN_MANIFEST=$(pwd)/ports/esp32/boards/manifest_test.py
 }
 
 ########################################################################################
@@ -552,6 +567,14 @@ function ci_unix_nanbox_run_tests {
     ci_unix_run_tests_full_helper nanbox PYTHON=python2
 }
 
+function ci_unix_nanbox64_build {
+    ci_unix_build_helper VARIANT=nanbox MICROPY_FORCE_32BIT=0 BUILD=build-nanbox64
+}
+
+function ci_unix_nanbox64_run_tests {
+    ci_unix_run_tests_helper VARIANT=nanbox MICROPY_FORCE_32BIT=0 BUILD=build-nanbox64
+}
+
 function ci_unix_float_build {
     ci_unix_build_helper VARIANT=standard CFLAGS_EXTRA="-DMICROPY_FLOAT_IMPL=MICROPY_FLOAT_IMPL_FLOAT"
     ci_unix_build_ffi_lib_helper gcc
@@ -562,6 +585,18 @@ function ci_unix_float_run_tests {
     ci_unix_run_tests_helper CFLAGS_EXTRA="-DMICROPY_FLOAT_IMPL=MICROPY_FLOAT_IMPL_FLOAT"
 }
 
+function ci_unix_aes_software_build {
+    # Build the constant-time and table-based AES, which x86 hosts don't use.
+    ci_unix_build_helper VARIANT=standard BUILD=build-aes-ct CFLAGS_EXTRA="-DMICROPY_PY_CRYPTOLIB_AES_HW=0"
+    ci_unix_build_helper VARIANT=standard BUILD=build-aes-table CFLAGS_EXTRA="-DMICROPY_PY_CRYPTOLIB_AES_HW=0 -DMICROPY_PY_CRYPTOLIB_AES_CONST_TIME=0"
+}
+
+function ci_unix_aes_software_run_tests {
+    for build in build-aes-ct build-aes-table; do
+        (cd tests && MICROPY_MICROPYTHON=../ports/unix/$build/micropython ./run-tests.py extmod/cryptolib*.py)
+    done
+}
+
 function ci_unix_clang_setup {
     sudo apt-get install clang
     clang --version
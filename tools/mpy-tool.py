@@ -113,6 +113,8 @@ MP_NATIVE_ARCH_ARMV7EMSP = 7
 MP_NATIVE_ARCH_ARMV7EMDP = 8
 MP_NATIVE_ARCH_XTENSA = 9
 MP_NATIVE_ARCH_XTENSAWIN = 10
+MP_NATIVE_ARCH_RV32IMC = 11
+MP_NATIVE_ARCH_AARCH64 = 12
 
 MP_PERSISTENT_OBJ_FUN_TABLE = 0
 MP_PERSISTENT_OBJ_NONE = 1
@@ -191,9 +193,9 @@ class Opcode:
     MP_BC_BASE_QSTR_O                 = (0x10) # LLLLLLSSSDDII---
     MP_BC_BASE_VINT_E                 = (0x20) # MMLLLLSSDDBBBBBB
     MP_BC_BASE_VINT_O                 = (0x30) # UUMMCCCC--------
-    MP_BC_BASE_JUMP_E                 = (0x40) # J-JJJJJEEEEF----
+    MP_BC_BASE_JUMP_E                 = (0x40) # JLJJJJJEEEEF----
     MP_BC_BASE_BYTE_O                 = (0x50) # LLLLSSDTTTTTEEFF
-    MP_BC_BASE_BYTE_E                 = (0x60) # --BREEEYYI------
+    MP_BC_BASE_BYTE_E                 = (0x60) # SSBREEEYYI------
     MP_BC_LOAD_CONST_SMALL_INT_MULTI  = (0x70) # LLLLLLLLLLLLLLLL
     #                                 = (0x80) # LLLLLLLLLLLLLLLL
     #                                 = (0x90) # LLLLLLLLLLLLLLLL
@@ -229,6 +231,7 @@ class Opcode:
     MP_BC_LOAD_SUPER_METHOD           = (MP_BC_BASE_QSTR_O + 0x05) # qstr
     MP_BC_LOAD_BUILD_CLASS            = (MP_BC_BASE_BYTE_O + 0x04)
     MP_BC_LOAD_SUBSCR                 = (MP_BC_BASE_BYTE_O + 0x05)
+    MP_BC_LOAD_FAST_CACHED            = (MP_BC_BASE_JUMP_E + 0x01) # signed relative bytecode offset; then a byte
 
     MP_BC_STORE_FAST_N                = (MP_BC_BASE_VINT_E + 0x06) # uint
     MP_BC_STORE_DEREF                 = (MP_BC_BASE_VINT_E + 0x07) # uint
@@ -236,6 +239,8 @@ class Opcode:
     MP_BC_STORE_GLOBAL                = (MP_BC_BASE_QSTR_O + 0x07) # qstr
     MP_BC_STORE_ATTR                  = (MP_BC_BASE_QSTR_O + 0x08) # qstr
     MP_BC_STORE_SUBSCR                = (MP_BC_BASE_BYTE_O + 0x06)
+    MP_BC_STORE_FAST_CACHED           = (MP_BC_BASE_BYTE_E + 0x00) # byte
+    MP_BC_STORE_FAST_CACHED_ATTR      = (MP_BC_BASE_BYTE_E + 0x01) # byte
 
     MP_BC_DELETE_FAST                 = (MP_BC_BASE_VINT_E + 0x08) # uint
     MP_BC_DELETE_DEREF                = (MP_BC_BASE_VINT_E + 0x09) # uint
@@ -298,6 +303,7 @@ class Opcode:
     # Create sets of related opcodes.
     ALL_OFFSET_SIGNED = (
         MP_BC_UNWIND_JUMP,
+        MP_BC_LOAD_FAST_CACHED,
         MP_BC_JUMP,
         MP_BC_POP_JUMP_IF_TRUE,
         MP_BC_POP_JUMP_IF_FALSE,
@@ -669,6 +675,18 @@ class CompiledModule:
 
         self.freeze_constants()
 
+        # Stubs for the module's top-level functions, up to the last one that
+        # the VM may store as a stub instead of creating it on import.
+        lazy_children = self.raw_code.find_lazy_children()
+        if lazy_children:
+            print()
+            print("#if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS")
+            print("static const mp_obj_fun_lazy_t lazy_funs_%s[] = {" % self.escaped_name)
+            for rc in self.raw_code.children[: max(lazy_children) + 1]:
+                print("    {{ &mp_type_fun_lazy }, &proto_fun_%s }," % rc.escaped_name)
+            print("};")
+            print("#endif")
+
         print()
         print("static const mp_frozen_module_t frozen_module_%s = {" % self.escaped_name)
         print("    .constants = {")
@@ -685,6 +703,15 @@ class CompiledModule:
             print("        .obj_table = NULL,")
         print("    },")
         print("    .proto_fun = &proto_fun_%s," % self.raw_code.escaped_name)
+        global_names = {"__name__", "__file__"}
+        self.raw_code.find_global_names(global_names, True)
+        print("    .n_globals = %u," % len(global_names))
+        print("    #if MICROPY_MODULE_FROZEN_LAZY_FUNCTIONS")
+        if lazy_children:
+            print("    .lazy_funs = lazy_funs_%s," % self.escaped_name)
+        else:
+            print("    .lazy_funs = NULL,")
+        print("    #endif")
         print("};")
 
     def freeze_constant_obj(self, obj_name, obj):
@@ -890,6 +917,14 @@ class RawCode(object):
         for rc in self.children:
             rc.disassemble()
 
+    def find_global_names(self, names, is_module_scope):
+        # Native code can't be inspected, so it doesn't contribute any names.
+        pass
+
+    def find_lazy_children(self):
+        # Native code makes its functions itself, so none of them are lazy.
+        return set()
+
     def freeze_children(self, prelude_ptr=None):
         # Freeze children and generate table of children.
         if len(self.children):
@@ -1007,6 +1042,37 @@ class RawCodeBytecode(RawCode):
             ip += sz
         self.disassemble_children()
 
+    def find_global_names(self, names, is_module_scope):
+        # Collect the names that this code and its children store as globals.
+        bc = self.fun_data
+        ip = self.offset_opcodes
+        while ip < len(bc):
+            fmt, sz, arg, _ = mp_opcode_decode(bc, ip)
+            if bc[ip] == Opcode.MP_BC_STORE_GLOBAL or (
+                is_module_scope and bc[ip] == Opcode.MP_BC_STORE_NAME
+            ):
+                names.add(self.qstr_table[arg].str)
+            ip += sz
+        for rc in self.children:
+            rc.find_global_names(names, False)
+
+    def find_lazy_children(self):
+        # Find the children that MAKE_FUNCTION, ie without default args, creates
+        # and STORE_NAME then stores straight away, which the VM can make lazy.
+        bc = self.fun_data
+        ip = self.offset_opcodes
+        children = set()
+        while ip < len(bc):
+            fmt, sz, arg, _ = mp_opcode_decode(bc, ip)
+            if (
+                bc[ip] == Opcode.MP_BC_MAKE_FUNCTION
+                and ip + sz < len(bc)
+                and bc[ip + sz] == Opcode.MP_BC_STORE_NAME
+            ):
+                children.add(arg)
+            ip += sz
+        return children
+
     def freeze(self):
         # generate bytecode data
         bc = self.fun_data
@@ -1079,23 +1145,30 @@ class RawCodeNative(RawCode):
             MP_NATIVE_ARCH_X64,
             MP_NATIVE_ARCH_XTENSA,
             MP_NATIVE_ARCH_XTENSAWIN,
+            MP_NATIVE_ARCH_RV32IMC,
         ):
             self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",@progbits # ")))'
+        elif config.native_arch == MP_NATIVE_ARCH_AARCH64:
+            self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",@progbits // ")))'
         else:
             self.fun_data_attributes = '__attribute__((section(".text,\\"ax\\",%progbits @ ")))'
 
         # Allow single-byte alignment by default for x86/x64.
-        # ARM needs word alignment, ARM Thumb needs halfword, due to instruction size.
+        # ARM and AArch64 need word alignment, ARM Thumb and RV32IMC need halfword, due to instruction size.
         # Xtensa needs word alignment due to the 32-bit constant table embedded in the code.
         if config.native_arch in (
             MP_NATIVE_ARCH_ARMV6,
             MP_NATIVE_ARCH_XTENSA,
             MP_NATIVE_ARCH_XTENSAWIN,
+            MP_NATIVE_ARCH_AARCH64,
         ):
-            # ARMV6 or Xtensa -- four byte align.
+            # ARMV6, Xtensa or AArch64 -- four byte align.
             self.fun_data_attributes += " __attribute__ ((aligned (4)))"
-        elif MP_NATIVE_ARCH_ARMV6M <= config.native_arch <= MP_NATIVE_ARCH_ARMV7EMDP:
-            # ARMVxxM -- two byte align.
+        elif (
+            MP_NATIVE_ARCH_ARMV6M <= config.native_arch <= MP_NATIVE_ARCH_ARMV7EMDP
+            or config.native_arch == MP_NATIVE_ARCH_RV32IMC
+        ):
+            # ARMVxxM or RV32IMC -- two byte align.
             self.fun_data_attributes += " __attribute__ ((aligned (2)))"
 
     def disassemble(self):
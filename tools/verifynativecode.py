@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#
+# This file is part of the MicroPython project, http://micropython.org/
+#
+# The MIT License (MIT)
+#
+# Copyright (c) 2026 The MicroPython contributors
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+
+# Check that the machine code of every native and viper function in the given
+# .mpy files disassembles, with llvm-mc, into valid instructions only.  This
+# tests the output of native emitters that can't be run on the CI host.
+#
+# Usage: verifynativecode.py [--llvm-mc <path>] file.mpy...
+
+import argparse
+import importlib.util
+import os
+import subprocess
+import sys
+
+TOOLS_DIR = os.path.dirname(os.path.abspath(__file__))
+sys.path.append(os.path.join(TOOLS_DIR, "../py"))
+
+spec = importlib.util.spec_from_file_location("mpy_tool", os.path.join(TOOLS_DIR, "mpy-tool.py"))
+mpy_tool = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(mpy_tool)
+
+# The llvm-mc target for each architecture whose machine code has no data mixed
+# in with the instructions.
+LLVM_TARGETS = {
+    mpy_tool.MP_NATIVE_ARCH_RV32IMC: ("riscv32", "+m,+c"),
+    mpy_tool.MP_NATIVE_ARCH_AARCH64: ("aarch64", ""),
+}
+
+
+def raw_codes(rc):
+    yield rc
+    for child in rc.children:
+        yield from raw_codes(child)
+
+
+def verify_file(llvm_mc, filename):
+    mpy_tool.config.native_arch = mpy_tool.MP_NATIVE_ARCH_NONE
+    compiled_module = mpy_tool.read_mpy(filename)
+    if mpy_tool.config.native_arch == mpy_tool.MP_NATIVE_ARCH_NONE:
+        # bytecode only
+        return 0
+    if mpy_tool.config.native_arch not in LLVM_TARGETS:
+        print("{}: unsupported native architecture".format(filename))
+        return 1
+    triple, mattr = LLVM_TARGETS[mpy_tool.config.native_arch]
+    errors = 0
+    for rc in raw_codes(compiled_module.raw_code):
+        if not isinstance(rc, mpy_tool.RawCodeNative):
+            continue
+        code = rc.fun_data
+        if rc.code_kind == mpy_tool.MP_CODE_NATIVE_PY:
+            # the prelude follows the machine code
+            code = code[: rc.prelude_offset]
+        result = subprocess.run(
+            [llvm_mc, "--disassemble", "--triple=" + triple, "-mattr=" + mattr],
+            input=" ".join("0x%02x" % b for b in code),
+            stdout=subprocess.PIPE,
+            stderr=subprocess.PIPE,
+            universal_newlines=True,
+        )
+        if result.returncode != 0 or result.stderr:
+            print("{}: {}: {}".format(filename, rc.simple_name.str, result.stderr.strip().splitlines()[0]))
+            errors += 1
+    return errors
+
+
+def main():
+    cmd_parser = argparse.ArgumentParser(description="Verify native code in .mpy files.")
+    cmd_parser.add_argument("--llvm-mc", default="llvm-mc", help="llvm-mc executable")
+    cmd_parser.add_argument("files", nargs="+", help=".mpy files to verify")
+    args = cmd_parser.parse_args()
+
+    # Set up mpy-tool.py for reading .mpy files, like its main() does.
+    mpy_tool.config.MICROPY_LONGINT_IMPL = mpy_tool.config.MICROPY_LONGINT_IMPL_MPZ
+    mpy_tool.config.MPZ_DIG_SIZE = 16
+    mpy_tool.config.MICROPY_QSTR_BYTES_IN_LEN = 1
+    mpy_tool.config.MICROPY_QSTR_BYTES_IN_HASH = 1
+    mpy_tool.global_qstrs = mpy_tool.GlobalQStrList()
+
+    errors = 0
+    for filename in args.files:
+        errors += verify_file(args.llvm_mc, filename)
+    if errors:
+        print("{} functions with invalid machine code".format(errors))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()